@@ -1,9 +1,17 @@
+#include <algorithm>
+#include <dirent.h>
 #include <unistd.h>
 #include "ubench.h"
 
 #include "value-types.hh"
 #include "prim-types.hh"
 #include "usdGeom.hh"
+#include "xform.hh"
+
+#if defined(TINYUSDZ_WITH_TYDRA)
+#include "tinyusdz.hh"
+#include "tydra/render-data.hh"
+#endif
 
 using namespace tinyusdz;
 
@@ -61,10 +69,236 @@ UBENCH(perf, timesamples_double_10M)
   tinyusdz::value::TimeSamples ts;
 
   for (size_t i = 0; i < ns; i++) {
-    ts.times.push_back(double(i));
-    ts.values.push_back(double(i));
+    ts.add_sample(double(i), value::Value(double(i)));
+  }
+}
+
+//
+// Evaluate 10k animated xformOps(translate) for 1000 frames.
+//
+constexpr size_t kNumXformOps = 10000;
+constexpr size_t kNumFrames = 1000;
+
+static std::vector<TypedTimeSamples<value::double3>> BuildXformOpTimeSamples() {
+  std::vector<TypedTimeSamples<value::double3>> ops(kNumXformOps);
+
+  // Keyframes on every 10 frames.
+  for (size_t i = 0; i < kNumXformOps; i++) {
+    for (size_t f = 0; f <= kNumFrames; f += 10) {
+      double v = double(i + f);
+      ops[i].add_sample(double(f), {v, v + 1.0, v + 2.0});
+    }
+  }
+
+  return ops;
+}
+
+UBENCH_EX(perf, timesamples_eval_xformops_get)
+{
+  const std::vector<TypedTimeSamples<value::double3>> ops = BuildXformOpTimeSamples();
+  std::vector<value::double3> dst(kNumXformOps);
+
+  UBENCH_DO_BENCHMARK() {
+    for (size_t f = 0; f < kNumFrames; f++) {
+      for (size_t i = 0; i < kNumXformOps; i++) {
+        ops[i].get(&dst[i], double(f));
+      }
+    }
+    UBENCH_DO_NOTHING(dst.data());
+  }
+}
+
+UBENCH_EX(perf, timesamples_eval_xformops_cursor)
+{
+  const std::vector<TypedTimeSamples<value::double3>> ops = BuildXformOpTimeSamples();
+
+  std::vector<const TypedTimeSamples<value::double3> *> ptrs;
+  for (const auto &op : ops) {
+    ptrs.push_back(&op);
+  }
+  std::vector<value::double3> dst(kNumXformOps);
+
+  UBENCH_DO_BENCHMARK() {
+    std::vector<value::TimeSampleCursor> cursors(kNumXformOps);
+    for (size_t f = 0; f < kNumFrames; f++) {
+      EvaluateTimeSamples(ptrs.data(), ptrs.size(), double(f), dst.data(),
+                          value::TimeSampleInterpolationType::Linear, cursors.data());
+    }
+    UBENCH_DO_NOTHING(dst.data());
+  }
+}
+
+UBENCH_EX(perf, timesamples_eval_xformops_batch)
+{
+  const std::vector<TypedTimeSamples<value::double3>> ops = BuildXformOpTimeSamples();
+
+  std::vector<double> times(kNumFrames);
+  for (size_t f = 0; f < kNumFrames; f++) {
+    times[f] = double(f);
+  }
+  std::vector<value::double3> dst(kNumFrames);
+
+  UBENCH_DO_BENCHMARK() {
+    for (size_t i = 0; i < kNumXformOps; i++) {
+      ops[i].get_batch(times.data(), times.size(), dst.data());
+    }
+    UBENCH_DO_NOTHING(dst.data());
+  }
+}
+
+//
+// Transform 1M points.
+//
+constexpr size_t kNumPoints = 1000 * 1000;
+
+static std::vector<value::float3> BuildPoints() {
+  std::vector<value::float3> pts(kNumPoints);
+  for (size_t i = 0; i < kNumPoints; i++) {
+    float f = float(i);
+    pts[i] = {f, f + 1.0f, f + 2.0f};
+  }
+  return pts;
+}
+
+static const value::matrix4d kBenchMatrix =
+    trs_angle_xyz({1.0, 2.0, 3.0}, {30.0, 45.0, 60.0}, {2.0, 2.0, 2.0});
+
+UBENCH_EX(perf, transform_points_1M_scalar)
+{
+  const std::vector<value::float3> pts = BuildPoints();
+  std::vector<value::float3> dst(kNumPoints);
+
+  UBENCH_DO_BENCHMARK() {
+    for (size_t i = 0; i < kNumPoints; i++) {
+      dst[i] = transform(kBenchMatrix, pts[i]);
+    }
+    UBENCH_DO_NOTHING(dst.data());
+  }
+}
+
+UBENCH_EX(perf, transform_points_1M_batch)
+{
+  const std::vector<value::float3> pts = BuildPoints();
+  std::vector<value::float3> dst(kNumPoints);
+
+  UBENCH_DO_BENCHMARK() {
+    transform_points(kBenchMatrix, pts.data(), dst.data(), kNumPoints);
+    UBENCH_DO_NOTHING(dst.data());
+  }
+}
+
+UBENCH_EX(perf, transform_normals_1M_scalar)
+{
+  const std::vector<value::float3> pts = BuildPoints();
+  std::vector<value::normal3f> nrms(kNumPoints);
+  for (size_t i = 0; i < kNumPoints; i++) {
+    nrms[i] = {pts[i][0], pts[i][1], pts[i][2]};
+  }
+  std::vector<value::normal3f> dst(kNumPoints);
+
+  UBENCH_DO_BENCHMARK() {
+    value::matrix4d nm = transpose(inverse(upper_left_3x3_only(kBenchMatrix)));
+    for (size_t i = 0; i < kNumPoints; i++) {
+      value::normal3f n = transform_dir(nm, nrms[i]);
+      float len = std::sqrt(n[0] * n[0] + n[1] * n[1] + n[2] * n[2]);
+      dst[i] = {n[0] / len, n[1] / len, n[2] / len};
+    }
+    UBENCH_DO_NOTHING(dst.data());
+  }
+}
+
+UBENCH_EX(perf, transform_normals_1M_batch)
+{
+  const std::vector<value::float3> pts = BuildPoints();
+  std::vector<value::normal3f> nrms(kNumPoints);
+  for (size_t i = 0; i < kNumPoints; i++) {
+    nrms[i] = {pts[i][0], pts[i][1], pts[i][2]};
+  }
+  std::vector<value::normal3f> dst(kNumPoints);
+
+  UBENCH_DO_BENCHMARK() {
+    transform_normals(kBenchMatrix, nrms.data(), dst.data(), kNumPoints);
+    UBENCH_DO_NOTHING(dst.data());
+  }
+}
+
+#if defined(TINYUSDZ_WITH_TYDRA) && defined(TINYUSDZ_BENCHMARK_MODELS_DIR)
+//
+// Vertex cache optimization of triangulated meshes in models/.
+// ACMR(FIFO cache size 16) before and after is reported once.
+//
+static std::vector<tydra::RenderMesh> LoadModelMeshes() {
+  std::vector<tydra::RenderMesh> meshes;
+
+  const std::string dir(TINYUSDZ_BENCHMARK_MODELS_DIR);
+  DIR *dp = opendir(dir.c_str());
+  if (!dp) {
+    return meshes;
+  }
+
+  std::vector<std::string> filenames;
+  while (struct dirent *ent = readdir(dp)) {
+    const std::string name(ent->d_name);
+    if ((name[0] != '.') && IsUSD(dir + "/" + name)) {
+      filenames.push_back(name);
+    }
+  }
+  closedir(dp);
+  std::sort(filenames.begin(), filenames.end());
+
+  for (const auto &name : filenames) {
+    const std::string filepath = dir + "/" + name;
+    Stage stage;
+    std::string warn, err;
+    if (!LoadUSDFromFile(filepath, &stage, &warn, &err)) {
+      continue;
+    }
+
+    tydra::RenderScene scene;
+    tydra::RenderSceneConverter converter;
+    tydra::RenderSceneConverterEnv env(stage);
+    env.set_search_paths({dir});
+    if (!converter.ConvertToRenderScene(env, &scene)) {
+      continue;
+    }
+
+    for (auto &mesh : scene.meshes) {
+      if (mesh.is_triangulated()) {
+        mesh.abs_path = name + ":" + mesh.abs_path;
+        meshes.emplace_back(std::move(mesh));
+      }
+    }
+  }
+
+  return meshes;
+}
+
+UBENCH_EX(perf, vertex_cache_optimize_models)
+{
+  const std::vector<tydra::RenderMesh> meshes = LoadModelMeshes();
+  constexpr uint32_t kCacheSize = 16;
+
+  for (const auto &mesh : meshes) {
+    tydra::RenderMesh m = mesh;
+    float before = tydra::ComputeACMR(m.triangulatedFaceVertexIndices, kCacheSize);
+    if (!tydra::OptimizeRenderMeshVertexCache(&m, kCacheSize)) {
+      continue;
+    }
+    float after = tydra::ComputeACMR(m.triangulatedFaceVertexIndices, kCacheSize);
+    printf("  %s : %d tris, ACMR %.3f -> %.3f\n", mesh.abs_path.c_str(),
+           int(m.triangulatedFaceVertexIndices.size() / 3), double(before),
+           double(after));
+  }
+
+  UBENCH_DO_BENCHMARK() {
+    for (const auto &mesh : meshes) {
+      tydra::RenderMesh m = mesh;
+      tydra::OptimizeRenderMeshVertexCache(&m, kCacheSize);
+      UBENCH_DO_NOTHING(m.triangulatedFaceVertexIndices.data());
+    }
   }
 }
+#endif
 
 UBENCH(perf, gprim_10M)
 {
@@ -179,10 +179,23 @@ int main(int argc, char **argv) {
     // - [ ] Specializes
     //
 
+    // Share loaded Layers among subLayers/references/payload composition and
+    // iterations.
+    tinyusdz::LayerCache layer_cache;
+
+    tinyusdz::SublayersCompositionOptions sublayers_options;
+    sublayers_options.layer_cache = &layer_cache;
+
+    tinyusdz::ReferencesCompositionOptions references_options;
+    references_options.layer_cache = &layer_cache;
+
+    tinyusdz::PayloadCompositionOptions payload_options;
+    payload_options.layer_cache = &layer_cache;
+
     tinyusdz::Layer src_layer = root_layer;
     if (comp_features.subLayers) {
       tinyusdz::Layer composited_layer;
-      if (!tinyusdz::CompositeSublayers(resolver, src_layer, &composited_layer, &warn, &err)) {
+      if (!tinyusdz::CompositeSublayers(resolver, src_layer, &composited_layer, &warn, &err, sublayers_options)) {
         std::cerr << "Failed to composite subLayers: " << err << "\n";
         return -1;
       }
@@ -209,7 +222,7 @@ int main(int argc, char **argv) {
           has_unresolved = true;
 
           tinyusdz::Layer composited_layer;
-          if (!tinyusdz::CompositeReferences(resolver, src_layer, &composited_layer, &warn, &err)) {
+          if (!tinyusdz::CompositeReferences(resolver, src_layer, &composited_layer, &warn, &err, references_options)) {
             std::cerr << "Failed to composite `references`: " << err << "\n";
             return -1;
           }
@@ -232,7 +245,7 @@ int main(int argc, char **argv) {
           has_unresolved = true;
 
           tinyusdz::Layer composited_layer;
-          if (!tinyusdz::CompositePayload(resolver, src_layer, &composited_layer, &warn, &err)) {
+          if (!tinyusdz::CompositePayload(resolver, src_layer, &composited_layer, &warn, &err, payload_options)) {
             std::cerr << "Failed to composite `payload`: " << err << "\n";
             return -1;
           }
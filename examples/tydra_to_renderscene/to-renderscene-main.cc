@@ -35,6 +35,8 @@ int main(int argc, char **argv) {
     std::cout
         << "  --dumpobj: Dump mesh as wavefront .obj(for visual debugging)\n";
     std::cout << "  --dumpusd: Dump scene as USD(USDA Ascii)\n";
+    std::cout << "  --optvcache: Optimize meshes for vertex cache and report "
+                 "ACMR before/after\n";
     return EXIT_FAILURE;
   }
 
@@ -48,6 +50,7 @@ int main(int argc, char **argv) {
   bool export_obj = false;
   bool export_usd = false;
   bool no_usdprint = false;
+  bool optimize_vertex_cache = false;
 
   std::string filepath;
   for (int i = 1; i < argc; i++) {
@@ -61,6 +64,8 @@ int main(int argc, char **argv) {
       export_obj = true;
     } else if (strcmp(argv[i], "--dumpusd") == 0) {
       export_usd = true;
+    } else if (strcmp(argv[i], "--optvcache") == 0) {
+      optimize_vertex_cache = true;
     } else if (strcmp(argv[i], "--timecode") == 0) {
       if ((i + 1) >= argc) {
         std::cerr << "arg is missing for --timecode flag.\n";
@@ -169,6 +174,32 @@ int main(int argc, char **argv) {
               << "\n";
   }
 
+  if (optimize_vertex_cache) {
+    // Same as `MeshConverterConfig::optimize_vertex_cache`, but applied here
+    // to report ACMR(average cache miss ratio) before and after.
+    constexpr uint32_t kACMRCacheSize = 16;
+    std::cout << "Optimize vertex cache. ACMR(FIFO cache size "
+              << kACMRCacheSize << ")\n";
+    for (auto &mesh : render_scene.meshes) {
+      if (!mesh.is_triangulated()) {
+        continue;
+      }
+      float before = tinyusdz::tydra::ComputeACMR(mesh.faceVertexIndices(),
+                                                  kACMRCacheSize);
+      std::string vc_err;
+      if (!tinyusdz::tydra::OptimizeRenderMeshVertexCache(
+              &mesh, env.mesh_config.vertex_cache_size, &vc_err)) {
+        std::cerr << "  " << mesh.abs_path << ": " << vc_err << "\n";
+        continue;
+      }
+      float after = tinyusdz::tydra::ComputeACMR(mesh.faceVertexIndices(),
+                                                 kACMRCacheSize);
+      std::cout << "  " << mesh.abs_path << " : "
+                << mesh.faceVertexIndices().size() / 3 << " tris, " << before
+                << " -> " << after << "\n";
+    }
+  }
+
   std::cout << DumpRenderScene(render_scene) << "\n";
 
   if (export_obj) {
@@ -286,7 +286,7 @@ bool AsciiParser::ParseTimeSamplesOfArray(const std::string &type_name,
       DCOUT("sep = " << sep);
       if (sep == '}') {
         // End of item
-        ts.add_sample(timeVal, value);
+        ts.add_sample(timeVal, std::move(value));
         break;
       } else if (sep == ',') {
         // ok
@@ -304,7 +304,7 @@ bool AsciiParser::ParseTimeSamplesOfArray(const std::string &type_name,
 
           if (nc == '}') {
             // End of item
-            ts.add_sample(timeVal, value);
+            ts.add_sample(timeVal, std::move(value));
             break;
           }
         }
@@ -318,7 +318,7 @@ bool AsciiParser::ParseTimeSamplesOfArray(const std::string &type_name,
       return false;
     }
 
-    ts.add_sample(timeVal, value);
+    ts.add_sample(timeVal, std::move(value));
   }
 
   DCOUT("Parse TimeSamples success. # of items = " << ts.size());
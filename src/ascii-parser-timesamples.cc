@@ -233,7 +233,7 @@ bool AsciiParser::ParseTimeSamples(const std::string &type_name,
       DCOUT("sep = " << sep);
       if (sep == '}') {
         // End of item
-        ts.add_sample(timeVal, value);
+        ts.add_sample(timeVal, std::move(value));
         break;
       } else if (sep == ',') {
         // ok
@@ -251,7 +251,7 @@ bool AsciiParser::ParseTimeSamples(const std::string &type_name,
 
           if (nc == '}') {
             // End of item
-            ts.add_sample(timeVal, value);
+            ts.add_sample(timeVal, std::move(value));
             break;
           }
         }
@@ -265,7 +265,7 @@ bool AsciiParser::ParseTimeSamples(const std::string &type_name,
       return false;
     }
 
-    ts.add_sample(timeVal, value);
+    ts.add_sample(timeVal, std::move(value));
   }
 
   DCOUT("Parse TimeSamples success. # of items = " << ts.size());
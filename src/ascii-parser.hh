@@ -284,11 +284,14 @@ class AsciiParser {
   /// For composition(Treat Prim as generic container).
   /// AsciiParser(i.e. USDAReader)
   ///
+  /// `properties` is not used after the callback, so the callback can move
+  /// it(to avoid copying large attribute values).
+  ///
   using PrimSpecFunction = std::function<nonstd::expected<bool, std::string>(
       const Path &full_path, const Specifier spec,
       const std::string &primTypeName, const Path &prim_name,
       const int64_t primIdx, const int64_t parentPrimIdx,
-      const std::map<std::string, Property> &properties,
+      std::map<std::string, Property> &properties,
       const PrimMetaMap &in_meta, const VariantSetList &in_variantSetLists)>;
 
   void RegisterPrimSpecFunction(PrimSpecFunction fun) { _primspec_fun = fun; }
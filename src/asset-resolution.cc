@@ -199,4 +199,36 @@ bool AssetResolutionResolver::open_asset(const std::string &resolvedPath, const
   return true;
 }
 
+bool AssetResolutionResolver::get_modification_stamp(
+    const std::string &resolvedPath, uint64_t *stamp) const {
+  if (!stamp) {
+    return false;
+  }
+
+  if (resolvedPath.empty()) {
+    return false;
+  }
+
+  std::string ext = io::GetFileExtension(resolvedPath);
+
+  if (_asset_resolution_handlers.count(ext)) {
+    if (_asset_resolution_handlers.at(ext).size_fun) {
+      void *userdata = _asset_resolution_handlers.at(ext).userdata;
+
+      uint64_t sz{0};
+      std::string err;
+      int ret = _asset_resolution_handlers.at(ext).size_fun(
+          resolvedPath.c_str(), &sz, &err, userdata);
+      if (ret != 0) {
+        return false;
+      }
+
+      (*stamp) = sz;
+      return true;
+    }
+  }
+
+  return io::GetFileModificationStamp(resolvedPath, stamp);
+}
+
 }  // namespace tinyusdz
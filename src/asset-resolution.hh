@@ -272,6 +272,22 @@ class AssetResolutionResolver {
   bool open_asset(const std::string &resolvedPath, const std::string &assetPath,
                   Asset *asset, std::string *warn, std::string *err) const;
 
+  ///
+  /// Get modification stamp of the resolved asset. Used for detecting asset
+  /// updates(e.g. invalidating cached Layer).
+  ///
+  /// For the built-in file handler, the stamp is computed from the file's last
+  /// write time and size. For assets served by custom AssetResolutionHandler,
+  /// asset size(through `size_fun`) is used as the stamp.
+  ///
+  /// @param[in] resolvedPath Resolved path(through `resolve()`)
+  /// @param[out] stamp Modification stamp.
+  ///
+  /// @return true upon success. false when the stamp cannot be obtained.
+  ///
+  bool get_modification_stamp(const std::string &resolvedPath,
+                              uint64_t *stamp) const;
+
   void set_userdata(void *userdata) { _userdata = userdata; }
   void *get_userdata() { return _userdata; }
   const void *get_userdata() const { return _userdata; }
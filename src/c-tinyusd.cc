@@ -2083,7 +2083,7 @@ CTinyUSDValue *c_tinyusd_value_new_array_##__tyname(uint64_t n, const __cty *val
   static_assert(sizeof(__cppty) == sizeof(__cty), ""); \
   std::vector<__cppty> cppvalarray; \
   cppvalarray.resize(size_t(n)); \
-  memcpy(cppvalarray.data(), &vals, sizeof(__cppty) * size_t(n)); \
+  memcpy(cppvalarray.data(), vals, sizeof(__cppty) * size_t(n)); \
   tinyusdz::value::Value *vp = new tinyusdz::value::Value(std::move(cppvalarray)); \
   return reinterpret_cast<CTinyUSDValue *>(vp); \
 }
@@ -2100,6 +2100,32 @@ ATTRIB_VALUE_NEW_ARRAY_IMPL(float4, value::float4, c_tinyusd_float4_t, C_TINYUSD
 
 #undef ATTRIB_VALUE_NEW_ARRAY_IMPL
 
+#define ATTRIB_VALUE_AS_ARRAY_IMPL(__tyname, __cppty, __cty) \
+int c_tinyusd_value_as_array_##__tyname(const CTinyUSDValue *_value, uint64_t *n, const __cty **vals) { \
+  /* ensure C++ and C types has same size. */ \
+  static_assert(sizeof(__cppty) == sizeof(__cty), ""); \
+  if (!_value || !n || !vals) { return 0; } \
+  const tinyusdz::value::Value *vp = reinterpret_cast<const tinyusdz::value::Value *>(_value); \
+  if (auto pv = vp->get_array_view<__cppty>()) { \
+    (*n) = uint64_t(pv.value().size()); \
+    (*vals) = reinterpret_cast<const __cty *>(pv.value().data()); \
+    return 1; \
+  } \
+  return 0; \
+}
+
+ATTRIB_VALUE_AS_ARRAY_IMPL(int, int, int)
+ATTRIB_VALUE_AS_ARRAY_IMPL(int2, value::int2, c_tinyusd_int2_t)
+ATTRIB_VALUE_AS_ARRAY_IMPL(int3, value::int3, c_tinyusd_int3_t)
+ATTRIB_VALUE_AS_ARRAY_IMPL(int4, value::int4, c_tinyusd_int4_t)
+
+ATTRIB_VALUE_AS_ARRAY_IMPL(float, float, float)
+ATTRIB_VALUE_AS_ARRAY_IMPL(float2, value::float2, c_tinyusd_float2_t)
+ATTRIB_VALUE_AS_ARRAY_IMPL(float3, value::float3, c_tinyusd_float3_t)
+ATTRIB_VALUE_AS_ARRAY_IMPL(float4, value::float4, c_tinyusd_float4_t)
+
+#undef ATTRIB_VALUE_AS_ARRAY_IMPL
+
 #define ATTRIB_VALUE_AS_IMPL(__tyname, __cppty, __cty) \
 int c_tinyusd_value_as_##__tyname(const CTinyUSDValue *_value, __cty *val) { \
   /* ensure C++ and C types has same size. */ \
@@ -639,6 +639,32 @@ C_TINYUSD_EXPORT CTinyUSDValue *c_tinyusd_value_new_array_float4(
     uint64_t n, const c_tinyusd_float4_t *vals);
 /*   TODO: List up other types... */
 
+/*
+   Get the pointer to 1D array data in CTinyUSDValue by specifying the type.
+   NOTE: Array data is NOT copied. The pointer is valid until `value` is
+   modified or freed.
+   Returns 1 upon success, 0 failed(e.g. Value is invalid, type mismatch).
+ */
+C_TINYUSD_EXPORT int c_tinyusd_value_as_array_int(const CTinyUSDValue *value,
+                                                  uint64_t *n,
+                                                  const int **vals);
+C_TINYUSD_EXPORT int c_tinyusd_value_as_array_int2(
+    const CTinyUSDValue *value, uint64_t *n, const c_tinyusd_int2_t **vals);
+C_TINYUSD_EXPORT int c_tinyusd_value_as_array_int3(
+    const CTinyUSDValue *value, uint64_t *n, const c_tinyusd_int3_t **vals);
+C_TINYUSD_EXPORT int c_tinyusd_value_as_array_int4(
+    const CTinyUSDValue *value, uint64_t *n, const c_tinyusd_int4_t **vals);
+C_TINYUSD_EXPORT int c_tinyusd_value_as_array_float(const CTinyUSDValue *value,
+                                                    uint64_t *n,
+                                                    const float **vals);
+C_TINYUSD_EXPORT int c_tinyusd_value_as_array_float2(
+    const CTinyUSDValue *value, uint64_t *n, const c_tinyusd_float2_t **vals);
+C_TINYUSD_EXPORT int c_tinyusd_value_as_array_float3(
+    const CTinyUSDValue *value, uint64_t *n, const c_tinyusd_float3_t **vals);
+C_TINYUSD_EXPORT int c_tinyusd_value_as_array_float4(
+    const CTinyUSDValue *value, uint64_t *n, const c_tinyusd_float4_t **vals);
+/*   TODO: List up other types... */
+
 /* opaque pointer to tinyusdz::Path */
 typedef struct CTinyUSDPath CTinyUSDPath;
 
@@ -3,8 +3,12 @@
 
 #include "composition.hh"
 
+#include <list>
 #include <set>
 #include <stack>
+#include <unordered_map>
+
+#include <mutex>
 
 #if defined(__linux__)
 #include <unistd.h>
@@ -13,6 +17,7 @@
 #include "asset-resolution.hh"
 #include "common-macros.inc"
 #include "io-util.hh"
+#include "parallel-util.hh"
 #include "pprinter.hh"
 #include "prim-pprint.hh"
 #include "prim-reconstruct.hh"
@@ -76,6 +81,267 @@ RECONSTRUCT_PRIM_DECL(Shader);
 
 }  // namespace prim
 
+//
+// LayerCache
+//
+class LayerCache::Impl {
+ public:
+  struct Entry {
+    uint64_t stamp{0};
+    size_t nbytes{0};
+    std::shared_ptr<Layer> layer;
+    std::list<std::string>::iterator lru_it;
+  };
+
+  // Evict least recently used Layers until `bytes` fits into `max_bytes`
+  void evict(size_t required_bytes) {
+    while (!lru.empty() && ((bytes + required_bytes) > max_bytes)) {
+      const std::string &key = lru.back();
+      auto it = entries.find(key);
+      if (it != entries.end()) {
+        bytes -= it->second.nbytes;
+        entries.erase(it);
+      }
+      lru.pop_back();
+    }
+  }
+
+  void remove(std::unordered_map<std::string, Entry>::iterator it) {
+    bytes -= it->second.nbytes;
+    lru.erase(it->second.lru_it);
+    entries.erase(it);
+  }
+
+  size_t max_bytes{0};
+  size_t bytes{0};
+  uint64_t num_hits{0};
+  uint64_t num_misses{0};
+
+  // front = most recently used.
+  std::list<std::string> lru;
+  std::unordered_map<std::string, Entry> entries;
+
+  // Always locked since worker threads of composition(`num_threads`) use
+  // the cache regardless of TINYUSDZ_ENABLE_THREAD.
+  mutable std::mutex mutex;
+};
+
+#define LAYER_CACHE_LOCK() std::lock_guard<std::mutex> lock(_impl->mutex)
+
+LayerCache::LayerCache(size_t max_bytes) : _impl(new Impl()) {
+  _impl->max_bytes = max_bytes;
+}
+
+LayerCache::~LayerCache() = default;
+
+std::shared_ptr<Layer> LayerCache::find(const std::string &key,
+                                        const uint64_t stamp) {
+  LAYER_CACHE_LOCK();
+
+  auto it = _impl->entries.find(key);
+  if (it == _impl->entries.end()) {
+    _impl->num_misses++;
+    return nullptr;
+  }
+
+  if (it->second.stamp != stamp) {
+    // Asset was modified.
+    DCOUT("Stale Layer in cache: " << key);
+    _impl->remove(it);
+    _impl->num_misses++;
+    return nullptr;
+  }
+
+  // Move to the front of LRU list.
+  _impl->lru.splice(_impl->lru.begin(), _impl->lru, it->second.lru_it);
+  _impl->num_hits++;
+
+  return it->second.layer;
+}
+
+bool LayerCache::insert(const std::string &key, const uint64_t stamp,
+                        std::shared_ptr<Layer> layer, const size_t nbytes) {
+  if (!layer) {
+    return false;
+  }
+
+  LAYER_CACHE_LOCK();
+
+  auto it = _impl->entries.find(key);
+  if (it != _impl->entries.end()) {
+    _impl->remove(it);
+  }
+
+  if (nbytes > _impl->max_bytes) {
+    return false;
+  }
+
+  _impl->evict(nbytes);
+
+  _impl->lru.push_front(key);
+
+  Impl::Entry entry;
+  entry.stamp = stamp;
+  entry.nbytes = nbytes;
+  entry.layer = std::move(layer);
+  entry.lru_it = _impl->lru.begin();
+
+  _impl->entries.emplace(key, std::move(entry));
+  _impl->bytes += nbytes;
+
+  return true;
+}
+
+bool LayerCache::erase(const std::string &key) {
+  LAYER_CACHE_LOCK();
+
+  auto it = _impl->entries.find(key);
+  if (it == _impl->entries.end()) {
+    return false;
+  }
+
+  _impl->remove(it);
+  return true;
+}
+
+void LayerCache::clear() {
+  LAYER_CACHE_LOCK();
+
+  _impl->entries.clear();
+  _impl->lru.clear();
+  _impl->bytes = 0;
+}
+
+void LayerCache::set_max_bytes(const size_t max_bytes) {
+  LAYER_CACHE_LOCK();
+
+  _impl->max_bytes = max_bytes;
+  _impl->evict(0);
+}
+
+size_t LayerCache::max_bytes() const {
+  LAYER_CACHE_LOCK();
+  return _impl->max_bytes;
+}
+
+size_t LayerCache::bytes() const {
+  LAYER_CACHE_LOCK();
+  return _impl->bytes;
+}
+
+size_t LayerCache::size() const {
+  LAYER_CACHE_LOCK();
+  return _impl->entries.size();
+}
+
+uint64_t LayerCache::num_hits() const {
+  LAYER_CACHE_LOCK();
+  return _impl->num_hits;
+}
+
+uint64_t LayerCache::num_misses() const {
+  LAYER_CACHE_LOCK();
+  return _impl->num_misses;
+}
+
+#undef LAYER_CACHE_LOCK
+
+void CompositionDependencyGraph::add(const std::string &asset_path,
+                                     const Path &prim_path,
+                                     const LoadState arc) {
+  const std::string &prim_part = prim_path.prim_part();
+  const uint32_t bit = static_cast<uint32_t>(arc);
+
+  _asset_to_prims[asset_path][prim_part] |= bit;
+  _prim_to_arcs[prim_part][asset_path] |= bit;
+}
+
+std::vector<Path> CompositionDependencyGraph::get_dependent_prim_paths(
+    const std::string &asset_path, const uint32_t arcs) const {
+  std::vector<Path> paths;
+
+  auto it = _asset_to_prims.find(asset_path);
+  if (it == _asset_to_prims.end()) {
+    return paths;
+  }
+
+  for (const auto &item : it->second) {
+    if (item.second & arcs) {
+      paths.push_back(Path(item.first, ""));
+    }
+  }
+
+  return paths;
+}
+
+bool CompositionDependencyGraph::has_arc(const Path &prim_path,
+                                         const uint32_t arcs) const {
+  auto it = _prim_to_arcs.find(prim_path.prim_part());
+  if (it == _prim_to_arcs.end()) {
+    return false;
+  }
+
+  for (const auto &item : it->second) {
+    if (item.second & arcs) {
+      return true;
+    }
+  }
+
+  return false;
+}
+
+void CompositionDependencyGraph::remove_prim_subtree(const Path &prim_path,
+                                                     const uint32_t arcs) {
+  const std::string &root = prim_path.prim_part();
+
+  // Paths of descendants are sorted right after `root` with "/" prefix,
+  // but other paths(e.g. "/root_1") may be interleaved.
+  auto it = _prim_to_arcs.lower_bound(root);
+  while ((it != _prim_to_arcs.end()) && startsWith(it->first, root)) {
+    const std::string &path = it->first;
+    if ((path.size() != root.size()) && (path[root.size()] != '/')) {
+      ++it;
+      continue;
+    }
+
+    for (auto ait = it->second.begin(); ait != it->second.end();) {
+      ait->second &= ~arcs;
+
+      auto &prims = _asset_to_prims[ait->first];
+      auto pit = prims.find(path);
+      if (pit != prims.end()) {
+        pit->second &= ~arcs;
+        if (pit->second == 0) {
+          prims.erase(pit);
+        }
+      }
+      if (prims.empty()) {
+        _asset_to_prims.erase(ait->first);
+      }
+
+      if (ait->second == 0) {
+        ait = it->second.erase(ait);
+      } else {
+        ++ait;
+      }
+    }
+
+    if (it->second.empty()) {
+      it = _prim_to_arcs.erase(it);
+    } else {
+      ++it;
+    }
+  }
+}
+
+std::vector<std::string> CompositionDependencyGraph::get_asset_paths() const {
+  std::vector<std::string> paths;
+  for (const auto &item : _asset_to_prims) {
+    paths.push_back(item.first);
+  }
+  return paths;
+}
+
 namespace {
 
 bool IsVisited(const std::vector<std::set<std::string>> layer_names_stack,
@@ -156,91 +422,15 @@ bool PropagateAssetResolverState(uint32_t depth, PrimSpec &ps,
   return true;
 }
 
-// TODO: support loading non-USD asset
-bool LoadAsset(AssetResolutionResolver &resolver,
-               const std::string &current_working_path,
-               const std::vector<std::string> &search_paths,
-               const std::map<std::string, FileFormatHandler> &fileformats,
-               const value::AssetPath &assetPath, const Path &primPath,
-               Layer *dst_layer, const PrimSpec **dst_primspec_root,
-               const bool error_when_no_prims_found,
-               const bool error_when_asset_not_found,
-               const bool error_when_unsupported_fileformat, std::string *warn,
-               std::string *err) {
-  if (!dst_layer) {
-    PUSH_ERROR_AND_RETURN(
-        "[Internal error]. `dst_layer` output arg is nullptr.");
-  }
-
-  std::string asset_path = assetPath.GetAssetPath();
+// Open asset and read its content into Layer.
+bool LoadAssetToLayer(AssetResolutionResolver &resolver,
+                      const std::map<std::string, FileFormatHandler> &fileformats,
+                      const std::string &asset_path,
+                      const std::string &resolved_path, Layer *layer,
+                      size_t *asset_bytes, std::string *warn,
+                      std::string *err) {
   std::string ext = GetExtension(asset_path);
 
-  if (asset_path.empty()) {
-    PUSH_ERROR_AND_RETURN(
-        "TODO: No assetPath but Prim path(e.g. </xform>) in references.");
-  }
-
-  // TODO: Use std::stack to manage AssetResolutionResolver state?
-  if (current_working_path.size()) {
-    resolver.set_current_working_path(current_working_path);
-  }
-
-  if (search_paths.size()) {
-    resolver.set_search_paths(search_paths);
-  }
-
-  // resolve path
-  // TODO: Store resolved path to Reference?
-  std::string resolved_path = resolver.resolve(asset_path);
-
-  DCOUT("Loading references: " << resolved_path
-                               << ", asset_path: " << asset_path);
-
-  if (resolved_path.empty()) {
-    if (error_when_asset_not_found) {
-      PUSH_ERROR_AND_RETURN(
-          fmt::format("Failed to resolve asset path `{}`", asset_path));
-    } else {
-      PUSH_WARN(fmt::format("Asset not found: `{}`", asset_path));
-#if 0 // for debugging. print cwd.
-#if defined(__linux__)
-      char pathname[4096];
-      memset(pathname, 0, 4096);
-      char *pathname_p = getcwd(pathname, 4096);
-
-      if (pathname_p == nullptr) {
-        PUSH_ERROR_AND_RETURN(
-            "Getting current working directory failed.");
-      }
-
-      PUSH_WARN(fmt::format("  cwd = {}", std::string(pathname_p)));
-#endif
-#endif
-      PUSH_WARN(
-          fmt::format("  current working path: `{}`", current_working_path));
-      PUSH_WARN(fmt::format("  resolver.current_working_path: `{}`",
-                            resolver.current_working_path()));
-      PUSH_WARN(fmt::format("  search_paths: `{}`", search_paths));
-      PUSH_WARN(fmt::format("  resolver.search_paths: `{}`",
-                            resolver.search_paths()));
-      (*dst_primspec_root) = nullptr;
-      return true;
-    }
-  }
-
-  resolver.set_search_paths(search_paths);
-
-  // Use resolved asset_path's basedir for current working path.
-  // Add resolved asset_path's basedir to search path.
-  std::string base_dir = io::GetBaseDir(resolved_path);
-  if (base_dir.size()) {
-    DCOUT(fmt::format("Add `{}' to asset search path.", base_dir));
-
-    resolver.set_current_working_path(base_dir);
-
-    resolver.add_search_path(base_dir);
-  }
-
   Asset asset;
   if (!resolver.open_asset(resolved_path, asset_path, &asset, warn, err)) {
     PUSH_ERROR_AND_RETURN(
@@ -250,55 +440,18 @@ bool LoadAsset(AssetResolutionResolver &resolver,
   DCOUT("Opened resolved assst: " << resolved_path
                                   << ", asset_path: " << asset_path);
 
-  if (IsBuiltinFileFormat(asset_path)) {
-    if (IsUSDFileFormat(asset_path) || IsMtlxFileFormat(asset_path)) {
-      // ok
-    } else {
-      // TODO: obj
-      if (error_when_unsupported_fileformat) {
-        PUSH_ERROR_AND_RETURN(fmt::format(
-            "TODO: Unknown/unsupported asset file format: {}", asset_path));
-      } else {
-        PUSH_WARN(fmt::format(
-            "TODO: Unknown/unsupported asset file format. Skipped: {}",
-            asset_path));
-        return true;
-      }
-    }
-  } else {
-    if (fileformats.count(ext)) {
-      DCOUT("Fileformat handler found for: " + ext);
-
-    } else {
-      DCOUT("Unknown/unsupported fileformat: " + ext);
-      if (error_when_unsupported_fileformat) {
-        PUSH_ERROR_AND_RETURN(fmt::format(
-            "Unknown/unsupported asset file format: {}", asset_path));
-      } else {
-        PUSH_WARN(fmt::format(
-            "Unknown/unsupported asset file format. Skipped: {}", asset_path));
-        return true;
-      }
-    }
-  }
+  (*asset_bytes) = asset.size();
 
-  Layer layer;
   std::string _warn;
   std::string _err;
 
   if (IsUSDFileFormat(asset_path)) {
-    if (!LoadLayerFromMemory(asset.data(), asset.size(), asset_path, &layer,
+    if (!LoadLayerFromMemory(asset.data(), asset.size(), asset_path, layer,
                              &_warn, &_err)) {
       PUSH_ERROR_AND_RETURN(
           fmt::format("Failed to open `{}` as Layer: {}", asset_path, _err));
     }
   } else if (IsMtlxFileFormat(asset_path)) {
-    // primPath must be '</MaterialX>'
-    if (primPath.prim_part() != "/MaterialX") {
-      PUSH_ERROR_AND_RETURN("Prim path must be </MaterialX>, but got: " +
-                            primPath.prim_part());
-    }
-
     PrimSpec ps;
     if (!LoadMaterialXFromAsset(asset, asset_path, ps, &_warn, &_err)) {
       PUSH_ERROR_AND_RETURN(
@@ -306,7 +459,7 @@ bool LoadAsset(AssetResolutionResolver &resolver,
     }
 
     ps.name() = "MaterialX";
-    layer.primspecs()["MaterialX"] = ps;
+    layer->primspecs()["MaterialX"] = std::move(ps);
 
   } else {
     if (fileformats.count(ext)) {
@@ -323,7 +476,8 @@ bool LoadAsset(AssetResolutionResolver &resolver,
             "PrimSpec element_name is empty. asset `{}`", asset_path));
       }
 
-      layer.primspecs()[ps.name()] = ps;
+      std::string name = ps.name();
+      layer->primspecs()[name] = std::move(ps);
       DCOUT("Read asset from custom fileformat handler: " << ext);
     } else {
       PUSH_ERROR_AND_RETURN(fmt::format(
@@ -331,7 +485,7 @@ bool LoadAsset(AssetResolutionResolver &resolver,
     }
   }
 
-  DCOUT("layer = " << print_layer(layer, 0));
+  DCOUT("layer = " << print_layer(*layer, 0));
 
   // TODO: Recursively resolve `references`
 
@@ -341,57 +495,33 @@ bool LoadAsset(AssetResolutionResolver &resolver,
     }
   }
 
-  if (layer.primspecs().empty()) {
-    if (error_when_no_prims_found) {
-      PUSH_ERROR_AND_RETURN(fmt::format("No prims in layer `{}`", asset_path));
-    }
-
-    if (dst_primspec_root) {
-      (*dst_primspec_root) = nullptr;
-    }
+  return true;
+}
 
-    (*dst_layer) = std::move(layer);
+// Open asset and read it as Layer, then record the AssetResolver state to the
+// Layer. `resolver` must hold the state set by `ResolveAssetForLoad`.
+bool LoadResolvedAsset(AssetResolutionResolver &resolver,
+                       const std::map<std::string, FileFormatHandler> &fileformats,
+                       const std::string &asset_path,
+                       const std::string &resolved_path,
+                       std::shared_ptr<Layer> *dst_layer, size_t *asset_bytes,
+                       std::string *warn, std::string *err) {
+  auto layer_ptr = std::make_shared<Layer>();
 
-    return true;
+  if (!LoadAssetToLayer(resolver, fileformats, asset_path, resolved_path,
+                        layer_ptr.get(), asset_bytes, warn, err)) {
+    return false;
   }
 
-  const PrimSpec *src_ps{nullptr};
-
-  if (dst_primspec_root) {
-    std::string default_prim;
-    if (primPath.is_valid()) {
-      default_prim = primPath.prim_part();
-      DCOUT("primPath = " << default_prim);
-    } else {
-      // Use `defaultPrim` metadatum
-      if (layer.metas().defaultPrim.valid()) {
-        default_prim = "/" + layer.metas().defaultPrim.str();
-        DCOUT("layer.meta.defaultPrim = " << default_prim);
-      } else {
-        // Use the first Prim in the layer.
-        default_prim = "/" + layer.primspecs().begin()->first;
-        DCOUT("layer.primspecs[0].name = " << default_prim);
-      }
-    }
-
-    if (!layer.find_primspec_at(Path(default_prim, ""), &src_ps, err)) {
-      PUSH_ERROR_AND_RETURN(fmt::format(
-          "Failed to find PrimSpec `{}` in layer `{}`(resolved path: `{}`)",
-          default_prim, asset_path, resolved_path));
-    }
-
-    if (!src_ps) {
-      PUSH_ERROR_AND_RETURN("Internal error: PrimSpec pointer is nullptr.");
-    }
-
-    if (!PropagateAssetResolverState(0, *const_cast<PrimSpec *>(src_ps),
+  // Record AssetResolver state to each PrimSpec for nested composition.
+  // Do it here(not per arc) since the Layer may be shared through the cache.
+  for (auto &item : layer_ptr->primspecs()) {
+    if (!PropagateAssetResolverState(0, item.second,
                                      resolver.current_working_path(),
                                      resolver.search_paths())) {
       PUSH_ERROR_AND_RETURN(
           "Store AssetResolver state to each PrimSpec failed.\n");
     }
-
-    (*dst_primspec_root) = src_ps;
   }
 
   // FIXME: This may be redundant, since assetresulution state is stored in
@@ -399,21 +529,497 @@ bool LoadAsset(AssetResolutionResolver &resolver,
   // TODO: Remove layer-level assetresulution state store?
   //
   // save assetresolution state for nested composition.
-  layer.set_asset_resolution_state(resolver.current_working_path(),
-                                   resolver.search_paths(),
-                                   resolver.get_userdata());
+  layer_ptr->set_asset_resolution_state(resolver.current_working_path(),
+                                        resolver.search_paths(),
+                                        resolver.get_userdata());
 
-  (*dst_layer) = std::move(layer);
+  (*dst_layer) = std::move(layer_ptr);
 
   return true;
 }
 
+// Key for LayerCache.
+// Asset resolution state is recorded to PrimSpecs of the loaded Layer, so
+// include it to the key.
+std::string LayerCacheKey(const std::string &resolved_path,
+                          const std::string &current_working_path,
+                          const std::vector<std::string> &search_paths) {
+  std::string key = resolved_path;
+  key += '\n';
+  key += current_working_path;
+  for (const auto &p : search_paths) {
+    key += '\n';
+    key += p;
+  }
+  return key;
+}
+
+// Set AssetResolver state for the asset and resolve its path.
+std::string ResolveAssetPath(AssetResolutionResolver &resolver,
+                             const std::string &current_working_path,
+                             const std::vector<std::string> &search_paths,
+                             const std::string &asset_path) {
+  // TODO: Use std::stack to manage AssetResolutionResolver state?
+  if (current_working_path.size()) {
+    resolver.set_current_working_path(current_working_path);
+  }
+
+  if (search_paths.size()) {
+    resolver.set_search_paths(search_paths);
+  }
+
+  // TODO: Store resolved path to Reference?
+  return resolver.resolve(asset_path);
+}
+
+// Set AssetResolver state for loading the resolved asset.
+void SetupResolverForAsset(AssetResolutionResolver &resolver,
+                           const std::vector<std::string> &search_paths,
+                           const std::string &resolved_path) {
+  resolver.set_search_paths(search_paths);
+
+  // Use resolved asset_path's basedir for current working path.
+  // Add resolved asset_path's basedir to search path.
+  std::string base_dir = io::GetBaseDir(resolved_path);
+  if (base_dir.size()) {
+    DCOUT(fmt::format("Add `{}' to asset search path.", base_dir));
+
+    resolver.set_current_working_path(base_dir);
+
+    resolver.add_search_path(base_dir);
+  }
+}
+
+// Resolve the asset path, then set AssetResolver state for loading the
+// resolved asset. Returns empty string when the asset is not found(AssetResolver
+// state for loading is not set in this case).
+std::string ResolveAssetForLoad(AssetResolutionResolver &resolver,
+                                const std::string &current_working_path,
+                                const std::vector<std::string> &search_paths,
+                                const std::string &asset_path) {
+  std::string resolved_path = ResolveAssetPath(resolver, current_working_path,
+                                               search_paths, asset_path);
+  if (resolved_path.size()) {
+    SetupResolverForAsset(resolver, search_paths, resolved_path);
+  }
+  return resolved_path;
+}
+
+// Copy of AssetResolver for a worker thread, since AssetResolver state is
+// modified while loading an asset.
+AssetResolutionResolver CopyResolver(const AssetResolutionResolver &resolver) {
+  // copy ctor does not copy these states.
+  AssetResolutionResolver dst = resolver;
+  dst.set_current_working_path(resolver.current_working_path());
+  dst.set_max_asset_bytes_in_mb(resolver.get_max_asset_bytes_in_mb());
+  return dst;
+}
+
+// Get LayerCache key and modification stamp of the resolved asset.
+// Returns false when the asset cannot be cached(no modification stamp).
+bool GetLayerCacheEntry(const AssetResolutionResolver &resolver,
+                        const std::string &resolved_path,
+                        const std::string &current_working_path,
+                        const std::vector<std::string> &search_paths,
+                        std::string *cache_key, uint64_t *stamp) {
+  if (!resolver.get_modification_stamp(resolved_path, stamp)) {
+    return false;
+  }
+
+  (*cache_key) =
+      LayerCacheKey(resolved_path, current_working_path, search_paths);
+  return true;
+}
+
+bool IsSupportedAssetFormat(
+    const std::string &asset_path,
+    const std::map<std::string, FileFormatHandler> &fileformats) {
+  if (IsBuiltinFileFormat(asset_path)) {
+    // TODO: obj
+    return IsUSDFileFormat(asset_path) || IsMtlxFileFormat(asset_path);
+  }
+
+  return fileformats.count(GetExtension(asset_path));
+}
+
+// TODO: support loading non-USD asset
+//
+// `dst_layer` may be shared with `layer_cache`. Do not modify it when
+// `layer_cache` is not nullptr.
+bool LoadAsset(AssetResolutionResolver &resolver, LayerCache *layer_cache,
+               const std::string &current_working_path,
+               const std::vector<std::string> &search_paths,
+               const std::map<std::string, FileFormatHandler> &fileformats,
+               const value::AssetPath &assetPath, const Path &primPath,
+               std::shared_ptr<Layer> *dst_layer,
+               const PrimSpec **dst_primspec_root,
+               const bool error_when_no_prims_found,
+               const bool error_when_asset_not_found,
+               const bool error_when_unsupported_fileformat, std::string *warn,
+               std::string *err, std::string *resolved_path_out = nullptr) {
+  if (!dst_layer) {
+    PUSH_ERROR_AND_RETURN(
+        "[Internal error]. `dst_layer` output arg is nullptr.");
+  }
+
+  std::string asset_path = assetPath.GetAssetPath();
+  std::string ext = GetExtension(asset_path);
+
+  if (asset_path.empty()) {
+    PUSH_ERROR_AND_RETURN(
+        "TODO: No assetPath but Prim path(e.g. </xform>) in references.");
+  }
+
+  // resolve path
+  std::string resolved_path = ResolveAssetForLoad(
+      resolver, current_working_path, search_paths, asset_path);
+  if (resolved_path_out) {
+    (*resolved_path_out) = resolved_path;
+  }
+
+  if (IsMtlxFileFormat(asset_path)) {
+    // primPath must be '</MaterialX>'
+    if (primPath.prim_part() != "/MaterialX") {
+      PUSH_ERROR_AND_RETURN("Prim path must be </MaterialX>, but got: " +
+                            primPath.prim_part());
+    }
+  }
+
+  DCOUT("Loading references: " << resolved_path
+                               << ", asset_path: " << asset_path);
+
+  if (resolved_path.empty()) {
+    if (error_when_asset_not_found) {
+      PUSH_ERROR_AND_RETURN(
+          fmt::format("Failed to resolve asset path `{}`", asset_path));
+    } else {
+      PUSH_WARN(fmt::format("Asset not found: `{}`", asset_path));
+#if 0 // for debugging. print cwd.
+#if defined(__linux__)
+      char pathname[4096];
+      memset(pathname, 0, 4096);
+      char *pathname_p = getcwd(pathname, 4096);
+
+      if (pathname_p == nullptr) {
+        PUSH_ERROR_AND_RETURN(
+            "Getting current working directory failed.");
+      }
+
+      PUSH_WARN(fmt::format("  cwd = {}", std::string(pathname_p)));
+#endif
+#endif
+      PUSH_WARN(
+          fmt::format("  current working path: `{}`", current_working_path));
+      PUSH_WARN(fmt::format("  resolver.current_working_path: `{}`",
+                            resolver.current_working_path()));
+      PUSH_WARN(fmt::format("  search_paths: `{}`", search_paths));
+      PUSH_WARN(fmt::format("  resolver.search_paths: `{}`",
+                            resolver.search_paths()));
+      (*dst_primspec_root) = nullptr;
+      return true;
+    }
+  }
+
+  if (!IsSupportedAssetFormat(asset_path, fileformats)) {
+    DCOUT("Unknown/unsupported fileformat: " + ext);
+    if (error_when_unsupported_fileformat) {
+      PUSH_ERROR_AND_RETURN(fmt::format(
+          "Unknown/unsupported asset file format: {}", asset_path));
+    } else {
+      PUSH_WARN(fmt::format(
+          "Unknown/unsupported asset file format. Skipped: {}", asset_path));
+      return true;
+    }
+  }
+
+  std::string cache_key;
+  uint64_t stamp{0};
+  bool cacheable{false};
+  std::shared_ptr<Layer> layer_ptr;
+
+  if (layer_cache) {
+    // Asset without modification stamp is not cached.
+    if (GetLayerCacheEntry(resolver, resolved_path, current_working_path,
+                           search_paths, &cache_key, &stamp)) {
+      cacheable = true;
+      layer_ptr = layer_cache->find(cache_key, stamp);
+      if (layer_ptr) {
+        DCOUT("Use cached Layer: " << resolved_path);
+      }
+    }
+  }
+
+  if (!layer_ptr) {
+    size_t asset_bytes{0};
+    if (!LoadResolvedAsset(resolver, fileformats, asset_path, resolved_path,
+                           &layer_ptr, &asset_bytes, warn, err)) {
+      return false;
+    }
+
+    if (cacheable) {
+      // Approximate memory usage of the Layer by the asset size.
+      layer_cache->insert(cache_key, stamp, layer_ptr, asset_bytes);
+    }
+  }
+
+  // NOTE: Use const Layer to keep PrimSpec path index of the cached Layer.
+  const Layer &layer = *layer_ptr;
+
+  if (layer.primspecs().empty()) {
+    if (error_when_no_prims_found) {
+      PUSH_ERROR_AND_RETURN(fmt::format("No prims in layer `{}`", asset_path));
+    }
+
+    if (dst_primspec_root) {
+      (*dst_primspec_root) = nullptr;
+    }
+
+    (*dst_layer) = std::move(layer_ptr);
+
+    return true;
+  }
+
+  const PrimSpec *src_ps{nullptr};
+
+  if (dst_primspec_root) {
+    std::string default_prim;
+    if (primPath.is_valid()) {
+      default_prim = primPath.prim_part();
+      DCOUT("primPath = " << default_prim);
+    } else {
+      // Use `defaultPrim` metadatum
+      if (layer.metas().defaultPrim.valid()) {
+        default_prim = "/" + layer.metas().defaultPrim.str();
+        DCOUT("layer.meta.defaultPrim = " << default_prim);
+      } else {
+        // Use the first Prim in the layer.
+        default_prim = "/" + layer.primspecs().begin()->first;
+        DCOUT("layer.primspecs[0].name = " << default_prim);
+      }
+    }
+
+    if (!layer.find_primspec_at(Path(default_prim, ""), &src_ps, err)) {
+      PUSH_ERROR_AND_RETURN(fmt::format(
+          "Failed to find PrimSpec `{}` in layer `{}`(resolved path: `{}`)",
+          default_prim, asset_path, resolved_path));
+    }
+
+    if (!src_ps) {
+      PUSH_ERROR_AND_RETURN("Internal error: PrimSpec pointer is nullptr.");
+    }
+
+    (*dst_primspec_root) = src_ps;
+  }
+
+  (*dst_layer) = std::move(layer_ptr);
+
+  return true;
+}
+
+// Asset load request collected from `references`/`payload` arcs for
+// prefetching.
+struct AssetLoadRequest {
+  // Arc info
+  std::string current_working_path;
+  std::vector<std::string> search_paths;
+  std::string asset_path;
+
+  // Filled by the resolution phase.
+  AssetResolutionResolver resolver;
+  std::string resolved_path;
+  std::string cache_key;
+  uint64_t stamp{0};
+  bool resolved{false};
+
+  // Filled by the load phase.
+  std::shared_ptr<Layer> layer;
+  size_t asset_bytes{0};
+  std::string warn;
+};
+
+void CollectAssetLoadRequests(
+    uint32_t depth, const PrimSpec &primspec, const bool references,
+    const bool payload, const uint32_t max_depth,
+    std::set<std::string> &visited, std::vector<AssetLoadRequest> &requests) {
+  if (depth > max_depth) {
+    // Too deep. Error will be reported in the composition pass.
+    return;
+  }
+
+  for (const auto &child : primspec.children()) {
+    CollectAssetLoadRequests(depth + 1, child, references, payload, max_depth,
+                             visited, requests);
+  }
+
+  auto add_request = [&](const value::AssetPath &assetPath) {
+    std::string asset_path = assetPath.GetAssetPath();
+    if (asset_path.empty()) {
+      return;
+    }
+
+    AssetLoadRequest req;
+    req.current_working_path = primspec.get_current_working_path();
+    req.search_paths = primspec.get_asset_search_paths();
+    req.asset_path = asset_path;
+
+    // Dedup identical requests.
+    std::string key = LayerCacheKey(asset_path, req.current_working_path,
+                                    req.search_paths);
+    if (visited.count(key)) {
+      return;
+    }
+    visited.insert(key);
+
+    requests.emplace_back(std::move(req));
+  };
+
+  if (references && primspec.metas().references) {
+    for (const auto &reference : primspec.metas().references.value().second) {
+      add_request(reference.asset_path);
+    }
+  }
+
+  if (payload && primspec.metas().payload) {
+    for (const auto &pl : primspec.metas().payload.value().second) {
+      add_request(pl.asset_path);
+    }
+  }
+}
+
+//
+// Load assets referenced from `references`/`payload` arcs in the Layer
+// concurrently, and store them to `layer_cache`.
+//
+// Arcs are then applied serially in the composition pass(through the cache), so
+// the result and the strength ordering are identical to the serial
+// composition. Errors are also reported in the composition pass.
+//
+void PrefetchAssets(const AssetResolutionResolver &resolver,
+                    LayerCache *layer_cache, const Layer &layer,
+                    const bool references, const bool payload,
+                    const uint32_t max_depth,
+                    const std::map<std::string, FileFormatHandler> &fileformats,
+                    const int num_threads, std::string *warn) {
+  uint32_t nthreads = parallel::GetNumThreads(num_threads);
+  if ((nthreads <= 1) || !layer_cache) {
+    return;
+  }
+
+  std::vector<AssetLoadRequest> requests;
+  std::set<std::string> visited;
+
+  for (const auto &item : layer.primspecs()) {
+    CollectAssetLoadRequests(/* depth */ 0, item.second, references, payload,
+                             max_depth, visited, requests);
+  }
+
+  if (requests.empty()) {
+    return;
+  }
+
+  DCOUT("# of assets to prefetch: " << requests.size());
+
+  // 1. Resolve asset paths.
+  parallel::ParallelFor(
+      0, requests.size(), nthreads, [&](size_t i, uint32_t /* thread_id */) {
+        AssetLoadRequest &req = requests[i];
+
+        req.resolver = CopyResolver(resolver);
+
+        req.resolved_path =
+            ResolveAssetForLoad(req.resolver, req.current_working_path,
+                                req.search_paths, req.asset_path);
+        if (req.resolved_path.empty()) {
+          return;
+        }
+
+        if (!IsSupportedAssetFormat(req.asset_path, fileformats)) {
+          return;
+        }
+
+        if (!GetLayerCacheEntry(req.resolver, req.resolved_path,
+                                req.current_working_path, req.search_paths,
+                                &req.cache_key, &req.stamp)) {
+          return;
+        }
+
+        req.resolved = true;
+      });
+
+  // 2. Exclude cached assets and assets resolved to the same path.
+  std::vector<size_t> load_indices;
+  {
+    std::set<std::string> keys;
+    for (size_t i = 0; i < requests.size(); i++) {
+      const AssetLoadRequest &req = requests[i];
+      if (!req.resolved || keys.count(req.cache_key)) {
+        continue;
+      }
+      keys.insert(req.cache_key);
+
+      if (layer_cache->find(req.cache_key, req.stamp)) {
+        continue;
+      }
+
+      load_indices.push_back(i);
+    }
+  }
+
+  // 3. Load and parse assets.
+  parallel::ParallelFor(
+      0, load_indices.size(), nthreads,
+      [&](size_t i, uint32_t /* thread_id */) {
+        AssetLoadRequest &req = requests[load_indices[i]];
+
+        std::string err;
+        if (!LoadResolvedAsset(req.resolver, fileformats, req.asset_path,
+                               req.resolved_path, &req.layer, &req.asset_bytes,
+                               &req.warn, &err)) {
+          // Report it in the composition pass.
+          req.layer.reset();
+        }
+      });
+
+  // 4. Store to the cache in deterministic order.
+  for (size_t idx : load_indices) {
+    AssetLoadRequest &req = requests[idx];
+    if (!req.layer) {
+      continue;
+    }
+
+    if (req.warn.size()) {
+      PUSH_WARN(req.warn);
+    }
+
+    layer_cache->insert(req.cache_key, req.stamp, std::move(req.layer),
+                        req.asset_bytes);
+  }
+}
+
+// Composite a subset of root PrimSpecs in subLayers(for incremental
+// re-composition).
+struct SublayerPrimFilter {
+  // Root PrimSpec names to composite.
+  std::set<std::string> prim_names;
+
+  // Resolved paths of modified subLayer assets.
+  std::set<std::string> modified_asset_paths;
+
+  // [out] Root PrimSpec names found in modified assets, but not in
+  // `prim_names`(i.e. newly added PrimSpecs).
+  std::set<std::string> new_prim_names;
+};
+
+//
+// `filter` : Only merge root PrimSpecs in `filter` when not nullptr.
+//
 bool CompositeSublayersRec(AssetResolutionResolver &resolver,
                            const Layer &in_layer,
                            std::vector<std::set<std::string>> layer_names_stack,
                            Layer *composited_layer, std::string *warn,
                            std::string *err,
-                           const SublayersCompositionOptions &options) {
+                           const SublayersCompositionOptions &options,
+                           SublayerPrimFilter *filter) {
   if (layer_names_stack.size() > options.max_depth) {
     if (err) {
       (*err) += "subLayer is nested too deeply.";
@@ -444,25 +1050,39 @@ bool CompositeSublayersRec(AssetResolutionResolver &resolver,
                                         resolver.search_paths_str()));
     }
 
-    tinyusdz::Layer sublayer;
-    if (!LoadAsset(resolver, in_layer.get_current_working_path(),
+    std::shared_ptr<Layer> sublayer_ptr;
+    std::string resolved_path;
+    if (!LoadAsset(resolver, options.layer_cache,
+                   in_layer.get_current_working_path(),
                    in_layer.get_asset_search_paths(), options.fileformats,
                    layer.assetPath, /* not_used */ Path::make_root_path(),
-                   &sublayer, /* primspec_root */ nullptr,
+                   &sublayer_ptr, /* primspec_root */ nullptr,
                    options.error_when_no_prims_in_sublayer,
                    options.error_when_asset_not_found,
-                   options.error_when_unsupported_fileformat, warn, err)) {
+                   options.error_when_unsupported_fileformat, warn, err,
+                   &resolved_path)) {
       PUSH_ERROR_AND_RETURN(
           fmt::format("Load asset in subLayer failed: `{}`", layer.assetPath));
     }
 
+    if (!sublayer_ptr) {
+      // Unsupported fileformat. Skipped.
+      continue;
+    }
+
+    // Layer in the cache must not be modified(PrimSpecs are moved out only
+    // when the Layer is not shared through the cache).
+    const bool movable = (options.layer_cache == nullptr);
+    const Layer &sublayer = *sublayer_ptr;
+
     curr_layer_names.insert(sublayer_asset_path);
 
     Layer composited_sublayer;
 
     // Recursively load subLayer
     if (!CompositeSublayersRec(resolver, sublayer, layer_names_stack,
-                               &composited_sublayer, warn, err, options)) {
+                               &composited_sublayer, warn, err, options,
+                               filter)) {
       return false;
     }
 
@@ -472,6 +1092,13 @@ bool CompositeSublayersRec(AssetResolutionResolver &resolver,
       // NOTE: `over` specifier is ignored when merging Prims among different
       // subLayers
       for (auto &prim : composited_sublayer.primspecs()) {
+        if (options.dependency_graph) {
+          // Prims in sublayer's sublayers also depend on this sublayer
+          // (e.g. when subLayers are added or removed in the sublayer).
+          options.dependency_graph->add(resolved_path, Path("/" + prim.first, ""),
+                                        LoadState::Sublayer);
+        }
+
         if (composited_layer->has_primspec(prim.first)) {
           // Skip
         } else {
@@ -485,19 +1112,54 @@ bool CompositeSublayersRec(AssetResolutionResolver &resolver,
       }
 
       // 2/2. merge sublayer
-      for (auto &prim : sublayer.primspecs()) {
-        if (composited_layer->has_primspec(prim.first)) {
+      // `movable_ps` : Same as `ps` when it can be moved. nullptr otherwise.
+      auto merge_primspec = [&](const std::string &name, const PrimSpec &ps,
+                                PrimSpec *movable_ps) -> bool {
+        if (filter && !filter->prim_names.count(name)) {
+          if (filter->modified_asset_paths.count(resolved_path)) {
+            filter->new_prim_names.insert(name);
+          }
+          return true;
+        }
+
+        if (options.dependency_graph) {
+          options.dependency_graph->add(resolved_path, Path("/" + name, ""),
+                                        LoadState::Sublayer);
+        }
+
+        if (composited_layer->has_primspec(name)) {
           // Skip
         } else {
-          if (!composited_layer->emplace_primspec(prim.first, std::move(prim.second))) {
+          bool ret = movable_ps ? composited_layer->emplace_primspec(
+                                      name, std::move(*movable_ps))
+                                : composited_layer->add_primspec(name, ps);
+          if (!ret) {
             PUSH_ERROR_AND_RETURN(
-                fmt::format("Compositing PrimSpec {} in {} failed.", prim.first,
+                fmt::format("Compositing PrimSpec {} in {} failed.", name,
                             layer_filepath));
           }
-          DCOUT("add primspec: " << prim.first);
+          DCOUT("add primspec: " << name);
         }
-      }
-    }
+        return true;
+      };
+
+      if (movable) {
+        // Not shared. Move PrimSpecs out of the loaded Layer.
+        for (auto &prim : sublayer_ptr->primspecs()) {
+          if (!merge_primspec(prim.first, prim.second, &prim.second)) {
+            return false;
+          }
+        }
+      } else {
+        // Iterate through const Layer so that the PrimSpec path index of the
+        // cached Layer is kept.
+        for (const auto &prim : sublayer.primspecs()) {
+          if (!merge_primspec(prim.first, prim.second, nullptr)) {
+            return false;
+          }
+        }
+      }
+    }
   }
 
   layer_names_stack.pop_back();
@@ -505,21 +1167,21 @@ bool CompositeSublayersRec(AssetResolutionResolver &resolver,
   return true;
 }
 
-}  // namespace
-
-bool CompositeSublayers(AssetResolutionResolver &resolver,
-                        const Layer &in_layer, Layer *composited_layer,
-                        std::string *warn, std::string *err,
-                        SublayersCompositionOptions options) {
-  if (!composited_layer) {
-    return false;
-  }
-
+//
+// Composite subLayers and merge root PrimSpecs of `in_layer`.
+// `filter` : Only composite root PrimSpecs in `filter` when not nullptr.
+//
+bool CompositeSublayersImpl(AssetResolutionResolver &resolver,
+                            const Layer &in_layer, Layer *composited_layer,
+                            std::string *warn, std::string *err,
+                            const SublayersCompositionOptions &options,
+                            SublayerPrimFilter *filter) {
   std::vector<std::set<std::string>> layer_names_stack;
 
   DCOUT("Resolve subLayers..");
   if (!CompositeSublayersRec(resolver, in_layer, layer_names_stack,
-                             composited_layer, warn, err, options)) {
+                             composited_layer, warn, err, options,
+                             filter)) {
     PUSH_ERROR_AND_RETURN("Composite subLayers failed.");
   }
 
@@ -528,6 +1190,10 @@ bool CompositeSublayers(AssetResolutionResolver &resolver,
   DCOUT("in_layer # of primspecs: " << in_layer.primspecs().size());
   for (auto &prim : in_layer.primspecs()) {
     DCOUT("in_layer.prim: " << prim.first);
+    if (filter && !filter->prim_names.count(prim.first)) {
+      continue;
+    }
+
     if (composited_layer->has_primspec(prim.first)) {
       // over
       if (prim.second.specifier() == Specifier::Class) {
@@ -560,85 +1226,42 @@ bool CompositeSublayers(AssetResolutionResolver &resolver,
     }
   }
 
-  composited_layer->metas() = in_layer.metas();
-  // Remove subLayers metadatum
-  composited_layer->metas().subLayers.clear();
-
-  DCOUT("Composite subLayers ok.");
   return true;
 }
 
-namespace {
-
-#if 0
-static bool FindPrimSpecRec(const std::string &parent_path, const Path &path,
-                            const PrimSpec &parent,
-                            const PrimSpec **foundPrimSpec, uint32_t depth) {
-  if (depth > 1024 * 1024 * 256) {
-    return false;
-  }
-
-  std::string abs_path;
-  {
-    std::string elementName = parent.name();
-    abs_path = parent_path + "/" + elementName;
-    DCOUT(fmt::format("findPrimSpec: {}, abs_path {}", path.full_path_name(), abs_path));
-    if (abs_path == path.full_path_name()) {
-      (*foundPrimSpec) = &parent;
-      return true;
-    }
-  }
-
-  for (const auto &child : parent.children()) {
-    if (FindPrimSpecRec(abs_path, path, child, foundPrimSpec, depth + 1)) {
-      return true;
-    }
-  }
-
-  return false;
-}
+}  // namespace
 
-// TODO: cache result.
-static bool FindPrimSpecAt(const Path &path, const PrimSpec &rootPS,
-                           const PrimSpec **foundPS, std::string *err) {
-  if (!path.is_valid()) {
-    if (err) {
-      (*err) += "Path is invalid.\n";
-    }
+bool CompositeSublayers(AssetResolutionResolver &resolver,
+                        const Layer &in_layer, Layer *composited_layer,
+                        std::string *warn, std::string *err,
+                        SublayersCompositionOptions options) {
+  if (!composited_layer) {
     return false;
   }
 
-  if (path.is_relative_path()) {
-    if (err) {
-      (*err) += "TODO: Relative path.\n";
-    }
+  if (!CompositeSublayersImpl(resolver, in_layer, composited_layer, warn, err,
+                              options, /* filter */ nullptr)) {
     return false;
   }
 
-  if (!path.is_absolute_path()) {
-    if (err) {
-      (*err) += "Path is not absolute: " + path.full_path_name() + "\n";
-    }
-    return false;
-  }
+  composited_layer->metas() = in_layer.metas();
+  // Remove subLayers metadatum
+  composited_layer->metas().subLayers.clear();
 
-  bool ret = FindPrimSpecRec("", path, rootPS, foundPS, 0);
+  DCOUT("Composite subLayers ok.");
+  return true;
+}
 
-  if (!ret) {
-    if (err) {
-      (*err) += "Prim path " + path.full_path_name() +
-                " not found in given PrimSpec tree.\n";
-    }
-  }
+namespace {
 
-  return ret;
-}
-#endif
 
 
+//
+// `prim_path` : Absolute path of `primspec`. Used for recording dependencies.
+//
 bool CompositeReferencesRec(uint32_t depth, AssetResolutionResolver &resolver,
                             const std::vector<std::string> &asset_search_paths,
-                            const Layer &in_layer,
+                            const Layer &in_layer, const std::string &prim_path,
                             PrimSpec &primspec /* [inout] */, std::string *warn,
                             std::string *err,
                             const ReferencesCompositionOptions &options) {
@@ -648,7 +1271,13 @@ bool CompositeReferencesRec(uint32_t depth, AssetResolutionResolver &resolver,
 
   // Traverse children first.
   for (auto &child : primspec.children()) {
-    if (!CompositeReferencesRec(depth + 1, resolver, asset_search_paths, in_layer, child,
+    std::string child_path;
+    if (options.dependency_graph) {
+      child_path = prim_path + "/" + child.name();
+    }
+
+    if (!CompositeReferencesRec(depth + 1, resolver, asset_search_paths, in_layer,
+                                     child_path, child,
                                 warn, err, options)) {
       return false;
     }
@@ -665,8 +1294,9 @@ bool CompositeReferencesRec(uint32_t depth, AssetResolutionResolver &resolver,
     if ((qual == ListEditQual::ResetToExplicit) ||
         (qual == ListEditQual::Prepend)) {
       for (const auto &reference : refecences) {
-        Layer layer;
+        std::shared_ptr<Layer> layer;
         const PrimSpec *src_ps{nullptr};
+        std::string resolved_path;
 
         if (reference.asset_path.GetAssetPath().empty()) {
           if (reference.prim_path.is_absolute_path()) {
@@ -687,17 +1317,24 @@ bool CompositeReferencesRec(uint32_t depth, AssetResolutionResolver &resolver,
           DCOUT("reference.prim_path = " << reference.prim_path);
           DCOUT("primspec.cwp = " << cwp);
           DCOUT("primspec.search_paths = " << search_paths);
-          if (!LoadAsset(resolver, cwp, search_paths, options.fileformats,
+          if (!LoadAsset(resolver, options.layer_cache, cwp, search_paths,
+                         options.fileformats,
                          reference.asset_path, reference.prim_path, &layer,
                          &src_ps, /* error_when_no_prims_found */ true,
                          options.error_when_asset_not_found,
-                         options.error_when_unsupported_fileformat, warn, err)) {
+                         options.error_when_unsupported_fileformat, warn, err,
+                         &resolved_path)) {
             PUSH_ERROR_AND_RETURN(
                 fmt::format("Failed to `references` asset `{}`",
                             reference.asset_path.GetAssetPath()));
           }
         }
 
+        if (options.dependency_graph && !resolved_path.empty()) {
+          options.dependency_graph->add(resolved_path, Path(prim_path, ""),
+                                        LoadState::Reference);
+        }
+
         if (!src_ps) {
           // LoadAsset allowed not-found or unsupported file. so do nothing.
           continue;
@@ -731,8 +1368,9 @@ bool CompositeReferencesRec(uint32_t depth, AssetResolutionResolver &resolver,
       PUSH_ERROR_AND_RETURN("Invalid listedit qualifier to for `references`.");
     } else if (qual == ListEditQual::Append) {
       for (const auto &reference : refecences) {
-        Layer layer;
+        std::shared_ptr<Layer> layer;
         const PrimSpec *src_ps{nullptr};
+        std::string resolved_path;
 
         if (reference.asset_path.GetAssetPath().empty()) {
           if (reference.prim_path.is_absolute_path()) {
@@ -749,17 +1387,24 @@ bool CompositeReferencesRec(uint32_t depth, AssetResolutionResolver &resolver,
                             reference.prim_path.full_path_name()));
           }
         } else {
-          if (!LoadAsset(resolver, cwp, search_paths, options.fileformats,
+          if (!LoadAsset(resolver, options.layer_cache, cwp, search_paths,
+                         options.fileformats,
                          reference.asset_path, reference.prim_path, &layer,
                          &src_ps, /* error_when_no_prims */ true,
                          options.error_when_asset_not_found,
-                         options.error_when_unsupported_fileformat, warn, err)) {
+                         options.error_when_unsupported_fileformat, warn, err,
+                         &resolved_path)) {
             PUSH_ERROR_AND_RETURN(
                 fmt::format("Failed to `references` asset `{}`",
                             reference.asset_path.GetAssetPath()));
           }
         }
 
+        if (options.dependency_graph && !resolved_path.empty()) {
+          options.dependency_graph->add(resolved_path, Path(prim_path, ""),
+                                        LoadState::Reference);
+        }
+
         if (!src_ps) {
           // LoadAsset allowed not-found or unsupported file. so do nothing.
           continue;
@@ -790,9 +1435,12 @@ bool CompositeReferencesRec(uint32_t depth, AssetResolutionResolver &resolver,
   return true;
 }
 
+//
+// `prim_path` : Absolute path of `primspec`. Used for recording dependencies.
+//
 bool CompositePayloadRec(uint32_t depth, AssetResolutionResolver &resolver,
                          const std::vector<std::string> &asset_search_paths,
-                         const Layer &in_layer,
+                         const Layer &in_layer, const std::string &prim_path,
                          PrimSpec &primspec /* [inout] */, std::string *warn,
                          std::string *err,
                          const PayloadCompositionOptions &options) {
@@ -802,7 +1450,13 @@ bool CompositePayloadRec(uint32_t depth, AssetResolutionResolver &resolver,
 
   // Traverse children first.
   for (auto &child : primspec.children()) {
-    if (!CompositePayloadRec(depth + 1, resolver, asset_search_paths, in_layer, child,
+    std::string child_path;
+    if (options.dependency_graph) {
+      child_path = prim_path + "/" + child.name();
+    }
+
+    if (!CompositePayloadRec(depth + 1, resolver, asset_search_paths, in_layer,
+                                  child_path, child,
                              warn, err, options)) {
       return false;
     }
@@ -822,8 +1476,9 @@ bool CompositePayloadRec(uint32_t depth, AssetResolutionResolver &resolver,
         std::string asset_path = pl.asset_path.GetAssetPath();
         DCOUT("asset_path = " << asset_path);
 
-        Layer layer;
+        std::shared_ptr<Layer> layer;
         const PrimSpec *src_ps{nullptr};
+        std::string resolved_path;
 
         if (pl.asset_path.GetAssetPath().empty()) {
           if (pl.prim_path.is_absolute_path()) {
@@ -840,16 +1495,23 @@ bool CompositePayloadRec(uint32_t depth, AssetResolutionResolver &resolver,
           }
         } else {
 
-          if (!LoadAsset(resolver, cwp, search_paths, options.fileformats,
+          if (!LoadAsset(resolver, options.layer_cache, cwp, search_paths,
+                         options.fileformats,
                          pl.asset_path, pl.prim_path, &layer, &src_ps,
                          /* error_when_no_prims_found */ true,
                          options.error_when_asset_not_found,
-                         options.error_when_unsupported_fileformat, warn, err)) {
+                         options.error_when_unsupported_fileformat, warn, err,
+                         &resolved_path)) {
             PUSH_ERROR_AND_RETURN(fmt::format("Failed to `references` asset `{}`",
                                               pl.asset_path.GetAssetPath()));
           }
         }
 
+        if (options.dependency_graph && !resolved_path.empty()) {
+          options.dependency_graph->add(resolved_path, Path(prim_path, ""),
+                                        LoadState::Payload);
+        }
+
         if (!src_ps) {
           // LoadAsset allowed not-found or unsupported file. so do nothing.
           continue;
@@ -885,8 +1547,9 @@ bool CompositePayloadRec(uint32_t depth, AssetResolutionResolver &resolver,
       for (const auto &pl : payloads) {
         std::string asset_path = pl.asset_path.GetAssetPath();
 
-        Layer layer;
+        std::shared_ptr<Layer> layer;
         const PrimSpec *src_ps{nullptr};
+        std::string resolved_path;
 
         if (pl.asset_path.GetAssetPath().empty()) {
           if (pl.prim_path.is_absolute_path()) {
@@ -903,16 +1566,23 @@ bool CompositePayloadRec(uint32_t depth, AssetResolutionResolver &resolver,
           }
         } else {
 
-          if (!LoadAsset(resolver, cwp, search_paths, options.fileformats,
+          if (!LoadAsset(resolver, options.layer_cache, cwp, search_paths,
+                         options.fileformats,
                          pl.asset_path, pl.prim_path, &layer, &src_ps,
                          /* error_when_no_prims_found */ true,
                          options.error_when_asset_not_found,
-                         options.error_when_unsupported_fileformat, warn, err)) {
+                         options.error_when_unsupported_fileformat, warn, err,
+                         &resolved_path)) {
             PUSH_ERROR_AND_RETURN(fmt::format("Failed to `references` asset `{}`",
                                               pl.asset_path.GetAssetPath()));
           }
         }
 
+        if (options.dependency_graph && !resolved_path.empty()) {
+          options.dependency_graph->add(resolved_path, Path(prim_path, ""),
+                                        LoadState::Payload);
+        }
+
         if (!src_ps) {
           // LoadAsset allowed not-found or unsupported file. so do nothing.
           continue;
@@ -970,6 +1640,7 @@ bool CompositeVariantRec(uint32_t depth, PrimSpec &primspec /* [inout] */,
 }
 
 bool CompositeInheritsRec(uint32_t depth, const Layer &layer,
+                          const std::string &prim_path,
                           PrimSpec &primspec /* [inout] */, std::string *warn,
                           std::string *err) {
   if (depth > (1024 * 1024)) {
@@ -978,7 +1649,8 @@ bool CompositeInheritsRec(uint32_t depth, const Layer &layer,
 
   // Traverse children first.
   for (auto &child : primspec.children()) {
-    if (!CompositeInheritsRec(depth + 1, layer, child, warn, err)) {
+    if (!CompositeInheritsRec(depth + 1, layer, prim_path + "/" + child.name(),
+                              child, warn, err)) {
       return false;
     }
   }
@@ -1018,7 +1690,15 @@ bool CompositeInheritsRec(uint32_t depth, const Layer &layer,
     (void)qual;
 
     if (inheritPrimSpec) {
-      if (!InheritPrimSpec(primspec, *inheritPrimSpec, warn, err)) {
+      // PrimSpec tree of `layer` is modified. Update the path index of the
+      // subtree.
+      layer.remove_primspec_index(prim_path, primspec);
+
+      bool ret = InheritPrimSpec(primspec, *inheritPrimSpec, warn, err);
+
+      layer.add_primspec_index(prim_path, primspec);
+
+      if (!ret) {
         return false;
       }
 
@@ -1038,6 +1718,75 @@ bool CompositeInheritsRec(uint32_t depth, const Layer &layer,
   return true;
 }
 
+bool CompositeSpecializesRec(uint32_t depth, const Layer &layer,
+                             const std::string &prim_path,
+                             PrimSpec &primspec /* [inout] */,
+                             std::string *warn, std::string *err) {
+  if (depth > (1024 * 1024)) {
+    PUSH_ERROR_AND_RETURN("Too deep.");
+  }
+
+  // Traverse children first.
+  for (auto &child : primspec.children()) {
+    if (!CompositeSpecializesRec(depth + 1, layer,
+                                 prim_path + "/" + child.name(), child, warn,
+                                 err)) {
+      return false;
+    }
+  }
+
+  if (primspec.metas().specializes) {
+    const auto &qual = primspec.metas().specializes.value().first;
+    const auto &specializes = primspec.metas().specializes.value().second;
+
+    if (specializes.size() == 0) {
+      // no-op, just remove `specializes` metadataum.
+      primspec.metas().specializes.reset();
+      return true;
+    }
+
+    if (specializes.size() != 1) {
+      PUSH_ERROR_AND_RETURN("Multiple `specializes` is not supporetd.");
+    }
+
+    const Path &specializePath = specializes[0];
+
+    const PrimSpec *specializePrimSpec{nullptr};
+
+    if (!layer.find_primspec_at(specializePath, &specializePrimSpec, err) ||
+        !specializePrimSpec) {
+      PUSH_ERROR_AND_RETURN(
+          "Specialize primspec failed since Path <" +
+          specializePath.prim_part() + "> not found or is invalid.");
+    }
+
+    // TODO: listEdit
+    DCOUT("TODO: listEdit in `specializes`");
+    (void)qual;
+
+    // TODO: `specializes` is weaker than any other arcs(including remote
+    // opinions). For now treat it like `inherits`: opinions in `primspec` are
+    // stronger than the specialized PrimSpec.
+
+    // PrimSpec tree of `layer` is modified. Update the path index of the
+    // subtree.
+    layer.remove_primspec_index(prim_path, primspec);
+
+    bool ret = InheritPrimSpec(primspec, *specializePrimSpec, warn, err);
+
+    layer.add_primspec_index(prim_path, primspec);
+
+    if (!ret) {
+      return false;
+    }
+
+    // remove `specializes` metadataum.
+    primspec.metas().specializes.reset();
+  }
+
+  return true;
+}
+
 }  // namespace
 
 bool CompositeReferences(AssetResolutionResolver &resolver,
@@ -1050,11 +1799,25 @@ bool CompositeReferences(AssetResolutionResolver &resolver,
 
   std::vector<std::string> search_paths = in_layer.get_asset_search_paths();
 
+  // Load the asset referenced from multiple PrimSpecs only once.
+  LayerCache local_layer_cache;
+  if (!options.layer_cache) {
+    options.layer_cache = &local_layer_cache;
+  }
+
+  if (options.num_threads != 1) {
+    PrefetchAssets(resolver, options.layer_cache, in_layer,
+                   /* references */ true, /* payload */ false,
+                   options.max_depth, options.fileformats, options.num_threads,
+                   warn);
+  }
+
   Layer dst = in_layer;  // deep copy
 
   for (auto &item : dst.primspecs()) {
     if (!CompositeReferencesRec(/* depth */ 0, resolver, search_paths, in_layer,
-                                item.second, warn, err, options)) {
+                                "/" + item.first, item.second, warn, err,
+                                options)) {
       PUSH_ERROR_AND_RETURN("Composite `references` failed.");
     }
   }
@@ -1072,12 +1835,26 @@ bool CompositePayload(AssetResolutionResolver &resolver, const Layer &in_layer,
     return false;
   }
 
+  // Load the asset referenced from multiple PrimSpecs only once.
+  LayerCache local_layer_cache;
+  if (!options.layer_cache) {
+    options.layer_cache = &local_layer_cache;
+  }
+
+  if (options.num_threads != 1) {
+    PrefetchAssets(resolver, options.layer_cache, in_layer,
+                   /* references */ false, /* payload */ true,
+                   options.max_depth, options.fileformats, options.num_threads,
+                   warn);
+  }
+
   Layer dst = in_layer;  // deep copy
 
   for (auto &item : dst.primspecs()) {
     if (!CompositePayloadRec(/* depth */ 0, resolver,
-                             item.second.get_asset_search_paths(), in_layer, item.second,
-                             warn, err, options)) {
+                             item.second.get_asset_search_paths(), in_layer,
+                             "/" + item.first, item.second, warn, err,
+                             options)) {
       PUSH_ERROR_AND_RETURN("Composite `payload` failed.");
     }
   }
@@ -1108,6 +1885,27 @@ bool CompositeVariant(const Layer &in_layer, Layer *composited_layer,
   return true;
 }
 
+bool CompositeSpecializes(const Layer &in_layer, Layer *composited_layer,
+                          std::string *warn, std::string *err) {
+  if (!composited_layer) {
+    return false;
+  }
+
+  Layer dst = in_layer;  // deep copy
+
+  for (auto &item : dst.primspecs()) {
+    if (!CompositeSpecializesRec(/* depth */ 0, dst, "/" + item.first,
+                                 item.second, warn, err)) {
+      PUSH_ERROR_AND_RETURN("Composite `specializes` failed.");
+    }
+  }
+
+  (*composited_layer) = dst;
+
+  DCOUT("Composite `specializes` ok.");
+  return true;
+}
+
 bool CompositeInherits(const Layer &in_layer, Layer *composited_layer,
                        std::string *warn, std::string *err) {
   if (!composited_layer) {
@@ -1117,7 +1915,8 @@ bool CompositeInherits(const Layer &in_layer, Layer *composited_layer,
   Layer dst = in_layer;  // deep copy
 
   for (auto &item : dst.primspecs()) {
-    if (!CompositeInheritsRec(/* depth */ 0, dst, item.second, warn, err)) {
+    if (!CompositeInheritsRec(/* depth */ 0, dst, "/" + item.first,
+                              item.second, warn, err)) {
       PUSH_ERROR_AND_RETURN("Composite `inherits` failed.");
     }
   }
@@ -1130,8 +1929,17 @@ bool CompositeInherits(const Layer &in_layer, Layer *composited_layer,
 
 namespace detail {
 
+//
+// `metas` is moved to the reconstructed Prim. Pass a copy of
+// `primspec.metas()` to keep `primspec` as is.
+//
+// `typeless_as_model` : Reconstruct typeless PrimSpec(e.g. `def "bora"`) as
+// Model(as done in USDA/USDC readers). Typeless PrimSpec is not reconstructed
+// when false.
+//
 static nonstd::optional<Prim> ReconstructPrimFromPrimSpec(
-    const PrimSpec &primspec, std::string *warn, std::string *err) {
+    const PrimSpec &primspec, PrimMeta &&metas, const bool typeless_as_model,
+    std::string *warn, std::string *err) {
   (void)warn;
 
   // TODO:
@@ -1147,20 +1955,21 @@ static nonstd::optional<Prim> ReconstructPrimFromPrimSpec(
                  << " elementName: " << primspec.name());                \
       return nonstd::nullopt;                                            \
     }                                                                    \
-    typed_prim.meta = primspec.metas();                                  \
+    typed_prim.meta = std::move(metas);                                  \
     typed_prim.name = primspec.name();                                   \
     typed_prim.spec = primspec.specifier();                              \
     /*typed_prim.propertyNames() = properties; */                        \
     /*typed_prim.primChildrenNames() = primChildren;*/                   \
-    value::Value primdata = typed_prim;                                  \
-    Prim prim(primspec.name(), primdata);                                \
+    value::Value primdata(std::move(typed_prim));                        \
+    Prim prim(primspec.name(), std::move(primdata));                     \
     prim.prim_type_name() = primspec.typeName();                         \
     /* also add primChildren to Prim */                                  \
     /* prim.metas().primChildren = primChildren; */                      \
     return std::move(prim);                                              \
   } else
 
-  if (primspec.typeName() == "Model") {
+  if ((typeless_as_model && primspec.typeName().empty()) ||
+      primspec.typeName() == "Model") {
     // Code is mostly identical to RECONSTRUCT_PRIM.
     // Difference is store primTypeName to Model class itself.
     Model typed_prim;
@@ -1168,14 +1977,14 @@ static nonstd::optional<Prim> ReconstructPrimFromPrimSpec(
       PUSH_ERROR("Failed to reconstruct Model");
       return nonstd::nullopt;
     }
-    typed_prim.meta = primspec.metas();
+    typed_prim.meta = std::move(metas);
     typed_prim.name = primspec.name();
     typed_prim.prim_type_name = primspec.typeName();
     typed_prim.spec = primspec.specifier();
     // typed_prim.propertyNames() = properties;
     // typed_prim.primChildrenNames() = primChildren;
-    value::Value primdata = typed_prim;
-    Prim prim(primspec.name(), primdata);
+    value::Value primdata(std::move(typed_prim));
+    Prim prim(primspec.name(), std::move(primdata));
     prim.prim_type_name() = primspec.typeName();
     /* also add primChildren to Prim */
     // prim.metas().primChildren = primChildren;
@@ -1314,6 +2123,399 @@ static bool InheritPrimSpecImpl(PrimSpec &dst, const PrimSpec &src,
 
 }  // namespace detail
 
+namespace {
+
+//
+// Reconstruct Prim tree from PrimSpec tree(for building Stage from Layer).
+// PrimSpec of unsupported Prim type is skipped(with its descendants).
+// Typeless PrimSpec is reconstructed as Model to get the same Prim tree as
+// USDA/USDC readers.
+//
+bool ReconstructPrimTreeFromPrimSpec(uint32_t depth, const PrimSpec &primspec,
+                                     nonstd::optional<Prim> *dst,
+                                     std::string *warn, std::string *err) {
+  if (depth > (1024 * 1024)) {
+    PUSH_ERROR_AND_RETURN("PrimSpec tree too deep.");
+  }
+
+  std::string local_err;
+  (*dst) = detail::ReconstructPrimFromPrimSpec(
+      primspec, PrimMeta(primspec.metas()), /* typeless_as_model */ true, warn,
+      &local_err);
+  if (!(*dst)) {
+    if (!local_err.empty()) {
+      PUSH_ERROR_AND_RETURN(local_err);
+    }
+    // unsupported Prim type.
+    return true;
+  }
+
+  Prim &prim = dst->value();
+  prim.specifier() = primspec.specifier();
+
+  for (const auto &child : primspec.children()) {
+    nonstd::optional<Prim> child_prim;
+    if (!ReconstructPrimTreeFromPrimSpec(depth + 1, child, &child_prim, warn,
+                                         err)) {
+      return false;
+    }
+
+    if (child_prim) {
+      std::string add_err;
+      if (!prim.add_child(std::move(child_prim.value()),
+                          /* rename_element_name */ false, &add_err)) {
+        PUSH_ERROR_AND_RETURN(add_err);
+      }
+    }
+  }
+
+  return true;
+}
+
+//
+// Move version. PrimSpec data(metadatum, properties and children) is released
+// as soon as the corresponding Prim is reconstructed, so at most the
+// properties of one PrimSpec are duplicated during the conversion.
+//
+bool ReconstructPrimTreeFromPrimSpec(uint32_t depth, PrimSpec &&primspec,
+                                     nonstd::optional<Prim> *dst,
+                                     std::string *warn, std::string *err) {
+  if (depth > (1024 * 1024)) {
+    PUSH_ERROR_AND_RETURN("PrimSpec tree too deep.");
+  }
+
+  std::string local_err;
+  // NOTE: prim::ReconstructPrim reads properties through const reference, so
+  // attribute values are copied to the typed Prim here.
+  (*dst) = detail::ReconstructPrimFromPrimSpec(
+      primspec, std::move(primspec.metas()), /* typeless_as_model */ true,
+      warn, &local_err);
+
+  // Release properties.
+  primspec.props().clear();
+
+  if (!(*dst)) {
+    if (!local_err.empty()) {
+      PUSH_ERROR_AND_RETURN(local_err);
+    }
+    // unsupported Prim type.
+    return true;
+  }
+
+  Prim &prim = dst->value();
+  prim.specifier() = primspec.specifier();
+
+  std::vector<PrimSpec> children = std::move(primspec.children());
+  primspec.children().clear();
+
+  for (auto &child : children) {
+    nonstd::optional<Prim> child_prim;
+    if (!ReconstructPrimTreeFromPrimSpec(depth + 1, std::move(child),
+                                         &child_prim, warn, err)) {
+      return false;
+    }
+
+    if (child_prim) {
+      std::string add_err;
+      if (!prim.add_child(std::move(child_prim.value()),
+                          /* rename_element_name */ false, &add_err)) {
+        PUSH_ERROR_AND_RETURN(add_err);
+      }
+    }
+
+    // Release child PrimSpec.
+    child = PrimSpec();
+  }
+
+  return true;
+}
+
+//
+// Root PrimSpec names in `primChildren` order(remaining PrimSpecs are sorted
+// by name for deterministic Prim order).
+//
+std::vector<std::string> GetRootPrimSpecNames(const Layer &layer) {
+  std::vector<std::string> names;
+  std::set<std::string> visited;
+
+  for (const auto &tok : layer.metas().primChildren) {
+    if (layer.has_primspec(tok.str()) && !visited.count(tok.str())) {
+      names.push_back(tok.str());
+      visited.insert(tok.str());
+    }
+  }
+
+  std::vector<std::string> others;
+  for (const auto &item : layer.primspecs()) {
+    if (!visited.count(item.first)) {
+      others.push_back(item.first);
+    }
+  }
+  std::sort(others.begin(), others.end());
+
+  names.insert(names.end(), others.begin(), others.end());
+
+  return names;
+}
+
+std::vector<std::string> SplitPrimPath(const std::string &prim_path) {
+  return split(prim_path, "/");
+}
+
+//
+// Get mutable PrimSpec at `prim_path`(prim_part). nullptr when not found.
+//
+PrimSpec *GetPrimSpecAtPath(Layer &layer, const std::string &prim_path) {
+  // Lookup through const Layer to use(and keep) the PrimSpec path index.
+  const Layer &clayer = layer;
+  const PrimSpec *ps{nullptr};
+  if (!clayer.find_primspec_at(Path(prim_path, ""), &ps, nullptr)) {
+    return nullptr;
+  }
+
+  // PrimSpec is owned by the non-const `layer`.
+  return const_cast<PrimSpec *>(ps);
+}
+
+//
+// Replace(or add) PrimSpec at `prim_path` with `ps`. Remove PrimSpec at
+// `prim_path` when `ps` is nullptr.
+//
+// PrimSpec path index of the Layer is updated incrementally.
+//
+bool SetPrimSpecAtPath(Layer &layer, const std::string &prim_path,
+                       PrimSpec *ps, std::string *err) {
+  std::vector<std::string> elems = SplitPrimPath(prim_path);
+  if (elems.empty()) {
+    PUSH_ERROR_AND_RETURN(fmt::format("Invalid Prim path: {}", prim_path));
+  }
+
+  if (elems.size() == 1) {
+    if (ps) {
+      bool ret = layer.has_primspec(elems[0])
+                     ? layer.replace_primspec(elems[0], std::move(*ps))
+                     : layer.emplace_primspec(elems[0], std::move(*ps));
+      if (!ret) {
+        PUSH_ERROR_AND_RETURN(
+            fmt::format("Failed to set PrimSpec `{}`", prim_path));
+      }
+    } else {
+      layer.remove_primspec(elems[0]);
+    }
+    return true;
+  }
+
+  std::string parent_path = prim_path.substr(0, prim_path.find_last_of('/'));
+  PrimSpec *parent = GetPrimSpecAtPath(layer, parent_path);
+  if (!parent) {
+    if (!ps) {
+      // Already removed.
+      return true;
+    }
+    PUSH_ERROR_AND_RETURN(
+        fmt::format("Parent PrimSpec not found for `{}`", prim_path));
+  }
+
+  auto &children = parent->children();
+  auto it = std::find_if(
+      children.begin(), children.end(),
+      [&](const PrimSpec &child) { return child.name() == elems.back(); });
+
+  if (ps && (it != children.end())) {
+    // Sibling PrimSpecs are not moved.
+    layer.remove_primspec_index(prim_path, *it);
+    (*it) = std::move(*ps);
+    layer.add_primspec_index(prim_path, *it);
+    return true;
+  }
+
+  // Sibling PrimSpecs may be moved by adding/removing a child.
+  layer.remove_primspec_index(parent_path, *parent);
+
+  if (ps) {
+    children.emplace_back(std::move(*ps));
+  } else if (it != children.end()) {
+    children.erase(it);
+  }
+
+  layer.add_primspec_index(parent_path, *parent);
+
+  return true;
+}
+
+bool HasArcRec(uint32_t depth, const PrimSpec &primspec, const LoadState arc) {
+  if (depth > (1024 * 1024)) {
+    return false;
+  }
+
+  if ((arc == LoadState::Reference) && primspec.metas().references) {
+    return true;
+  }
+
+  if ((arc == LoadState::Payload) && primspec.metas().payload) {
+    return true;
+  }
+
+  for (const auto &child : primspec.children()) {
+    if (HasArcRec(depth + 1, child, arc)) {
+      return true;
+    }
+  }
+
+  return false;
+}
+
+//
+// Find topmost PrimSpec paths to be recomposed for `arc`.
+//
+// PrimSpec is recomposed from its outermost ancestor(inclusive) which has
+// `arc`, since opinions of the ancestor's arc are merged into descendants.
+//
+std::vector<std::string> GetRecompositionRoots(
+    const CompositionDependencyGraph &graph, const LoadState arc,
+    const std::vector<std::string> &modified_asset_paths,
+    const std::vector<Path> &prim_paths) {
+  const uint32_t arcs = static_cast<uint32_t>(arc);
+
+  std::set<std::string> targets;
+  for (const auto &asset_path : modified_asset_paths) {
+    for (const auto &path : graph.get_dependent_prim_paths(asset_path, arcs)) {
+      targets.insert(path.prim_part());
+    }
+  }
+
+  for (const auto &path : prim_paths) {
+    targets.insert(path.prim_part());
+  }
+
+  std::set<std::string> roots;
+  for (const auto &target : targets) {
+    std::string root = target;
+    std::string path;
+    for (const auto &elem : SplitPrimPath(target)) {
+      path += "/" + elem;
+      if (graph.has_arc(Path(path, ""), arcs)) {
+        root = path;
+        break;
+      }
+    }
+    roots.insert(root);
+  }
+
+  // Remove descendants of other roots.
+  std::vector<std::string> result;
+  for (const auto &root : roots) {
+    bool has_ancestor{false};
+    size_t pos = root.find_last_of('/');
+    while ((pos != std::string::npos) && (pos > 0)) {
+      if (roots.count(root.substr(0, pos))) {
+        has_ancestor = true;
+        break;
+      }
+      pos = root.find_last_of('/', pos - 1);
+    }
+
+    if (!has_ancestor) {
+      result.push_back(root);
+    }
+  }
+
+  return result;
+}
+
+//
+// Recompose PrimSpec subtrees for `references` or `payload`.
+//
+// `compose_fun(in_layer, prim_path, primspec)` composites one level of the
+// arc to `primspec`.
+//
+template <typename Options, typename ComposeFun>
+bool RecompositeArcs(const Layer &in_layer, const LoadState arc,
+                     const std::vector<std::string> &modified_asset_paths,
+                     Layer *composited_layer, std::vector<Path> *prim_paths,
+                     std::string *err, const Options &options,
+                     ComposeFun compose_fun) {
+  if (!composited_layer || !prim_paths) {
+    PUSH_ERROR_AND_RETURN("`composited_layer` or `prim_paths` is nullptr.");
+  }
+
+  if (!options.dependency_graph) {
+    PUSH_ERROR_AND_RETURN(
+        "`dependency_graph` must be set to the options for re-composition.");
+  }
+
+  CompositionDependencyGraph &graph = *options.dependency_graph;
+
+  std::vector<std::string> roots = GetRecompositionRoots(
+      graph, arc, modified_asset_paths, (*prim_paths));
+
+  prim_paths->clear();
+
+  for (const auto &root : roots) {
+    DCOUT("Recomposite PrimSpec: " << root);
+    Path root_path(root, "");
+
+    // Dependencies are re-recorded during the composition.
+    graph.remove_prim_subtree(root_path, static_cast<uint32_t>(arc));
+
+    const PrimSpec *src_ps{nullptr};
+    std::string local_err;
+    if (!in_layer.find_primspec_at(root_path, &src_ps, &local_err) ||
+        !src_ps) {
+      // PrimSpec was removed.
+      if (!SetPrimSpecAtPath(*composited_layer, root, nullptr, err)) {
+        return false;
+      }
+      prim_paths->push_back(root_path);
+      continue;
+    }
+
+    PrimSpec ps = (*src_ps);  // copy
+
+    if (!compose_fun(in_layer, root, ps)) {
+      return false;
+    }
+
+    // Compose nested arcs brought by the assets.
+    uint32_t iter = 0;
+    while (HasArcRec(0, ps, arc)) {
+      if (iter > options.max_depth) {
+        PUSH_ERROR_AND_RETURN(
+            fmt::format("Arcs nested too deeply in `{}`", root));
+      }
+
+      if (!compose_fun(*composited_layer, root, ps)) {
+        return false;
+      }
+      iter++;
+    }
+
+    if (!SetPrimSpecAtPath(*composited_layer, root, &ps, err)) {
+      return false;
+    }
+
+    prim_paths->push_back(root_path);
+  }
+
+  return true;
+}
+
+void ReleasePrimIdRec(uint32_t depth, const Stage &stage, const Prim &prim) {
+  if (depth > (1024 * 1024)) {
+    return;
+  }
+
+  if (prim.prim_id() > 0) {
+    stage.release_prim_id(uint64_t(prim.prim_id()));
+  }
+
+  for (const auto &child : prim.children()) {
+    ReleasePrimIdRec(depth + 1, stage, child);
+  }
+}
+
+}  // namespace
+
 bool LayerToStage(const Layer &layer, Stage *stage_out, std::string *warn,
                   std::string *err) {
   if (!stage_out) {
@@ -1327,16 +2529,269 @@ bool LayerToStage(const Layer &layer, Stage *stage_out, std::string *warn,
 
   stage.metas() = layer.metas();
 
-  // TODO: primChildren metadatum
-  for (const auto &primspec : layer.primspecs()) {
-    if (auto pv =
-            detail::ReconstructPrimFromPrimSpec(primspec.second, warn, err)) {
-      // TODO
-      (void)pv;
+  for (const auto &name : GetRootPrimSpecNames(layer)) {
+    nonstd::optional<Prim> prim;
+    if (!ReconstructPrimTreeFromPrimSpec(0, layer.primspecs().at(name), &prim,
+                                         warn, err)) {
+      return false;
+    }
+
+    if (prim) {
+      if (!stage.add_root_prim(std::move(prim.value()),
+                               /* rename_prim_name */ false)) {
+        PUSH_ERROR_AND_RETURN(stage.get_error());
+      }
+    }
+  }
+
+  if (!stage.commit()) {
+    PUSH_ERROR_AND_RETURN(stage.get_error());
+  }
+
+  (*stage_out) = std::move(stage);
+
+  return true;
+}
+
+bool LayerToStage(Layer &&layer, Stage *stage_out, std::string *warn,
+                  std::string *err) {
+  if (!stage_out) {
+    if (err) {
+      (*err) += "`stage_ptr` is nullptr.";
+    }
+    return false;
+  }
+
+  Stage stage;
+
+  std::vector<std::string> root_names = GetRootPrimSpecNames(layer);
+
+  stage.metas() = std::move(layer.metas());
+
+  for (const auto &name : root_names) {
+    auto it = layer.primspecs().find(name);
+
+    PrimSpec primspec = std::move(it->second);
+    // Release root PrimSpec entry.
+    layer.primspecs().erase(it);
+
+    nonstd::optional<Prim> prim;
+    if (!ReconstructPrimTreeFromPrimSpec(0, std::move(primspec), &prim, warn,
+                                         err)) {
+      return false;
+    }
+
+    if (prim) {
+      if (!stage.add_root_prim(std::move(prim.value()),
+                               /* rename_prim_name */ false)) {
+        PUSH_ERROR_AND_RETURN(stage.get_error());
+      }
+    }
+  }
+
+  layer.clear_primspecs();
+
+  if (!stage.commit()) {
+    PUSH_ERROR_AND_RETURN(stage.get_error());
+  }
+
+  (*stage_out) = std::move(stage);
+
+  return true;
+}
+
+bool RecompositeSublayers(AssetResolutionResolver &resolver,
+                          const Layer &in_layer,
+                          const std::vector<std::string> &modified_asset_paths,
+                          Layer *composited_layer,
+                          std::vector<Path> *prim_paths, std::string *warn,
+                          std::string *err,
+                          SublayersCompositionOptions options) {
+  if (!composited_layer || !prim_paths) {
+    PUSH_ERROR_AND_RETURN("`composited_layer` or `prim_paths` is nullptr.");
+  }
+
+  if (!options.dependency_graph) {
+    PUSH_ERROR_AND_RETURN(
+        "`dependency_graph` must be set to the options for re-composition.");
+  }
+
+  CompositionDependencyGraph &graph = *options.dependency_graph;
+  const uint32_t arcs = static_cast<uint32_t>(LoadState::Sublayer);
+
+  SublayerPrimFilter filter;
+  for (const auto &asset_path : modified_asset_paths) {
+    filter.modified_asset_paths.insert(asset_path);
+    for (const auto &path : graph.get_dependent_prim_paths(asset_path, arcs)) {
+      // Dependencies of subLayers are recorded to root PrimSpecs.
+      std::vector<std::string> elems = SplitPrimPath(path.prim_part());
+      if (!elems.empty()) {
+        filter.prim_names.insert(elems[0]);
+      }
     }
   }
 
-  (*stage_out) = stage;
+  std::set<std::string> prim_names;
+  Layer layer;
+
+  // 2nd iteration composites PrimSpecs newly added to modified subLayers.
+  for (uint32_t iter = 0; iter < 2; iter++) {
+    if (filter.prim_names.empty()) {
+      break;
+    }
+
+    for (const auto &name : filter.prim_names) {
+      // Dependencies are re-recorded during the composition.
+      graph.remove_prim_subtree(Path("/" + name, ""), arcs);
+    }
+
+    if (!CompositeSublayersImpl(resolver, in_layer, &layer, warn, err, options,
+                                &filter)) {
+      return false;
+    }
+
+    prim_names.insert(filter.prim_names.begin(), filter.prim_names.end());
+
+    filter.prim_names = std::move(filter.new_prim_names);
+    filter.new_prim_names.clear();
+  }
+
+  prim_paths->clear();
+
+  for (const auto &name : prim_names) {
+    if (layer.has_primspec(name)) {
+      composited_layer->primspecs()[name] =
+          std::move(layer.primspecs().at(name));
+    } else {
+      // PrimSpec was removed.
+      composited_layer->primspecs().erase(name);
+    }
+    prim_paths->push_back(Path("/" + name, ""));
+  }
+
+  DCOUT("Recomposite subLayers ok.");
+  return true;
+}
+
+bool RecompositeReferences(AssetResolutionResolver &resolver,
+                           const Layer &in_layer,
+                           const std::vector<std::string> &modified_asset_paths,
+                           Layer *composited_layer,
+                           std::vector<Path> *prim_paths, std::string *warn,
+                           std::string *err,
+                           ReferencesCompositionOptions options) {
+  LayerCache local_layer_cache;
+  if (!options.layer_cache) {
+    options.layer_cache = &local_layer_cache;
+  }
+
+  std::vector<std::string> search_paths = in_layer.get_asset_search_paths();
+
+  auto compose_fun = [&](const Layer &layer, const std::string &prim_path,
+                         PrimSpec &ps) -> bool {
+    return CompositeReferencesRec(/* depth */ 0, resolver, search_paths, layer,
+                                  prim_path, ps, warn, err, options);
+  };
+
+  if (!RecompositeArcs(in_layer, LoadState::Reference, modified_asset_paths,
+                       composited_layer, prim_paths, err, options,
+                       compose_fun)) {
+    PUSH_ERROR_AND_RETURN("Recomposite `references` failed.");
+  }
+
+  DCOUT("Recomposite `references` ok.");
+  return true;
+}
+
+bool RecompositePayload(AssetResolutionResolver &resolver,
+                        const Layer &in_layer,
+                        const std::vector<std::string> &modified_asset_paths,
+                        Layer *composited_layer, std::vector<Path> *prim_paths,
+                        std::string *warn, std::string *err,
+                        PayloadCompositionOptions options) {
+  LayerCache local_layer_cache;
+  if (!options.layer_cache) {
+    options.layer_cache = &local_layer_cache;
+  }
+
+  auto compose_fun = [&](const Layer &layer, const std::string &prim_path,
+                         PrimSpec &ps) -> bool {
+    return CompositePayloadRec(/* depth */ 0, resolver,
+                               ps.get_asset_search_paths(), layer, prim_path,
+                               ps, warn, err, options);
+  };
+
+  if (!RecompositeArcs(in_layer, LoadState::Payload, modified_asset_paths,
+                       composited_layer, prim_paths, err, options,
+                       compose_fun)) {
+    PUSH_ERROR_AND_RETURN("Recomposite `payload` failed.");
+  }
+
+  DCOUT("Recomposite `payload` ok.");
+  return true;
+}
+
+bool UpdateStageFromLayer(const Layer &layer,
+                          const std::vector<Path> &prim_paths, Stage *stage,
+                          std::string *warn, std::string *err) {
+  if (!stage) {
+    PUSH_ERROR_AND_RETURN("`stage` is nullptr.");
+  }
+
+  for (const auto &path : prim_paths) {
+    const std::string &prim_part = path.prim_part();
+    std::vector<std::string> elems = SplitPrimPath(prim_part);
+    if (elems.empty()) {
+      PUSH_ERROR_AND_RETURN(fmt::format("Invalid Prim path: {}", prim_part));
+    }
+
+    if (elems.size() > 1) {
+      const Prim *parent{nullptr};
+      std::string parent_path = prim_part.substr(0, prim_part.find_last_of('/'));
+      if (!stage->find_prim_at_path(Path(parent_path, ""), parent)) {
+        PUSH_WARN(fmt::format(
+            "Parent Prim of `{}` not found in Stage. Skip updating it.",
+            prim_part));
+        continue;
+      }
+    }
+
+    const Prim *prim{nullptr};
+    if (stage->find_prim_at_path(Path(prim_part, ""), prim)) {
+      ReleasePrimIdRec(0, *stage, *prim);
+    } else {
+      prim = nullptr;
+    }
+
+    const PrimSpec *ps{nullptr};
+    std::string local_err;
+    nonstd::optional<Prim> new_prim;
+    if (layer.find_primspec_at(path, &ps, &local_err) && ps) {
+      if (!ReconstructPrimTreeFromPrimSpec(0, *ps, &new_prim, warn, err)) {
+        return false;
+      }
+    }
+
+    // Use Stage API to keep Prim path cache and Prim name bookkeeping of the
+    // Stage consistent.
+    if (new_prim) {
+      if (!stage->replace_prim_at_path(Path(prim_part, ""),
+                                       std::move(new_prim.value()))) {
+        PUSH_ERROR_AND_RETURN(stage->get_error());
+      }
+    } else if (prim) {
+      // Remove Prim.
+      if (!stage->remove_prim_at_path(Path(prim_part, ""))) {
+        PUSH_ERROR_AND_RETURN(stage->get_error());
+      }
+    }
+  }
+
+  // Assign Prim id only to new Prims.
+  if (!stage->compute_absolute_prim_path_and_assign_prim_id(
+          /* force_assign_prim_id */ false)) {
+    PUSH_ERROR_AND_RETURN(stage->get_error());
+  }
 
   return true;
 }
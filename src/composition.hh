@@ -5,6 +5,8 @@
 //
 #pragma once
 
+#include <memory>
+
 #include "asset-resolution.hh"
 #include "prim-types.hh"
 
@@ -30,6 +32,148 @@ enum class LoadState : uint32_t {
   Payload = 1 << 3     // load USD from Prim meta payload
 };
 
+///
+/// LRU cache of Layers loaded through composition arcs(`subLayers`,
+/// `references` and `payload`).
+///
+/// Layer is keyed by the resolved asset path(+ asset resolution state, since
+/// it is recorded to the loaded PrimSpecs for nested composition), and the
+/// cached Layer is discarded when the modification stamp of the asset
+/// changes. Memory usage is bounded by `max_bytes`(approximated by the asset
+/// byte size). Least recently used Layer is evicted first.
+///
+/// Share one LayerCache among CompositeSublayers, CompositeReferences and
+/// CompositePayload(and among composition iterations) so that an asset is
+/// read and parsed only once.
+///
+/// Cached Layer is shared with composition results in progress, so do not
+/// modify Layer obtained from the cache.
+///
+/// LayerCache methods are locked so that worker threads of one composition
+/// (`num_threads` option) can use it. But cached Layers are not locked(e.g.
+/// `Layer::check_unresolved_references()` updates its cached flags), so
+/// LayerCache is not thread-safe when shared between compositions running
+/// concurrently.
+///
+class LayerCache {
+ public:
+  // 1GB by default
+  explicit LayerCache(size_t max_bytes = 1024ull * 1024ull * 1024ull);
+  ~LayerCache();
+
+  LayerCache(const LayerCache &) = delete;
+  LayerCache &operator=(const LayerCache &) = delete;
+
+  ///
+  /// Find cached Layer.
+  ///
+  /// @param[in] key Cache key(resolved asset path)
+  /// @param[in] stamp Modification stamp of the asset.
+  ///
+  /// @return Layer when found and its stamp matches. nullptr otherwise(stale
+  /// Layer is removed from the cache).
+  ///
+  std::shared_ptr<Layer> find(const std::string &key, const uint64_t stamp);
+
+  ///
+  /// Insert Layer to the cache. Existing entry with the same key is replaced.
+  /// Layer is not cached when `nbytes` exceeds `max_bytes`.
+  ///
+  /// @param[in] key Cache key(resolved asset path)
+  /// @param[in] stamp Modification stamp of the asset.
+  /// @param[in] layer Layer.
+  /// @param[in] nbytes Approximated memory usage of the Layer.
+  ///
+  /// @return true when the Layer is stored to the cache.
+  ///
+  bool insert(const std::string &key, const uint64_t stamp,
+              std::shared_ptr<Layer> layer, const size_t nbytes);
+
+  ///
+  /// Remove cached Layer.
+  ///
+  bool erase(const std::string &key);
+
+  void clear();
+
+  ///
+  /// Set the memory budget. Evict Layers if required.
+  ///
+  void set_max_bytes(const size_t max_bytes);
+  size_t max_bytes() const;
+
+  size_t bytes() const;  // approximated memory usage of cached Layers.
+  size_t size() const;   // # of cached Layers
+
+  // Statistics
+  uint64_t num_hits() const;
+  uint64_t num_misses() const;
+
+ private:
+  class Impl;
+  std::unique_ptr<Impl> _impl;
+};
+
+///
+/// Dependency graph of composition arcs for incremental re-composition.
+///
+/// Records which asset(resolved asset path) contributed to which PrimSpec
+/// through which composition arc(`LoadState::Sublayer`, `LoadState::Reference`
+/// or `LoadState::Payload`). PrimSpec path is the path in the composited
+/// Layer, and is the root PrimSpec path for `subLayers`.
+///
+/// Pass the same graph to the composition options(and Recomposite*
+/// functions), then use `get_dependent_prim_paths` to find the PrimSpecs to
+/// be recomposed when an asset is modified.
+///
+class CompositionDependencyGraph {
+ public:
+  ///
+  /// Record that `asset_path` contributes to the PrimSpec at `prim_path`
+  /// through `arc`.
+  ///
+  void add(const std::string &asset_path, const Path &prim_path,
+           const LoadState arc);
+
+  ///
+  /// Return PrimSpec paths which depend on `asset_path` through arcs in
+  /// `arcs`(bitmask of LoadState).
+  ///
+  std::vector<Path> get_dependent_prim_paths(
+      const std::string &asset_path, const uint32_t arcs = ~0u) const;
+
+  ///
+  /// Return true when any asset contributes to the PrimSpec at `prim_path`
+  /// through arcs in `arcs`(bitmask of LoadState).
+  ///
+  bool has_arc(const Path &prim_path, const uint32_t arcs = ~0u) const;
+
+  ///
+  /// Remove dependencies of the PrimSpec at `prim_path` and its descendants
+  /// through arcs in `arcs`(bitmask of LoadState).
+  ///
+  void remove_prim_subtree(const Path &prim_path, const uint32_t arcs = ~0u);
+
+  ///
+  /// Return all asset paths recorded in the graph.
+  ///
+  std::vector<std::string> get_asset_paths() const;
+
+  void clear() {
+    _asset_to_prims.clear();
+    _prim_to_arcs.clear();
+  }
+
+  bool empty() const { return _asset_to_prims.empty(); }
+
+ private:
+  // asset path -> (prim path(prim_part) -> bitmask of LoadState)
+  std::map<std::string, std::map<std::string, uint32_t>> _asset_to_prims;
+
+  // prim path(prim_part) -> (asset path -> bitmask of LoadState)
+  std::map<std::string, std::map<std::string, uint32_t>> _prim_to_arcs;
+};
+
 struct SublayersCompositionOptions {
   // The maximum depth for nested `subLayers`
   uint32_t max_depth = 1024u;
@@ -45,6 +189,13 @@ struct SublayersCompositionOptions {
 
   // File formats
   std::map<std::string, FileFormatHandler> fileformats;
+
+  // Layer cache shared among composition arcs. nullptr = no caching.
+  LayerCache *layer_cache{nullptr};
+
+  // Record dependencies of root PrimSpecs to subLayer assets when not
+  // nullptr. Required for `RecompositeSublayers`.
+  CompositionDependencyGraph *dependency_graph{nullptr};
 };
 
 struct ReferencesCompositionOptions {
@@ -59,6 +210,21 @@ struct ReferencesCompositionOptions {
 
   // File formats
   std::map<std::string, FileFormatHandler> fileformats;
+
+  // Layer cache shared among composition arcs. When nullptr, a temporary
+  // cache is used during a single composition call.
+  LayerCache *layer_cache{nullptr};
+
+  // Record dependencies of PrimSpecs to `references` assets when not nullptr.
+  // Required for `RecompositeReferences`.
+  CompositionDependencyGraph *dependency_graph{nullptr};
+
+  // # of threads for loading assets of `references` concurrently.
+  // 1 = load assets serially. -1 = use system's # of threads.
+  // Assets are loaded in parallel, then applied in the same strength order as
+  // serial composition. AssetResolutionHandler and FileFormatHandler
+  // callbacks must be thread-safe when `num_threads` is not 1.
+  int num_threads{1};
 };
 
 struct PayloadCompositionOptions {
@@ -73,6 +239,21 @@ struct PayloadCompositionOptions {
 
   // File formats
   std::map<std::string, FileFormatHandler> fileformats;
+
+  // Layer cache shared among composition arcs. When nullptr, a temporary
+  // cache is used during a single composition call.
+  LayerCache *layer_cache{nullptr};
+
+  // Record dependencies of PrimSpecs to `payload` assets when not nullptr.
+  // Required for `RecompositePayload`.
+  CompositionDependencyGraph *dependency_graph{nullptr};
+
+  // # of threads for loading assets of `payload` concurrently.
+  // 1 = load assets serially. -1 = use system's # of threads.
+  // Assets are loaded in parallel, then applied in the same strength order as
+  // serial composition. AssetResolutionHandler and FileFormatHandler
+  // callbacks must be thread-safe when `num_threads` is not 1.
+  int num_threads{1};
 };
 
 ///
@@ -215,9 +396,94 @@ bool LayerToStage(const Layer &layer, Stage *stage, std::string *warn,
 ///
 /// `layer` object will be destroyed after `stage` is being build.
 ///
+/// PrimSpec tree is moved to Prims, and each PrimSpec is released as soon as
+/// its Prim is reconstructed. Remaining copies:
+///
+/// - Attribute values are copied from PrimSpec properties to the typed Prim
+///   (`prim::ReconstructPrim` takes properties as const reference), but only
+///   the properties of one PrimSpec are duplicated at a time.
+///
+/// Use `LoadLayerFromFile` + `LayerToStage(std::move(layer), ...)` to keep
+/// peak memory low. USDA/USDC readers move PrimSpecs to the Layer.
+///
 bool LayerToStage(Layer &&layer, Stage *stage, std::string *warn,
                   std::string *err);
 
+///
+/// Incrementally recompose `subLayers` for modified assets.
+///
+/// Only root PrimSpecs which depend on `modified_asset_paths`(according to
+/// `options.dependency_graph`) are recomposed and replaced in
+/// `composited_layer`. Unmodified subLayers are taken from
+/// `options.layer_cache` when available.
+///
+/// @param[in] layer Layer passed to `CompositeSublayers`.
+/// @param[in] modified_asset_paths Resolved paths of modified assets.
+/// @param[inout] composited_layer Layer composited by `CompositeSublayers`.
+/// @param[out] prim_paths Paths of PrimSpecs updated(or removed) in
+/// `composited_layer`.
+///
+/// @return true upon success. false when error(or `dependency_graph` is not
+/// set in `options`).
+///
+bool RecompositeSublayers(
+    AssetResolutionResolver &resolver /* inout */, const Layer &layer,
+    const std::vector<std::string> &modified_asset_paths,
+    Layer *composited_layer, std::vector<Path> *prim_paths, std::string *warn,
+    std::string *err,
+    const SublayersCompositionOptions options = SublayersCompositionOptions());
+
+///
+/// Incrementally recompose `references` for modified assets.
+///
+/// PrimSpec subtrees which depend on `modified_asset_paths` are recomposed
+/// from `layer`(including nested `references`) and replaced in
+/// `composited_layer`.
+///
+/// @param[in] layer Layer passed to `CompositeReferences`.
+/// @param[in] modified_asset_paths Resolved paths of modified assets.
+/// @param[inout] composited_layer Layer composited by `CompositeReferences`
+/// (possibly iterated until no `references` remain).
+/// @param[inout] prim_paths [in] Paths of PrimSpecs modified in `layer`(e.g.
+/// output of `RecompositeSublayers`). [out] Paths of PrimSpecs updated(or
+/// removed) in `composited_layer`.
+///
+bool RecompositeReferences(AssetResolutionResolver &resolver /* inout */,
+                           const Layer &layer,
+                           const std::vector<std::string> &modified_asset_paths,
+                           Layer *composited_layer,
+                           std::vector<Path> *prim_paths /* inout */,
+                           std::string *warn, std::string *err,
+                           const ReferencesCompositionOptions options =
+                               ReferencesCompositionOptions());
+
+///
+/// Incrementally recompose `payload` for modified assets.
+/// See `RecompositeReferences` for details.
+///
+bool RecompositePayload(
+    AssetResolutionResolver &resolver /* inout */, const Layer &layer,
+    const std::vector<std::string> &modified_asset_paths,
+    Layer *composited_layer, std::vector<Path> *prim_paths /* inout */,
+    std::string *warn, std::string *err,
+    const PayloadCompositionOptions options = PayloadCompositionOptions());
+
+///
+/// Update Prims at `prim_paths` in `stage` with PrimSpecs in `layer`.
+///
+/// Prim is replaced by `Stage::replace_root_prim` or `Prim::replace_child`,
+/// and removed when the PrimSpec does not exist in `layer`. Prim ids of other
+/// Prims are preserved.
+///
+/// @param[in] layer Composited Layer.
+/// @param[in] prim_paths Paths of updated PrimSpecs(e.g. output of
+/// `RecompositeReferences`).
+/// @param[inout] stage Stage built from `layer`(e.g. by `LayerToStage`).
+///
+bool UpdateStageFromLayer(const Layer &layer,
+                          const std::vector<Path> &prim_paths, Stage *stage,
+                          std::string *warn, std::string *err);
+
 struct VariantSelector {
   std::string selection;  // current selection
   VariantSelectionMap vsmap;
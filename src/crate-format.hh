@@ -495,6 +495,10 @@ class CrateValue {
     return value_;
   }
 
+  value::Value &get_raw() {
+    return value_;
+  }
+
  private:
   value::Value value_;
 };
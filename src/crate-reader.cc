@@ -863,6 +863,8 @@ bool CrateReader::ReadTimeSamples(value::TimeSamples *d) {
     PUSH_ERROR_AND_RETURN_TAG(kTag, "# of `times` elements and # of values in Crate differs.");
   }
 
+  d->reserve(times.size());
+
   for (size_t i = 0; i < num_values; i++) {
 
     crate::ValueRep rep;
@@ -880,7 +882,7 @@ bool CrateReader::ReadTimeSamples(value::TimeSamples *d) {
       PUSH_ERROR_AND_RETURN_TAG(kTag, "Failed to unpack value of TimeSample's value element.");
     }
 
-    d->add_sample(times[i], value.get_raw());
+    d->add_sample(times[i], std::move(value.get_raw()));
 
     // UnpackValueRep() will change StreamReader's read position.
     // Revert to next ValueRep location here.
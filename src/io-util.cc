@@ -741,6 +741,37 @@ bool FileExists(const std::string &filepath, void *userdata) {
   return ret;
 }
 
+bool GetFileModificationStamp(const std::string &filepath, uint64_t *stamp) {
+  if (!stamp) {
+    return false;
+  }
+
+#if defined(__wasi__) || defined(TINYUSDZ_ANDROID_LOAD_FROM_ASSETS)
+  (void)filepath;
+  return false;
+#else
+  std::error_code ec;
+  ghc::filesystem::path fspath = ghc::filesystem::u8path(filepath);
+
+  auto ftime = ghc::filesystem::last_write_time(fspath, ec);
+  if (ec) {
+    return false;
+  }
+
+  uintmax_t fsize = ghc::filesystem::file_size(fspath, ec);
+  if (ec) {
+    return false;
+  }
+
+  // Mix file size so that rewrites within the timestamp resolution are also
+  // likely detected.
+  uint64_t t = uint64_t(ftime.time_since_epoch().count());
+  (*stamp) = t ^ (uint64_t(fsize) * 0x9e3779b97f4a7c15ull);
+
+  return true;
+#endif
+}
+
 std::string FindFile(const std::string &filename,
                      const std::vector<std::string> &search_paths) {
   // TODO: Use ghc filesystem?
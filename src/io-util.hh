@@ -102,6 +102,14 @@ std::string ExpandFilePath(const std::string &filepath,
 
 bool FileExists(const std::string &filepath, void *userdata = nullptr);
 
+///
+/// Get modification stamp(last write time mixed with file size) of a file.
+/// The value is only meaningful for comparing with a stamp of the same file.
+///
+/// @return false when the file does not exist or the stamp cannot be obtained.
+///
+bool GetFileModificationStamp(const std::string &filepath, uint64_t *stamp);
+
 ///
 /// Find file from search paths.
 /// Returns empty string if a file is not found.
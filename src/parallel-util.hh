@@ -0,0 +1,118 @@
+// SPDX-License-Identifier: Apache 2.0
+// Copyright 2024 - Present, Light Transport Entertainment Inc.
+//
+// Simple parallel-for utility built on top of C++11 std::thread.
+//
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <thread>
+#include <vector>
+
+namespace tinyusdz {
+namespace parallel {
+
+///
+/// Returns true when the platform can spawn threads.
+///
+inline bool IsThreadSupported() {
+#if defined(__wasi__)
+  return false;
+#elif defined(__EMSCRIPTEN__) && !defined(__EMSCRIPTEN_PTHREADS__)
+  return false;
+#else
+  return true;
+#endif
+}
+
+///
+/// Resolve the number of threads to use.
+///
+/// @param[in] num_threads Requested # of threads. -1(or 0) = use system's # of
+/// threads.
+///
+/// @return # of threads in [1, 1024]. Always 1 when the platform does not
+/// support threading.
+///
+inline uint32_t GetNumThreads(const int num_threads) {
+  if (!IsThreadSupported()) {
+    return 1;
+  }
+
+  int n = num_threads;
+  if (n <= 0) {
+    n = (std::max)(1, int(std::thread::hardware_concurrency()));
+  }
+
+  // Limit to 1024 threads.
+  return uint32_t((std::min)(1024, n));
+}
+
+///
+/// Call `func(i, thread_id)` for each i in [begin, end).
+///
+/// Items are dynamically distributed to threads in `grain_size` chunks, so
+/// the order of calls is not specified. `func` must be thread-safe. Use
+/// `thread_id`(in [0, num_threads)) to access per-thread storage.
+///
+/// Runs on the calling thread when `num_threads` <= 1 or the range is
+/// smaller than `grain_size`.
+///
+template <typename Func>
+void ParallelFor(const size_t begin, const size_t end,
+                 const uint32_t num_threads, Func &&func,
+                 const size_t grain_size = 1) {
+  if (end <= begin) {
+    return;
+  }
+
+  const size_t n = end - begin;
+  const size_t grain = (std::max)(size_t(1), grain_size);
+
+  uint32_t nthreads = (std::min)(num_threads, uint32_t((n + grain - 1) / grain));
+  if (!IsThreadSupported()) {
+    nthreads = 1;
+  }
+
+  if (nthreads <= 1) {
+    for (size_t i = begin; i < end; i++) {
+      func(i, uint32_t(0));
+    }
+    return;
+  }
+
+  std::atomic<size_t> counter(begin);
+
+  auto worker = [&](uint32_t thread_id) {
+    for (;;) {
+      size_t s = counter.fetch_add(grain);
+      if (s >= end) {
+        break;
+      }
+      size_t e = (std::min)(end, s + grain);
+      for (size_t i = s; i < e; i++) {
+        func(i, thread_id);
+      }
+    }
+  };
+
+  std::vector<std::thread> workers;
+  workers.reserve(nthreads - 1);
+
+  for (uint32_t t = 1; t < nthreads; t++) {
+    workers.emplace_back(worker, t);
+  }
+
+  // Calling thread also works.
+  worker(0);
+
+  for (auto &th : workers) {
+    th.join();
+  }
+}
+
+}  // namespace parallel
+}  // namespace tinyusdz
@@ -246,14 +246,16 @@ std::string print_typed_timesamples(const TypedTimeSamples<T> &v,
 
   ss << "{\n";
 
-  const auto &samples = v.get_samples();
+  const std::vector<double> &times = v.get_times();
 
-  for (size_t i = 0; i < samples.size(); i++) {
-    ss << pprint::Indent(indent + 1) << samples[i].t << ": ";
-    if (samples[i].blocked) {
+  T val{};
+  for (size_t i = 0; i < times.size(); i++) {
+    ss << pprint::Indent(indent + 1) << times[i] << ": ";
+    if (v.is_blocked(i)) {
       ss << "None";
     } else {
-      ss << samples[i].value;
+      v.get_value(i, &val);
+      ss << val;
     }
     ss << ",\n";
   }
@@ -270,14 +272,16 @@ std::string print_typed_token_timesamples(const TypedTimeSamples<T> &v,
 
   ss << "{\n";
 
-  const auto &samples = v.get_samples();
+  const std::vector<double> &times = v.get_times();
 
-  for (size_t i = 0; i < samples.size(); i++) {
-    ss << pprint::Indent(indent + 1) << samples[i].t << ": ";
-    if (samples[i].blocked) {
+  T val{};
+  for (size_t i = 0; i < times.size(); i++) {
+    ss << pprint::Indent(indent + 1) << times[i] << ": ";
+    if (v.is_blocked(i)) {
       ss << "None";
     } else {
-      ss << quote(to_string(samples[i].value));
+      v.get_value(i, &val);
+      ss << quote(to_string(val));
     }
     ss << ",\n";
   }
@@ -293,14 +297,16 @@ static std::string print_str_timesamples(const TypedTimeSamples<std::string> &v,
 
   ss << "{\n";
 
-  const auto &samples = v.get_samples();
+  const std::vector<double> &times = v.get_times();
 
-  for (size_t i = 0; i < samples.size(); i++) {
-    ss << pprint::Indent(indent + 1) << samples[i].t << ": ";
-    if (samples[i].blocked) {
+  std::string val;
+  for (size_t i = 0; i < times.size(); i++) {
+    ss << pprint::Indent(indent + 1) << times[i] << ": ";
+    if (v.is_blocked(i)) {
       ss << "None";
     } else {
-      ss << buildEscapedAndQuotedStringForUSDA(samples[i].value);
+      v.get_value(i, &val);
+      ss << buildEscapedAndQuotedStringForUSDA(val);
     }
     ss << ",\n";
   }
@@ -1288,8 +1294,8 @@ std::string print_timesamples(const value::TimeSamples &v,
 
   for (size_t i = 0; i < v.size(); i++) {
     ss << pprint::Indent(indent + 1);
-    ss << v.get_samples()[i].t << ": "
-       << value::pprint_value(v.get_samples()[i].value);
+    ss << v.get_times()[i] << ": "
+       << value::pprint_value(v.get_values()[i]);
     ss << ",\n";  // USDA allow ',' for the last item
   }
   ss << pprint::Indent(indent) << "}\n";
@@ -137,14 +137,17 @@ static nonstd::optional<Animatable<T>> ConvertToAnimatable(const primvar::PrimVa
   }
 
   if (var.has_timesamples()) {
-    for (size_t i = 0; i < var.ts_raw().size(); i++) {
-      const value::TimeSamples::Sample &s = var.ts_raw().get_samples()[i];
+    const value::TimeSamples &ts = var.ts_raw();
+    const std::vector<double> &times = ts.get_times();
+    const std::vector<value::Value> &values = ts.get_values();
+    dst.reserve_timesamples(times.size());
 
+    for (size_t i = 0; i < times.size(); i++) {
       // Attribute Block?
-      if (s.blocked) {
-        dst.add_blocked_sample(s.t);
-      } else if (auto pv = s.value.get_value<T>()) {
-        dst.add_sample(s.t, pv.value());
+      if (ts.is_blocked(i)) {
+        dst.add_blocked_sample(times[i]);
+      } else if (auto pv = values[i].get_value<T>()) {
+        dst.add_sample(times[i], pv.value());
       } else {
         // Type mismatch
         DCOUT(i << "/" << var.ts_raw().size() << " type mismatch.");
@@ -196,18 +199,21 @@ nonstd::optional<Animatable<Extent>> ConvertToAnimatable(const primvar::PrimVar
   }
 
   if (var.has_timesamples()) {
-    for (size_t i = 0; i < var.ts_raw().size(); i++) {
-      const value::TimeSamples::Sample &s = var.ts_raw().get_samples()[i];
+    const value::TimeSamples &ts = var.ts_raw();
+    const std::vector<double> &times = ts.get_times();
+    const std::vector<value::Value> &values = ts.get_values();
+    dst.reserve_timesamples(times.size());
 
+    for (size_t i = 0; i < times.size(); i++) {
       // Attribute Block?
-      if (s.blocked) {
-        dst.add_blocked_sample(s.t);
-      } else if (auto pv = s.value.get_value<std::vector<value::float3>>()) {
+      if (ts.is_blocked(i)) {
+        dst.add_blocked_sample(times[i]);
+      } else if (auto pv = values[i].get_value<std::vector<value::float3>>()) {
         if (pv.value().size() == 2) {
           Extent ext;
           ext.lower = pv.value()[0];
           ext.upper = pv.value()[1];
-          dst.add_sample(s.t, ext);
+          dst.add_sample(times[i], ext);
         } else {
           DCOUT(i << "/" << var.ts_raw().size() << " array size mismatch.");
           return nonstd::nullopt;
@@ -97,10 +97,14 @@ bool ConvertTokenAttributeToStringAttribute(
           toks.get_scalar(&tok);
           strs.set(tok.str());
         } else if (toks.is_timesamples()) {
-          auto tok_ts = toks.get_timesamples();
-  
-          for (auto &item : tok_ts.get_samples()) {
-            strs.add_sample(item.t, item.value.str());
+          const auto &tok_ts = toks.get_timesamples();
+          const std::vector<double> &times = tok_ts.get_times();
+
+          value::token tok;
+          for (size_t i = 0; i < times.size(); i++) {
+            if (tok_ts.get_value(i, &tok)) {
+              strs.add_sample(times[i], tok.str());
+            }
           }
         } else if (toks.is_blocked()) {
           // TODO
@@ -1237,6 +1241,32 @@ bool Prim::replace_child(const std::string &child_prim_name, Prim &&rhs,
   return true;
 }
 
+bool Prim::remove_child(const std::string &child_prim_name,
+                        std::string *err) {
+#if defined(TINYUSDZ_ENABLE_THREAD)
+  // TODO: Only take a lock when dirty.
+  std::lock_guard<std::mutex> lock(_mutex);
+#endif
+
+  auto result = std::find_if(_children.begin(), _children.end(),
+                             [child_prim_name](const Prim &p) {
+                               return (p.element_name() == child_prim_name);
+                             });
+
+  if (result == _children.end()) {
+    if (err) {
+      (*err) += fmt::format("Child Prim `{}` not found.\n", child_prim_name);
+    }
+    return false;
+  }
+
+  _children.erase(result);
+  _childrenNameSet.erase(child_prim_name);
+  _child_dirty = true;
+
+  return true;
+}
+
 const std::vector<int64_t> &Prim::get_child_indices_from_primChildren(
     bool force_update, bool *indices_is_valid) const {
 #if defined(TINYUSDZ_ENABLE_THREAD)
@@ -1968,37 +1998,26 @@ int AttrMetas::get_unauthoredValuesIndex() const {
 
 namespace {
 
-nonstd::optional<const PrimSpec *> GetPrimSpecAtPathRec(
-    const PrimSpec *parent, const std::string &parent_path, const Path &path,
-    uint32_t depth) {
+bool BuildPrimSpecPathIndexRec(
+    const PrimSpec *ps, const std::string &parent_path, uint32_t depth,
+    std::unordered_map<std::string, const PrimSpec *> &index) {
   if (depth > (1024 * 1024 * 128)) {
     // Too deep.
-    return nonstd::nullopt;
-  }
-
-  if (!parent) {
-    return nonstd::nullopt;
+    return false;
   }
 
-  std::string abs_path;
-  {
-    std::string elementName = parent->name();
+  std::string abs_path = parent_path + "/" + ps->name();
 
-    abs_path = parent_path + "/" + elementName;
+  // Keep the first one when PrimSpecs with same path exist.
+  index.emplace(abs_path, ps);
 
-    if (abs_path == path.full_path_name()) {
-      return parent;
-    }
-  }
-
-  for (const auto &child : parent->children()) {
-    if (auto pv = GetPrimSpecAtPathRec(&child, abs_path, path, depth + 1)) {
-      return pv.value();
+  for (const auto &child : ps->children()) {
+    if (!BuildPrimSpecPathIndexRec(&child, abs_path, depth + 1, index)) {
+      return false;
     }
   }
 
-  // not found
-  return nonstd::nullopt;
+  return true;
 }
 
 bool HasReferencesRec(uint32_t depth, const PrimSpec &primspec,
@@ -2144,42 +2163,84 @@ bool Layer::find_primspec_at(const Path &path, const PrimSpec **ps,
     PUSH_ERROR_AND_RETURN(fmt::format("Path is not absolute path: {}", path.full_path_name()));
   }
 
-#if defined(TINYUSDZ_ENABLE_THREAD)
-  // TODO: Only take a lock when dirty.
-  std::lock_guard<std::mutex> lock(_mutex);
-#endif
+  if (_primspec_index.dirty.load(std::memory_order_acquire)) {
+    std::lock_guard<std::mutex> lock(_primspec_index.mutex);
 
-  if (_dirty) {
-    DCOUT("clear cache.");
-    // Clear cache.
-    _primspec_path_cache.clear();
+    // Other thread may have built the index.
+    if (_primspec_index.dirty.load(std::memory_order_relaxed)) {
+      DCOUT("Build PrimSpec path index.");
+      _primspec_index.index.clear();
 
-    _dirty = false;
-  } else {
-    // First find from a cache.
-    auto ret = _primspec_path_cache.find(path.prim_part());
-    if (ret != _primspec_path_cache.end()) {
-      DCOUT("Found cache.");
-      return ret->second;
+      for (const auto &parent : _prim_specs) {
+        if (!BuildPrimSpecPathIndexRec(&parent.second, /* parent_path */ "",
+                                       /* depth */ 0,
+                                       _primspec_index.index)) {
+          _primspec_index.index.clear();
+          PUSH_ERROR_AND_RETURN("PrimSpec tree too deep.");
+        }
+      }
+
+      _primspec_index.dirty.store(false, std::memory_order_release);
     }
   }
 
-  // Brute-force search.
-  for (const auto &parent : _prim_specs) {
-    if (auto pv = GetPrimSpecAtPathRec(&parent.second, /* parent_path */ "",
-                                       path, /* depth */ 0)) {
-      (*ps) = pv.value();
-
-      // Add to cache.
-      // Assume pointer address does not change unless dirty state changes.
-      _primspec_path_cache[path.prim_part()] = pv.value();
-      return true;
-    }
+  auto it = _primspec_index.index.find(path.prim_part());
+  if (it != _primspec_index.index.end()) {
+    (*ps) = it->second;
+    return true;
   }
 
   return false;
 }
 
+namespace {
+
+void RemovePrimSpecPathIndexRec(
+    const PrimSpec &ps, const std::string &abs_path, uint32_t depth,
+    std::unordered_map<std::string, const PrimSpec *> &index) {
+  if (depth > (1024 * 1024 * 128)) {
+    // Too deep.
+    return;
+  }
+
+  auto it = index.find(abs_path);
+  // PrimSpec with same path may exist.
+  if ((it != index.end()) && (it->second == &ps)) {
+    index.erase(it);
+  }
+
+  for (const auto &child : ps.children()) {
+    RemovePrimSpecPathIndexRec(child, abs_path + "/" + child.name(), depth + 1,
+                               index);
+  }
+}
+
+}  // namespace
+
+void Layer::remove_primspec_index(const std::string &prim_path,
+                                  const PrimSpec &ps) const {
+  if (_primspec_index.dirty.load(std::memory_order_relaxed)) {
+    return;
+  }
+
+  RemovePrimSpecPathIndexRec(ps, prim_path, /* depth */ 0,
+                             _primspec_index.index);
+}
+
+void Layer::add_primspec_index(const std::string &prim_path,
+                               const PrimSpec &ps) const {
+  if (_primspec_index.dirty.load(std::memory_order_relaxed)) {
+    return;
+  }
+
+  std::string parent_path = prim_path.substr(0, prim_path.find_last_of('/'));
+  if (!BuildPrimSpecPathIndexRec(&ps, parent_path, /* depth */ 0,
+                                 _primspec_index.index)) {
+    // Too deep. Rebuild at the next lookup.
+    _primspec_index.invalidate();
+  }
+}
+
 bool Layer::check_unresolved_references(const uint32_t max_depth) const {
   bool ret = false;
 
@@ -17,13 +17,14 @@
 #include <map>
 #include <memory>
 #include <set>
+#include <atomic>
+#include <mutex>
 #include <string>
 #include <unordered_map>
 #include <utility>
 #include <vector>
 
 #if defined(TINYUSDZ_ENABLE_THREAD)
-#include <mutex>
 #include <thread>
 #endif
 
@@ -1122,6 +1123,133 @@ using AttrMeta = AttrMetas;
 
 using PropMetas = AttrMetas;
 
+//
+// Value buffer for TypedTimeSamples.
+//
+// Values are stored in a single contiguous array in the order of samples.
+//
+template <typename T>
+class TimeSampleValueBuffer {
+ public:
+  size_t size() const { return _values.size(); }
+
+  void clear() { _values.clear(); }
+
+  void reserve(size_t n) { _values.reserve(n); }
+
+  void push_back(const T &v) { _values.push_back(v); }
+
+  void push_back(T &&v) { _values.push_back(std::move(v)); }
+
+  void get(size_t idx, T *dst) const { (*dst) = _values[idx]; }
+
+  void set(size_t idx, const T &v) { _values[idx] = v; }
+
+  void interpolate(size_t idx0, size_t idx1, double dt, T *dst) const {
+    (*dst) = tinyusdz::lerp(_values[idx0], _values[idx1], dt);
+  }
+
+  void permute(const std::vector<size_t> &order) {
+    value::ApplyTimeSampleOrder(order, &_values);
+  }
+
+ private:
+  std::vector<T> _values;
+};
+
+//
+// Array values are flattened into a single contiguous buffer.
+// The value of i'th sample is stored in [_offsets[i], _offsets[i+1]).
+//
+template <typename T>
+class TimeSampleValueBuffer<std::vector<T>> {
+ public:
+  size_t size() const { return _offsets.size() - 1; }
+
+  void clear() {
+    _data.clear();
+    _offsets.assign(1, 0);
+  }
+
+  // `n` = # of samples
+  void reserve(size_t n) { _offsets.reserve(n + 1); }
+
+  void push_back(const std::vector<T> &v) {
+    _data.insert(_data.end(), v.begin(), v.end());
+    _offsets.push_back(_data.size());
+  }
+
+  // # of array elements of the sample.
+  size_t count(size_t idx) const { return _offsets[idx + 1] - _offsets[idx]; }
+
+  void get(size_t idx, std::vector<T> *dst) const {
+    dst->assign(iter(_offsets[idx]), iter(_offsets[idx + 1]));
+  }
+
+  value::ArrayView<T> view(size_t idx) const {
+    return value::ArrayView<T>(_data.data() + _offsets[idx], count(idx));
+  }
+
+  void set(size_t idx, const std::vector<T> &v) {
+    const size_t n = count(idx);
+    if (v.size() == n) {
+      std::copy(v.begin(), v.end(), _data.begin() + std::ptrdiff_t(_offsets[idx]));
+      return;
+    }
+
+    auto first = _data.begin() + std::ptrdiff_t(_offsets[idx]);
+    first = _data.erase(first, first + std::ptrdiff_t(n));
+    _data.insert(first, v.begin(), v.end());
+
+    for (size_t i = idx + 1; i < _offsets.size(); i++) {
+      _offsets[i] = _offsets[i] - n + v.size();
+    }
+  }
+
+  // Same result with lerp(std::vector<T>, std::vector<T>, dt) in
+  // value-eval-util.hh, but without allocating temporary arrays.
+  void interpolate(size_t idx0, size_t idx1, double dt, std::vector<T> *dst) const {
+    const size_t n0 = count(idx0);
+    const size_t n1 = count(idx1);
+    const size_t n = (std::min)(n0, n1);
+
+    if (n0 != n1) {
+      dst->assign(n, T());
+      return;
+    }
+
+    dst->resize(n);
+    if (n > 0) {
+      tinyusdz::lerp_array(&_data[_offsets[idx0]], &_data[_offsets[idx1]], n, dt, dst->data());
+    }
+  }
+
+  void permute(const std::vector<size_t> &order) {
+    std::vector<T> data;
+    data.reserve(_data.size());
+
+    std::vector<size_t> offsets;
+    offsets.reserve(_offsets.size());
+    offsets.push_back(0);
+
+    for (size_t idx : order) {
+      data.insert(data.end(), iter(_offsets[idx]), iter(_offsets[idx + 1]));
+      offsets.push_back(data.size());
+    }
+
+    _data = std::move(data);
+    _offsets = std::move(offsets);
+  }
+
+ private:
+  typename std::vector<T>::const_iterator iter(size_t offset) const {
+    return _data.cbegin() + std::ptrdiff_t(offset);
+  }
+
+  std::vector<T> _data;
+  std::vector<size_t> _offsets{0};
+};
+
 // TODO: Move to value-types.hh?
 //
 // Typed TimeSamples value
@@ -1134,21 +1262,44 @@ using PropMetas = AttrMetas;
 // 1: (2.0, true)
 // 2: (3.0, false)
 //
+// Samples are stored in struct-of-arrays layout(sorted times, blocked bitset and
+// TimeSampleValueBuffer).
+//
 
 template <typename T>
 struct TypedTimeSamples {
  public:
+  // Materialized sample. Only used for the interface.
   struct Sample {
     double t;
     T value;
     bool blocked{false};
   };
 
-  bool empty() const { return _samples.empty(); }
+  bool empty() const { return _times.empty(); }
+
+  size_t size() const { return _times.size(); }
+
+  void clear() {
+    _times.clear();
+    _blocked.clear();
+    _values.clear();
+    _dirty = false;
+  }
+
+  void reserve(size_t n) {
+    _times.reserve(n);
+    _blocked.reserve(n);
+    _values.reserve(n);
+  }
 
   void update() const {
-    std::sort(_samples.begin(), _samples.end(),
-              [](const Sample &a, const Sample &b) { return a.t < b.t; });
+    std::vector<size_t> order;
+    if (value::ComputeTimeSampleOrder(_times, &order)) {
+      value::ApplyTimeSampleOrder(order, &_times);
+      value::ApplyTimeSampleOrder(order, &_blocked);
+      _values.permute(order);
+    }
 
     _dirty = false;
 
@@ -1156,17 +1307,23 @@ struct TypedTimeSamples {
   }
 
   // Get value at specified time.
-  // For non-interpolatable types(includes enums and unknown types)
   //
-  // Return `Held` value even when TimeSampleInterpolationType is
-  // Linear. Returns nullopt when specified time is out-of-range.
-  template<typename V = T, std::enable_if_t<!value::LerpTraits<V>::supported(), std::nullptr_t> = nullptr>
+  // Return linearly interpolated value when TimeSampleInterpolationType is
+  // Linear and `T` is interpolatable. Otherwise return `Held` value.
+  // (For non-interpolatable types(includes enums and unknown types), `Held`
+  // value is returned even when TimeSampleInterpolationType is Linear)
+  //
+  // Returns false when samples is empty.
   bool get(T *dst, double t = value::TimeCode::Default(),
            value::TimeSampleInterpolationType interp =
                value::TimeSampleInterpolationType::Linear) const {
+    return get(dst, t, interp, nullptr);
+  }
 
-    (void)interp;
-
+  // Get value at specified time with `cursor` as a lookup hint.
+  // `cursor` is updated to the interval of `t`.
+  bool get(T *dst, double t, value::TimeSampleInterpolationType interp,
+           value::TimeSampleCursor *cursor) const {
     if (!dst) {
       return false;
     }
@@ -1182,46 +1339,26 @@ struct TypedTimeSamples {
     if (value::TimeCode(t).is_default()) {
       // FIXME: Use the first item for now.
       // TODO: Handle bloked
-      (*dst) = _samples[0].value;
-      return true;
-    } else {
-
-      if (_samples.size() == 1) {
-        (*dst) = _samples[0].value;
-        return true;
-      }
-
-      // Held = nerarest preceding value for a gien time.
-      // example:
-      // input = 0.0: 100, 1.0: 200
-      //
-      // t -1.0 => 100(time 0.0)
-      // t 0.0 => 100(time 0.0)
-      // t 0.1 => 100(time 0.0)
-      // t 0.9 => 100(time 0.0)
-      // t 1.0 => 200(time 1.0)
-      //
-      // This can be achieved by using upper_bound, and subtract 1 from the found position.
-      auto it = std::upper_bound(
-        _samples.begin(), _samples.end(), t,
-        [](double tval, const Sample &a) { return tval < a.t; });
-
-      const auto it_minus_1 = (it == _samples.begin()) ? _samples.begin() : (it - 1);
-
-      (*dst) = it_minus_1->value;
+      _values.get(0, dst);
       return true;
     }
 
+    eval(t, interp, cursor, dst);
+    return true;
   }
 
-  // TODO: Move to .cc to save compile time.
-  // Get value at specified time.
-  // Return linearly interpolated value when TimeSampleInterpolationType is
-  // Linear. Returns nullopt when specified time is out-of-range.
-  template<typename V = T, std::enable_if_t<value::LerpTraits<V>::supported(), std::nullptr_t> = nullptr>
-  bool get(T *dst, double t = value::TimeCode::Default(),
-           value::TimeSampleInterpolationType interp =
-               value::TimeSampleInterpolationType::Linear) const {
+  ///
+  /// Zero-copy access to the array value at specified time(T = `U[]` only).
+  ///
+  /// Only succeeds when the value at `t` is one of the stored samples(Held
+  /// interpolation or `t` is on/outside of the sample times). Returns false
+  /// when the value needs to be interpolated, so use get() in that case.
+  ///
+  template <typename U = T>
+  bool get_array_view(value::ArrayView<typename U::value_type> *dst, double t,
+                      value::TimeSampleInterpolationType interp =
+                          value::TimeSampleInterpolationType::Linear,
+                      value::TimeSampleCursor *cursor = nullptr) const {
     if (!dst) {
       return false;
     }
@@ -1234,119 +1371,115 @@ struct TypedTimeSamples {
       update();
     }
 
-    if (value::TimeCode(t).is_default()) {
-      // FIXME: Use the first item for now.
-      // TODO: Handle bloked
-      (*dst) = _samples[0].value;
-      return true;
-    } else {
-
-      if (_samples.size() == 1) {
-        (*dst) = _samples[0].value;
-        return true;
+    size_t idx = 0;
+    if (!value::TimeCode(t).is_default()) {
+      idx = held_index(t, cursor ? cursor->index : 0);
+      if (cursor) {
+        cursor->index = idx;
       }
 
-      auto it = std::lower_bound(
-        _samples.begin(), _samples.end(), t,
-        [](const Sample &a, double tval) { return a.t < tval; });
-
-      if (interp == value::TimeSampleInterpolationType::Linear) {
-
-        // MS STL does not allow seek vector iterator before begin
-        // Issue #110
-        const auto it_minus_1 = (it == _samples.begin()) ? _samples.begin() : (it - 1);
-
-        size_t idx0 = size_t((std::max)(
-            int64_t(0),
-            (std::min)(int64_t(_samples.size() - 1),
-                     int64_t(std::distance(_samples.begin(), it_minus_1)))));
-        size_t idx1 =
-            size_t((std::max)(int64_t(0), (std::min)(int64_t(_samples.size() - 1),
-                                                 int64_t(idx0) + 1)));
-
-        double tl = _samples[idx0].t;
-        double tu = _samples[idx1].t;
-
-        double dt = (t - tl);
-        if (std::fabs(tu - tl) < std::numeric_limits<double>::epsilon()) {
-          // slope is zero.
-          dt = 0.0;
-        } else {
-          dt /= (tu - tl);
-        }
-
-        // Just in case.
-        dt = (std::max)(0.0, (std::min)(1.0, dt));
-
-        const value::Value &pv0 = _samples[idx0].value;
-        const value::Value &pv1 = _samples[idx1].value;
+      if ((interp == value::TimeSampleInterpolationType::Linear) &&
+          value::LerpTraits<T>::supported() && ((idx + 1) < _times.size()) &&
+          (t > _times[idx])) {
+        return false;
+      }
+    }
 
-        if (pv0.type_id() != pv1.type_id()) {
-          // Type mismatch.
-          return false;
-        }
+    (*dst) = _values.view(idx);
+    return true;
+  }
 
-        // To concrete type
-        const T *p0 = pv0.as<T>();
-        const T *p1 = pv1.as<T>();
+  ///
+  /// Batch evaluation: Get values at `n` times into `dst[0..n)`.
+  ///
+  /// `times` can be in any order, but sorted(ascending) times are evaluated
+  /// without binary search.
+  ///
+  bool get_batch(const double *times, const size_t n, T *dst,
+                 value::TimeSampleInterpolationType interp =
+                     value::TimeSampleInterpolationType::Linear) const {
+    if (!times || !dst) {
+      return false;
+    }
 
-        if (!p0 || !p1) {
-          return false;
-        }
+    if (empty()) {
+      return false;
+    }
 
-        const T p = lerp(*p0, *p1, dt);
+    if (_dirty) {
+      update();
+    }
 
-        (*dst) = std::move(p);
-        return true;
+    value::TimeSampleCursor cursor;
+    for (size_t i = 0; i < n; i++) {
+      if (value::TimeCode(times[i]).is_default()) {
+        _values.get(0, &dst[i]);
       } else {
-        if (it == _samples.end()) {
-          // ???
-          return false;
-        }
-
-        (*dst) = it->value;
-        return true;
+        eval(times[i], interp, &cursor, &dst[i]);
       }
     }
 
-    return false;
+    return true;
   }
 
   void add_sample(const Sample &s) {
-    _samples.push_back(s);
+    _times.push_back(s.t);
+    _blocked.push_back(s.blocked);
+    _values.push_back(s.value);
     _dirty = true;
   }
 
   void add_sample(const double t, const T &v) {
-    Sample s;
-    s.t = t;
-    s.value = v;
-    _samples.emplace_back(s);
+    _times.push_back(t);
+    _blocked.push_back(false);
+    _values.push_back(v);
     _dirty = true;
   }
 
   void add_blocked_sample(const double t) {
-    Sample s;
-    s.t = t;
-    s.blocked = true;
-    _samples.emplace_back(s);
+    _times.push_back(t);
+    _blocked.push_back(true);
+    _values.push_back(T());
     _dirty = true;
   }
 
   bool has_sample_at(const double t) const {
+    return find_sample_at(t, nullptr);
+  }
+
+  ///
+  /// Find the index of the sample at time `t`.
+  ///
+  bool find_sample_at(const double t, size_t *idx) const {
     if (_dirty) {
       update();
     }
 
-    const auto it = std::find_if(_samples.begin(), _samples.end(), [&t](const Sample &s) {
-      return tinyusdz::math::is_close(t, s.t);
+    const auto it = std::find_if(_times.begin(), _times.end(), [&t](const double st) {
+      return tinyusdz::math::is_close(t, st);
     });
 
-    return (it != _samples.end());
+    if (it == _times.end()) {
+      return false;
+    }
+
+    if (idx) {
+      (*idx) = size_t(std::distance(_times.begin(), it));
+    }
+    return true;
   }
 
-  bool get_sample_at(const double t, Sample **dst) {
-    if (!dst) {
+  // Sorted time array.
+  const std::vector<double> &get_times() const {
+    if (_dirty) {
+      update();
+    }
+
+    return _times;
+  }
+
+  bool is_blocked(size_t idx) const {
+    if (idx >= _blocked.size()) {
       return false;
     }
 
@@ -1354,71 +1487,214 @@ struct TypedTimeSamples {
       update();
     }
 
-    const auto it = std::find_if(_samples.begin(), _samples.end(), [&t](const Sample &sample) {
-      return math::is_close(t, sample.t);
-    });
+    return _blocked[idx];
+  }
 
-    if (it != _samples.end()) {
-      (*dst) = &(*it); 
+  // Get the value of `idx`th sample(in the order of `get_times()`).
+  bool get_value(size_t idx, T *dst) const {
+    if (!dst || (idx >= _times.size())) {
+      return false;
     }
-    return false;
+
+    if (_dirty) {
+      update();
+    }
+
+    _values.get(idx, dst);
+    return true;
+  }
+
+  // Zero-copy access to the array value of `idx`th sample(T = `U[]` only).
+  template <typename U = T>
+  bool get_value_view(size_t idx,
+                      value::ArrayView<typename U::value_type> *dst) const {
+    if (!dst || (idx >= _times.size())) {
+      return false;
+    }
+
+    if (_dirty) {
+      update();
+    }
+
+    (*dst) = _values.view(idx);
+    return true;
   }
 
-  const std::vector<Sample> &get_samples() const {
+  // Overwrite the value of `idx`th sample.
+  bool set_value(size_t idx, const T &v) {
+    if (idx >= _times.size()) {
+      return false;
+    }
+
     if (_dirty) {
       update();
     }
 
-    return _samples;
+    _values.set(idx, v);
+    _blocked[idx] = false;
+    return true;
   }
 
-  std::vector<Sample> &samples() {
+  ///
+  /// Materialize samples(compatibility helper).
+  /// NOTE: Returns by value, and deep-copies every sample value(e.g. whole
+  /// arrays). Use get_times(), is_blocked() and get_value()/get_value_view()
+  /// to access samples without copying.
+  ///
+  std::vector<Sample> get_samples() const {
     if (_dirty) {
       update();
     }
 
-    return _samples;
+    std::vector<Sample> samples(_times.size());
+    for (size_t i = 0; i < _times.size(); i++) {
+      samples[i].t = _times[i];
+      samples[i].blocked = _blocked[i];
+      _values.get(i, &samples[i].value);
+    }
+
+    return samples;
   }
 
   // From typeless timesamples.
   bool from_timesamples(const value::TimeSamples &ts) {
-    std::vector<Sample> buf;
-    for (size_t i = 0; i < ts.size(); i++) {
-      if (ts.get_samples()[i].value.type_id() != value::TypeTraits<T>::type_id()) {
+    const std::vector<double> &times = ts.get_times();
+    const std::vector<value::Value> &values = ts.get_values();
+
+    TypedTimeSamples<T> buf;
+    buf.reserve(times.size());
+
+    for (size_t i = 0; i < times.size(); i++) {
+      if (values[i].type_id() != value::TypeTraits<T>::type_id()) {
         return false;
       }
-      Sample s;
-      s.t = ts.get_samples()[i].t;
-      s.blocked = ts.get_samples()[i].blocked;
-      if (const auto pv = ts.get_samples()[i].value.as<T>()) {
-        s.value = (*pv);
+      if (const auto pv = values[i].as<T>()) {
+        buf._times.push_back(times[i]);
+        buf._blocked.push_back(ts.is_blocked(i));
+        buf._values.push_back(*pv);
       } else {
         return false;
       }
+    }
 
-      buf.push_back(s);
+    (*this) = std::move(buf);
+
+    return true;
+  }
+
+ private:
+
+  // Index of the nearest preceding sample for a given time.
+  //
+  // Held = nerarest preceding value for a gien time.
+  // example:
+  // input = 0.0: 100, 1.0: 200
+  //
+  // t -1.0 => 100(time 0.0)
+  // t 0.0 => 100(time 0.0)
+  // t 0.1 => 100(time 0.0)
+  // t 0.9 => 100(time 0.0)
+  // t 1.0 => 200(time 1.0)
+  //
+  // This can be achieved by using upper_bound, and subtract 1 from the found
+  // position. `hint` and the next interval are checked first.
+  size_t held_index(const double t, const size_t hint) const {
+    const size_t n = _times.size();
+    if ((hint < n) && (_times[hint] <= t)) {
+      if (((hint + 1) == n) || (t < _times[hint + 1])) {
+        return hint;
+      }
+      if (((hint + 2) == n) || (t < _times[hint + 2])) {
+        return hint + 1;
+      }
     }
 
+    const size_t idx = size_t(std::distance(
+        _times.begin(), std::upper_bound(_times.begin(), _times.end(), t)));
+    return (idx == 0) ? 0 : (idx - 1);
+  }
 
-    _samples = std::move(buf);
-    _dirty = true;
+  // Evaluate the value at non-default time. Samples must be sorted.
+  void eval(const double t, value::TimeSampleInterpolationType interp,
+            value::TimeSampleCursor *cursor, T *dst) const {
+    const size_t idx0 = held_index(t, cursor ? cursor->index : 0);
+    if (cursor) {
+      cursor->index = idx0;
+    }
 
-    return true;
+    if ((interp == value::TimeSampleInterpolationType::Held) ||
+        ((idx0 + 1) >= _times.size())) {
+      _values.get(idx0, dst);
+      return;
+    }
+
+    eval_linear(t, idx0, dst, std::integral_constant<bool, value::LerpTraits<T>::supported()>());
   }
 
-  size_t size() const {
-    if (_dirty) {
-      update();
+  void eval_linear(const double t, const size_t idx0, T *dst, std::true_type) const {
+    const size_t idx1 = idx0 + 1;
+
+    double tl = _times[idx0];
+    double tu = _times[idx1];
+
+    double dt = (t - tl);
+    if (std::fabs(tu - tl) < std::numeric_limits<double>::epsilon()) {
+      // slope is zero.
+      dt = 0.0;
+    } else {
+      dt /= (tu - tl);
     }
-    return _samples.size();
+
+    // Just in case.
+    dt = (std::max)(0.0, (std::min)(1.0, dt));
+
+    _values.interpolate(idx0, idx1, dt, dst);
+  }
+
+  // Non-interpolatable type. Return Held value.
+  void eval_linear(const double t, const size_t idx0, T *dst, std::false_type) const {
+    (void)t;
+    _values.get(idx0, dst);
   }
 
- private:
   // Need to be sorted when looking up the value.
-  mutable std::vector<Sample> _samples;
+  mutable std::vector<double> _times;
+  mutable std::vector<bool> _blocked;
+  mutable TimeSampleValueBuffer<T> _values;
   mutable bool _dirty{false};
 };
 
+///
+/// Batch evaluation: Evaluate `n` TimeSamples at time `t` into `dst[0..n)`.
+///
+/// @param[inout] cursors Optional. Array of `n` cursors(one per TimeSamples).
+/// Keep them across calls to evaluate with increasing `t`(e.g. playback)
+/// without binary search.
+///
+/// @return false when any of TimeSamples is nullptr or empty(`dst` of such
+/// TimeSamples is not modified). Other TimeSamples are still evaluated.
+///
+template <typename T>
+bool EvaluateTimeSamples(const TypedTimeSamples<T> *const *samples,
+                         const size_t n, const double t, T *dst,
+                         value::TimeSampleInterpolationType interp =
+                             value::TimeSampleInterpolationType::Linear,
+                         value::TimeSampleCursor *cursors = nullptr) {
+  if (!samples || !dst) {
+    return false;
+  }
+
+  bool ok = true;
+  for (size_t i = 0; i < n; i++) {
+    if (!samples[i] ||
+        !samples[i]->get(&dst[i], t, interp, cursors ? &cursors[i] : nullptr)) {
+      ok = false;
+    }
+  }
+
+  return ok;
+}
+
 //
 // Scalar(default) and/or TimeSamples
 //
@@ -1450,9 +1726,13 @@ struct Animatable {
   ///
   /// Get value at specific time.
   ///
+  /// @param[inout] cursor Optional lookup hint for timesamples. See
+  /// value::TimeSampleCursor.
+  ///
   bool get(double t, T *v,
            const value::TimeSampleInterpolationType tinerp =
-               value::TimeSampleInterpolationType::Linear) const {
+               value::TimeSampleInterpolationType::Linear,
+           value::TimeSampleCursor *cursor = nullptr) const {
     if (!v) {
       return false;
     }
@@ -1469,7 +1749,7 @@ struct Animatable {
     }
 
     if (has_timesamples()) {
-      return _ts.get(v, t, tinerp);
+      return _ts.get(v, t, tinerp, cursor);
     }
     
     if (has_default()) {
@@ -1502,6 +1782,44 @@ struct Animatable {
     return get_scalar(v);
   }
 
+  ///
+  /// Zero-copy access to the array value at specific time(T = `U[]` only).
+  ///
+  /// Returns false when the value needs to be interpolated from timesamples.
+  /// Use get() in that case. See TypedTimeSamples::get_array_view.
+  ///
+  template <typename U = T>
+  bool get_array_view(double t, value::ArrayView<typename U::value_type> *v,
+                      const value::TimeSampleInterpolationType tinerp =
+                          value::TimeSampleInterpolationType::Linear,
+                      value::TimeSampleCursor *cursor = nullptr) const {
+    if (!v) {
+      return false;
+    }
+
+    if (is_blocked()) {
+      return false;
+    }
+
+    if (value::TimeCode(t).is_default()) {
+      if (has_value()) {
+        (*v) = value::ArrayView<typename U::value_type>(_value);
+        return true;
+      }
+    }
+
+    if (has_timesamples()) {
+      return _ts.get_array_view(v, t, tinerp, cursor);
+    }
+
+    if (has_default()) {
+      (*v) = value::ArrayView<typename U::value_type>(_value);
+      return true;
+    }
+
+    return false;
+  }
+
   // TimeSamples
   // void set(double t, const T &v);
 
@@ -1510,6 +1828,9 @@ struct Animatable {
   // Add None(ValueBlock) sample to timesamples
   void add_blocked_sample(const double t) { _ts.add_blocked_sample(t); }
 
+  // Reserve the storage for `n` timesamples.
+  void reserve_timesamples(const size_t n) { _ts.reserve(n); }
+
   // Scalar
   void set(const T &v) {
     _value = v;
@@ -1542,7 +1863,7 @@ struct Animatable {
   }
 
   void clear_timesamples() {
-    _ts.samples().clear();
+    _ts.clear();
   }
 
   bool has_value() const {
@@ -1627,6 +1948,15 @@ class TypedAttribute {
     return false;
   }
 
+  // Access the value without copying. Returns nullptr when no value is
+  // assigned. The pointer is valid until the attribute is modified.
+  const T *get_value_ptr() const {
+    if (_attrib) {
+      return &_attrib.value();
+    }
+    return nullptr;
+  }
+
   bool is_blocked() const { return _blocked; }
 
   // for `uniform` attribute only
@@ -2587,6 +2917,20 @@ class Attribute {
     return get_value(dst);
   }
 
+  ///
+  /// Zero-copy access to the array value(`T[]`) at specified time.
+  /// No copy, so prefer this over `get()` to read large arrays(e.g. `points`).
+  ///
+  /// Returns false when the value needs to be interpolated from timesamples
+  /// or type mismatch. `dst` is valid until the attribute is modified.
+  ///
+  template <typename T>
+  bool get_array_view(const double t, value::ArrayView<T> *dst,
+                      value::TimeSampleInterpolationType tinterp =
+                          value::TimeSampleInterpolationType::Linear) const {
+    return _var.get_array_view(t, dst, tinterp);
+  }
+
   // TODO: Deprecate 'get_value' API
   template <typename T>
   bool get_value(const double t, T *dst,
@@ -3649,6 +3993,15 @@ class Prim {
   bool replace_child(const std::string &child_prim_name, Prim &&prim,
                      std::string *err = nullptr);
 
+  ///
+  /// Remove child Prim whose elementName is `child_prim_name`.
+  ///
+  /// @return true Upon success. false when no child Prim with elementName
+  /// `child_prim_name` exists.
+  ///
+  bool remove_child(const std::string &child_prim_name,
+                    std::string *err = nullptr);
+
 #if 0
   ///
   /// Add Prim as a child.
@@ -4239,7 +4592,10 @@ class Layer {
 
   void set_name(const std::string name) { _name = name; }
 
-  void clear_primspecs() { _prim_specs.clear(); }
+  void clear_primspecs() {
+    _prim_specs.clear();
+    _primspec_index.invalidate();
+  }
 
   // Check if `primname` exists in root Prims?
   bool has_primspec(const std::string &primname) const {
@@ -4266,7 +4622,8 @@ class Layer {
       return false;
     }
 
-    _prim_specs.emplace(name, ps);
+    auto it = _prim_specs.emplace(name, ps).first;
+    add_primspec_index("/" + name, it->second);
 
     return true;
   }
@@ -4291,7 +4648,8 @@ class Layer {
       return false;
     }
 
-    _prim_specs.emplace(name, std::move(ps));
+    auto it = _prim_specs.emplace(name, std::move(ps)).first;
+    add_primspec_index("/" + name, it->second);
 
     return true;
   }
@@ -4316,7 +4674,10 @@ class Layer {
       return false;
     }
 
-    _prim_specs.at(name) = ps;
+    PrimSpec &dst = _prim_specs.at(name);
+    remove_primspec_index("/" + name, dst);
+    dst = ps;
+    add_primspec_index("/" + name, dst);
 
     return true;
   }
@@ -4341,7 +4702,27 @@ class Layer {
       return false;
     }
 
-    _prim_specs.at(name) = std::move(ps);
+    PrimSpec &dst = _prim_specs.at(name);
+    remove_primspec_index("/" + name, dst);
+    dst = std::move(ps);
+    add_primspec_index("/" + name, dst);
+
+    return true;
+  }
+
+  ///
+  /// Remove root PrimSpec.
+  ///
+  /// @return false when `name` does not exist in `primspecs`.
+  ///
+  bool remove_primspec(const std::string &name) {
+    auto it = _prim_specs.find(name);
+    if (it == _prim_specs.end()) {
+      return false;
+    }
+
+    remove_primspec_index("/" + name, it->second);
+    _prim_specs.erase(it);
 
     return true;
   }
@@ -4350,7 +4731,14 @@ class Layer {
     return _prim_specs;
   }
 
-  std::unordered_map<std::string, PrimSpec> &primspecs() { return _prim_specs; }
+  ///
+  /// PrimSpec tree may be modified through the returned reference, so the
+  /// PrimSpec path index for `find_primspec_at` is invalidated.
+  ///
+  std::unordered_map<std::string, PrimSpec> &primspecs() {
+    _primspec_index.invalidate();
+    return _prim_specs;
+  }
 
   const LayerMetas &metas() const { return _metas; }
   LayerMetas &metas() { return _metas; }
@@ -4434,12 +4822,39 @@ class Layer {
   ///
   /// Find a PrimSpec at `path` and returns it if found.
   ///
+  /// Path to PrimSpec index is built at the first call(and after the Layer is
+  /// modified), so the lookup is O(1) on average.
+  ///
   /// @param[in] path PrimSpec path to find.
   /// @param[out] ps Pointer to PrimSpec pointer
   /// @param[out] err Error message
   ///
   bool find_primspec_at(const Path &path, const PrimSpec **ps, std::string *err) const;
 
+  ///
+  /// Invalidate PrimSpec path index used in `find_primspec_at`.
+  ///
+  /// Layer's modifier methods keep the index up to date, but you need to call
+  /// this when modifying PrimSpec tree through the reference obtained before
+  /// calling `find_primspec_at`(e.g. `primspecs()`).
+  ///
+  void invalidate_primspec_index() const { _primspec_index.invalidate(); }
+
+  ///
+  /// Update PrimSpec path index incrementally when the subtree of PrimSpec
+  /// `ps`(at `prim_path`, e.g. "/root/child") in this Layer is modified in
+  /// place. Call `remove_primspec_index` before the modification and
+  /// `add_primspec_index` after it. `ps` itself must not be moved(e.g.
+  /// modifying `children()` of the parent PrimSpec).
+  ///
+  /// The cost is O(# of PrimSpecs in the subtree). No-op when the index is
+  /// not built yet.
+  ///
+  void remove_primspec_index(const std::string &prim_path,
+                             const PrimSpec &ps) const;
+  void add_primspec_index(const std::string &prim_path,
+                          const PrimSpec &ps) const;
+
 
   ///
   /// Set state for AssetResolution in the subsequent composition operation.
@@ -4477,10 +4892,34 @@ class Layer {
   mutable std::mutex _mutex;
 #endif
 
-  // Cached primspec path.
-  // key : prim_part string (e.g. "/path/bora")
-  mutable std::map<std::string, const PrimSpec *> _primspec_path_cache;
-  mutable bool _dirty{true};
+  // Cached PrimSpec path index.
+  // Pointers refer to PrimSpecs in this Layer, so the index is not copied.
+  struct PrimSpecPathIndex {
+    PrimSpecPathIndex() = default;
+    PrimSpecPathIndex(const PrimSpecPathIndex &) {}
+    PrimSpecPathIndex &operator=(const PrimSpecPathIndex &) {
+      invalidate();
+      return *this;
+    }
+
+    // Not thread-safe. Layer must not be read concurrently while modifying it.
+    void invalidate() {
+      if (!dirty.load(std::memory_order_relaxed)) {
+        index.clear();
+        dirty.store(true, std::memory_order_relaxed);
+      }
+    }
+
+    // key : prim_part string (e.g. "/path/bora")
+    std::unordered_map<std::string, const PrimSpec *> index;
+
+    // The index is lazily built in const `find_primspec_at`, which may be
+    // called concurrently.
+    std::atomic<bool> dirty{true};
+    std::mutex mutex;
+  };
+
+  mutable PrimSpecPathIndex _primspec_index;
 
   // Cached flags for composition.
   // true by default even PrimSpec tree does not contain any `references`, `payload`, etc.
@@ -34,53 +34,42 @@ bool PrimVar::get_interpolated_value(const double t, const value::TimeSampleInte
   }
 
   if (has_timesamples()) {
-    const std::vector<value::TimeSamples::Sample> &samples = _ts.get_samples();
+    const std::vector<double> &times = _ts.get_times();
+    const std::vector<value::Value> &values = _ts.get_values();
 
-    if (samples.empty()) {
+    if (times.empty()) {
       // ???
       return false;
     }
 
     if (value::TimeCode(t).is_default())  {
       // FIXME: Use the first item for now.
-      if (samples[0].blocked) {
+      if (_ts.is_blocked(0)) {
         return false;
       }
 
-      (*dst) = samples[0].value;
+      (*dst) = values[0];
       return true;
     } else {
 
       if (tinterp == value::TimeSampleInterpolationType::Held || !value::IsLerpSupportedType(_value.type_id())) {
 
-        auto it = std::upper_bound(
-          samples.begin(), samples.end(), t,
-          [](double tval, const value::TimeSamples::Sample &a) { return tval < a.t; });
+        size_t idx = _ts.upper_bound_index(t);
+        idx = (idx == 0) ? 0 : (idx - 1);
 
-        const auto it_minus_1 = (it == samples.begin()) ? samples.begin() : (it - 1);
-
-        (*dst) = it_minus_1->value;
+        (*dst) = values[idx];
         return true;
 
       } else { // Lerp 
 
         // TODO: Unify code in prim-types.hh
-        auto it = std::lower_bound(
-            samples.begin(), samples.end(), t,
-            [](const value::TimeSamples::Sample &a, double tval) { return a.t < tval; });
-
-        const auto it_minus_1 = (it == samples.begin()) ? samples.begin() : (it - 1);
+        const size_t idx = _ts.lower_bound_index(t);
 
-        size_t idx0 = size_t(std::max(
-            int64_t(0),
-            std::min(int64_t(samples.size() - 1),
-                     int64_t(std::distance(samples.begin(), it_minus_1)))));
-        size_t idx1 =
-            size_t(std::max(int64_t(0), std::min(int64_t(samples.size() - 1),
-                                                 int64_t(idx0) + 1)));
+        size_t idx0 = (std::min)(times.size() - 1, (idx == 0) ? 0 : (idx - 1));
+        size_t idx1 = (std::min)(times.size() - 1, idx0 + 1);
 
-        double tl = samples[idx0].t;
-        double tu = samples[idx1].t;
+        double tl = times[idx0];
+        double tu = times[idx1];
 
         double dt = (t - tl);
         if (std::fabs(tu - tl) < std::numeric_limits<double>::epsilon()) {
@@ -93,8 +82,8 @@ bool PrimVar::get_interpolated_value(const double t, const value::TimeSampleInte
         // Just in case.
         dt = std::max(0.0, std::min(1.0, dt));
 
-        const value::Value &p0 = samples[idx0].value;
-        const value::Value &p1 = samples[idx1].value;
+        const value::Value &p0 = values[idx0];
+        const value::Value &p1 = values[idx1];
 
         bool ret = value::Lerp(p0, p1, dt, dst);
         return ret;
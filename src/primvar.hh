@@ -161,8 +161,12 @@ struct PrimVar {
   }
 
   nonstd::optional<value::TimeSamples::Sample> get_timesample(size_t idx) const {
-    if (idx < _ts.get_samples().size()) {
-      return _ts.get_samples()[idx];
+    if (idx < _ts.size()) {
+      value::TimeSamples::Sample s;
+      s.t = _ts.get_times()[idx];
+      s.value = _ts.get_values()[idx];
+      s.blocked = _ts.is_blocked(idx);
+      return s;
     }
     return nonstd::nullopt;
   }
@@ -191,11 +195,11 @@ struct PrimVar {
       return nonstd::nullopt;
     }
 
-    if (idx >= _ts.get_samples().size()) {
+    if (idx >= _ts.size()) {
       return nonstd::nullopt;
     }
 
-    return _ts.get_samples()[idx].blocked;
+    return _ts.is_blocked(idx);
   }
 
   // For Scalar only
@@ -317,6 +321,51 @@ struct PrimVar {
     return false;
   }
 
+  ///
+  /// Zero-copy access to the array value(`T[]`) at specified time.
+  ///
+  /// Returns false when the value needs to be interpolated from timesamples.
+  /// Use get_interpolated_value() in that case.
+  ///
+  template <typename T>
+  bool get_array_view(const double t, value::ArrayView<T> *v,
+                      const value::TimeSampleInterpolationType tinterp =
+                          value::TimeSampleInterpolationType::Linear) const {
+    if (!v) {
+      return false;
+    }
+
+    if (is_blocked()) {
+      return false;
+    }
+
+    if (value::TimeCode(t).is_default()) {
+      if (has_default()) {
+        if (auto pv = _value.get_array_view<T>()) {
+          (*v) = pv.value();
+          return true;
+        }
+      }
+
+      if (_ts.empty()) {
+        return false;
+      }
+    }
+
+    if (has_timesamples()) {
+      return _ts.get_array_view(v, t, tinterp);
+    }
+
+    if (has_default()) {
+      if (auto pv = _value.get_array_view<T>()) {
+        (*v) = pv.value();
+        return true;
+      }
+    }
+
+    return false;
+  }
+
   size_t num_timesamples() const {
     if (has_timesamples()) {
       return _ts.size();
@@ -85,6 +85,19 @@ nonstd::optional<const Prim *> GetPrimAtPathRec(const Prim *parent,
   return nonstd::nullopt;
 }
 
+void BuildPrimPathCacheRec(const Prim &prim, const std::string &parent_path,
+                           std::map<std::string, const Prim *> &cache) {
+  std::string abs_path =
+      parent_path + "/" + prim.element_path().prim_part();
+
+  // Keep the first one in depth-first order(same as GetPrimAtPathRec)
+  cache.emplace(abs_path, &prim);
+
+  for (const auto &child : prim.children()) {
+    BuildPrimPathCacheRec(child, abs_path, cache);
+  }
+}
+
 }  // namespace
 
 //
@@ -145,6 +158,16 @@ nonstd::expected<const Prim *, std::string> Stage::GetPrimAtPath(
                                  "> in the Stage.\n");
 }
 
+void Stage::build_prim_path_cache() const {
+  _prim_path_cache.clear();
+
+  for (const auto &root : _root_nodes) {
+    BuildPrimPathCacheRec(root, /* root */ "", _prim_path_cache);
+  }
+
+  _dirty = false;
+}
+
 bool Stage::find_prim_at_path(const Path &path, const Prim *&prim,
                               std::string *err) const {
   nonstd::expected<const Prim *, std::string> ret = GetPrimAtPath(path);
@@ -750,6 +773,99 @@ bool Stage::replace_root_prim(const std::string &prim_name, Prim &&prim) {
   return true;
 }
 
+bool Stage::replace_prim_at_path(const Path &path, Prim &&prim) {
+  if (!path.is_valid() || !path.is_absolute_path()) {
+    PUSH_ERROR_AND_RETURN(
+        fmt::format("Invalid Prim path: {}", path.full_path_name()));
+  }
+
+  const std::string &prim_part = path.prim_part();
+  const size_t pos = prim_part.find_last_of('/');
+  const std::string parent_path = prim_part.substr(0, pos);
+  const std::string prim_name = prim_part.substr(pos + 1);
+
+  if (parent_path.empty()) {
+    return replace_root_prim(prim_name, std::move(prim));
+  }
+
+  nonstd::expected<const Prim *, std::string> parent =
+      GetPrimAtPath(Path(parent_path, ""));
+  if (!parent) {
+    PUSH_ERROR_AND_RETURN(
+        fmt::format("Parent Prim not found for `{}`", prim_part));
+  }
+
+#if defined(TINYUSDZ_ENABLE_THREAD)
+  // TODO: Only take a lock when dirty.
+  std::lock_guard<std::mutex> lock(_mutex);
+#endif
+
+  // Prim is owned by this Stage.
+  Prim *parent_prim = const_cast<Prim *>(parent.value());
+
+  std::string err;
+  if (!parent_prim->replace_child(prim_name, std::move(prim), &err)) {
+    PUSH_ERROR_AND_RETURN(err);
+  }
+
+  _dirty = true;
+
+  return true;
+}
+
+bool Stage::remove_prim_at_path(const Path &path) {
+  if (!path.is_valid() || !path.is_absolute_path()) {
+    PUSH_ERROR_AND_RETURN(
+        fmt::format("Invalid Prim path: {}", path.full_path_name()));
+  }
+
+  const std::string &prim_part = path.prim_part();
+  const size_t pos = prim_part.find_last_of('/');
+  const std::string parent_path = prim_part.substr(0, pos);
+  const std::string prim_name = prim_part.substr(pos + 1);
+
+  const Prim *parent_ptr{nullptr};
+  if (parent_path.size()) {
+    nonstd::expected<const Prim *, std::string> parent =
+        GetPrimAtPath(Path(parent_path, ""));
+    if (!parent) {
+      PUSH_ERROR_AND_RETURN(
+          fmt::format("Parent Prim not found for `{}`", prim_part));
+    }
+    parent_ptr = parent.value();
+  }
+
+#if defined(TINYUSDZ_ENABLE_THREAD)
+  // TODO: Only take a lock when dirty.
+  std::lock_guard<std::mutex> lock(_mutex);
+#endif
+
+  if (parent_ptr) {
+    // Prim is owned by this Stage.
+    Prim *parent_prim = const_cast<Prim *>(parent_ptr);
+
+    std::string err;
+    if (!parent_prim->remove_child(prim_name, &err)) {
+      PUSH_ERROR_AND_RETURN(err);
+    }
+  } else {
+    auto result = std::find_if(
+        _root_nodes.begin(), _root_nodes.end(),
+        [&prim_name](const Prim &p) { return (p.element_name() == prim_name); });
+    if (result == _root_nodes.end()) {
+      PUSH_ERROR_AND_RETURN(fmt::format("Prim not found: {}", prim_part));
+    }
+
+    _root_nodes.erase(result);
+    _root_node_nameSet.erase(prim_name);
+  }
+
+  _dirty = true;
+  _prim_id_dirty = true;
+
+  return true;
+}
+
 namespace {
 
 std::string DumpPrimTreeRec(const Prim &prim, uint32_t depth) {
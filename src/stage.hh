@@ -87,6 +87,15 @@ class Stage {
   bool find_prim_at_path(const Path &path, int64_t *prim_id,
                          std::string *err = nullptr) const;
 
+  ///
+  /// Build the cache of Prim path -> Prim for all Prims in the Stage.
+  ///
+  /// After this call, `GetPrimAtPath` and `find_prim_at_path(path, prim)` do
+  /// not modify the Stage until the content of the Stage is changed, so they
+  /// can be called from multiple threads.
+  ///
+  void build_prim_path_cache() const;
+
   /// Find(Get) Prim from a relative Path.
   /// Path must be relative Path.
   ///
@@ -152,6 +161,28 @@ class Stage {
   ///
   bool replace_root_prim(const std::string &prim_name, Prim &&prim);
 
+  ///
+  /// Replace Prim at `path` with `prim`. `prim` is added when no Prim exists
+  /// at `path`(its parent Prim must exist).
+  ///
+  /// `prim`'s elementName will be modified to the element name of `path`.
+  /// Call `commit()`(or `compute_absolute_prim_path_and_assign_prim_id()`)
+  /// after modifying Prims to update absolute path and Prim id of Prims.
+  ///
+  /// @return true Upon success. false when failed to replace Prim(e.g. parent
+  /// Prim not found). Error message can be retrieved using `get_error()`.
+  ///
+  bool replace_prim_at_path(const Path &path, Prim &&prim);
+
+  ///
+  /// Remove Prim(and its descendants) at `path`.
+  ///
+  /// Prim id of removed Prims is not released.
+  ///
+  /// @return true Upon success. false when Prim is not found at `path`.
+  ///
+  bool remove_prim_at_path(const Path &path);
+
   ///
   /// @brief Get Stage metadatum
   ///
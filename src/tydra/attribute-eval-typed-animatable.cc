@@ -180,9 +180,9 @@ template<> bool EvaluateTypedAnimatableAttribute<std::string>(
     }
 
   } else {
-    Animatable<std::string> value;
-    if (tattr.get_value(&value)) {
-      if (value.get(t, value_out, tinterp)) {
+    // Evaluate in-place to avoid copying all timesamples.
+    if (const Animatable<std::string> *pv = tattr.get_value_ptr()) {
+      if (pv->get(t, value_out, tinterp)) {
         return true;
       } else {
         if (err) {
@@ -223,9 +223,9 @@ bool EvaluateTypedAnimatableAttribute(
     }
     return false;
   } else if (tattr.has_value()) {
-    Animatable<T> value;
-    if (tattr.get_value(&value)) {
-      if (value.get(t, value_out, tinterp)) {
+    // Evaluate in-place to avoid copying all timesamples.
+    if (const Animatable<T> *pv = tattr.get_value_ptr()) {
+      if (pv->get(t, value_out, tinterp)) {
         return true;
       } else {
         if (err) {
@@ -254,5 +254,47 @@ template<> bool EvaluateTypedAnimatableAttribute(
 
 #undef EXTERN_EVALUATE_TYPED_ATTRIBUTE
 
+///
+/// Zero-copy variant of EvaluateTypedAnimatableAttribute for array
+/// attribute(e.g. `points`).
+///
+/// `view` points to the storage of `attr` when the value at `t` is directly
+/// available(no connection and no interpolation required). Otherwise the value
+/// is evaluated into `buf` and `view` points to `buf`.
+///
+template<typename T>
+bool EvaluateTypedAnimatableAttributeView(
+    const tinyusdz::Stage &stage,
+    const TypedAttribute<Animatable<std::vector<T>>> &attr,
+    const std::string &attr_name,
+    value::ArrayView<T> *view,
+    std::vector<T> *buf,
+    std::string *err, const double t = tinyusdz::value::TimeCode::Default(),
+    const tinyusdz::value::TimeSampleInterpolationType tinterp =
+        tinyusdz::value::TimeSampleInterpolationType::Linear) {
+  if (!view || !buf) {
+    if (err) {
+      (*err) += "`view` or `buf` param is nullptr.\n";
+    }
+    return false;
+  }
+
+  if (!attr.is_blocked()) {
+    if (const Animatable<std::vector<T>> *pv = attr.get_value_ptr()) {
+      if (pv->get_array_view(t, view, tinterp)) {
+        return true;
+      }
+    }
+  }
+
+  if (!EvaluateTypedAnimatableAttribute(stage, attr, attr_name, buf, err, t,
+                                        tinterp)) {
+    return false;
+  }
+
+  (*view) = value::ArrayView<T>(*buf);
+  return true;
+}
+
 }  // namespace tydra
 }  // namespace tinyusdz
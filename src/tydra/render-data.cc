@@ -26,6 +26,7 @@
 //     indices/weights, BlendShape points, ...) as much as possible.
 //     - Implement spatial hash
 //
+#include <memory>
 #include <numeric>
 
 #include "image-loader.hh"
@@ -33,6 +34,7 @@
 #include "image-types.hh"
 #include "linear-algebra.hh"
 #include "math-util.inc"
+#include "parallel-util.hh"
 #include "pprinter.hh"
 #include "prim-types.hh"
 #include "str-util.hh"
@@ -41,6 +43,7 @@
 #include "usdGeom.hh"
 #include "usdShade.hh"
 #include "value-pprint.hh"
+#include "value-type-dispatch.hh"
 
 #if defined(TINYUSDZ_WITH_COLORIO)
 #include "external/tiny-color-io.h"
@@ -1289,6 +1292,118 @@ bool ArrayValueToVertexAttribute(
       value.underlying_type_name()));
 }
 
+template <typename T>
+struct VertexAttributeFormatTraits;
+
+#define VERTEX_ATTRIBUTE_FORMAT_TRAITS(__ty, __vfmt)  \
+  template <>                                         \
+  struct VertexAttributeFormatTraits<__ty> {          \
+    static constexpr VertexAttributeFormat format() { \
+      return __vfmt;                                  \
+    }                                                 \
+  };
+
+VERTEX_ATTRIBUTE_FORMAT_TRAITS(uint8_t, VertexAttributeFormat::Byte)
+VERTEX_ATTRIBUTE_FORMAT_TRAITS(value::uchar2, VertexAttributeFormat::Byte2)
+VERTEX_ATTRIBUTE_FORMAT_TRAITS(value::uchar3, VertexAttributeFormat::Byte3)
+VERTEX_ATTRIBUTE_FORMAT_TRAITS(value::uchar4, VertexAttributeFormat::Byte4)
+VERTEX_ATTRIBUTE_FORMAT_TRAITS(char, VertexAttributeFormat::Char)
+VERTEX_ATTRIBUTE_FORMAT_TRAITS(value::char2, VertexAttributeFormat::Char2)
+VERTEX_ATTRIBUTE_FORMAT_TRAITS(value::char3, VertexAttributeFormat::Char3)
+VERTEX_ATTRIBUTE_FORMAT_TRAITS(value::char4, VertexAttributeFormat::Char4)
+VERTEX_ATTRIBUTE_FORMAT_TRAITS(short, VertexAttributeFormat::Short)
+VERTEX_ATTRIBUTE_FORMAT_TRAITS(value::short2, VertexAttributeFormat::Short2)
+VERTEX_ATTRIBUTE_FORMAT_TRAITS(value::short3, VertexAttributeFormat::Short3)
+VERTEX_ATTRIBUTE_FORMAT_TRAITS(value::short4, VertexAttributeFormat::Short4)
+VERTEX_ATTRIBUTE_FORMAT_TRAITS(uint16_t, VertexAttributeFormat::Ushort)
+VERTEX_ATTRIBUTE_FORMAT_TRAITS(value::ushort2, VertexAttributeFormat::Ushort2)
+VERTEX_ATTRIBUTE_FORMAT_TRAITS(value::ushort3, VertexAttributeFormat::Ushort3)
+VERTEX_ATTRIBUTE_FORMAT_TRAITS(value::ushort4, VertexAttributeFormat::Ushort4)
+VERTEX_ATTRIBUTE_FORMAT_TRAITS(int, VertexAttributeFormat::Int)
+VERTEX_ATTRIBUTE_FORMAT_TRAITS(value::int2, VertexAttributeFormat::Ivec2)
+VERTEX_ATTRIBUTE_FORMAT_TRAITS(value::int3, VertexAttributeFormat::Ivec3)
+VERTEX_ATTRIBUTE_FORMAT_TRAITS(value::int4, VertexAttributeFormat::Ivec4)
+VERTEX_ATTRIBUTE_FORMAT_TRAITS(uint32_t, VertexAttributeFormat::Uint)
+VERTEX_ATTRIBUTE_FORMAT_TRAITS(value::uint2, VertexAttributeFormat::Uvec2)
+VERTEX_ATTRIBUTE_FORMAT_TRAITS(value::uint3, VertexAttributeFormat::Uvec3)
+VERTEX_ATTRIBUTE_FORMAT_TRAITS(value::uint4, VertexAttributeFormat::Uvec4)
+VERTEX_ATTRIBUTE_FORMAT_TRAITS(float, VertexAttributeFormat::Float)
+VERTEX_ATTRIBUTE_FORMAT_TRAITS(value::float2, VertexAttributeFormat::Vec2)
+VERTEX_ATTRIBUTE_FORMAT_TRAITS(value::float3, VertexAttributeFormat::Vec3)
+VERTEX_ATTRIBUTE_FORMAT_TRAITS(value::float4, VertexAttributeFormat::Vec4)
+VERTEX_ATTRIBUTE_FORMAT_TRAITS(value::half, VertexAttributeFormat::Half)
+VERTEX_ATTRIBUTE_FORMAT_TRAITS(value::half2, VertexAttributeFormat::Half2)
+VERTEX_ATTRIBUTE_FORMAT_TRAITS(value::half3, VertexAttributeFormat::Half3)
+VERTEX_ATTRIBUTE_FORMAT_TRAITS(value::half4, VertexAttributeFormat::Half4)
+VERTEX_ATTRIBUTE_FORMAT_TRAITS(double, VertexAttributeFormat::Double)
+VERTEX_ATTRIBUTE_FORMAT_TRAITS(value::double2, VertexAttributeFormat::Dvec2)
+VERTEX_ATTRIBUTE_FORMAT_TRAITS(value::double3, VertexAttributeFormat::Dvec3)
+VERTEX_ATTRIBUTE_FORMAT_TRAITS(value::double4, VertexAttributeFormat::Dvec4)
+VERTEX_ATTRIBUTE_FORMAT_TRAITS(value::matrix2f, VertexAttributeFormat::Mat2)
+VERTEX_ATTRIBUTE_FORMAT_TRAITS(value::matrix3f, VertexAttributeFormat::Mat3)
+VERTEX_ATTRIBUTE_FORMAT_TRAITS(value::matrix4f, VertexAttributeFormat::Mat4)
+VERTEX_ATTRIBUTE_FORMAT_TRAITS(value::matrix2d, VertexAttributeFormat::Dmat2)
+VERTEX_ATTRIBUTE_FORMAT_TRAITS(value::matrix3d, VertexAttributeFormat::Dmat3)
+VERTEX_ATTRIBUTE_FORMAT_TRAITS(value::matrix4d, VertexAttributeFormat::Dmat4)
+
+#undef VERTEX_ATTRIBUTE_FORMAT_TRAITS
+
+struct ToVertexAttributeArgs {
+  std::string name;
+  uint32_t elementSize;
+  VertexVariability variability;
+  uint32_t num_vertices;
+  uint32_t num_face_counts;
+  uint32_t num_face_vertex_indices;
+};
+
+// Dispatched by the underlying type of the flattened primvar value.
+template <typename T>
+struct ToVertexAttributeFn {
+  static bool call(const value::Value &value, const ToVertexAttributeArgs &args,
+                   VertexAttribute &dst, std::string *err) {
+    constexpr VertexAttributeFormat format =
+        VertexAttributeFormatTraits<T>::format();
+    if (value.type_id() & value::TYPE_ID_1D_ARRAY_BIT) {
+      return ArrayValueToVertexAttribute<std::vector<T>>(
+          value, args.name, args.elementSize, args.variability,
+          args.num_vertices, args.num_face_counts,
+          args.num_face_vertex_indices, format, dst, err);
+    } else {
+      return ScalarValueToVertexAttribute<T>(value, args.name, format, dst,
+                                             err);
+    }
+  }
+};
+
+// specialization for bool type: bool is represented as uint8 in USD primvar
+template <>
+struct ToVertexAttributeFn<bool> {
+  static bool call(const value::Value &value, const ToVertexAttributeArgs &args,
+                   VertexAttribute &dst, std::string *err) {
+    if (value.type_id() & value::TYPE_ID_1D_ARRAY_BIT) {
+      return ArrayValueToVertexAttribute<std::vector<uint8_t>>(
+          value, args.name, args.elementSize, args.variability,
+          args.num_vertices, args.num_face_counts,
+          args.num_face_vertex_indices, VertexAttributeFormat::Bool, dst, err);
+    } else {
+      return ScalarValueToVertexAttribute<uint8_t>(
+          value, args.name, VertexAttributeFormat::Bool, dst, err);
+    }
+  }
+};
+
+using ToVertexAttributeDispatcher = value::TypeIdDispatcher<
+    ToVertexAttributeFn, bool, uint8_t, value::uchar2, value::uchar3,
+    value::uchar4, char, value::char2, value::char3, value::char4, short,
+    value::short2, value::short3, value::short4, uint16_t, value::ushort2,
+    value::ushort3, value::ushort4, int, value::int2, value::int3, value::int4,
+    uint32_t, value::uint2, value::uint3, value::uint4, float, value::float2,
+    value::float3, value::float4, value::half, value::half2, value::half3,
+    value::half4, double, value::double2, value::double3, value::double4,
+    value::matrix2f, value::matrix3f, value::matrix4f, value::matrix2d,
+    value::matrix3d, value::matrix4d>;
+
 }  // namespace
 
 bool ToVertexAttribute(const GeomPrimvar &primvar, const std::string &name,
@@ -1312,8 +1427,7 @@ bool ToVertexAttribute(const GeomPrimvar &primvar, const std::string &name,
     PUSH_ERROR_AND_RETURN("Failed to flatten primvar");
   }
 
-  bool is_array = value.type_id() & value::TYPE_ID_1D_ARRAY_BIT;
-  DCOUT("is_array " << (is_array ? "true" : "false"));
+  DCOUT("is_array " << ((value.type_id() & value::TYPE_ID_1D_ARRAY_BIT) ? "true" : "false"));
 
   VertexVariability variability;
   if (primvar.get_interpolation() == Interpolation::Varying) {
@@ -1336,78 +1450,23 @@ bool ToVertexAttribute(const GeomPrimvar &primvar, const std::string &name,
                                    << value::GetTypeName(baseUnderlyingTypeId));
 
   // Cast to underlying type
-
-#define TO_TYPED_VALUE(__underlying_ty, __vfmt)                                \
-  if (baseUnderlyingTypeId == value::TypeTraits<__underlying_ty>::type_id()) { \
-    if (is_array) {                                                            \
-      return ArrayValueToVertexAttribute<std::vector<__underlying_ty>>(        \
-          value, name, elementSize, variability, num_vertices,                 \
-          num_face_counts, num_face_vertex_indices, __vfmt, dst, err);         \
-    } else {                                                                   \
-      return ScalarValueToVertexAttribute<__underlying_ty>(value, name,        \
-                                                           __vfmt, dst, err);  \
-    }                                                                          \
-  } else
-
-  // specialization for bool type: bool is represented as uint8 in USD primvar
-  if (baseUnderlyingTypeId == value::TypeTraits<bool>::type_id()) {
-    if (is_array) {
-      return ArrayValueToVertexAttribute<std::vector<uint8_t>>(
-          value, name, elementSize, variability, num_vertices, num_face_counts,
-          num_face_vertex_indices, VertexAttributeFormat::Bool, dst, err);
-    } else {
-      return ScalarValueToVertexAttribute<uint8_t>(
-          value, name, VertexAttributeFormat::Bool, dst, err);
-    }
-  } else
-    TO_TYPED_VALUE(uint8_t, VertexAttributeFormat::Byte)
-  TO_TYPED_VALUE(value::uchar2, VertexAttributeFormat::Byte2)
-  TO_TYPED_VALUE(value::uchar3, VertexAttributeFormat::Byte3)
-  TO_TYPED_VALUE(value::uchar4, VertexAttributeFormat::Byte4)
-  TO_TYPED_VALUE(char, VertexAttributeFormat::Char)
-  TO_TYPED_VALUE(value::char2, VertexAttributeFormat::Char2)
-  TO_TYPED_VALUE(value::char3, VertexAttributeFormat::Char3)
-  TO_TYPED_VALUE(value::char4, VertexAttributeFormat::Char4)
-  TO_TYPED_VALUE(short, VertexAttributeFormat::Short)
-  TO_TYPED_VALUE(value::short2, VertexAttributeFormat::Short2)
-  TO_TYPED_VALUE(value::short3, VertexAttributeFormat::Short3)
-  TO_TYPED_VALUE(value::short4, VertexAttributeFormat::Short4)
-  TO_TYPED_VALUE(uint16_t, VertexAttributeFormat::Ushort)
-  TO_TYPED_VALUE(value::ushort2, VertexAttributeFormat::Ushort2)
-  TO_TYPED_VALUE(value::ushort3, VertexAttributeFormat::Ushort3)
-  TO_TYPED_VALUE(value::ushort4, VertexAttributeFormat::Ushort4)
-  TO_TYPED_VALUE(int, VertexAttributeFormat::Int)
-  TO_TYPED_VALUE(value::int2, VertexAttributeFormat::Ivec2)
-  TO_TYPED_VALUE(value::int3, VertexAttributeFormat::Ivec3)
-  TO_TYPED_VALUE(value::int4, VertexAttributeFormat::Ivec4)
-  TO_TYPED_VALUE(uint32_t, VertexAttributeFormat::Uint)
-  TO_TYPED_VALUE(value::uint2, VertexAttributeFormat::Uvec2)
-  TO_TYPED_VALUE(value::uint3, VertexAttributeFormat::Uvec3)
-  TO_TYPED_VALUE(value::uint4, VertexAttributeFormat::Uvec4)
-  TO_TYPED_VALUE(float, VertexAttributeFormat::Float)
-  TO_TYPED_VALUE(value::float2, VertexAttributeFormat::Vec2)
-  TO_TYPED_VALUE(value::float3, VertexAttributeFormat::Vec3)
-  TO_TYPED_VALUE(value::float4, VertexAttributeFormat::Vec4)
-  TO_TYPED_VALUE(value::half, VertexAttributeFormat::Half)
-  TO_TYPED_VALUE(value::half2, VertexAttributeFormat::Half2)
-  TO_TYPED_VALUE(value::half3, VertexAttributeFormat::Half3)
-  TO_TYPED_VALUE(value::half4, VertexAttributeFormat::Half4)
-  TO_TYPED_VALUE(double, VertexAttributeFormat::Double)
-  TO_TYPED_VALUE(value::double2, VertexAttributeFormat::Dvec2)
-  TO_TYPED_VALUE(value::double3, VertexAttributeFormat::Dvec3)
-  TO_TYPED_VALUE(value::double4, VertexAttributeFormat::Dvec4)
-  TO_TYPED_VALUE(value::matrix2f, VertexAttributeFormat::Mat2)
-  TO_TYPED_VALUE(value::matrix3f, VertexAttributeFormat::Mat3)
-  TO_TYPED_VALUE(value::matrix4f, VertexAttributeFormat::Mat4)
-  TO_TYPED_VALUE(value::matrix2d, VertexAttributeFormat::Dmat2)
-  TO_TYPED_VALUE(value::matrix3d, VertexAttributeFormat::Dmat3)
-  TO_TYPED_VALUE(value::matrix4d, VertexAttributeFormat::Dmat4) {
+  ToVertexAttributeArgs args;
+  args.name = name;
+  args.elementSize = elementSize;
+  args.variability = variability;
+  args.num_vertices = num_vertices;
+  args.num_face_counts = num_face_counts;
+  args.num_face_vertex_indices = num_face_vertex_indices;
+
+  bool ret{false};
+  if (!ToVertexAttributeDispatcher::dispatch(baseUnderlyingTypeId, &ret, value,
+                                             args, dst, err)) {
     PUSH_ERROR_AND_RETURN(
         fmt::format("Unknown or unsupported data type for Geom PrimVar: {}",
                     attr.type_name()));
   }
 
-#undef TO_TYPED_VALUE
+  return ret;
 }
 
 #if 0  // TODO: Remove. The following could be done using ToVertexAttribute +
@@ -1470,7 +1529,194 @@ nonstd::expected<VertexAttribute, std::string> TriangulateGeomPrimvar(
 }
 #endif
 
+// Use threads only for a large mesh(# of faces or face vertices).
+constexpr size_t kMeshParallelMinElements = 1024 * 64;
+
 #if 1
+// How a face is triangulated.
+enum class TriangulateFaceType : uint8_t {
+  Triangle,       // as is
+  QuadDiagonal0,  // split at diagonal (0, 2)
+  QuadDiagonal1,  // split at diagonal (1, 3)
+  Fan,            // convex polygon. triangle fan from the first vertex.
+  Earcut,         // concave polygon.
+  Degenerated,
+};
+
+//
+// Polygon normal using Newell's method(not normalized).
+// Use double for accuracy. `float` precision may classify small-are polygon as
+// degenerated.
+//
+template <typename T>
+value::double3 PolygonNormal(const std::vector<T> &points,
+                             const uint32_t *face_vertex_indices,
+                             const size_t nverts) {
+  value::double3 n = {0, 0, 0};
+
+  for (size_t k = 0; k < nverts; ++k) {
+    const T &v0 = points[face_vertex_indices[k]];
+    const T &v1 = points[face_vertex_indices[(k + 1) % nverts]];
+
+    T a = {v0[0] - v1[0], v0[1] - v1[1], v0[2] - v1[2]};
+    T b = {v0[0] + v1[0], v0[1] + v1[1], v0[2] + v1[2]};
+
+    n[0] += double(a[1] * b[2]);
+    n[1] += double(a[2] * b[0]);
+    n[2] += double(a[0] * b[1]);
+  }
+
+  return n;
+}
+
+//
+// Returns the index of the first reflex(concave) vertex in the polygon, or
+// `nverts` when the polygon is convex.
+// `n` is the normal of the polygon.
+//
+template <typename T>
+size_t FindReflexVertex(const std::vector<T> &points,
+                        const uint32_t *face_vertex_indices,
+                        const size_t nverts, const value::double3 &n) {
+  for (size_t k = 0; k < nverts; k++) {
+    const T &p0 = points[face_vertex_indices[(k + nverts - 1) % nverts]];
+    const T &p1 = points[face_vertex_indices[k]];
+    const T &p2 = points[face_vertex_indices[(k + 1) % nverts]];
+
+    value::double3 e0 = {double(p1[0]) - double(p0[0]),
+                         double(p1[1]) - double(p0[1]),
+                         double(p1[2]) - double(p0[2])};
+    value::double3 e1 = {double(p2[0]) - double(p1[0]),
+                         double(p2[1]) - double(p1[1]),
+                         double(p2[2]) - double(p1[2])};
+
+    if (vdot(vcross(e0, e1), n) < 0.0) {
+      return k;
+    }
+  }
+
+  return nverts;
+}
+
+template <typename T>
+TriangulateFaceType ClassifyFace(const std::vector<T> &points,
+                                 const uint32_t *face_vertex_indices,
+                                 const size_t nverts) {
+  if (nverts == 3) {
+    return TriangulateFaceType::Triangle;
+  }
+
+  value::double3 n = PolygonNormal(points, face_vertex_indices, nverts);
+  const bool degenerated =
+      vlength(n) < std::numeric_limits<double>::epsilon();
+
+  if (nverts == 4) {
+    if (degenerated) {
+      return TriangulateFaceType::QuadDiagonal0;
+    }
+
+    // Split at the diagonal through the reflex vertex for concave quad,
+    // otherwise split at the shorter diagonal.
+    size_t r = FindReflexVertex(points, face_vertex_indices, nverts, n);
+    bool diagonal1;
+    if (r < nverts) {
+      diagonal1 = (r & 1);
+    } else {
+      const T &p0 = points[face_vertex_indices[0]];
+      const T &p1 = points[face_vertex_indices[1]];
+      const T &p2 = points[face_vertex_indices[2]];
+      const T &p3 = points[face_vertex_indices[3]];
+      diagonal1 = vlength(p3 - p1) < vlength(p2 - p0);
+    }
+
+    return diagonal1 ? TriangulateFaceType::QuadDiagonal1
+                     : TriangulateFaceType::QuadDiagonal0;
+  }
+
+  if (degenerated) {
+    return TriangulateFaceType::Degenerated;
+  }
+
+  if (FindReflexVertex(points, face_vertex_indices, nverts, n) == nverts) {
+    return TriangulateFaceType::Fan;
+  }
+
+  return TriangulateFaceType::Earcut;
+}
+
+//
+// Triangulate concave polygon using earcut.
+// Returns triangle indices(index to face vertex).
+//
+template <typename T, typename BaseTy>
+bool EarcutPolygon(const std::vector<T> &points,
+                   const uint32_t *face_vertex_indices, const size_t nverts,
+                   std::vector<uint32_t> *indices) {
+  value::double3 n =
+      vnormalize(PolygonNormal(points, face_vertex_indices, nverts));
+
+  T axis_w, axis_v, axis_u;
+  axis_w[0] = BaseTy(n[0]);
+  axis_w[1] = BaseTy(n[1]);
+  axis_w[2] = BaseTy(n[2]);
+  T a;
+  if (std::fabs(axis_w[0]) > BaseTy(0.9999999)) {  // TODO: use 1.0 - eps?
+    a = {BaseTy(0), BaseTy(1), BaseTy(0)};
+  } else {
+    a = {BaseTy(1), BaseTy(0), BaseTy(0)};
+  }
+  axis_v = vnormalize(vcross(axis_w, a));
+  axis_u = vcross(axis_w, axis_v);
+
+  using Point2D = std::array<BaseTy, 2>;
+
+  // TMW change: Find best normal and project v0x and v0y to those
+  // coordinates, instead of picking a plane aligned with an axis (which
+  // can flip polygons).
+
+  // Single polygon only(no holes)
+  std::vector<std::vector<Point2D>> polygon_2d(1);
+  std::vector<Point2D> &polyline = polygon_2d[0];
+  polyline.resize(nverts);
+
+  // Fill polygon data(world to local).
+  for (size_t k = 0; k < nverts; k++) {
+    const T &v = points[face_vertex_indices[k]];
+    polyline[k] = {vdot(v, axis_u), vdot(v, axis_v)};
+  }
+
+  (*indices) = mapbox::earcut<uint32_t>(polygon_2d);
+  //  => result = 3 * faces, clockwise
+
+  if ((indices->size() % 3) != 0) {
+    // This should not be happen, though.
+    return false;
+  }
+
+  // Keep the winding order of the input polygon.
+  if (indices->size()) {
+    BaseTy poly_area2 = BaseTy(0);
+    for (size_t k = 0; k < nverts; k++) {
+      const Point2D &p0 = polyline[k];
+      const Point2D &p1 = polyline[(k + 1) % nverts];
+      poly_area2 += p0[0] * p1[1] - p1[0] * p0[1];
+    }
+
+    const Point2D &p0 = polyline[(*indices)[0]];
+    const Point2D &p1 = polyline[(*indices)[1]];
+    const Point2D &p2 = polyline[(*indices)[2]];
+    BaseTy tri_area2 = (p1[0] - p0[0]) * (p2[1] - p0[1]) -
+                       (p2[0] - p0[0]) * (p1[1] - p0[1]);
+    if ((tri_area2 < BaseTy(0)) != (poly_area2 < BaseTy(0))) {
+      for (size_t k = 0; k < indices->size(); k += 3) {
+        std::swap((*indices)[k + 1], (*indices)[k + 2]);
+      }
+    }
+  }
+
+  return true;
+}
+
 ///
 /// Input: points, faceVertexCounts, faceVertexIndices
 /// Output: triangulated faceVertexCounts(all filled with 3), triangulated
@@ -1487,6 +1733,11 @@ nonstd::expected<VertexAttribute, std::string> TriangulateGeomPrimvar(
 /// from triangles(`faceVertexCounts` are all filled with 3) Return false when a
 /// polygon is degenerated. No overlap check at the moment
 ///
+/// Quads are split at the shorter diagonal(or at the reflex vertex for concave
+/// quad), convex polygons are triangulated as a triangle fan. earcut is only
+/// used for concave polygons. Faces are triangulated concurrently for a large
+/// mesh.
+///
 /// Example:
 ///   - faceVertexCounts = [4]
 ///   - faceVertexIndices = [0, 1, 3, 2]
@@ -1504,16 +1755,20 @@ bool TriangulatePolygon(
     std::vector<uint32_t> &triangulatedFaceVertexCounts,
     std::vector<uint32_t> &triangulatedFaceVertexIndices,
     std::vector<size_t> &triangulatedToOrigFaceVertexIndexMap,
-    std::vector<uint32_t> &triangulatedFaceCounts, std::string &err) {
+    std::vector<uint32_t> &triangulatedFaceCounts, std::string &err,
+    const int num_threads = 1) {
   triangulatedFaceVertexCounts.clear();
   triangulatedFaceVertexIndices.clear();
 
   triangulatedToOrigFaceVertexIndexMap.clear();
 
-  size_t faceIndexOffset = 0;
+  const size_t num_faces = faceVertexCounts.size();
 
-  // For each polygon(face)
-  for (size_t i = 0; i < faceVertexCounts.size(); i++) {
+  // Offset to faceVertexIndices for each face.
+  std::vector<size_t> face_offsets(num_faces + 1);
+  face_offsets[0] = 0;
+
+  for (size_t i = 0; i < num_faces; i++) {
     uint32_t npolys = faceVertexCounts[i];
 
     if (npolys < 3) {
@@ -1524,7 +1779,7 @@ bool TriangulatePolygon(
       return false;
     }
 
-    if (faceIndexOffset + npolys > faceVertexIndices.size()) {
+    if (face_offsets[i] + npolys > faceVertexIndices.size()) {
       err = fmt::format(
           "Invalid faceVertexIndices or faceVertexCounts. faceVertex index "
           "exceeds faceVertexIndices.size() at [{}]\n",
@@ -1532,179 +1787,170 @@ bool TriangulatePolygon(
       return false;
     }
 
-    if (npolys == 3) {
-      // No need for triangulation.
-      triangulatedFaceVertexCounts.push_back(3);
-      triangulatedFaceVertexIndices.push_back(
-          faceVertexIndices[faceIndexOffset + 0]);
-      triangulatedFaceVertexIndices.push_back(
-          faceVertexIndices[faceIndexOffset + 1]);
-      triangulatedFaceVertexIndices.push_back(
-          faceVertexIndices[faceIndexOffset + 2]);
-      triangulatedToOrigFaceVertexIndexMap.push_back(faceIndexOffset + 0);
-      triangulatedToOrigFaceVertexIndexMap.push_back(faceIndexOffset + 1);
-      triangulatedToOrigFaceVertexIndexMap.push_back(faceIndexOffset + 2);
-      triangulatedFaceCounts.push_back(1);
-#if 1
-    } else if (npolys == 4) {
-      // Use simple split
-      // TODO: Split at shortest edge for better triangulation.
-      triangulatedFaceVertexCounts.push_back(3);
-      triangulatedFaceVertexCounts.push_back(3);
-
-      triangulatedFaceVertexIndices.push_back(
-          faceVertexIndices[faceIndexOffset + 0]);
-      triangulatedFaceVertexIndices.push_back(
-          faceVertexIndices[faceIndexOffset + 1]);
-      triangulatedFaceVertexIndices.push_back(
-          faceVertexIndices[faceIndexOffset + 2]);
-
-      triangulatedFaceVertexIndices.push_back(
-          faceVertexIndices[faceIndexOffset + 0]);
-      triangulatedFaceVertexIndices.push_back(
-          faceVertexIndices[faceIndexOffset + 2]);
-      triangulatedFaceVertexIndices.push_back(
-          faceVertexIndices[faceIndexOffset + 3]);
-
-      triangulatedToOrigFaceVertexIndexMap.push_back(faceIndexOffset + 0);
-      triangulatedToOrigFaceVertexIndexMap.push_back(faceIndexOffset + 1);
-      triangulatedToOrigFaceVertexIndexMap.push_back(faceIndexOffset + 2);
-      triangulatedToOrigFaceVertexIndexMap.push_back(faceIndexOffset + 0);
-      triangulatedToOrigFaceVertexIndexMap.push_back(faceIndexOffset + 2);
-      triangulatedToOrigFaceVertexIndexMap.push_back(faceIndexOffset + 3);
-      triangulatedFaceCounts.push_back(2);
-#endif
-    } else {
-      // Use double for accuracy. `float` precision may classify small-are polygon as degenerated.
-      // Find the normal axis of the polygon using Newell's method
-      value::double3 n = {0, 0, 0};
-
-      size_t vi0;
-      size_t vi0_2;
-
-      for (size_t k = 0; k < npolys; ++k) {
-        vi0 = faceVertexIndices[faceIndexOffset + k];
-
-        size_t j = (k + 1) % npolys;
-        vi0_2 = faceVertexIndices[faceIndexOffset + j];
-
-        if (vi0 >= points.size()) {
-          err = fmt::format("Invalid vertex index.\n");
-          return false;
-        }
-
-        if (vi0_2 >= points.size()) {
-          err = fmt::format("Invalid vertex index.\n");
-          return false;
-        }
-
-        T v0 = points[vi0];
-        T v1 = points[vi0_2];
-
-        const T point1 = {v0[0], v0[1], v0[2]};
-        const T point2 = {v1[0], v1[1], v1[2]};
-
-        T a = {point1[0] - point2[0], point1[1] - point2[1],
-               point1[2] - point2[2]};
-        T b = {point1[0] + point2[0], point1[1] + point2[1],
-               point1[2] + point2[2]};
-
-        n[0] += double(a[1] * b[2]);
-        n[1] += double(a[2] * b[0]);
-        n[2] += double(a[0] * b[1]);
-        DCOUT("v0 " << v0);
-        DCOUT("v1 " << v1);
-        DCOUT("n " << n);
-      }
-      //BaseTy length_n = vlength(n);
-      double length_n = vlength(n);
-
-      // Check if zero length normal
-      if (std::fabs(length_n) < std::numeric_limits<double>::epsilon()) {
-        DCOUT("length_n " << length_n);
-        err = "Degenerated polygon found.\n";
-        return false;
-      }
-
-      // Negative is to flip the normal to the correct direction
-      n = vnormalize(n);
-
-      T axis_w, axis_v, axis_u;
-      axis_w[0] = BaseTy(n[0]);
-      axis_w[1] = BaseTy(n[1]);
-      axis_w[2] = BaseTy(n[2]);
-      T a;
-      if (std::fabs(axis_w[0]) > BaseTy(0.9999999)) {  // TODO: use 1.0 - eps?
-        a = {BaseTy(0), BaseTy(1), BaseTy(0)};
-      } else {
-        a = {BaseTy(1), BaseTy(0), BaseTy(0)};
-      }
-      axis_v = vnormalize(vcross(axis_w, a));
-      axis_u = vcross(axis_w, axis_v);
-
-      using Point3D = std::array<BaseTy, 3>;
-      using Point2D = std::array<BaseTy, 2>;
-      std::vector<Point2D> polyline;
-
-      // TMW change: Find best normal and project v0x and v0y to those
-      // coordinates, instead of picking a plane aligned with an axis (which
-      // can flip polygons).
-
-      // Fill polygon data.
-      for (size_t k = 0; k < npolys; k++) {
-        size_t vidx = faceVertexIndices[faceIndexOffset + k];
-
-        value::float3 v = points[vidx];
-        // Point3 polypoint = {v0[0],v0[1],v0[2]};
+    face_offsets[i + 1] = face_offsets[i] + npolys;
+  }
 
-        // world to local
-        Point3D loc = {vdot(v, axis_u), vdot(v, axis_v), vdot(v, axis_w)};
+  if (face_offsets[num_faces] > 0) {
+    uint32_t max_index = *std::max_element(
+        faceVertexIndices.begin(),
+        faceVertexIndices.begin() + long(face_offsets[num_faces]));
+    if (max_index >= points.size()) {
+      err = fmt::format("Invalid vertex index.\n");
+      return false;
+    }
+  }
 
-        polyline.push_back({loc[0], loc[1]});
-      }
+  const uint32_t nthreads = (num_faces >= kMeshParallelMinElements)
+                                ? parallel::GetNumThreads(num_threads)
+                                : 1u;
 
-      std::vector<std::vector<Point2D>> polygon_2d;
-      // Single polygon only(no holes)
+  //
+  // 1. Classify faces.
+  //
+  std::vector<TriangulateFaceType> face_types(num_faces);
+  parallel::ParallelFor(
+      0, num_faces, nthreads,
+      [&](size_t i, uint32_t tid) {
+        (void)tid;
+        face_types[i] =
+            ClassifyFace(points, faceVertexIndices.data() + face_offsets[i],
+                         faceVertexCounts[i]);
+      },
+      /* grain_size */ 1024);
+
+  // Concave polygons. Usually few.
+  std::vector<uint32_t> earcut_faces;
+  for (size_t i = 0; i < num_faces; i++) {
+    if (face_types[i] == TriangulateFaceType::Degenerated) {
+      DCOUT("Degenerated polygon at face " << i);
+      err = "Degenerated polygon found.\n";
+      return false;
+    } else if (face_types[i] == TriangulateFaceType::Earcut) {
+      earcut_faces.push_back(uint32_t(i));
+    }
+  }
 
-      std::vector<uint32_t> indices = mapbox::earcut<uint32_t>(polygon_2d);
-      //  => result = 3 * faces, clockwise
+  std::vector<std::vector<uint32_t>> earcut_indices(earcut_faces.size());
+  std::vector<uint8_t> earcut_results(earcut_faces.size(), 0);
+  parallel::ParallelFor(
+      0, earcut_faces.size(), nthreads,
+      [&](size_t k, uint32_t tid) {
+        (void)tid;
+        const size_t i = earcut_faces[k];
+        earcut_results[k] = EarcutPolygon<T, BaseTy>(
+            points, faceVertexIndices.data() + face_offsets[i],
+            faceVertexCounts[i], &earcut_indices[k]);
+      },
+      /* grain_size */ 16);
 
-      if ((indices.size() % 3) != 0) {
-        // This should not be happen, though.
+  //
+  // 2. Compute the offset to triangulated faces.
+  //
+  triangulatedFaceCounts.resize(num_faces);
+  std::vector<size_t> tri_offsets(num_faces + 1);
+  tri_offsets[0] = 0;
+
+  for (size_t i = 0, k = 0; i < num_faces; i++) {
+    size_t ntris;
+    if (face_types[i] == TriangulateFaceType::Earcut) {
+      if (!earcut_results[k]) {
         err = "Failed to triangulate.\n";
         return false;
       }
+      ntris = earcut_indices[k].size() / 3;
+      k++;
+    } else {
+      ntris = faceVertexCounts[i] - 2;
+    }
 
-      size_t ntris = indices.size() / 3;
+    triangulatedFaceCounts[i] = uint32_t(ntris);
+    tri_offsets[i + 1] = tri_offsets[i] + ntris;
+  }
 
-      // Up to 2GB tris.
-      if (ntris > size_t((std::numeric_limits<int32_t>::max)())) {
-        err = "Too many triangles are generated.\n";
-        return false;
-      }
+  const size_t total_tris = tri_offsets[num_faces];
 
-      for (size_t k = 0; k < ntris; k++) {
-        triangulatedFaceVertexCounts.push_back(3);
-        triangulatedFaceVertexIndices.push_back(
-            faceVertexIndices[faceIndexOffset + indices[3 * k + 0]]);
-        triangulatedFaceVertexIndices.push_back(
-            faceVertexIndices[faceIndexOffset + indices[3 * k + 1]]);
-        triangulatedFaceVertexIndices.push_back(
-            faceVertexIndices[faceIndexOffset + indices[3 * k + 2]]);
+  // Up to 2GB tris.
+  if (total_tris > size_t((std::numeric_limits<int32_t>::max)())) {
+    err = "Too many triangles are generated.\n";
+    return false;
+  }
 
-        triangulatedToOrigFaceVertexIndexMap.push_back(faceIndexOffset +
-                                                       indices[3 * k + 0]);
-        triangulatedToOrigFaceVertexIndexMap.push_back(faceIndexOffset +
-                                                       indices[3 * k + 1]);
-        triangulatedToOrigFaceVertexIndexMap.push_back(faceIndexOffset +
-                                                       indices[3 * k + 2]);
-      }
-      triangulatedFaceCounts.push_back(uint32_t(ntris));
+  // Map face index to the index in `earcut_faces`.
+  std::vector<uint32_t> earcut_slots;
+  if (!earcut_faces.empty()) {
+    earcut_slots.resize(num_faces, 0);
+    for (size_t k = 0; k < earcut_faces.size(); k++) {
+      earcut_slots[earcut_faces[k]] = uint32_t(k);
     }
-
-    faceIndexOffset += npolys;
   }
 
+  //
+  // 3. Write triangles.
+  //
+  triangulatedFaceVertexCounts.assign(total_tris, 3);
+  triangulatedFaceVertexIndices.resize(3 * total_tris);
+  triangulatedToOrigFaceVertexIndexMap.resize(3 * total_tris);
+
+  // fv = index to the face vertex in the face.
+  static const uint32_t kQuadIndices[2][6] = {{0, 1, 2, 0, 2, 3},
+                                              {1, 2, 3, 1, 3, 0}};
+
+  parallel::ParallelFor(
+      0, num_faces, nthreads,
+      [&](size_t i, uint32_t tid) {
+        (void)tid;
+        const size_t faceIndexOffset = face_offsets[i];
+        uint32_t *dst_indices =
+            triangulatedFaceVertexIndices.data() + 3 * tri_offsets[i];
+        size_t *dst_map =
+            triangulatedToOrigFaceVertexIndexMap.data() + 3 * tri_offsets[i];
+
+        auto Emit = [&](size_t k, uint32_t fv) {
+          dst_indices[k] = faceVertexIndices[faceIndexOffset + fv];
+          dst_map[k] = faceIndexOffset + fv;
+        };
+
+        switch (face_types[i]) {
+          case TriangulateFaceType::Triangle: {
+            // No need for triangulation.
+            Emit(0, 0);
+            Emit(1, 1);
+            Emit(2, 2);
+            break;
+          }
+          case TriangulateFaceType::QuadDiagonal0:
+          case TriangulateFaceType::QuadDiagonal1: {
+            const uint32_t *fvs = kQuadIndices
+                [face_types[i] == TriangulateFaceType::QuadDiagonal1 ? 1 : 0];
+            for (size_t k = 0; k < 6; k++) {
+              Emit(k, fvs[k]);
+            }
+            break;
+          }
+          case TriangulateFaceType::Fan: {
+            for (uint32_t k = 0; k < triangulatedFaceCounts[i]; k++) {
+              Emit(3 * k + 0, 0);
+              Emit(3 * k + 1, k + 1);
+              Emit(3 * k + 2, k + 2);
+            }
+            break;
+          }
+          case TriangulateFaceType::Earcut: {
+            const std::vector<uint32_t> &indices =
+                earcut_indices[earcut_slots[i]];
+            for (size_t k = 0; k < indices.size(); k++) {
+              Emit(k, indices[k]);
+            }
+            break;
+          }
+          case TriangulateFaceType::Degenerated: {
+            // Already rejected.
+            break;
+          }
+        }
+      },
+      /* grain_size */ 1024);
+
   return true;
 }
 #endif
@@ -1729,143 +1975,319 @@ static void GenerateBasis(const vec3 &n, vec3 *tangent,
 }
 #endif
 
-struct ComputeTangentPackedVertexData {
-  // value::float3 position;
-  uint32_t point_index;
-  value::float3 normal;
-  value::float2 uv;
-
-  // comparator for std::map
-  bool operator<(const DefaultPackedVertexData &rhs) const {
-    return memcmp(reinterpret_cast<const void *>(this),
-                  reinterpret_cast<const void *>(&rhs),
-                  sizeof(DefaultPackedVertexData)) > 0;
+//
+// Vertex welding.
+// Assign the same vertex index to face vertices whose attributes are all
+// identical(bitwise).
+//
+// Attributes present in the mesh are packed into fixed-stride keys(array of
+// 32bit words), and keys are deduplicated with an open-addressing hash table.
+// For a large mesh, face vertices are partitioned by hash value and each
+// partition is processed concurrently.
+//
+// Vertex indices are assigned in the order of first appearance regardless of
+// the # of threads.
+//
+class VertexWelder {
+ public:
+  ///
+  /// Add attribute stream.
+  ///
+  /// @param[in] data Attribute data(`num_words` 32bit words per face vertex).
+  /// @param[in] num_words # of 32bit words per face vertex.
+  ///
+  void add_attribute(const void *data, const size_t num_words) {
+    Attrib attr;
+    attr.data = reinterpret_cast<const uint8_t *>(data);
+    attr.num_words = num_words;
+    _attribs.push_back(attr);
+    _stride += num_words;
   }
-};
 
-struct ComputeTangentPackedVertexDataHasher {
-  inline size_t operator()(const ComputeTangentPackedVertexData &v) const {
-    // Simple hasher using FNV1 32bit
-    // TODO: Use 64bit FNV1?
-    // TODO: Use spatial hash or LSH(LocallySensitiveHash) for position value.
-    static constexpr uint32_t kFNV_Prime = 0x01000193;
-    static constexpr uint32_t kFNV_Offset_Basis = 0x811c9dc5;
+  ///
+  /// @param[in] n # of face vertices.
+  /// @param[in] num_threads # of threads.
+  /// @param[out] out_indices Vertex index of each face vertex.
+  /// @param[out] unique_fvs Face vertex index of each(unique) vertex.
+  ///
+  void weld(const size_t n, const uint32_t num_threads,
+            std::vector<uint32_t> *out_indices,
+            std::vector<uint32_t> *unique_fvs) const {
+    const uint32_t nthreads =
+        (n >= kMeshParallelMinElements) ? num_threads : 1u;
+
+    // Pack keys and compute hash values.
+    std::vector<uint32_t> keys(n * _stride);
+    std::vector<uint64_t> hashes(n);
+
+    const size_t kChunk = 4096;
+    parallel::ParallelFor(
+        0, (n + kChunk - 1) / kChunk, nthreads,
+        [&](size_t c, uint32_t tid) {
+          (void)tid;
+          const size_t s = c * kChunk;
+          const size_t e = (std::min)(n, s + kChunk);
+          for (size_t i = s; i < e; i++) {
+            uint32_t *key = keys.data() + i * _stride;
+            for (const auto &attr : _attribs) {
+              memcpy(key, attr.data + i * attr.num_words * sizeof(uint32_t),
+                     attr.num_words * sizeof(uint32_t));
+              key += attr.num_words;
+            }
+            hashes[i] = HashKey(keys.data() + i * _stride, _stride);
+          }
+        });
+
+    // Partition face vertices by the upper bits of hash value.
+    // Face vertices with the same key go to the same partition.
+    uint32_t partition_bits = 0;
+    while ((nthreads > (1u << partition_bits)) && (partition_bits < 8)) {
+      partition_bits++;
+    }
+    const size_t num_partitions = size_t(1) << partition_bits;
 
-    const uint8_t *ptr = reinterpret_cast<const uint8_t *>(&v);
-    size_t n = sizeof(DefaultPackedVertexData);
+    auto PartitionOf = [&](size_t i) -> size_t {
+      return partition_bits ? size_t(hashes[i] >> (64 - partition_bits)) : 0;
+    };
 
-    uint32_t hash = kFNV_Offset_Basis;
+    // counting sort(the order of face vertices in a partition is preserved).
+    std::vector<size_t> offsets(num_partitions + 1, 0);
     for (size_t i = 0; i < n; i++) {
-      hash = (kFNV_Prime * hash) ^ (ptr[i]);
+      offsets[PartitionOf(i) + 1]++;
+    }
+    for (size_t p = 1; p <= num_partitions; p++) {
+      offsets[p] += offsets[p - 1];
+    }
+
+    std::vector<uint32_t> order(n);
+    {
+      std::vector<size_t> cursors(offsets.begin(), offsets.end() - 1);
+      for (size_t i = 0; i < n; i++) {
+        order[cursors[PartitionOf(i)]++] = uint32_t(i);
+      }
     }
 
-    return size_t(hash);
+    // The first face vertex which has the same key.
+    std::vector<uint32_t> rep(n);
+
+    parallel::ParallelFor(
+        0, num_partitions, nthreads,
+        [&](size_t p, uint32_t tid) {
+          (void)tid;
+          FindRepresentatives(keys, hashes, order.data() + offsets[p],
+                              offsets[p + 1] - offsets[p], rep.data());
+        });
+
+    out_indices->resize(n);
+    unique_fvs->clear();
+    for (size_t i = 0; i < n; i++) {
+      if (rep[i] == i) {
+        (*out_indices)[i] = uint32_t(unique_fvs->size());
+        unique_fvs->push_back(uint32_t(i));
+      } else {
+        // rep[i] < i
+        (*out_indices)[i] = (*out_indices)[rep[i]];
+      }
+    }
   }
-};
 
-struct ComputeTangentPackedVertexDataEqual {
-  bool operator()(const ComputeTangentPackedVertexData &lhs,
-                  const ComputeTangentPackedVertexData &rhs) const {
-    return memcmp(reinterpret_cast<const void *>(&lhs),
-                  reinterpret_cast<const void *>(&rhs),
-                  sizeof(ComputeTangentPackedVertexData)) == 0;
+ private:
+  struct Attrib {
+    const uint8_t *data{nullptr};
+    size_t num_words{0};
+  };
+
+  static uint64_t HashKey(const uint32_t *key, const size_t stride) {
+    // Process 64bit at once, then apply splitmix64 finalizer.
+    uint64_t h = 0x9e3779b97f4a7c15ull ^ uint64_t(stride);
+    size_t i = 0;
+    for (; (i + 2) <= stride; i += 2) {
+      uint64_t w;
+      memcpy(&w, key + i, sizeof(uint64_t));
+      h = (h ^ w) * 0xbf58476d1ce4e5b9ull;
+      h ^= h >> 31;
+    }
+    if (i < stride) {
+      h = (h ^ uint64_t(key[i])) * 0xbf58476d1ce4e5b9ull;
+      h ^= h >> 31;
+    }
+
+    h ^= h >> 30;
+    h *= 0xbf58476d1ce4e5b9ull;
+    h ^= h >> 27;
+    h *= 0x94d049bb133111ebull;
+    h ^= h >> 31;
+    return h;
+  }
+
+  // Find the representative(first) face vertex for each of `fvs`(must be
+  // sorted in ascending order).
+  void FindRepresentatives(const std::vector<uint32_t> &keys,
+                           const std::vector<uint64_t> &hashes,
+                           const uint32_t *fvs, const size_t count,
+                           uint32_t *rep) const {
+    if (count == 0) {
+      return;
+    }
+
+    // Load factor <= 0.5
+    size_t capacity = 16;
+    while (capacity < count * 2) {
+      capacity *= 2;
+    }
+    const size_t mask = capacity - 1;
+
+    // Face vertex index + 1(0 = empty slot).
+    std::vector<uint32_t> slots(capacity, 0);
+
+    const size_t key_bytes = _stride * sizeof(uint32_t);
+
+    for (size_t k = 0; k < count; k++) {
+      const uint32_t fv = fvs[k];
+      const uint64_t h = hashes[fv];
+      const uint32_t *key = keys.data() + size_t(fv) * _stride;
+
+      size_t slot = size_t(h) & mask;
+      for (;;) {
+        const uint32_t entry = slots[slot];
+        if (entry == 0) {
+          slots[slot] = fv + 1;
+          rep[fv] = fv;
+          break;
+        }
+
+        const uint32_t other = entry - 1;
+        if ((hashes[other] == h) &&
+            (memcmp(keys.data() + size_t(other) * _stride, key, key_bytes) ==
+             0)) {
+          rep[fv] = other;
+          break;
+        }
+
+        slot = (slot + 1) & mask;
+      }
+    }
   }
+
+  std::vector<Attrib> _attribs;
+  size_t _stride{0};
 };
 
-template <class PackedVert>
-struct ComputeTangentVertexInput {
-  // std::vector<value::float3> positions;
-  std::vector<uint32_t> point_indices;
-  std::vector<value::float3> normals;
-  std::vector<value::float2> uvs;
+template <typename T>
+std::vector<T> GatherUniqueVertices(const T *src,
+                                    const std::vector<uint32_t> &unique_fvs) {
+  std::vector<T> dst(unique_fvs.size());
+  for (size_t i = 0; i < unique_fvs.size(); i++) {
+    dst[i] = src[unique_fvs[i]];
+  }
+  return dst;
+}
 
-  size_t size() const { return point_indices.size(); }
+//
+// Compute the offset to faceVertexIndices of each face.
+// `face_offsets` has (# of faces + 1) elements.
+//
+static bool BuildFaceOffsets(const std::vector<uint32_t> &faceVertexCounts,
+                             const size_t num_face_vertex_indices,
+                             std::vector<size_t> *face_offsets,
+                             std::string *err) {
+  face_offsets->resize(faceVertexCounts.size() + 1);
+  (*face_offsets)[0] = 0;
 
-  void get(size_t idx, PackedVert &output) const {
-    if (idx < point_indices.size()) {
-      output.point_index = point_indices[idx];
-    } else {
-      output.point_index = ~0u;  // never should reach here though.
-    }
-    if (idx < normals.size()) {
-      output.normal = normals[idx];
-    } else {
-      output.normal = {0.0f, 0.0f, 0.0f};
-    }
-    if (idx < uvs.size()) {
-      output.uv = uvs[idx];
-    } else {
-      output.uv = {0.0f, 0.0f};
+  for (size_t f = 0; f < faceVertexCounts.size(); f++) {
+    size_t nv = faceVertexCounts[f];
+
+    if (nv < 3) {
+      PUSH_ERROR_AND_RETURN(
+          fmt::format("Invalid face num {} at faceVertexCounts[{}]", nv, f));
     }
+
+    (*face_offsets)[f + 1] = (*face_offsets)[f] + nv;
   }
-};
 
-template <class PackedVert>
-struct ComputeTangentVertexOutput {
-  // std::vector<value::float3> positions;
-  std::vector<uint32_t> point_indices;
-  std::vector<value::float3> normals;
-  std::vector<value::float2> uvs;
+  if (face_offsets->back() > num_face_vertex_indices) {
+    PUSH_ERROR_AND_RETURN(fmt::format(
+        "Sum of faceVertexCounts {} exceeds faceVertexIndices.size {}",
+        face_offsets->back(), num_face_vertex_indices));
+  }
+
+  return true;
+}
 
-  size_t size() const { return point_indices.size(); }
+}  // namespace
 
-  void push_back(const PackedVert &v) {
-    // positions.push_back(v.position);
-    point_indices.push_back(v.point_index);
-    normals.push_back(v.normal);
-    uvs.push_back(v.uv);
+//
+// Build vertex -> face vertices adjacency(CSR).
+// Face vertices of vertex `v` are `corners[offsets[v]:offsets[v+1]]`, in
+// ascending order.
+//
+void BuildVertexToCorners(const uint32_t *vertex_indices,
+                          const size_t num_corners, const size_t num_vertices,
+                          std::vector<size_t> *offsets,
+                          std::vector<uint32_t> *corners) {
+  offsets->assign(num_vertices + 1, 0);
+  for (size_t c = 0; c < num_corners; c++) {
+    (*offsets)[vertex_indices[c] + 1]++;
   }
-};
+  for (size_t v = 1; v <= num_vertices; v++) {
+    (*offsets)[v] += (*offsets)[v - 1];
+  }
+
+  corners->resize(num_corners);
+  std::vector<size_t> cursors(offsets->begin(), offsets->end() - 1);
+  for (size_t c = 0; c < num_corners; c++) {
+    (*corners)[cursors[vertex_indices[c]]++] = uint32_t(c);
+  }
+}
 
 ///
-/// Compute facevarying tangent and facevarying binormal.
+/// Compute tangent and binormal for each vertex.
 ///
 /// Reference:
 /// http://www.opengl-tutorial.org/intermediate-tutorials/tutorial-13-normal-mapping
 ///
-/// Implemented code uses two adjacent edge composed from three vertices v_{i},
-/// v_{i+1}, v_{i+2} for i < (N - 1) , where N is the number of vertices per
-/// facet.
+/// Tangent and binormal of each facet is computed using two adjacent edge
+/// composed from three vertices v_{i}, v_{i+1}, v_{i+2} for i < (N - 1),
+/// where N is the number of vertices per face, and accumulated to its face
+/// vertices. Then face vertices which have the same point index, normal and
+/// texcoord are merged into a vertex, and tangent and binormal of the vertex
+/// is orthogonalized with its normal.
+///
+/// Facets are processed concurrently, then vertices are processed
+/// concurrently(accumulation order is fixed, so the result does not depend on
+/// the # of threads).
 ///
 /// This may produce unwanted tangent/binormal frame for ill-defined
-/// polygon(quad, pentagon, ...). Also, we assume input mesh has well-formed and
-/// has no or few vertices with similar property(position, uvs and normals)
+/// polygon(quad, pentagon, ...).
 ///
 /// TODO:
-/// - [ ] Implement better getSimilarVertexIndex in the above opengl-tutorial to
-/// better average tangent/binormal.
-///   - Use kNN search(e.g. nanoflann https://github.com/jlblancoc/nanoflann ),
-///   or point-query by building BVH over the mesh points.
-///     - BVH builder candidate:
-///       - NanoRT https://github.com/lighttransport/nanort
-///       - bvh https://github.com/madmann91/bvh
-///   - Or we can quantize vertex attributes and compute locally sensitive
-///   hashsing? https://dl.acm.org/doi/10.1145/3188745.3188846
 /// - [ ] Support robusut computing tangent/binormal on arbitrary mesh.
 ///  - e.g. vector field calculation, use instance-mesh algorithm, etc...
-//   - Use half-edges to find adjacent face/vertex.
-///
+///   - Use half-edges to find adjacent face/vertex.
 ///
 /// @param[in] vertices Vertex points(`vertex` variability).
-/// @param[in] faceVertexCounts faceVertexCounts of the mesh.
+/// @param[in] faceVertexCounts faceVertexCounts of the mesh. Can be empty for
+/// a triangle mesh.
 /// @param[in] faceVertexIndices faceVertexIndices of the mesh.
 /// @param[in] texcoords Primary texcoords.
 /// @param[in] normals normals.
 /// @param[in] is_facevarying_input false = texcoords and normals are 'vertex'
 /// variability. true = 'facevarying' variability.
+/// @param[in] num_threads # of threads.
 /// @param[out] tangents Computed tangents;
 /// @param[out] binormals Computed binormals;
 /// @param[out] out_vertex_indices Vertex indices.
 /// @param[out] err Error message.
 ///
-static bool ComputeTangentsAndBinormals(
+bool ComputeTangentsAndBinormals(
     const std::vector<vec3> &vertices,
     const std::vector<uint32_t> &faceVertexCounts,
     const std::vector<uint32_t> &faceVertexIndices,
     const std::vector<vec2> &texcoords, const std::vector<vec3> &normals,
     bool is_facevarying_input,  // false: 'vertex' varying
-    std::vector<vec3> *tangents, std::vector<vec3> *binormals,
-    std::vector<uint32_t> *out_vertex_indices, std::string *err) {
+    const int num_threads, std::vector<vec3> *tangents,
+    std::vector<vec3> *binormals, std::vector<uint32_t> *out_vertex_indices,
+    std::string *err) {
   if (!tangents) {
     PUSH_ERROR_AND_RETURN("tangents arg is nullptr.");
   }
@@ -1895,10 +2317,14 @@ static bool ComputeTangentsAndBinormals(
     PUSH_ERROR_AND_RETURN("normals is empty");
   }
 
+  uint32_t max_vert_index =
+      *std::max_element(faceVertexIndices.begin(), faceVertexIndices.end());
+  if (max_vert_index >= vertices.size()) {
+    PUSH_ERROR_AND_RETURN(
+        "Invalid value in faceVertexIndices. some exceeds vertices.size()");
+  }
+
   if (is_facevarying_input) {
-    if (vertices.size() != faceVertexIndices.size()) {
-      PUSH_ERROR_AND_RETURN("Invalid vertices.size.");
-    }
     if (texcoords.size() != faceVertexIndices.size()) {
       PUSH_ERROR_AND_RETURN("Invalid texcoords.size.");
     }
@@ -1906,11 +2332,6 @@ static bool ComputeTangentsAndBinormals(
       PUSH_ERROR_AND_RETURN("Invalid normals.size.");
     }
   } else {
-    uint32_t max_vert_index =
-        *std::max_element(faceVertexIndices.begin(), faceVertexIndices.end());
-    if (max_vert_index >= vertices.size()) {
-      PUSH_ERROR_AND_RETURN("Invalid vertices.size.");
-    }
     if (max_vert_index >= texcoords.size()) {
       PUSH_ERROR_AND_RETURN("Invalid texcoords.size.");
     }
@@ -1919,7 +2340,7 @@ static bool ComputeTangentsAndBinormals(
     }
   }
 
-  bool hasFaceVertexCounts = true;
+  std::vector<size_t> face_offsets;
   if (faceVertexCounts.size() == 0) {
     // Assume all triangle faces.
     if ((faceVertexIndices.size() % 3) != 0) {
@@ -1927,276 +2348,177 @@ static bool ComputeTangentsAndBinormals(
           "Invalid faceVertexIndices. It must be all triangles: "
           "faceVertexIndices.size % 3 == 0");
     }
-    hasFaceVertexCounts = false;
+    face_offsets.resize(faceVertexIndices.size() / 3 + 1);
+    for (size_t f = 0; f < face_offsets.size(); f++) {
+      face_offsets[f] = f * 3;
+    }
+  } else {
+    if (!BuildFaceOffsets(faceVertexCounts, faceVertexIndices.size(),
+                          &face_offsets, err)) {
+      return false;
+    }
   }
 
-  // tn, bn = facevarying
-  std::vector<value::normal3f> tn(faceVertexIndices.size());
-  memset(&tn.at(0), 0, sizeof(value::normal3f) * tn.size());
-  std::vector<value::normal3f> bn(faceVertexIndices.size());
-  memset(&bn.at(0), 0, sizeof(value::normal3f) * bn.size());
+  const size_t num_faces = face_offsets.size() - 1;
+  const size_t num_fvs = face_offsets.back();
+
+  const uint32_t nthreads = (num_faces >= kMeshParallelMinElements)
+                                ? parallel::GetNumThreads(num_threads)
+                                : 1u;
+
+  // texcoords and normals are indexed by face vertex index for 'facevarying'
+  // input, or by point index for 'vertex' input.
+  auto AttribIndex = [&](size_t fvi) -> size_t {
+    return is_facevarying_input ? fvi : size_t(faceVertexIndices[fvi]);
+  };
 
   //
   // 1. Compute facevarying tangent/binormal for each faceVertex.
   //
-  size_t faceVertexIndexOffset{0};
-  for (size_t i = 0; i < faceVertexCounts.size(); i++) {
-    size_t nv = hasFaceVertexCounts ? faceVertexCounts[i] : 3;
+  // tn, bn = facevarying
+  std::vector<vec3> tn(num_fvs, {0.0f, 0.0f, 0.0f});
+  std::vector<vec3> bn(num_fvs, {0.0f, 0.0f, 0.0f});
+
+  parallel::ParallelFor(
+      0, num_faces, nthreads,
+      [&](size_t i, uint32_t tid) {
+        (void)tid;
+        const size_t offset = face_offsets[i];
+        const size_t nv = face_offsets[i + 1] - offset;
+
+        // Process each two-edges per facet.
+        //
+        // Example:
+        //
+        // fv3
+        //  o----------------o fv2
+        //   \              /
+        //    \            /
+        //     o----------o
+        //    fv0         fv1
+
+        // facet0:  fv0, fv1, fv2
+        // facet1:  fv1, fv2, fv3
+
+        for (size_t f = 0; f < nv - 2; f++) {
+          size_t fid0 = offset + f;
+          size_t fid1 = offset + f + 1;
+          size_t fid2 = offset + f + 2;
+
+          const vec3 &v1 = vertices[faceVertexIndices[fid0]];
+          const vec3 &v2 = vertices[faceVertexIndices[fid1]];
+          const vec3 &v3 = vertices[faceVertexIndices[fid2]];
+
+          const vec2 &uv1 = texcoords[AttribIndex(fid0)];
+          const vec2 &uv2 = texcoords[AttribIndex(fid1)];
+          const vec2 &uv3 = texcoords[AttribIndex(fid2)];
+
+          float x1 = v2[0] - v1[0];
+          float x2 = v3[0] - v1[0];
+          float y1 = v2[1] - v1[1];
+          float y2 = v3[1] - v1[1];
+          float z1 = v2[2] - v1[2];
+          float z2 = v3[2] - v1[2];
+
+          float s1 = uv2[0] - uv1[0];
+          float s2 = uv3[0] - uv1[0];
+          float t1 = uv2[1] - uv1[1];
+          float t2 = uv3[1] - uv1[1];
+
+          float r = 1.0;
+
+          if (std::fabs(double(s1 * t2 - s2 * t1)) > 1.0e-20) {
+            r /= (s1 * t2 - s2 * t1);
+          }
 
-    if ((faceVertexIndexOffset + nv) >= faceVertexIndices.size()) {
-      // Invalid faceVertexIndices
-      PUSH_ERROR_AND_RETURN("Invalid value in faceVertexOffset.");
-    }
+          vec3 tdir{(t2 * x1 - t1 * x2) * r, (t2 * y1 - t1 * y2) * r,
+                    (t2 * z1 - t1 * z2) * r};
+          vec3 bdir{(s1 * x2 - s2 * x1) * r, (s1 * y2 - s2 * y1) * r,
+                    (s1 * z2 - s2 * z1) * r};
 
-    if (nv < 3) {
-      PUSH_ERROR_AND_RETURN("Degenerated facet found.");
-    }
+          tn[fid0] += tdir;
+          tn[fid1] += tdir;
+          tn[fid2] += tdir;
 
-    // Process each two-edges per facet.
-    //
-    // Example:
-    //
-    // fv3
-    //  o----------------o fv2
-    //   \              /
-    //    \            /
-    //     o----------o
-    //    fv0         fv1
-
-    // facet0:  fv0, fv1, fv2
-    // facet1:  fv1, fv2, fv3
-
-    for (size_t f = 0; f < nv - 2; f++) {
-      size_t fid0 = faceVertexIndexOffset + f;
-      size_t fid1 = faceVertexIndexOffset + f + 1;
-      size_t fid2 = faceVertexIndexOffset + f + 2;
-
-      uint32_t vf0 =
-          is_facevarying_input ? uint32_t(fid0) : faceVertexIndices[fid0];
-      uint32_t vf1 =
-          is_facevarying_input ? uint32_t(fid1) : faceVertexIndices[fid1];
-      uint32_t vf2 =
-          is_facevarying_input ? uint32_t(fid2) : faceVertexIndices[fid2];
-
-      if ((vf0 >= vertices.size()) || (vf1 >= vertices.size()) ||
-          (vf2 >= vertices.size())) {
-        // index out-of-range
-        PUSH_ERROR_AND_RETURN(
-            "Invalid value in faceVertexIndices. some exceeds vertices.size()");
-      }
-
-      vec3 v1 = vertices[vf0];
-      vec3 v2 = vertices[vf1];
-      vec3 v3 = vertices[vf2];
-
-      float v1x = v1[0];
-      float v1y = v1[1];
-      float v1z = v1[2];
-
-      float v2x = v2[0];
-      float v2y = v2[1];
-      float v2z = v2[2];
-
-      float v3x = v3[0];
-      float v3y = v3[1];
-      float v3z = v3[2];
-
-      float w1x = 0.0f;
-      float w1y = 0.0f;
-      float w2x = 0.0f;
-      float w2y = 0.0f;
-      float w3x = 0.0f;
-      float w3y = 0.0f;
-
-      if ((vf0 >= texcoords.size()) || (vf1 >= texcoords.size()) ||
-          (vf2 >= texcoords.size())) {
-        // index out-of-range
-        PUSH_ERROR_AND_RETURN("Invalid index. some exceeds texcoords.size()");
-      }
-
-      {
-        vec2 uv1 = texcoords[vf0];
-        vec2 uv2 = texcoords[vf1];
-        vec2 uv3 = texcoords[vf2];
-
-        w1x = uv1[0];
-        w1y = uv1[1];
-        w2x = uv2[0];
-        w2y = uv2[1];
-        w3x = uv3[0];
-        w3y = uv3[1];
-      }
-
-      float x1 = v2x - v1x;
-      float x2 = v3x - v1x;
-      float y1 = v2y - v1y;
-      float y2 = v3y - v1y;
-      float z1 = v2z - v1z;
-      float z2 = v3z - v1z;
-
-      float s1 = w2x - w1x;
-      float s2 = w3x - w1x;
-      float t1 = w2y - w1y;
-      float t2 = w3y - w1y;
-
-      float r = 1.0;
-
-      if (std::fabs(double(s1 * t2 - s2 * t1)) > 1.0e-20) {
-        r /= (s1 * t2 - s2 * t1);
-      }
-
-      vec3 tdir{(t2 * x1 - t1 * x2) * r, (t2 * y1 - t1 * y2) * r,
-                (t2 * z1 - t1 * z2) * r};
-      vec3 bdir{(s1 * x2 - s2 * x1) * r, (s1 * y2 - s2 * y1) * r,
-                (s1 * z2 - s2 * z1) * r};
-
-      //
-      // NOTE: for quad or polygon mesh, this overwrites previous 2 facevarying
-      // points for each face.
-      //       And this would not be a good way to compute tangents for
-      //       quad/polygon.
-      //
-
-      tn[fid0][0] = tdir[0];
-      tn[fid0][1] = tdir[1];
-      tn[fid0][2] = tdir[2];
-
-      tn[fid1][0] = tdir[0];
-      tn[fid1][1] = tdir[1];
-      tn[fid1][2] = tdir[2];
-
-      tn[fid2][0] = tdir[0];
-      tn[fid2][1] = tdir[1];
-      tn[fid2][2] = tdir[2];
-
-      bn[fid0][0] = bdir[0];
-      bn[fid0][1] = bdir[1];
-      bn[fid0][2] = bdir[2];
-
-      bn[fid1][0] = bdir[0];
-      bn[fid1][1] = bdir[1];
-      bn[fid1][2] = bdir[2];
-
-      bn[fid2][0] = bdir[0];
-      bn[fid2][1] = bdir[1];
-      bn[fid2][2] = bdir[2];
-    }
-
-    faceVertexIndexOffset += nv;
-  }
+          bn[fid0] += bdir;
+          bn[fid1] += bdir;
+          bn[fid2] += bdir;
+        }
+      },
+      /* grain_size */ 1024);
 
   //
   // 2. Build indices(use same index for shared-vertex)
   //
-  std::vector<uint32_t> vertex_indices;  // len = faceVertexIndices.size()
+  std::vector<uint32_t> vertex_indices;  // len = num_fvs
+  std::vector<uint32_t> unique_fvs;
   {
-    ComputeTangentVertexInput<ComputeTangentPackedVertexData> vertex_input;
-    ComputeTangentVertexOutput<ComputeTangentPackedVertexData> vertex_output;
-
+    VertexWelder welder;
+    welder.add_attribute(faceVertexIndices.data(), 1);
     if (is_facevarying_input) {
-      // input position is still in 'vertex' variability.
-      for (size_t i = 0; i < faceVertexIndices.size(); i++) {
-        vertex_input.point_indices.push_back(faceVertexIndices[i]);
-      }
-      vertex_input.normals = normals;
-      vertex_input.uvs = texcoords;
+      welder.add_attribute(normals.data(), 3);
+      welder.add_attribute(texcoords.data(), 2);
     } else {
-      // expand to facevarying.
-      for (size_t i = 0; i < faceVertexIndices.size(); i++) {
-        vertex_input.point_indices.push_back(faceVertexIndices[i]);
-        vertex_input.normals.push_back(normals[faceVertexIndices[i]]);
-        vertex_input.uvs.push_back(texcoords[faceVertexIndices[i]]);
-      }
+      // normals and texcoords are determined by point index.
     }
 
-    std::vector<uint32_t> vertex_point_indices;
-
-    BuildIndices<ComputeTangentVertexInput<ComputeTangentPackedVertexData>,
-                 ComputeTangentVertexOutput<ComputeTangentPackedVertexData>,
-                 ComputeTangentPackedVertexData,
-                 ComputeTangentPackedVertexDataHasher,
-                 ComputeTangentPackedVertexDataEqual>(
-        vertex_input, vertex_output, vertex_indices, vertex_point_indices);
+    welder.weld(num_fvs, nthreads, &vertex_indices, &unique_fvs);
 
     DCOUT("faceVertexIndices.size : " << faceVertexIndices.size());
-    DCOUT("# of indices after the build: "
-          << vertex_indices.size() << ", reduced "
-          << (faceVertexIndices.size() - vertex_indices.size()) << " indices.");
-    // We only need indices. Discard vertex_output and vertrex_point_indices
+    DCOUT("# of vertices after the build: " << unique_fvs.size());
   }
 
-  const uint32_t num_verts =
-      *std::max_element(vertex_indices.begin(), vertex_indices.end());
+  const size_t num_verts = unique_fvs.size();
+
+  std::vector<size_t> vertex_offsets;
+  std::vector<uint32_t> vertex_corners;
+  BuildVertexToCorners(vertex_indices.data(), num_fvs, num_verts,
+                       &vertex_offsets, &vertex_corners);
 
   //
-  // 3. normalize * orthogonalize;
+  // 3. Accumulate, normalize and orthogonalize.
   //
-
-  // per-vertex tangents/binormals
-  std::vector<value::normal3f> v_tn;
-  v_tn.assign(num_verts, {0.0f, 0.0f, 0.0f});
-
-  std::vector<value::normal3f> v_bn;
-  v_bn.assign(num_verts, {0.0f, 0.0f, 0.0f});
-
-  for (size_t i = 0; i < vertex_indices.size(); i++) {
-    value::normal3f Tn = tn[vertex_indices[i]];
-    value::normal3f Bn = bn[vertex_indices[i]];
-
-    v_tn[vertex_indices[i]][0] += Tn[0];
-    v_tn[vertex_indices[i]][1] += Tn[1];
-    v_tn[vertex_indices[i]][2] += Tn[2];
-
-    v_bn[vertex_indices[i]][0] += Bn[0];
-    v_bn[vertex_indices[i]][1] += Bn[1];
-    v_bn[vertex_indices[i]][2] += Bn[2];
-  }
-
-  for (size_t i = 0; i < size_t(num_verts); i++) {
-    if (vlength(v_tn[i]) > 0.0f) {
-      v_tn[i] = vnormalize(v_tn[i]);
-    }
-    if (vlength(v_bn[i]) > 0.0f) {
-      v_bn[i] = vnormalize(v_bn[i]);
-    }
-  }
-
   tangents->assign(num_verts, {0.0f, 0.0f, 0.0f});
   binormals->assign(num_verts, {0.0f, 0.0f, 0.0f});
 
-  for (size_t i = 0; i < vertex_indices.size(); i++) {
-    value::normal3f n;
-
-    // http://www.terathon.com/code/tangent.html
-
-    n[0] = normals[vertex_indices[i]][0];
-    n[1] = normals[vertex_indices[i]][1];
-    n[2] = normals[vertex_indices[i]][2];
+  parallel::ParallelFor(
+      0, num_verts, nthreads,
+      [&](size_t v, uint32_t tid) {
+        (void)tid;
+        vec3 Tn{0.0f, 0.0f, 0.0f};
+        vec3 Bn{0.0f, 0.0f, 0.0f};
+        for (size_t k = vertex_offsets[v]; k < vertex_offsets[v + 1]; k++) {
+          Tn += tn[vertex_corners[k]];
+          Bn += bn[vertex_corners[k]];
+        }
 
-    value::normal3f Tn = v_tn[vertex_indices[i]];
-    value::normal3f Bn = v_bn[vertex_indices[i]];
+        if (vlength(Tn) > 0.0f) {
+          Tn = vnormalize(Tn);
+        }
+        if (vlength(Bn) > 0.0f) {
+          Bn = vnormalize(Bn);
+        }
 
-    // Gram-Schmidt orthogonalize
-    Tn = (Tn - n * vdot(n, Tn));
-    if (vlength(Tn) > 0.0f) {
-      Tn = vnormalize(Tn);
-    }
+        // http://www.terathon.com/code/tangent.html
+        const vec3 &n = normals[AttribIndex(unique_fvs[v])];
 
-    // Calculate handedness
-    if (vdot(vcross(n, Tn), Bn) < 0.0f) {
-      Tn = Tn * -1.0f;
-    }
+        // Gram-Schmidt orthogonalize
+        Tn = (Tn - n * vdot(n, Tn));
+        if (vlength(Tn) > 0.0f) {
+          Tn = vnormalize(Tn);
+        }
 
-    ((*tangents)[vertex_indices[i]])[0] = Tn[0];
-    ((*tangents)[vertex_indices[i]])[1] = Tn[1];
-    ((*tangents)[vertex_indices[i]])[2] = Tn[2];
+        // Calculate handedness
+        if (vdot(vcross(n, Tn), Bn) < 0.0f) {
+          Tn = Tn * -1.0f;
+        }
 
-    ((*binormals)[vertex_indices[i]])[0] = Bn[0];
-    ((*binormals)[vertex_indices[i]])[1] = Bn[1];
-    ((*binormals)[vertex_indices[i]])[2] = Bn[2];
-  }
+        (*tangents)[v] = Tn;
+        (*binormals)[v] = Bn;
+      },
+      /* grain_size */ 1024);
 
-  (*out_vertex_indices) = vertex_indices;
+  (*out_vertex_indices) = std::move(vertex_indices);
 
   return true;
 }
@@ -2219,74 +2541,146 @@ inline static value::float3 GeometricNormal(const value::float3 v0,
   return Nf;
 }
 
+//
+// Angle between two edges(v1 - v0, v2 - v0) at v0.
+//
+inline static float CornerAngle(const value::float3 v0,
+                                const value::float3 v1,
+                                const value::float3 v2) {
+  const value::float3 e1 = v1 - v0;
+  const value::float3 e2 = v2 - v0;
+
+  const float l1 = vlength(e1);
+  const float l2 = vlength(e2);
+  if ((l1 <= 0.0f) || (l2 <= 0.0f)) {
+    return 0.0f;
+  }
+
+  float c = vdot(e1, e2) / (l1 * l2);
+  c = (std::max)(-1.0f, (std::min)(1.0f, c));
+
+  return std::acos(c);
+}
+
 //
 // Compute a normal for vertices.
-// Normal vector is computed as weighted(by the area of the triangle) vector.
+//
+// 1. Compute the normal of each face concurrently.
+// 2. Gather face normals for each vertex concurrently, using vertex -> face
+//    adjacency. Face normals are weighted by the area of the face or the angle
+//    of the face corner at the vertex.
 //
 // TODO: Implement better normal calculation. ref.
 // http://www.bytehazard.com/articles/vertnorm.html
 //
-static bool ComputeNormals(const std::vector<vec3> &vertices,
-                           const std::vector<uint32_t> &faceVertexCounts,
-                           const std::vector<uint32_t> &faceVertexIndices,
-                           std::vector<vec3> &normals, std::string *err) {
-  normals.assign(vertices.size(), {0.0f, 0.0f, 0.0f});
-
-  size_t faceVertexIndexOffset{0};
-  for (size_t f = 0; f < faceVertexCounts.size(); f++) {
-    size_t nv = faceVertexCounts[f];
-
-    if (nv < 3) {
-      PUSH_ERROR_AND_RETURN(
-          fmt::format("Invalid face num {} at faceVertexCounts[{}]", nv, f));
-    }
+bool ComputeNormals(const std::vector<vec3> &vertices,
+                    const std::vector<uint32_t> &faceVertexCounts,
+                    const std::vector<uint32_t> &faceVertexIndices,
+                    const NormalWeighting weighting, const int num_threads,
+                    std::vector<vec3> &normals, std::string *err) {
+  std::vector<size_t> face_offsets;
+  if (!BuildFaceOffsets(faceVertexCounts, faceVertexIndices.size(),
+                        &face_offsets, err)) {
+    return false;
+  }
 
-    // For quad/polygon, first three vertices are used to compute face normal
-    // (Assume quad/polygon plane is co-planar)
-    uint32_t vidx0 = faceVertexIndices[faceVertexIndexOffset + 0];
-    uint32_t vidx1 = faceVertexIndices[faceVertexIndexOffset + 1];
-    uint32_t vidx2 = faceVertexIndices[faceVertexIndexOffset + 2];
+  const size_t num_faces = faceVertexCounts.size();
+  const size_t num_fvs = face_offsets.back();
 
-    if (vidx0 >= vertices.size()) {
+  // Validate indices before the computation.
+  if (num_fvs) {
+    uint32_t max_vert_index = *std::max_element(
+        faceVertexIndices.begin(), faceVertexIndices.begin() + long(num_fvs));
+    if (max_vert_index >= vertices.size()) {
       PUSH_ERROR_AND_RETURN(
-          fmt::format("vertexIndex0 {} exceeds vertices.size {}", vidx0, vertices.size()));
+          fmt::format("vertexIndex {} exceeds vertices.size {}",
+                      max_vert_index, vertices.size()));
     }
+  }
 
-    if (vidx1 >= vertices.size()) {
-      PUSH_ERROR_AND_RETURN(
-          fmt::format("vertexIndex1 {} exceeds vertices.size {}", vidx1, vertices.size()));
-    }
+  const uint32_t nthreads = (num_faces >= kMeshParallelMinElements)
+                                ? parallel::GetNumThreads(num_threads)
+                                : 1u;
 
-    if (vidx2 >= vertices.size()) {
-      PUSH_ERROR_AND_RETURN(
-          fmt::format("vertexIndex2 {} exceeds vertices.size {}", vidx2, vertices.size()));
-    }
+  //
+  // 1. Face normals
+  //
+  // Area: area-weighted face normal. Angle: face normal.
+  std::vector<vec3> face_normals(num_faces);
+
+  parallel::ParallelFor(
+      0, num_faces, nthreads,
+      [&](size_t f, uint32_t tid) {
+        (void)tid;
+        const size_t offset = face_offsets[f];
+
+        // For quad/polygon, first three vertices are used to compute face
+        // normal (Assume quad/polygon plane is co-planar)
+        uint32_t vidx0 = faceVertexIndices[offset + 0];
+        uint32_t vidx1 = faceVertexIndices[offset + 1];
+        uint32_t vidx2 = faceVertexIndices[offset + 2];
+
+        float area{0.0f};
+        value::float3 Nf = GeometricNormal(vertices[vidx0], vertices[vidx1],
+                                           vertices[vidx2], area);
+
+        if (weighting == NormalWeighting::Angle) {
+          face_normals[f] = Nf;
+        } else {
+          face_normals[f] = area * Nf;
+        }
+      },
+      /* grain_size */ 1024);
 
-    float area{0.0f};
-    value::float3 Nf = GeometricNormal(vertices[vidx0], vertices[vidx1],
-                                       vertices[vidx2], area);
+  //
+  // 2. Gather face normals for each vertex.
+  //
+  std::vector<size_t> vertex_offsets;
+  std::vector<uint32_t> vertex_corners;
+  BuildVertexToCorners(faceVertexIndices.data(), num_fvs, vertices.size(),
+                       &vertex_offsets, &vertex_corners);
 
-    for (size_t v = 0; v < nv; v++) {
-      uint32_t vidx = faceVertexIndices[faceVertexIndexOffset + v];
-      if (vidx >= vertices.size()) {
-        PUSH_ERROR_AND_RETURN(fmt::format(
-            "vertexIndex exceeds vertices.size {}", vertices.size()));
-      }
-      normals[vidx] += area * Nf;
+  // face vertex -> face
+  std::vector<uint32_t> corner_faces(num_fvs);
+  for (size_t f = 0; f < num_faces; f++) {
+    for (size_t c = face_offsets[f]; c < face_offsets[f + 1]; c++) {
+      corner_faces[c] = uint32_t(f);
     }
-
-    faceVertexIndexOffset += nv;
   }
 
-  for (size_t v = 0; v < normals.size(); v++) {
-    normals[v] = vnormalize(normals[v]);
-  }
+  normals.assign(vertices.size(), {0.0f, 0.0f, 0.0f});
+
+  parallel::ParallelFor(
+      0, vertices.size(), nthreads,
+      [&](size_t v, uint32_t tid) {
+        (void)tid;
+        vec3 n{0.0f, 0.0f, 0.0f};
+        for (size_t k = vertex_offsets[v]; k < vertex_offsets[v + 1]; k++) {
+          const size_t c = vertex_corners[k];
+          const size_t f = corner_faces[c];
+
+          if (weighting == NormalWeighting::Angle) {
+            const size_t offset = face_offsets[f];
+            const size_t nv = face_offsets[f + 1] - offset;
+            const size_t i = c - offset;
+            const size_t prev = offset + ((i + nv - 1) % nv);
+            const size_t next = offset + ((i + 1) % nv);
+
+            float angle = CornerAngle(vertices[faceVertexIndices[c]],
+                                      vertices[faceVertexIndices[next]],
+                                      vertices[faceVertexIndices[prev]]);
+            n += angle * face_normals[f];
+          } else {
+            n += face_normals[f];
+          }
+        }
+        normals[v] = vnormalize(n);
+      },
+      /* grain_size */ 1024);
 
   return true;
 }
 
-}  // namespace
-
 #if 0
 // Currently float2 only
 std::vector<UsdPrimvarReader_float2> ExtractPrimvarReadersFromMaterialNode(
@@ -2473,7 +2867,8 @@ bool RenderSceneConverter::ConvertVertexVariabilityImpl(
   return true;
 }
 
-bool RenderSceneConverter::BuildVertexIndicesImpl(RenderMesh &mesh) {
+bool RenderSceneConverter::BuildVertexIndicesImpl(RenderMesh &mesh,
+                                                  const int num_threads) {
   //
   // - If mesh is triangulated, use triangulatedFaceVertexIndices, otherwise use
   // faceVertxIndices.
@@ -2487,17 +2882,12 @@ bool RenderSceneConverter::BuildVertexIndicesImpl(RenderMesh &mesh) {
           ? mesh.triangulatedFaceVertexIndices
           : mesh.usdFaceVertexIndices;
 
-  DefaultVertexInput<DefaultPackedVertexData> vertex_input;
-
   size_t num_fvs = fvIndices.size();
-  vertex_input.point_indices = fvIndices;
-  vertex_input.uv0s.assign(num_fvs, {0.0f, 0.0f});
-  vertex_input.uv1s.assign(num_fvs, {0.0f, 0.0f});
-  vertex_input.normals.assign(num_fvs, {0.0f, 0.0f, 0.0f});
-  vertex_input.tangents.assign(num_fvs, {0.0f, 0.0f, 0.0f});
-  vertex_input.binormals.assign(num_fvs, {0.0f, 0.0f, 0.0f});
-  vertex_input.colors.assign(num_fvs, {0.0f, 0.0f, 0.0f});
-  vertex_input.opacities.assign(num_fvs, 0.0f);
+
+  if (num_fvs == 0) {
+    // Nothing to weld.
+    return true;
+  }
 
   if (mesh.normals.vertex_count()) {
     if (!mesh.normals.is_facevarying()) {
@@ -2590,7 +2980,7 @@ bool RenderSceneConverter::BuildVertexIndicesImpl(RenderMesh &mesh) {
           "Internal error. vertex_opacities must be 'facevarying' "
           "variability.");
     }
-    if (mesh.vertex_colors.vertex_count() != num_fvs) {
+    if (mesh.vertex_opacities.vertex_count() != num_fvs) {
       PUSH_ERROR_AND_RETURN(
           "Internal error. The number of vertex_opacity items does not match "
           "with the number of facevarying items.");
@@ -2615,48 +3005,45 @@ bool RenderSceneConverter::BuildVertexIndicesImpl(RenderMesh &mesh) {
 
   for (size_t i = 0; i < num_fvs; i++) {
     size_t fvi = fvIndices[i];
-    if (fvi >= num_fvs) {
-      PUSH_ERROR_AND_RETURN(fmt::format(
-          "Invalid faceVertexIndex {}. Must be less than {}", fvi, num_fvs));
+    if (fvi >= mesh.points.size()) {
+      PUSH_ERROR_AND_RETURN(
+          fmt::format("Invalid faceVertexIndex {}. Must be less than {}", fvi,
+                      mesh.points.size()));
     }
+  }
 
-    if (normals_ptr) {
-      vertex_input.normals[i] = normals_ptr[i];
-    }
-    if (texcoord0_ptr) {
-      vertex_input.uv0s[i] = texcoord0_ptr[i];
-    }
-    if (texcoord1_ptr) {
-      vertex_input.uv1s[i] = texcoord1_ptr[i];
-    }
-    if (tangents_ptr) {
-      vertex_input.tangents[i] = tangents_ptr[i];
-    }
-    if (binormals_ptr) {
-      vertex_input.binormals[i] = binormals_ptr[i];
-    }
-    if (colors_ptr) {
-      vertex_input.colors[i] = colors_ptr[i];
-    }
-    if (opacities_ptr) {
-      vertex_input.opacities[i] = opacities_ptr[i];
-    }
+  // Only attributes present in the mesh are used for the key.
+  VertexWelder welder;
+  welder.add_attribute(fvIndices.data(), 1);
+  if (normals_ptr) {
+    welder.add_attribute(normals_ptr, 3);
+  }
+  if (texcoord0_ptr) {
+    welder.add_attribute(texcoord0_ptr, 2);
+  }
+  if (texcoord1_ptr) {
+    welder.add_attribute(texcoord1_ptr, 2);
+  }
+  if (tangents_ptr) {
+    welder.add_attribute(tangents_ptr, 3);
+  }
+  if (binormals_ptr) {
+    welder.add_attribute(binormals_ptr, 3);
+  }
+  if (colors_ptr) {
+    welder.add_attribute(colors_ptr, 3);
+  }
+  if (opacities_ptr) {
+    welder.add_attribute(opacities_ptr, 1);
   }
 
   std::vector<uint32_t> out_indices;
-  std::vector<uint32_t> out_point_indices;  // to reorder position data
-  DefaultVertexOutput<DefaultPackedVertexData> vertex_output;
+  std::vector<uint32_t> unique_fvs;  // face vertex index of each vertex
+  welder.weld(num_fvs, parallel::GetNumThreads(num_threads), &out_indices,
+              &unique_fvs);
 
-  BuildIndices<DefaultVertexInput<DefaultPackedVertexData>,
-               DefaultVertexOutput<DefaultPackedVertexData>,
-               DefaultPackedVertexData, DefaultPackedVertexDataHasher,
-               DefaultPackedVertexDataEqual>(vertex_input, vertex_output,
-                                             out_indices, out_point_indices);
-
-  if (out_indices.size() != out_point_indices.size()) {
-    PUSH_ERROR_AND_RETURN(
-        "Internal error. out_indices.size != out_point_indices.");
-  }
+  // to reorder position data
+  std::vector<uint32_t> out_point_indices = fvIndices;
 
   DCOUT("faceVertexIndices.size : " << fvIndices.size());
   DCOUT("# of indices after the build: "
@@ -2733,8 +3120,8 @@ bool RenderSceneConverter::BuildVertexIndicesImpl(RenderMesh &mesh) {
       // org pointIdx -> List of pointIdx in reordered points.
       std::unordered_map<uint32_t, std::vector<uint32_t>> pointIdxRemap;
 
-      for (size_t i = 0; i < vertex_output.size(); i++) {
-        pointIdxRemap[vertex_output.point_indices[i]].push_back(uint32_t(i));
+      for (size_t i = 0; i < unique_fvs.size(); i++) {
+        pointIdxRemap[out_point_indices[unique_fvs[i]]].push_back(uint32_t(i));
       }
 
       for (auto &target : mesh.targets) {
@@ -2783,51 +3170,65 @@ bool RenderSceneConverter::BuildVertexIndicesImpl(RenderMesh &mesh) {
 
   // Other 'facevarying' attributes are now 'vertex' variability
   if (normals_ptr) {
+    std::vector<value::float3> buf =
+        GatherUniqueVertices(normals_ptr, unique_fvs);
     mesh.normals.set_buffer(
-        reinterpret_cast<const uint8_t *>(vertex_output.normals.data()),
-        vertex_output.normals.size() * sizeof(value::float3));
+        reinterpret_cast<const uint8_t *>(buf.data()),
+        buf.size() * sizeof(value::float3));
     mesh.normals.variability = VertexVariability::Vertex;
   }
 
   if (texcoord0_ptr) {
+    std::vector<value::float2> buf =
+        GatherUniqueVertices(texcoord0_ptr, unique_fvs);
     mesh.texcoords[0].set_buffer(
-        reinterpret_cast<const uint8_t *>(vertex_output.uv0s.data()),
-        vertex_output.uv0s.size() * sizeof(value::float2));
+        reinterpret_cast<const uint8_t *>(buf.data()),
+        buf.size() * sizeof(value::float2));
     mesh.texcoords[0].variability = VertexVariability::Vertex;
   }
 
   if (texcoord1_ptr) {
+    std::vector<value::float2> buf =
+        GatherUniqueVertices(texcoord1_ptr, unique_fvs);
     mesh.texcoords[1].set_buffer(
-        reinterpret_cast<const uint8_t *>(vertex_output.uv1s.data()),
-        vertex_output.uv1s.size() * sizeof(value::float2));
+        reinterpret_cast<const uint8_t *>(buf.data()),
+        buf.size() * sizeof(value::float2));
     mesh.texcoords[1].variability = VertexVariability::Vertex;
   }
 
   if (tangents_ptr) {
+    std::vector<value::float3> buf =
+        GatherUniqueVertices(tangents_ptr, unique_fvs);
     mesh.tangents.set_buffer(
-        reinterpret_cast<const uint8_t *>(vertex_output.tangents.data()),
-        vertex_output.tangents.size() * sizeof(value::float3));
+        reinterpret_cast<const uint8_t *>(buf.data()),
+        buf.size() * sizeof(value::float3));
     mesh.tangents.variability = VertexVariability::Vertex;
   }
 
   if (binormals_ptr) {
+    std::vector<value::float3> buf =
+        GatherUniqueVertices(binormals_ptr, unique_fvs);
     mesh.binormals.set_buffer(
-        reinterpret_cast<const uint8_t *>(vertex_output.binormals.data()),
-        vertex_output.binormals.size() * sizeof(value::float3));
+        reinterpret_cast<const uint8_t *>(buf.data()),
+        buf.size() * sizeof(value::float3));
     mesh.binormals.variability = VertexVariability::Vertex;
   }
 
   if (colors_ptr) {
+    std::vector<value::float3> buf =
+        GatherUniqueVertices(colors_ptr, unique_fvs);
     mesh.vertex_colors.set_buffer(
-        reinterpret_cast<const uint8_t *>(vertex_output.colors.data()),
-        vertex_output.colors.size() * sizeof(value::float3));
+        reinterpret_cast<const uint8_t *>(buf.data()),
+        buf.size() * sizeof(value::float3));
     mesh.vertex_colors.variability = VertexVariability::Vertex;
   }
 
   if (opacities_ptr) {
+    std::vector<float> buf =
+        GatherUniqueVertices(opacities_ptr, unique_fvs);
     mesh.vertex_opacities.set_buffer(
-        reinterpret_cast<const uint8_t *>(vertex_output.opacities.data()),
-        vertex_output.opacities.size() * sizeof(float));
+        reinterpret_cast<const uint8_t *>(buf.data()),
+        buf.size() * sizeof(float));
     mesh.vertex_opacities.variability = VertexVariability::Vertex;
   }
 
@@ -2868,6 +3269,14 @@ bool RenderSceneConverter::ConvertMesh(
     PUSH_ERROR_AND_RETURN("`dst` mesh pointer is nullptr");
   }
 
+  // Worker converter reads materials/textures of the parent converter, and
+  // does not spawn threads inside of the mesh conversion.
+  const std::vector<RenderMaterial> &src_materials =
+      _parent ? _parent->materials : materials;
+  const std::vector<UVTexture> &src_textures =
+      _parent ? _parent->textures : textures;
+  const int mesh_num_threads = _parent ? 1 : env.mesh_config.num_threads;
+
   RenderMesh dst;
 
   dst.is_rightHanded =
@@ -2881,9 +3290,11 @@ bool RenderSceneConverter::ConvertMesh(
   //
 
   {
-    std::vector<value::point3f> points;
-    bool ret = EvaluateTypedAnimatableAttribute(
-        env.stage, mesh.points, "points", &points, &_err, env.timecode,
+    // `points` references the attribute's storage where possible.
+    std::vector<value::point3f> buf;
+    value::ArrayView<value::point3f> points;
+    bool ret = EvaluateTypedAnimatableAttributeView(
+        env.stage, mesh.points, "points", &points, &buf, &_err, env.timecode,
         value::TimeSampleInterpolationType::Linear);
     if (!ret) {
       return false;
@@ -2900,14 +3311,16 @@ bool RenderSceneConverter::ConvertMesh(
   }
 
   {
-    std::vector<int32_t> indices;
-    bool ret = EvaluateTypedAnimatableAttribute(
-        env.stage, mesh.faceVertexIndices, "faceVertexIndices", &indices, &_err,
-        env.timecode, value::TimeSampleInterpolationType::Held);
+    std::vector<int32_t> buf;
+    value::ArrayView<int32_t> indices;
+    bool ret = EvaluateTypedAnimatableAttributeView(
+        env.stage, mesh.faceVertexIndices, "faceVertexIndices", &indices, &buf,
+        &_err, env.timecode, value::TimeSampleInterpolationType::Held);
     if (!ret) {
       return false;
     }
 
+    dst.usdFaceVertexIndices.reserve(indices.size());
     for (size_t i = 0; i < indices.size(); i++) {
       if (indices[i] < 0) {
         PUSH_ERROR_AND_RETURN(fmt::format(
@@ -2924,16 +3337,18 @@ bool RenderSceneConverter::ConvertMesh(
   }
 
   {
-    std::vector<int> counts;
-    bool ret = EvaluateTypedAnimatableAttribute(
-        env.stage, mesh.faceVertexCounts, "faceVertexCounts", &counts, &_err,
-        env.timecode, value::TimeSampleInterpolationType::Held);
+    std::vector<int32_t> buf;
+    value::ArrayView<int32_t> counts;
+    bool ret = EvaluateTypedAnimatableAttributeView(
+        env.stage, mesh.faceVertexCounts, "faceVertexCounts", &counts, &buf,
+        &_err, env.timecode, value::TimeSampleInterpolationType::Held);
     if (!ret) {
       return false;
     }
 
     size_t sumCounts = 0;
     dst.usdFaceVertexCounts.clear();
+    dst.usdFaceVertexCounts.reserve(counts.size());
     for (size_t i = 0; i < counts.size(); i++) {
       if (counts[i] < 3) {
         PUSH_ERROR_AND_RETURN(
@@ -2993,15 +3408,16 @@ bool RenderSceneConverter::ConvertMesh(
 
     // TODO: Raise error when indices is empty?
     if (psubset->indices.authored()) {
-      std::vector<int> indices;  // index to faceVertexCounts
-      bool ret = EvaluateTypedAnimatableAttribute(
-          env.stage, psubset->indices, "indices", &indices, &_err, env.timecode,
-          value::TimeSampleInterpolationType::Held);
+      std::vector<int32_t> buf;
+      value::ArrayView<int32_t> indices;  // index to faceVertexCounts
+      bool ret = EvaluateTypedAnimatableAttributeView(
+          env.stage, psubset->indices, "indices", &indices, &buf, &_err,
+          env.timecode, value::TimeSampleInterpolationType::Held);
       if (!ret) {
         return false;
       }
 
-      ms.usdIndices = indices;
+      ms.usdIndices = indices.to_vector();
     }
 
     if (subset_material_path_map.count(psubset->name)) {
@@ -3064,11 +3480,12 @@ bool RenderSceneConverter::ConvertMesh(
          mit++) {
       int64_t rmaterial_id = int64_t(mit->first);
 
-      if ((rmaterial_id > -1) && (size_t(rmaterial_id) < materials.size())) {
-        const RenderMaterial &material = materials[size_t(rmaterial_id)];
+      if ((rmaterial_id > -1) &&
+          (size_t(rmaterial_id) < src_materials.size())) {
+        const RenderMaterial &material = src_materials[size_t(rmaterial_id)];
 
         StringAndIdMap uvname_map;
-        if (!ListUVNames(material, textures, uvname_map)) {
+        if (!ListUVNames(material, src_textures, uvname_map)) {
           DCOUT("Failed to list UV names");
           return false;
         }
@@ -3433,7 +3850,7 @@ bool RenderSceneConverter::ConvertMesh(
             dst.points, dst.usdFaceVertexCounts, dst.usdFaceVertexIndices,
             triangulatedFaceVertexCounts, triangulatedFaceVertexIndices,
             triangulatedToOrigFaceVertexIndexMap, triangulatedFaceCounts,
-            err)) {
+            err, mesh_num_threads)) {
       PUSH_ERROR_AND_RETURN("Triangulation failed: " + err);
     }
 
@@ -3850,7 +4267,9 @@ bool RenderSceneConverter::ConvertMesh(
     DCOUT("Compute normals");
     std::vector<vec3> normals;
     if (!ComputeNormals(dst.points, dst.faceVertexCounts(),
-                       dst.faceVertexIndices(), normals, &_err)) {
+                        dst.faceVertexIndices(),
+                        env.mesh_config.normal_weighting,
+                        mesh_num_threads, normals, &_err)) {
       DCOUT("compute normals failed.");
       return false;
     }
@@ -3884,7 +4303,7 @@ bool RenderSceneConverter::ConvertMesh(
   if (env.mesh_config.build_vertex_indices && (!is_single_indexable)) {
     DCOUT("Build vertex indices");
 
-    if (!BuildVertexIndicesImpl(dst)) {
+    if (!BuildVertexIndicesImpl(dst, mesh_num_threads)) {
       return false;
     }
 
@@ -3918,45 +4337,60 @@ bool RenderSceneConverter::ConvertMesh(
 
     if (!ComputeTangentsAndBinormals(dst.points, dst.faceVertexCounts(),
                                      dst.faceVertexIndices(), texcoords,
-                                     normals, !is_single_indexable, &tangents,
+                                     normals, !is_single_indexable,
+                                     mesh_num_threads, &tangents,
                                      &binormals, &vertex_indices, &_err)) {
       PUSH_ERROR_AND_RETURN("Failed to compute tangents/binormals.");
     }
 
-    // 1. Firstly, always convert tangents/binormals to 'facevarying'
-    // variability
+    // 1. Convert tangents/binormals to 'facevarying' variability.
+    //    For single-indexable mesh, convert them to 'vertex' variability
+    //    instead(face vertices of the same point have the same tangent frame
+    //    since 'vertex' inputs are merged by point index).
+    //    BuildVertexIndicesImpl cannot be applied to the mesh whose attributes
+    //    are already 'vertex'.
     {
-      std::vector<vec3> facevarying_tangents;
-      std::vector<vec3> facevarying_binormals;
-      facevarying_tangents.assign(vertex_indices.size(), {0.0f, 0.0f, 0.0f});
-      facevarying_binormals.assign(vertex_indices.size(), {0.0f, 0.0f, 0.0f});
+      const std::vector<uint32_t> &fvIndices = dst.faceVertexIndices();
+      const size_t n =
+          is_single_indexable ? dst.points.size() : vertex_indices.size();
+      std::vector<vec3> dst_tangents;
+      std::vector<vec3> dst_binormals;
+      dst_tangents.assign(n, {0.0f, 0.0f, 0.0f});
+      dst_binormals.assign(n, {0.0f, 0.0f, 0.0f});
       for (size_t i = 0; i < vertex_indices.size(); i++) {
-        facevarying_tangents[i] = tangents[vertex_indices[i]];
-        facevarying_binormals[i] = binormals[vertex_indices[i]];
+        const size_t idx = is_single_indexable ? fvIndices[i] : i;
+        dst_tangents[idx] = tangents[vertex_indices[i]];
+        dst_binormals[idx] = binormals[vertex_indices[i]];
       }
 
-      dst.tangents.data.resize(facevarying_tangents.size() * sizeof(vec3));
-      memcpy(dst.tangents.data.data(), facevarying_tangents.data(),
-             facevarying_tangents.size() * sizeof(vec3));
+      const VertexVariability variability = is_single_indexable
+                                                ? VertexVariability::Vertex
+                                                : VertexVariability::FaceVarying;
+
+      dst.tangents.data.resize(dst_tangents.size() * sizeof(vec3));
+      memcpy(dst.tangents.data.data(), dst_tangents.data(),
+             dst_tangents.size() * sizeof(vec3));
 
       dst.tangents.format = VertexAttributeFormat::Vec3;
       dst.tangents.stride = 0;
       dst.tangents.elementSize = 1;
-      dst.tangents.variability = VertexVariability::FaceVarying;
+      dst.tangents.variability = variability;
+      dst.tangents.indices.clear();
 
-      dst.binormals.data.resize(facevarying_binormals.size() * sizeof(vec3));
-      memcpy(dst.binormals.data.data(), facevarying_binormals.data(),
-             facevarying_binormals.size() * sizeof(vec3));
+      dst.binormals.data.resize(dst_binormals.size() * sizeof(vec3));
+      memcpy(dst.binormals.data.data(), dst_binormals.data(),
+             dst_binormals.size() * sizeof(vec3));
 
       dst.binormals.format = VertexAttributeFormat::Vec3;
       dst.binormals.stride = 0;
       dst.binormals.elementSize = 1;
-      dst.binormals.variability = VertexVariability::FaceVarying;
+      dst.binormals.variability = variability;
+      dst.binormals.indices.clear();
     }
 
     // 2. Build single vertex indices if `build_vertex_indices` is true.
-    if (env.mesh_config.build_vertex_indices) {
-      if (!BuildVertexIndicesImpl(dst)) {
+    if (!is_single_indexable && env.mesh_config.build_vertex_indices) {
+      if (!BuildVertexIndicesImpl(dst, mesh_num_threads)) {
         return false;
       }
       is_single_indexable = true;
@@ -3965,6 +4399,18 @@ bool RenderSceneConverter::ConvertMesh(
 
   dst.is_single_indexable = is_single_indexable;
 
+  //
+  // 9. Reorder triangles and vertices for vertex cache locality.
+  //
+  if (env.mesh_config.optimize_vertex_cache && dst.is_triangulated()) {
+    std::string vc_err;
+    if (!OptimizeRenderMeshVertexCache(&dst, env.mesh_config.vertex_cache_size,
+                                       &vc_err)) {
+      PUSH_WARN(fmt::format("Skip vertex cache optimization of {}: {}",
+                            abs_path.full_path_name(), vc_err));
+    }
+  }
+
   dst.prim_name = mesh.name;
   dst.abs_path = abs_path.full_path_name();
   dst.display_name = mesh.metas().displayName.value_or("");
@@ -4213,359 +4659,444 @@ nonstd::expected<bool, std::string> GetConnectedUVTexture(
 
 }  // namespace
 
-// Convert UsdUVTexture shader node.
-// @return true upon conversion success(textures.back() contains the converted
-// UVTexture)
-//
-// Possible network configuration
-//
-// - UsdUVTexture -> UsdPrimvarReader
-// - UsdUVTexture -> UsdTransform2d -> UsdPrimvarReader
-bool RenderSceneConverter::ConvertUVTexture(const RenderSceneConverterEnv &env,
-                                            const Path &tex_abs_path,
-                                            const AssetInfo &assetInfo,
-                                            const UsdUVTexture &texture,
-                                            UVTexture *tex_out) {
-  DCOUT("ConvertUVTexture " << tex_abs_path);
-
-  if (!tex_out) {
-    PUSH_ERROR_AND_RETURN("tex_out arg is nullptr.");
-  }
-  std::string err;
-
-  UVTexture tex;
-
-  if (!texture.file.authored()) {
-    PUSH_ERROR_AND_RETURN(fmt::format("`asset:file` is not authored. Path = {}",
-                                      tex_abs_path.prim_part()));
-  }
+bool RenderSceneConverter::LoadTextureImageImpl(
+    const RenderSceneConverterEnv &env, const Path &tex_abs_path,
+    const value::AssetPath &assetPath, const AssetInfo &assetInfo,
+    const UsdUVTexture &texture, TextureImage *texImageOut,
+    BufferData *imageBufferOut, bool *tex_loaded_out) {
+  DCOUT("LoadTextureImage " << tex_abs_path);
+  (void)tex_abs_path;
 
-  value::AssetPath assetPath;
-  if (auto apath = texture.file.get_value()) {
-    if (!apath.value().get(env.timecode, &assetPath)) {
-      PUSH_ERROR_AND_RETURN(fmt::format(
-          "Failed to get `asset:file` value from Path {} at time {}",
-          tex_abs_path.prim_part(), env.timecode));
-    }
-  } else {
-    PUSH_ERROR_AND_RETURN(
-        fmt::format("Failed to get `asset:file` value from Path {}",
-                    tex_abs_path.prim_part()));
+  if (!texImageOut || !imageBufferOut || !tex_loaded_out) {
+    PUSH_ERROR_AND_RETURN("Invalid argument(nullptr).");
   }
 
-  // TextureImage and BufferData
-  {
-    TextureImage texImage;
-    BufferData assetImageBuffer;
-
-    // Texel data is treated as byte array
-    assetImageBuffer.componentType = ComponentType::UInt8;
+  std::string err;
 
-    bool tex_loaded{false};
+  TextureImage texImage;
+  BufferData assetImageBuffer;
 
-    if (env.scene_config.load_texture_assets) {
-      DCOUT("load texture : " << assetPath.GetAssetPath());
-      std::string warn;
+  // Texel data is treated as byte array
+  assetImageBuffer.componentType = ComponentType::UInt8;
 
-      TextureImageLoaderFunction tex_loader_fun =
-          env.material_config.texture_image_loader_function;
+  bool tex_loaded{false};
 
-      if (!tex_loader_fun) {
-        tex_loader_fun = DefaultTextureImageLoaderFunction;
-      }
+  if (env.scene_config.load_texture_assets) {
+    DCOUT("load texture : " << assetPath.GetAssetPath());
+    std::string warn;
 
-      tex_loaded = tex_loader_fun(
-          assetPath, assetInfo, env.asset_resolver, &texImage,
-          &assetImageBuffer.data,
-          env.material_config.texture_image_loader_function_userdata, &warn,
-          &err);
+    TextureImageLoaderFunction tex_loader_fun =
+        env.material_config.texture_image_loader_function;
 
-      if (warn.size()) {
-        DCOUT("WARN: " << warn);
-        PushWarn(warn);
-      }
+    if (!tex_loader_fun) {
+      tex_loader_fun = DefaultTextureImageLoaderFunction;
+    }
 
-      if (!tex_loaded && !env.material_config.allow_texture_load_failure) {
-        PUSH_ERROR_AND_RETURN(fmt::format("Failed to load texture image: `{}` err = {}", assetPath.GetAssetPath(), err));
-      }
+    tex_loaded = tex_loader_fun(
+        assetPath, assetInfo, env.asset_resolver, &texImage,
+        &assetImageBuffer.data,
+        env.material_config.texture_image_loader_function_userdata, &warn,
+        &err);
 
+    if (warn.size()) {
+      DCOUT("WARN: " << warn);
+      PushWarn(warn);
+    }
 
-      if (err.size()) {
-        // report as warn.
-        PUSH_WARN(fmt::format("Failed to load texture image: `{}`. Skip loading. reason = {} ", assetPath.GetAssetPath(), err));
-      }
+    if (!tex_loaded && !env.material_config.allow_texture_load_failure) {
+      PUSH_ERROR_AND_RETURN(fmt::format("Failed to load texture image: `{}` err = {}", assetPath.GetAssetPath(), err));
+    }
 
-      // store unresolved asset path.
-      texImage.asset_identifier = assetPath.GetAssetPath();
 
-    } else {
-      // store resolved asset path.
-      texImage.asset_identifier =
-          env.asset_resolver.resolve(assetPath.GetAssetPath());
-    }
-
-    // colorSpace.
-    // First look into `colorSpace` metadata of asset, then
-    // look into `inputs:sourceColorSpace' attribute.
-    // When both `colorSpace` metadata and `inputs:sourceColorSpace' attribute
-    // exists, `colorSpace` metadata supercedes.
-    // NOTE: `inputs:sourceColorSpace` attribute should be deprecated in favor of `colorSpace` metadata.
-    bool inferColorSpaceFailed = false;
-    if (texture.file.metas().has_colorSpace()) {
-      ColorSpace cs;
-      value::token cs_token = texture.file.metas().get_colorSpace();
-      if (InferColorSpace(cs_token, &cs)) {
-        texImage.usdColorSpace = cs;
-        DCOUT("Inferred colorSpace: " << to_string(cs));
-      } else {
-        inferColorSpaceFailed = true;
-      }
+    if (err.size()) {
+      // report as warn.
+      PUSH_WARN(fmt::format("Failed to load texture image: `{}`. Skip loading. reason = {} ", assetPath.GetAssetPath(), err));
     }
 
-    bool sourceColorSpaceSet = false;
-    if (inferColorSpaceFailed || !texture.file.metas().has_colorSpace()) {
-      if (texture.sourceColorSpace.authored()) {
-        UsdUVTexture::SourceColorSpace cs;
-        if (texture.sourceColorSpace.get_value().get(env.timecode, &cs)) {
-          if (cs == UsdUVTexture::SourceColorSpace::SRGB) {
-            texImage.usdColorSpace = tydra::ColorSpace::sRGB;
-            sourceColorSpaceSet = true;
-          } else if (cs == UsdUVTexture::SourceColorSpace::Raw) {
-            texImage.usdColorSpace = tydra::ColorSpace::Raw;
-            sourceColorSpaceSet = true;
-          } else if (cs == UsdUVTexture::SourceColorSpace::Auto) {
-
-            if (tex_loaded) {
-
-              // The spec says: https://openusd.org/release/spec_usdpreviewsurface.html
-              //
-              // auto : Check for gamma/color space metadata in the texture file itself; if metadata is indicative of sRGB, mark texture as sRGB . If no relevant metadata is found, mark texture as sRGB if it is either 8-bit and has 3 channels or if it is 8-bit and has 4 channels. Otherwise, do not mark texture as sRGB and use texture data as it was read from the texture.
-              //
-              if (((texImage.assetTexelComponentType == ComponentType::UInt8) ||
-                  (texImage.assetTexelComponentType == ComponentType::Int8)) &&
-                ((texImage.channels == 3) || (texImage.channels ==4))) {
-                texImage.usdColorSpace = tydra::ColorSpace::sRGB;
-                sourceColorSpaceSet = true;
-              } else {
-                PUSH_WARN(fmt::format("Infer colorSpace failed for {}. Set to Raw for now. Results may be wrong.", assetPath.GetAssetPath()));
-                // At least 'not' sRGB. For now set to Raw.
+    // store unresolved asset path.
+    texImage.asset_identifier = assetPath.GetAssetPath();
 
-                texImage.usdColorSpace = tydra::ColorSpace::Raw;
-                sourceColorSpaceSet = true;
-              }
+  } else {
+    // store resolved asset path.
+    texImage.asset_identifier =
+        env.asset_resolver.resolve(assetPath.GetAssetPath());
+  }
+
+  // colorSpace.
+  // First look into `colorSpace` metadata of asset, then
+  // look into `inputs:sourceColorSpace' attribute.
+  // When both `colorSpace` metadata and `inputs:sourceColorSpace' attribute
+  // exists, `colorSpace` metadata supercedes.
+  // NOTE: `inputs:sourceColorSpace` attribute should be deprecated in favor of `colorSpace` metadata.
+  bool inferColorSpaceFailed = false;
+  if (texture.file.metas().has_colorSpace()) {
+    ColorSpace cs;
+    value::token cs_token = texture.file.metas().get_colorSpace();
+    if (InferColorSpace(cs_token, &cs)) {
+      texImage.usdColorSpace = cs;
+      DCOUT("Inferred colorSpace: " << to_string(cs));
+    } else {
+      inferColorSpaceFailed = true;
+    }
+  }
+
+  bool sourceColorSpaceSet = false;
+  if (inferColorSpaceFailed || !texture.file.metas().has_colorSpace()) {
+    if (texture.sourceColorSpace.authored()) {
+      UsdUVTexture::SourceColorSpace cs;
+      if (texture.sourceColorSpace.get_value().get(env.timecode, &cs)) {
+        if (cs == UsdUVTexture::SourceColorSpace::SRGB) {
+          texImage.usdColorSpace = tydra::ColorSpace::sRGB;
+          sourceColorSpaceSet = true;
+        } else if (cs == UsdUVTexture::SourceColorSpace::Raw) {
+          texImage.usdColorSpace = tydra::ColorSpace::Raw;
+          sourceColorSpaceSet = true;
+        } else if (cs == UsdUVTexture::SourceColorSpace::Auto) {
+
+          if (tex_loaded) {
+
+            // The spec says: https://openusd.org/release/spec_usdpreviewsurface.html
+            //
+            // auto : Check for gamma/color space metadata in the texture file itself; if metadata is indicative of sRGB, mark texture as sRGB . If no relevant metadata is found, mark texture as sRGB if it is either 8-bit and has 3 channels or if it is 8-bit and has 4 channels. Otherwise, do not mark texture as sRGB and use texture data as it was read from the texture.
+            //
+            if (((texImage.assetTexelComponentType == ComponentType::UInt8) ||
+                (texImage.assetTexelComponentType == ComponentType::Int8)) &&
+              ((texImage.channels == 3) || (texImage.channels ==4))) {
+              texImage.usdColorSpace = tydra::ColorSpace::sRGB;
+              sourceColorSpaceSet = true;
             } else {
-              texImage.usdColorSpace = tydra::ColorSpace::Unknown;
+              PUSH_WARN(fmt::format("Infer colorSpace failed for {}. Set to Raw for now. Results may be wrong.", assetPath.GetAssetPath()));
+              // At least 'not' sRGB. For now set to Raw.
+
+              texImage.usdColorSpace = tydra::ColorSpace::Raw;
               sourceColorSpaceSet = true;
             }
+          } else {
+            texImage.usdColorSpace = tydra::ColorSpace::Unknown;
+            sourceColorSpaceSet = true;
           }
         }
       }
     }
+  }
 
-    if (!sourceColorSpaceSet && inferColorSpaceFailed) {
-      value::token cs_token = texture.file.metas().get_colorSpace();
-      PUSH_ERROR_AND_RETURN(
-          fmt::format("Invalid or unknown colorSpace metadataum: {}. Please "
-                      "report an issue to TinyUSDZ github repo.",
-                      cs_token.str()));
-    }
-
-    if (tex_loaded) {
-      BufferData imageBuffer;
-
-      // Linearlization and widen texel bit depth if required.
-      if (env.material_config.linearize_color_space) {
-        // TODO: Support ACEScg and Lin_DisplayP3
-        DCOUT("linearlize colorspace.");
-        size_t width = size_t(texImage.width);
-        size_t height = size_t(texImage.height);
-        size_t channels = size_t(texImage.channels);
-
-        if (channels > 4) {
-          PUSH_ERROR_AND_RETURN(
-              fmt::format("TODO: Multiband color channels(5 or more) are not "
-                          "supported(yet)."));
-        }
-
-        if (assetImageBuffer.componentType == tydra::ComponentType::UInt8) {
-          if (texImage.usdColorSpace == tydra::ColorSpace::sRGB) {
-            if (env.material_config.preserve_texel_bitdepth) {
-              // u8 sRGB -> u8 Linear
-              imageBuffer.componentType = tydra::ComponentType::UInt8;
-
-              bool ret = srgb_8bit_to_linear_8bit(
-                  assetImageBuffer.data, width, height, channels,
-                  /* channel stride */ channels, &imageBuffer.data, &_err);
-              if (!ret) {
-                PUSH_ERROR_AND_RETURN(
-                    "Failed to convert sRGB u8 image to Linear u8 image.");
-              }
-
-            } else {
-              DCOUT("u8 sRGB -> fp32 linear.");
-              // u8 sRGB -> fp32 Linear
-              imageBuffer.componentType = tydra::ComponentType::Float;
-
-              std::vector<float> buf;
-              bool ret = srgb_8bit_to_linear_f32(
-                  assetImageBuffer.data, width, height, channels,
-                  /* channel stride */ channels, &buf, &_err);
-              if (!ret) {
-                PUSH_ERROR_AND_RETURN(
-                    "Failed to convert sRGB u8 image to Linear f32 image.");
-              }
+  if (!sourceColorSpaceSet && inferColorSpaceFailed) {
+    value::token cs_token = texture.file.metas().get_colorSpace();
+    PUSH_ERROR_AND_RETURN(
+        fmt::format("Invalid or unknown colorSpace metadataum: {}. Please "
+                    "report an issue to TinyUSDZ github repo.",
+                    cs_token.str()));
+  }
 
-              DCOUT("sz = " << buf.size());
-              imageBuffer.data.resize(buf.size() * sizeof(float));
-              memcpy(imageBuffer.data.data(), buf.data(),
-                     sizeof(float) * buf.size());
-            }
+  if (tex_loaded) {
+    BufferData imageBuffer;
 
-            texImage.colorSpace = tydra::ColorSpace::Lin_sRGB;
+    // Linearlization and widen texel bit depth if required.
+    if (env.material_config.linearize_color_space) {
+      // TODO: Support ACEScg and Lin_DisplayP3
+      DCOUT("linearlize colorspace.");
+      size_t width = size_t(texImage.width);
+      size_t height = size_t(texImage.height);
+      size_t channels = size_t(texImage.channels);
 
-          } else if (texImage.usdColorSpace == tydra::ColorSpace::Lin_sRGB) {
-            if (env.material_config.preserve_texel_bitdepth) {
-              // no op.
-              imageBuffer = std::move(assetImageBuffer);
+      if (channels > 4) {
+        PUSH_ERROR_AND_RETURN(
+            fmt::format("TODO: Multiband color channels(5 or more) are not "
+                        "supported(yet)."));
+      }
 
-            } else {
-              // u8 -> fp32
-              imageBuffer.componentType = tydra::ComponentType::Float;
-
-              std::vector<float> buf;
-              bool ret = u8_to_f32_image(assetImageBuffer.data, width, height,
-                                         channels, &buf, &_err);
-              if (!ret) {
-                PUSH_ERROR_AND_RETURN("Failed to convert u8 image to f32 image.");
-              }
+      if (assetImageBuffer.componentType == tydra::ComponentType::UInt8) {
+        if (texImage.usdColorSpace == tydra::ColorSpace::sRGB) {
+          if (env.material_config.preserve_texel_bitdepth) {
+            // u8 sRGB -> u8 Linear
+            imageBuffer.componentType = tydra::ComponentType::UInt8;
 
-              imageBuffer.data.resize(buf.size() * sizeof(float));
-              memcpy(imageBuffer.data.data(), buf.data(),
-                     sizeof(float) * buf.size());
+            bool ret = srgb_8bit_to_linear_8bit(
+                assetImageBuffer.data, width, height, channels,
+                /* channel stride */ channels, &imageBuffer.data, &_err);
+            if (!ret) {
+              PUSH_ERROR_AND_RETURN(
+                  "Failed to convert sRGB u8 image to Linear u8 image.");
             }
 
-            texImage.colorSpace = tydra::ColorSpace::Lin_sRGB;
-
           } else {
-            PUSH_ERROR(fmt::format("TODO: Color space {}",
-                                   to_string(texImage.usdColorSpace)));
-          }
-
-        } else if (assetImageBuffer.componentType ==
-                   tydra::ComponentType::Float) {
-          // ignore preserve_texel_bitdepth
-
-          if (texImage.usdColorSpace == tydra::ColorSpace::sRGB) {
-            // srgb f32 -> linear f32
-            std::vector<float> in_buf;
-            std::vector<float> out_buf;
-            in_buf.resize(assetImageBuffer.data.size() / sizeof(float));
-            memcpy(in_buf.data(), assetImageBuffer.data.data(),
-                   in_buf.size() * sizeof(float));
-
-            out_buf.resize(assetImageBuffer.data.size() / sizeof(float));
-
-            // TODO: scale factor & bias
-            float scale_factor = 1.0f;
-            float bias = 0.0f;
-            float alpha_scale_factor = 1.0f;
-            float alpha_bias = 0.0f;
-
-            bool ret =
-                srgb_f32_to_linear_f32(in_buf, width, height, channels,
-                                       /* channel stride */ channels, &out_buf, scale_factor, bias, alpha_scale_factor, alpha_bias, &_err);
+            DCOUT("u8 sRGB -> fp32 linear.");
+            // u8 sRGB -> fp32 Linear
+            imageBuffer.componentType = tydra::ComponentType::Float;
 
+            std::vector<float> buf;
+            bool ret = srgb_8bit_to_linear_f32(
+                assetImageBuffer.data, width, height, channels,
+                /* channel stride */ channels, &buf, &_err);
             if (!ret) {
               PUSH_ERROR_AND_RETURN(
-                  "Failed to convert sRGB f32 image to Linear f32 image.");
+                  "Failed to convert sRGB u8 image to Linear f32 image.");
             }
 
-            imageBuffer.data.resize(assetImageBuffer.data.size());
-            memcpy(imageBuffer.data.data(), out_buf.data(),
-                   imageBuffer.data.size());
-
-
-          } else if (texImage.usdColorSpace == tydra::ColorSpace::Lin_sRGB) {
-            // no op
-            imageBuffer = std::move(assetImageBuffer);
-
-          } else {
-            PUSH_ERROR(fmt::format("TODO: Color space {}",
-                                   to_string(texImage.usdColorSpace)));
+            DCOUT("sz = " << buf.size());
+            imageBuffer.data.resize(buf.size() * sizeof(float));
+            memcpy(imageBuffer.data.data(), buf.data(),
+                   sizeof(float) * buf.size());
           }
 
-        } else {
-          PUSH_ERROR(fmt::format("TODO: asset texture texel format {}",
-                                 to_string(assetImageBuffer.componentType)));
-        }
-
-      } else {
-        // Same color space.
-        DCOUT("assetImageBuffer.sz = " << assetImageBuffer.data.size());
+          texImage.colorSpace = tydra::ColorSpace::Lin_sRGB;
 
-        if (assetImageBuffer.componentType == tydra::ComponentType::UInt8) {
+        } else if (texImage.usdColorSpace == tydra::ColorSpace::Lin_sRGB) {
           if (env.material_config.preserve_texel_bitdepth) {
-            // Do nothing.
+            // no op.
             imageBuffer = std::move(assetImageBuffer);
 
           } else {
-            size_t width = size_t(texImage.width);
-            size_t height = size_t(texImage.height);
-            size_t channels = size_t(texImage.channels);
-
-            // u8 to f32, but no sRGB -> linear conversion(this would break
-            // UsdPreviewSurface's spec though)
-            PUSH_WARN(
-                "8bit sRGB texture is converted to fp32 sRGB texture(without "
-                "linearlization)");
+            // u8 -> fp32
+            imageBuffer.componentType = tydra::ComponentType::Float;
+
             std::vector<float> buf;
             bool ret = u8_to_f32_image(assetImageBuffer.data, width, height,
                                        channels, &buf, &_err);
             if (!ret) {
               PUSH_ERROR_AND_RETURN("Failed to convert u8 image to f32 image.");
             }
-            imageBuffer.componentType = tydra::ComponentType::Float;
 
             imageBuffer.data.resize(buf.size() * sizeof(float));
             memcpy(imageBuffer.data.data(), buf.data(),
                    sizeof(float) * buf.size());
           }
 
-          texImage.colorSpace = texImage.usdColorSpace;
-
-        } else if (assetImageBuffer.componentType ==
-                   tydra::ComponentType::Float) {
-          // ignore preserve_texel_bitdepth
-
-          // f32 to f32, so no op
-          imageBuffer = std::move(assetImageBuffer);
+          texImage.colorSpace = tydra::ColorSpace::Lin_sRGB;
 
         } else {
-          PUSH_ERROR(fmt::format("TODO: asset texture texel format {}",
-                                 to_string(assetImageBuffer.componentType)));
+          PUSH_ERROR(fmt::format("TODO: Color space {}",
+                                 to_string(texImage.usdColorSpace)));
         }
-      }
 
-      // Assign buffer id
-      texImage.buffer_id = int64_t(buffers.size());
+      } else if (assetImageBuffer.componentType ==
+                 tydra::ComponentType::Float) {
+        // ignore preserve_texel_bitdepth
+
+        if (texImage.usdColorSpace == tydra::ColorSpace::sRGB) {
+          // srgb f32 -> linear f32
+          std::vector<float> in_buf;
+          std::vector<float> out_buf;
+          in_buf.resize(assetImageBuffer.data.size() / sizeof(float));
+          memcpy(in_buf.data(), assetImageBuffer.data.data(),
+                 in_buf.size() * sizeof(float));
+
+          out_buf.resize(assetImageBuffer.data.size() / sizeof(float));
+
+          // TODO: scale factor & bias
+          float scale_factor = 1.0f;
+          float bias = 0.0f;
+          float alpha_scale_factor = 1.0f;
+          float alpha_bias = 0.0f;
+
+          bool ret =
+              srgb_f32_to_linear_f32(in_buf, width, height, channels,
+                                     /* channel stride */ channels, &out_buf, scale_factor, bias, alpha_scale_factor, alpha_bias, &_err);
+
+          if (!ret) {
+            PUSH_ERROR_AND_RETURN(
+                "Failed to convert sRGB f32 image to Linear f32 image.");
+          }
+
+          imageBuffer.data.resize(assetImageBuffer.data.size());
+          memcpy(imageBuffer.data.data(), out_buf.data(),
+                 imageBuffer.data.size());
+
+
+        } else if (texImage.usdColorSpace == tydra::ColorSpace::Lin_sRGB) {
+          // no op
+          imageBuffer = std::move(assetImageBuffer);
+
+        } else {
+          PUSH_ERROR(fmt::format("TODO: Color space {}",
+                                 to_string(texImage.usdColorSpace)));
+        }
+
+      } else {
+        PUSH_ERROR(fmt::format("TODO: asset texture texel format {}",
+                               to_string(assetImageBuffer.componentType)));
+      }
+
+    } else {
+      // Same color space.
+      DCOUT("assetImageBuffer.sz = " << assetImageBuffer.data.size());
+
+      if (assetImageBuffer.componentType == tydra::ComponentType::UInt8) {
+        if (env.material_config.preserve_texel_bitdepth) {
+          // Do nothing.
+          imageBuffer = std::move(assetImageBuffer);
+
+        } else {
+          size_t width = size_t(texImage.width);
+          size_t height = size_t(texImage.height);
+          size_t channels = size_t(texImage.channels);
+
+          // u8 to f32, but no sRGB -> linear conversion(this would break
+          // UsdPreviewSurface's spec though)
+          PUSH_WARN(
+              "8bit sRGB texture is converted to fp32 sRGB texture(without "
+              "linearlization)");
+          std::vector<float> buf;
+          bool ret = u8_to_f32_image(assetImageBuffer.data, width, height,
+                                     channels, &buf, &_err);
+          if (!ret) {
+            PUSH_ERROR_AND_RETURN("Failed to convert u8 image to f32 image.");
+          }
+          imageBuffer.componentType = tydra::ComponentType::Float;
+
+          imageBuffer.data.resize(buf.size() * sizeof(float));
+          memcpy(imageBuffer.data.data(), buf.data(),
+                 sizeof(float) * buf.size());
+        }
+
+        texImage.colorSpace = texImage.usdColorSpace;
+
+      } else if (assetImageBuffer.componentType ==
+                 tydra::ComponentType::Float) {
+        // ignore preserve_texel_bitdepth
+
+        // f32 to f32, so no op
+        imageBuffer = std::move(assetImageBuffer);
+
+      } else {
+        PUSH_ERROR(fmt::format("TODO: asset texture texel format {}",
+                               to_string(assetImageBuffer.componentType)));
+      }
+    }
+
+    (*imageBufferOut) = std::move(imageBuffer);
+  }
+
+  (*texImageOut) = std::move(texImage);
+  (*tex_loaded_out) = tex_loaded;
+
+  return true;
+}
+
+int64_t RenderSceneConverter::AddTextureImage(const std::string &asset_path,
+                                              TextureImage &&texImage,
+                                              BufferData &&imageBuffer) {
+  // Assign buffer id
+  texImage.buffer_id = int64_t(buffers.size());
+
+  // TODO: Share image data as much as possible.
+  // e.g. Texture A and B uses same image file, but texturing parameter is
+  // different.
+  buffers.emplace_back(std::move(imageBuffer));
+
+  int64_t image_id = int64_t(images.size());
+
+  std::stringstream ss;
+  ss << "Loaded texture image " << asset_path
+     << " : buffer_id " + std::to_string(texImage.buffer_id) << "\n";
+  ss << "  width x height x components " << texImage.width << " x "
+     << texImage.height << " x " << texImage.channels << "\n";
+  ss << "  colorSpace " << tinyusdz::tydra::to_string(texImage.colorSpace)
+     << "\n";
+  PushInfo(ss.str());
+
+  images.emplace_back(std::move(texImage));
+
+  return image_id;
+}
+
+// Convert UsdUVTexture shader node.
+// @return true upon conversion success(textures.back() contains the converted
+// UVTexture)
+//
+// Possible network configuration
+//
+// - UsdUVTexture -> UsdPrimvarReader
+// - UsdUVTexture -> UsdTransform2d -> UsdPrimvarReader
+bool RenderSceneConverter::ConvertUVTexture(const RenderSceneConverterEnv &env,
+                                            const Path &tex_abs_path,
+                                            const AssetInfo &assetInfo,
+                                            const UsdUVTexture &texture,
+                                            UVTexture *tex_out) {
+  DCOUT("ConvertUVTexture " << tex_abs_path);
+
+  if (!tex_out) {
+    PUSH_ERROR_AND_RETURN("tex_out arg is nullptr.");
+  }
+  std::string err;
+
+  UVTexture tex;
 
-      // TODO: Share image data as much as possible.
-      // e.g. Texture A and B uses same image file, but texturing parameter is
-      // different.
-      buffers.emplace_back(imageBuffer);
+  if (!texture.file.authored()) {
+    PUSH_ERROR_AND_RETURN(fmt::format("`asset:file` is not authored. Path = {}",
+                                      tex_abs_path.prim_part()));
+  }
+
+  value::AssetPath assetPath;
+  if (auto apath = texture.file.get_value()) {
+    if (!apath.value().get(env.timecode, &assetPath)) {
+      PUSH_ERROR_AND_RETURN(fmt::format(
+          "Failed to get `asset:file` value from Path {} at time {}",
+          tex_abs_path.prim_part(), env.timecode));
+    }
+  } else {
+    PUSH_ERROR_AND_RETURN(
+        fmt::format("Failed to get `asset:file` value from Path {}",
+                    tex_abs_path.prim_part()));
+  }
+
+  // TextureImage and BufferData
+  if (env.scene_config.load_texture_assets && _defer_texture_loading) {
+    // Texture images are loaded later in LoadTexturesImpl.
+    // The same texture file with the same colorSpace setting is loaded only
+    // once.
+    std::string key = env.asset_resolver.resolve(assetPath.GetAssetPath());
+    if (key.empty()) {
+      key = assetPath.GetAssetPath();
+    }
+
+    key += "|";
+    if (texture.file.metas().has_colorSpace()) {
+      key += texture.file.metas().get_colorSpace().str();
+    }
+
+    key += "|";
+    if (texture.sourceColorSpace.authored()) {
+      UsdUVTexture::SourceColorSpace cs;
+      if (texture.sourceColorSpace.get_value().get(env.timecode, &cs)) {
+        key += tinyusdz::to_string(cs);
+      }
+    }
+
+    size_t request_id{0};
+    const auto it = _texture_request_map.find(key);
+    if (it != _texture_request_map.end()) {
+      request_id = it->second;
+    } else {
+      request_id = _texture_requests.size();
+
+      TextureImageRequest req;
+      req.tex_abs_path = tex_abs_path;
+      req.asset_path = assetPath;
+      req.asset_info = assetInfo;
+      req.texture = &texture;
+      _texture_requests.emplace_back(std::move(req));
+
+      _texture_request_map[key] = request_id;
+    }
+
+    // Replaced with the id of TextureImage in LoadTexturesImpl.
+    tex.texture_image_id = int64_t(request_id);
 
-      tex.texture_image_id = int64_t(images.size());
+  } else {
+    TextureImage texImage;
+    BufferData imageBuffer;
+    bool tex_loaded{false};
 
-      images.emplace_back(texImage);
+    if (!LoadTextureImageImpl(env, tex_abs_path, assetPath, assetInfo,
+                              texture, &texImage, &imageBuffer,
+                              &tex_loaded)) {
+      return false;
+    }
 
-      std::stringstream ss;
-      ss << "Loaded texture image " << assetPath.GetAssetPath()
-         << " : buffer_id " + std::to_string(texImage.buffer_id) << "\n";
-      ss << "  width x height x components " << texImage.width << " x "
-         << texImage.height << " x " << texImage.channels << "\n";
-      ss << "  colorSpace " << tinyusdz::tydra::to_string(texImage.colorSpace)
-         << "\n";
-      PushInfo(ss.str());
+    if (tex_loaded) {
+      tex.texture_image_id = AddTextureImage(
+          assetPath.GetAssetPath(), std::move(texImage), std::move(imageBuffer));
     }
   }
 
@@ -5039,13 +5570,65 @@ bool RenderSceneConverter::ConvertMaterial(const RenderSceneConverterEnv &env,
   return true;
 }
 
+struct MeshConvertItem {
+  Path abs_path;
+  const GeomMesh *mesh{nullptr};
+  MaterialPath material_path;
+  std::map<std::string, MaterialPath> subset_material_path_map;
+  std::vector<const GeomSubset *> material_subsets;
+  std::vector<std::pair<std::string, const BlendShape *>> blendshapes;
+
+  // true when the mesh refers to Prims outside of its subtree(Skeleton,
+  // BlendShape targets, attribute connections). Converted serially.
+  bool refers_external_prims{false};
+};
+
 namespace {
 
+//
+// Materials bound to GeomMesh are converted in the traversal, and GeomMeshes
+// are collected to `mesh_items`(converted later in ConvertMeshesImpl).
+//
 struct MeshVisitorEnv {
   RenderSceneConverter *converter{nullptr};
   const RenderSceneConverterEnv *env{nullptr};
+  std::vector<MeshConvertItem> *mesh_items{nullptr};
 };
 
+// true when the GeomMesh refers to Prims outside of its subtree.
+bool RefersExternalPrims(const Path &abs_path, const GeomMesh &mesh) {
+  if (mesh.skeleton.has_value()) {
+    return true;
+  }
+
+  if (mesh.blendShapeTargets.has_value()) {
+    const Relationship &rel = mesh.blendShapeTargets.value();
+    if (rel.is_path() && !rel.targetPath.has_prefix(abs_path)) {
+      return true;
+    }
+    if (rel.is_pathvector()) {
+      for (const auto &target : rel.targetPathVector) {
+        if (!target.has_prefix(abs_path)) {
+          return true;
+        }
+      }
+    }
+  }
+
+  if (mesh.points.has_connections() || mesh.normals.has_connections()) {
+    return true;
+  }
+
+  for (const auto &prop : mesh.props) {
+    if (prop.second.is_attribute() &&
+        prop.second.get_attribute().connections().size()) {
+      return true;
+    }
+  }
+
+  return false;
+}
+
 bool MeshVisitor(const tinyusdz::Path &abs_path, const tinyusdz::Prim &prim,
                  const int32_t level, void *userdata, std::string *err) {
   if (!userdata) {
@@ -5309,31 +5892,16 @@ bool MeshVisitor(const tinyusdz::Path &abs_path, const tinyusdz::Prim &prim,
       }
       DCOUT("# of blendshapes : " << blendshapes.size());
 
-      RenderMesh rmesh;
-
-      if (!visitorEnv->converter->ConvertMesh(
-              *visitorEnv->env, abs_path, *pmesh, material_path,
-              subset_material_path_map, visitorEnv->converter->materialMap,
-              material_subsets, blendshapes, &rmesh)) {
-        if (err) {
-          (*err) += fmt::format("Mesh conversion failed: {}",
-                                abs_path.full_path_name());
-          (*err) += "\n" + visitorEnv->converter->GetError() + "\n";
-
-        }
-        return false;
-      }
-
-      uint64_t mesh_id = uint64_t(visitorEnv->converter->meshes.size());
-      if (mesh_id >= size_t((std::numeric_limits<int32_t>::max)())) {
-        if (err) {
-          (*err) += "Mesh index too large.\n";
-        }
-        return false;
-      }
-      visitorEnv->converter->meshMap.add(abs_path.full_path_name(), mesh_id);
+      MeshConvertItem item;
+      item.refers_external_prims = RefersExternalPrims(abs_path, *pmesh);
+      item.abs_path = abs_path;
+      item.mesh = pmesh;
+      item.material_path = std::move(material_path);
+      item.subset_material_path_map = std::move(subset_material_path_map);
+      item.material_subsets = std::move(material_subsets);
+      item.blendshapes = std::move(blendshapes);
 
-      visitorEnv->converter->meshes.emplace_back(std::move(rmesh));
+      visitorEnv->mesh_items->emplace_back(std::move(item));
     }
   }
 
@@ -5431,21 +5999,23 @@ bool RenderSceneConverter::ConvertSkelAnimation(const RenderSceneConverterEnv &e
       DCOUT("Convert ttranslations");
       const TypedTimeSamples<std::vector<value::float3>> &ts_txs = translations.get_timesamples();
 
-      if (ts_txs.get_samples().empty()) {
+      if (ts_txs.empty()) {
         PUSH_ERROR_AND_RETURN(fmt::format("`translations` timeSamples in SkelAnimation is empty : {}", abs_path));
       }
 
-      for (const auto &sample : ts_txs.get_samples()) {
-        if (!sample.blocked) {
+      const std::vector<double> &times = ts_txs.get_times();
+      for (size_t i = 0; i < times.size(); i++) {
+        value::ArrayView<value::float3> values;
+        if (!ts_txs.is_blocked(i) && ts_txs.get_value_view(i, &values)) {
           // length check
-          if (sample.value.size() != joints.size()) {
-            PUSH_ERROR_AND_RETURN(fmt::format("Array length mismatch in SkelAnimation. timeCode {} translations.size {} must be equal to joints.size {} : {}", sample.t, sample.value.size(), joints.size(), abs_path));
+          if (values.size() != joints.size()) {
+            PUSH_ERROR_AND_RETURN(fmt::format("Array length mismatch in SkelAnimation. timeCode {} translations.size {} must be equal to joints.size {} : {}", times[i], values.size(), joints.size(), abs_path));
           }
 
-          for (size_t j = 0; j < sample.value.size(); j++) {
+          for (size_t j = 0; j < values.size(); j++) {
             AnimationSample<value::float3> s;
-            s.t = float(sample.t);
-            s.value = sample.value[j];
+            s.t = float(times[i]);
+            s.value = values[j];
 
             std::string jointName = jointIdMap.at(j);
             auto &it = channelMap[jointName][AnimationChannel::ChannelType::Translation];
@@ -5462,18 +6032,20 @@ bool RenderSceneConverter::ConvertSkelAnimation(const RenderSceneConverterEnv &e
     if (rotations.has_timesamples()) {
       const TypedTimeSamples<std::vector<value::quatf>> &ts_rots = rotations.get_timesamples();
       DCOUT("Convert rotations");
-      for (const auto &sample : ts_rots.get_samples()) {
-        if (!sample.blocked) {
-          if (sample.value.size() != joints.size()) {
-            PUSH_ERROR_AND_RETURN(fmt::format("Array length mismatch in SkelAnimation. timeCode {} rotations.size {} must be equal to joints.size {} : {}", sample.t, sample.value.size(), joints.size(), abs_path));
+      const std::vector<double> &times = ts_rots.get_times();
+      for (size_t i = 0; i < times.size(); i++) {
+        value::ArrayView<value::quatf> values;
+        if (!ts_rots.is_blocked(i) && ts_rots.get_value_view(i, &values)) {
+          if (values.size() != joints.size()) {
+            PUSH_ERROR_AND_RETURN(fmt::format("Array length mismatch in SkelAnimation. timeCode {} rotations.size {} must be equal to joints.size {} : {}", times[i], values.size(), joints.size(), abs_path));
           }
-          for (size_t j = 0; j < sample.value.size(); j++) {
+          for (size_t j = 0; j < values.size(); j++) {
             AnimationSample<value::float4> s;
-            s.t = float(sample.t);
-            s.value[0] = sample.value[j][0];
-            s.value[1] = sample.value[j][1];
-            s.value[2] = sample.value[j][2];
-            s.value[3] = sample.value[j][3];
+            s.t = float(times[i]);
+            s.value[0] = values[j][0];
+            s.value[1] = values[j][1];
+            s.value[2] = values[j][2];
+            s.value[3] = values[j][3];
 
             std::string jointName = jointIdMap.at(j);
             auto &it = channelMap[jointName][AnimationChannel::ChannelType::Rotation];
@@ -5490,18 +6062,20 @@ bool RenderSceneConverter::ConvertSkelAnimation(const RenderSceneConverterEnv &e
     if (scales.has_timesamples()) {
       const TypedTimeSamples<std::vector<value::half3>> &ts_scales = scales.get_timesamples();
       DCOUT("Convert scales");
-      for (const auto &sample : ts_scales.get_samples()) {
-        if (!sample.blocked) {
-          if (sample.value.size() != joints.size()) {
-            PUSH_ERROR_AND_RETURN(fmt::format("Array length mismatch in SkelAnimation. timeCode {} scales.size {} must be equal to joints.size {} : {}", sample.t, sample.value.size(), joints.size(), abs_path));
+      const std::vector<double> &times = ts_scales.get_times();
+      for (size_t i = 0; i < times.size(); i++) {
+        value::ArrayView<value::half3> values;
+        if (!ts_scales.is_blocked(i) && ts_scales.get_value_view(i, &values)) {
+          if (values.size() != joints.size()) {
+            PUSH_ERROR_AND_RETURN(fmt::format("Array length mismatch in SkelAnimation. timeCode {} scales.size {} must be equal to joints.size {} : {}", times[i], values.size(), joints.size(), abs_path));
           }
 
-          for (size_t j = 0; j < sample.value.size(); j++) {
+          for (size_t j = 0; j < values.size(); j++) {
             AnimationSample<value::float3> s;
-            s.t = float(sample.t);
-            s.value[0] = value::half_to_float(sample.value[j][0]);
-            s.value[1] = value::half_to_float(sample.value[j][1]);
-            s.value[2] = value::half_to_float(sample.value[j][2]);
+            s.t = float(times[i]);
+            s.value[0] = value::half_to_float(values[j][0]);
+            s.value[1] = value::half_to_float(values[j][1]);
+            s.value[2] = value::half_to_float(values[j][2]);
 
             std::string jointName = jointIdMap.at(j);
             auto &it = channelMap[jointName][AnimationChannel::ChannelType::Scale];
@@ -5661,16 +6235,18 @@ bool RenderSceneConverter::ConvertSkelAnimation(const RenderSceneConverterEnv &e
 
         const TypedTimeSamples<std::vector<float>> &ts_weights = weights.get_timesamples();
         DCOUT("Convert timeSampledd weights");
-        for (const auto &sample : ts_weights.get_samples()) {
-          if (!sample.blocked) {
-            if (sample.value.size() != blendShapes.size()) {
-              PUSH_ERROR_AND_RETURN(fmt::format("Array length mismatch in SkelAnimation. timeCode {} blendShapeWeights.size {} must be equal to blendShapes.size {} : {}", sample.t, sample.value.size(), blendShapes.size(), abs_path));
+        const std::vector<double> &times = ts_weights.get_times();
+        for (size_t i = 0; i < times.size(); i++) {
+          value::ArrayView<float> values;
+          if (!ts_weights.is_blocked(i) && ts_weights.get_value_view(i, &values)) {
+            if (values.size() != blendShapes.size()) {
+              PUSH_ERROR_AND_RETURN(fmt::format("Array length mismatch in SkelAnimation. timeCode {} blendShapeWeights.size {} must be equal to blendShapes.size {} : {}", times[i], values.size(), blendShapes.size(), abs_path));
             }
 
-            for (size_t j = 0; j < sample.value.size(); j++) {
+            for (size_t j = 0; j < values.size(); j++) {
               AnimationSample<float> s;
-              s.t = float(sample.t);
-              s.value = sample.value[j];
+              s.t = float(times[i]);
+              s.value = values[j];
 
               const std::string &targetName = blendShapes[j].str();
               weightsMap[targetName].samples.push_back(s);
@@ -5843,118 +6419,529 @@ bool RenderSceneConverter::BuildNodeHierarchy(
   return true;
 }
 
-bool RenderSceneConverter::ConvertToRenderScene(
-    const RenderSceneConverterEnv &env, RenderScene *scene) {
-  if (!scene) {
-    PUSH_ERROR_AND_RETURN("nullptr for RenderScene argument.");
-  }
+bool RenderSceneConverter::ConvertMeshesImpl(
+    const RenderSceneConverterEnv &env,
+    const std::vector<MeshConvertItem> &items, std::string *err) {
+  const uint32_t nthreads =
+      parallel::GetNumThreads(env.scene_config.num_threads);
+
+  struct MeshConvertResult {
+    bool converted{false};  // true when converted in a worker thread.
+    bool ret{false};
+    RenderMesh mesh;
+    std::string warn;
+    std::string err;
+  };
 
-  // 1. Convert Xform
-  // 2. Convert Material/Texture
-  // 3. Convert Mesh/SkinWeights/BlendShapes
-  // 4. Convert Skeleton(bones)
-  // 5. Build node hierarchy
-  // TODO: Convert lights
+  std::vector<MeshConvertResult> results(items.size());
 
-  //
-  // 1. Build Xform at specified time.
-  //    Each Prim in Stage is converted to XformNode.
-  //
-  XformNode xform_node;
-  if (!BuildXformNodeFromStage(env.stage, &xform_node, env.timecode)) {
-    PUSH_ERROR_AND_RETURN("Failed to build Xform node hierarchy.\n");
-  }
+  if ((nthreads > 1) && (items.size() > 1)) {
+    // Skeleton and SkelAnimation Prims are shared among meshes, and converted
+    // ones are appended to `skeletons` and `animations`. Convert meshes
+    // bound to Skeleton(or referring to other Prims outside of its subtree)
+    // serially.
+    std::vector<size_t> parallel_items;
+    for (size_t i = 0; i < items.size(); i++) {
+      if (!items[i].refers_external_prims) {
+        parallel_items.push_back(i);
+      }
+    }
 
-  std::string err;
+    // Prim lookup(e.g. attribute connection) in worker threads must not
+    // modify the Stage.
+    env.stage.build_prim_path_cache();
 
-  //
-  // 2. Convert Material/Texture
-  // 3. Convert Mesh/SkinWeights/BlendShapes
-  // 4. Convert Skeleton(bones) and SkelAnimation
-  //
-  // Material conversion will be done in MeshVisitor.
-  //
-  MeshVisitorEnv menv;
-  menv.env = &env;
-  menv.converter = this;
+    // Converter for each thread. Each converter has its own error/warning
+    // buffer, and reads `materials` and `textures` of this converter(not
+    // modified while converting meshes).
+    std::vector<std::unique_ptr<RenderSceneConverter>> workers(nthreads);
 
-  bool ret = tydra::VisitPrims(env.stage, MeshVisitor, &menv, &err);
+    parallel::ParallelFor(
+        0, parallel_items.size(), nthreads,
+        [&](size_t k, uint32_t tid) {
+          if (!workers[tid]) {
+            workers[tid].reset(new RenderSceneConverter());
+            workers[tid]->_parent = this;
+          }
+          RenderSceneConverter &worker = *workers[tid];
 
-  if (!ret) {
-    PUSH_ERROR_AND_RETURN(err);
-  }
+          const size_t idx = parallel_items[k];
+          const MeshConvertItem &item = items[idx];
+          MeshConvertResult &result = results[idx];
 
-  //
-  // 5. Build node hierarchy from XformNode and meshes, materials, skeletons,
-  // etc.
-  //
-  if (!BuildNodeHierarchy(env, xform_node)) {
-    return false;
+          worker._warn.clear();
+          worker._err.clear();
+
+          result.converted = true;
+          result.ret = worker.ConvertMesh(
+              env, item.abs_path, *item.mesh, item.material_path,
+              item.subset_material_path_map, materialMap,
+              item.material_subsets, item.blendshapes, &result.mesh);
+
+          result.warn = std::move(worker._warn);
+          result.err = std::move(worker._err);
+        },
+        /* grain_size */ 1);
   }
 
-  // render_scene.meshMap = std::move(meshMap);
-  // render_scene.materialMap = std::move(materialMap);
-  // render_scene.textureMap = std::move(textureMap);
-  // render_scene.imageMap = std::move(imageMap);
-  // render_scene.bufferMap = std::move(bufferMap);
+  // Assign mesh ids in the traversal order.
+  for (size_t i = 0; i < items.size(); i++) {
+    const MeshConvertItem &item = items[i];
+    MeshConvertResult &result = results[i];
 
-  RenderScene render_scene;
-  render_scene.usd_filename = env.usd_filename;
-  render_scene.default_root_node = 0;
-  if (default_node > -1) {
-    if (size_t(default_node) >= root_nodes.size()) {
-      PushWarn("Invalid default_node id. Use 0 for default_node id.");
+    if (result.converted) {
+      PushWarn(result.warn);
+      if (!result.ret) {
+        PushError(result.err);
+      }
     } else {
-      render_scene.default_root_node = uint32_t(default_node);
+      result.ret = ConvertMesh(env, item.abs_path, *item.mesh,
+                               item.material_path,
+                               item.subset_material_path_map, materialMap,
+                               item.material_subsets, item.blendshapes,
+                               &result.mesh);
+    }
+
+    if (!result.ret) {
+      if (err) {
+        (*err) += fmt::format("Mesh conversion failed: {}",
+                              item.abs_path.full_path_name());
+        (*err) += "\n" + GetError() + "\n";
+      }
+      return false;
+    }
+
+    uint64_t mesh_id = uint64_t(meshes.size());
+    if (mesh_id >= size_t((std::numeric_limits<int32_t>::max)())) {
+      if (err) {
+        (*err) += "Mesh index too large.\n";
+      }
+      return false;
     }
+    meshMap.add(item.abs_path.full_path_name(), mesh_id);
+
+    meshes.emplace_back(std::move(result.mesh));
   }
-  render_scene.nodes = std::move(root_nodes);
-  render_scene.meshes = std::move(meshes);
-  render_scene.textures = std::move(textures);
-  render_scene.images = std::move(images);
-  render_scene.buffers = std::move(buffers);
-  render_scene.materials = std::move(materials);
-  render_scene.skeletons = std::move(skeletons);
-  render_scene.animations = std::move(animations);
 
-  (*scene) = std::move(render_scene);
   return true;
 }
 
-bool RenderSceneConverter::ConvertSkeletonImpl(const RenderSceneConverterEnv &env, const tinyusdz::GeomMesh &mesh,
-                       SkelHierarchy *out_skel, nonstd::optional<Animation> *out_anim) {
+bool RenderSceneConverter::LoadTexturesImpl(const RenderSceneConverterEnv &env,
+                                            const size_t first_texture_id,
+                                            std::string *err) {
+  const uint32_t nthreads =
+      parallel::GetNumThreads(env.material_config.texture_load_num_threads);
 
-  if (!out_skel) {
-    return false;
-  }
+  struct TextureLoadResult {
+    bool ret{false};
+    bool loaded{false};
+    TextureImage texImage;
+    BufferData imageBuffer;
+    std::string warn;
+    std::string err;
+  };
 
-  if (!mesh.skeleton.has_value()) {
-    return false;
-  }
+  std::vector<TextureLoadResult> results(_texture_requests.size());
 
-  Path skelPath;
+  // Converter for each thread(for thread-local error/warning buffer).
+  std::vector<std::unique_ptr<RenderSceneConverter>> workers(nthreads);
 
-  if (mesh.skeleton.value().is_path()) {
-    skelPath = mesh.skeleton.value().targetPath;
-  } else if (mesh.skeleton.value().is_pathvector()) {
-    // Use the first one
-    if (mesh.skeleton.value().targetPathVector.size()) {
-      skelPath = mesh.skeleton.value().targetPathVector[0];
-    } else {
-      PUSH_WARN("`skel:skeleton` has invalid definition.");
-    }
-  } else {
-    PUSH_WARN("`skel:skeleton` has invalid definition.");
-  }
+  // Decoding and color space conversion are done concurrently.
+  // TextureImageLoaderFunction must be thread-safe when
+  // `texture_load_num_threads` is not 1.
+  parallel::ParallelFor(
+      0, _texture_requests.size(), nthreads,
+      [&](size_t i, uint32_t tid) {
+        if (!workers[tid]) {
+          workers[tid].reset(new RenderSceneConverter());
+        }
+        RenderSceneConverter &worker = *workers[tid];
 
-  if (skelPath.is_valid()) {
-    const Prim *skelPrim{nullptr};
-    if (!env.stage.find_prim_at_path(skelPath, skelPrim, &_err)) {
+        const TextureImageRequest &req = _texture_requests[i];
+        TextureLoadResult &result = results[i];
+
+        worker._warn.clear();
+        worker._err.clear();
+
+        result.ret = worker.LoadTextureImageImpl(
+            env, req.tex_abs_path, req.asset_path, req.asset_info,
+            *req.texture, &result.texImage, &result.imageBuffer,
+            &result.loaded);
+
+        result.warn = std::move(worker._warn);
+        result.err = std::move(worker._err);
+      },
+      /* grain_size */ 1);
+
+  // Assign image ids in the request order.
+  std::vector<int64_t> image_ids(_texture_requests.size(), -1);
+
+  for (size_t i = 0; i < _texture_requests.size(); i++) {
+    TextureLoadResult &result = results[i];
+
+    PushWarn(result.warn);
+    PushError(result.err);
+
+    if (!result.ret) {
+      if (err) {
+        (*err) += fmt::format("Failed to load texture image of {}\n",
+                              _texture_requests[i].tex_abs_path);
+      }
       return false;
     }
 
-    SkelHierarchy dst;
-    if (const auto pskel = skelPrim->as<Skeleton>()) {
+    if (result.loaded) {
+      image_ids[i] = AddTextureImage(
+          _texture_requests[i].asset_path.GetAssetPath(),
+          std::move(result.texImage), std::move(result.imageBuffer));
+    }
+  }
+
+  for (size_t i = first_texture_id; i < textures.size(); i++) {
+    int64_t request_id = textures[i].texture_image_id;
+    if ((request_id >= 0) && (size_t(request_id) < image_ids.size())) {
+      textures[i].texture_image_id = image_ids[size_t(request_id)];
+    }
+  }
+
+  _texture_requests.clear();
+  _texture_request_map.clear();
+
+  return true;
+}
+
+namespace {
+
+// Store indices as uint16 or uint32. `indices` = nullptr: 0, 1, 2, ...
+void StoreIndexBuffer(const uint32_t *indices, const size_t n,
+                      const bool use_16bit, BufferData *buf) {
+  if (use_16bit) {
+    buf->componentType = ComponentType::UInt16;
+    buf->data.resize(n * sizeof(uint16_t));
+    uint16_t *dst = reinterpret_cast<uint16_t *>(buf->data.data());
+    for (size_t i = 0; i < n; i++) {
+      dst[i] = indices ? uint16_t(indices[i]) : uint16_t(i);
+    }
+  } else {
+    buf->componentType = ComponentType::UInt32;
+    buf->data.resize(n * sizeof(uint32_t));
+    uint32_t *dst = reinterpret_cast<uint32_t *>(buf->data.data());
+    for (size_t i = 0; i < n; i++) {
+      dst[i] = indices ? indices[i] : uint32_t(i);
+    }
+  }
+}
+
+}  // namespace
+
+bool RenderSceneConverter::BuildLODsImpl(const RenderSceneConverterEnv &env) {
+  const uint32_t vertex_cache_size = env.mesh_config.optimize_vertex_cache
+                                         ? env.mesh_config.vertex_cache_size
+                                         : 0;
+
+  std::vector<uint8_t> rets(meshes.size(), 0);
+  std::vector<std::string> errs(meshes.size());
+
+  parallel::ParallelFor(
+      0, meshes.size(), parallel::GetNumThreads(env.scene_config.num_threads),
+      [&](size_t i, uint32_t tid) {
+        (void)tid;
+        rets[i] = BuildMeshLODs(meshes[i], env.mesh_config.lod_ratios,
+                                env.mesh_config.lod_max_error,
+                                vertex_cache_size, &meshes[i].lods, &errs[i])
+                      ? 1
+                      : 0;
+      },
+      /* grain_size */ 1);
+
+  for (size_t i = 0; i < meshes.size(); i++) {
+    if (!rets[i]) {
+      // e.g. Mesh is not triangulated.
+      PUSH_WARN(fmt::format("Skip building LODs of Mesh {}: {}",
+                            meshes[i].abs_path, errs[i]));
+      meshes[i].lods.clear();
+    }
+  }
+
+  return true;
+}
+
+bool RenderSceneConverter::BuildMeshletsImpl(
+    const RenderSceneConverterEnv &env) {
+  struct MeshletResult {
+    bool ret{false};
+    std::vector<Meshlet> meshlets;
+    std::vector<uint32_t> vertices;
+    std::vector<uint8_t> triangles;
+    std::map<std::string, std::vector<int>> subset_meshlets;
+    std::string err;
+  };
+
+  std::vector<MeshletResult> results(meshes.size());
+
+  parallel::ParallelFor(
+      0, meshes.size(), parallel::GetNumThreads(env.scene_config.num_threads),
+      [&](size_t i, uint32_t tid) {
+        (void)tid;
+        MeshletResult &r = results[i];
+        r.ret = BuildMeshlets(meshes[i], env.mesh_config.meshlet_max_vertices,
+                              env.mesh_config.meshlet_max_triangles,
+                              &r.meshlets, &r.vertices, &r.triangles,
+                              &r.subset_meshlets, &r.err);
+      },
+      /* grain_size */ 1);
+
+  for (size_t i = 0; i < meshes.size(); i++) {
+    MeshletResult &r = results[i];
+    if (!r.ret) {
+      // e.g. Mesh is not triangulated.
+      PUSH_WARN(fmt::format("Skip building meshlets of Mesh {}: {}",
+                            meshes[i].abs_path, r.err));
+      continue;
+    }
+
+    RenderMesh &mesh = meshes[i];
+    mesh.meshlets = std::move(r.meshlets);
+    mesh.material_subset_meshlets = std::move(r.subset_meshlets);
+
+    BufferData vb;
+    vb.componentType = ComponentType::UInt32;
+    vb.data.resize(r.vertices.size() * sizeof(uint32_t));
+    if (!r.vertices.empty()) {
+      memcpy(vb.data.data(), r.vertices.data(), vb.data.size());
+    }
+    mesh.meshlet_vertices_buffer_id = int64_t(buffers.size());
+    buffers.emplace_back(std::move(vb));
+
+    BufferData tb;
+    tb.componentType = ComponentType::UInt8;
+    tb.data = std::move(r.triangles);
+    mesh.meshlet_triangles_buffer_id = int64_t(buffers.size());
+    buffers.emplace_back(std::move(tb));
+  }
+
+  return true;
+}
+
+bool RenderSceneConverter::BuildInterleavedVertexBuffersImpl(
+    const RenderSceneConverterEnv &env) {
+  VertexLayout layout = env.mesh_config.interleaved_vertex_layout;
+  std::string err;
+  if (!ResolveVertexLayout(&layout, &err)) {
+    PUSH_ERROR_AND_RETURN(
+        fmt::format("Invalid interleaved vertex layout: {}", err));
+  }
+
+  struct BufferResult {
+    bool ret{false};
+    BufferData vertex_buffer;
+    BufferData index_buffer;
+    uint32_t num_vertices{0};
+    std::string err;
+  };
+
+  std::vector<BufferResult> results(meshes.size());
+
+  parallel::ParallelFor(
+      0, meshes.size(), parallel::GetNumThreads(env.scene_config.num_threads),
+      [&](size_t i, uint32_t tid) {
+        (void)tid;
+        BufferResult &r = results[i];
+        r.ret = BuildInterleavedVertexBuffer(
+            meshes[i], layout, env.mesh_config.use_16bit_indices,
+            &r.vertex_buffer, &r.index_buffer, &r.num_vertices, &r.err);
+      },
+      /* grain_size */ 1);
+
+  for (size_t i = 0; i < meshes.size(); i++) {
+    BufferResult &r = results[i];
+    if (!r.ret) {
+      // e.g. Mesh is not triangulated.
+      PUSH_WARN(fmt::format(
+          "Skip building interleaved vertex buffer of Mesh {}: {}",
+          meshes[i].abs_path, r.err));
+      continue;
+    }
+
+    RenderMesh &mesh = meshes[i];
+    mesh.vertex_layout = layout;
+    mesh.num_buffer_vertices = r.num_vertices;
+
+    mesh.vertex_buffer_id = int64_t(buffers.size());
+    buffers.emplace_back(std::move(r.vertex_buffer));
+
+    mesh.index_buffer_id = int64_t(buffers.size());
+    buffers.emplace_back(std::move(r.index_buffer));
+
+    // LODs share the vertex buffer(vertices = points).
+    if (mesh.is_single_indexable) {
+      const bool use_16bit = env.mesh_config.use_16bit_indices &&
+                             (mesh.num_buffer_vertices <= 65536);
+      for (auto &lod : mesh.lods) {
+        BufferData ib;
+        StoreIndexBuffer(lod.indices.data(), lod.indices.size(), use_16bit,
+                         &ib);
+        lod.index_buffer_id = int64_t(buffers.size());
+        buffers.emplace_back(std::move(ib));
+      }
+    }
+  }
+
+  return true;
+}
+
+bool RenderSceneConverter::ConvertToRenderScene(
+    const RenderSceneConverterEnv &env, RenderScene *scene) {
+  if (!scene) {
+    PUSH_ERROR_AND_RETURN("nullptr for RenderScene argument.");
+  }
+
+  // 1. Convert Xform
+  // 2. Convert Material/Texture
+  // 3. Convert Mesh/SkinWeights/BlendShapes
+  // 4. Convert Skeleton(bones)
+  // 5. Build node hierarchy
+  // TODO: Convert lights
+
+  //
+  // 1. Build Xform at specified time.
+  //    Each Prim in Stage is converted to XformNode.
+  //
+  XformNode xform_node;
+  if (!BuildXformNodeFromStage(env.stage, &xform_node, env.timecode)) {
+    PUSH_ERROR_AND_RETURN("Failed to build Xform node hierarchy.\n");
+  }
+
+  std::string err;
+
+  //
+  // 2. Convert Material/Texture
+  // 3. Convert Mesh/SkinWeights/BlendShapes
+  // 4. Convert Skeleton(bones) and SkelAnimation
+  //
+  // Material conversion will be done in MeshVisitor.
+  // GeomMeshes are collected in MeshVisitor, then converted(concurrently) in
+  // ConvertMeshesImpl.
+  //
+  // Texture images are loaded after the traversal(see LoadTexturesImpl).
+  //
+  std::vector<MeshConvertItem> mesh_items;
+
+  MeshVisitorEnv menv;
+  menv.env = &env;
+  menv.converter = this;
+  menv.mesh_items = &mesh_items;
+
+  const size_t first_texture_id = textures.size();
+  _defer_texture_loading = true;
+  _texture_requests.clear();
+  _texture_request_map.clear();
+
+  bool ret = tydra::VisitPrims(env.stage, MeshVisitor, &menv, &err);
+
+  _defer_texture_loading = false;
+
+  if (!ret) {
+    PUSH_ERROR_AND_RETURN(err);
+  }
+
+  if (!LoadTexturesImpl(env, first_texture_id, &err)) {
+    PUSH_ERROR_AND_RETURN(err);
+  }
+
+  if (!ConvertMeshesImpl(env, mesh_items, &err)) {
+    PUSH_ERROR_AND_RETURN(err);
+  }
+
+  if (env.mesh_config.build_lods) {
+    if (!BuildLODsImpl(env)) {
+      return false;
+    }
+  }
+
+  if (env.mesh_config.build_meshlets) {
+    if (!BuildMeshletsImpl(env)) {
+      return false;
+    }
+  }
+
+  if (env.mesh_config.build_interleaved_vertex_buffer) {
+    if (!BuildInterleavedVertexBuffersImpl(env)) {
+      return false;
+    }
+  }
+
+  //
+  // 5. Build node hierarchy from XformNode and meshes, materials, skeletons,
+  // etc.
+  //
+  if (!BuildNodeHierarchy(env, xform_node)) {
+    return false;
+  }
+
+  // render_scene.meshMap = std::move(meshMap);
+  // render_scene.materialMap = std::move(materialMap);
+  // render_scene.textureMap = std::move(textureMap);
+  // render_scene.imageMap = std::move(imageMap);
+  // render_scene.bufferMap = std::move(bufferMap);
+
+  RenderScene render_scene;
+  render_scene.usd_filename = env.usd_filename;
+  render_scene.default_root_node = 0;
+  if (default_node > -1) {
+    if (size_t(default_node) >= root_nodes.size()) {
+      PushWarn("Invalid default_node id. Use 0 for default_node id.");
+    } else {
+      render_scene.default_root_node = uint32_t(default_node);
+    }
+  }
+  render_scene.nodes = std::move(root_nodes);
+  render_scene.meshes = std::move(meshes);
+  render_scene.textures = std::move(textures);
+  render_scene.images = std::move(images);
+  render_scene.buffers = std::move(buffers);
+  render_scene.materials = std::move(materials);
+  render_scene.skeletons = std::move(skeletons);
+  render_scene.animations = std::move(animations);
+
+  (*scene) = std::move(render_scene);
+  return true;
+}
+
+bool RenderSceneConverter::ConvertSkeletonImpl(const RenderSceneConverterEnv &env, const tinyusdz::GeomMesh &mesh,
+                       SkelHierarchy *out_skel, nonstd::optional<Animation> *out_anim) {
+
+  if (!out_skel) {
+    return false;
+  }
+
+  if (!mesh.skeleton.has_value()) {
+    return false;
+  }
+
+  Path skelPath;
+
+  if (mesh.skeleton.value().is_path()) {
+    skelPath = mesh.skeleton.value().targetPath;
+  } else if (mesh.skeleton.value().is_pathvector()) {
+    // Use the first one
+    if (mesh.skeleton.value().targetPathVector.size()) {
+      skelPath = mesh.skeleton.value().targetPathVector[0];
+    } else {
+      PUSH_WARN("`skel:skeleton` has invalid definition.");
+    }
+  } else {
+    PUSH_WARN("`skel:skeleton` has invalid definition.");
+  }
+
+  if (skelPath.is_valid()) {
+    const Prim *skelPrim{nullptr};
+    if (!env.stage.find_prim_at_path(skelPath, skelPrim, &_err)) {
+      return false;
+    }
+
+    SkelHierarchy dst;
+    if (const auto pskel = skelPrim->as<Skeleton>()) {
       SkelNode root;
       if (!BuildSkelHierarchy((*pskel), root, &_err)) {
         return false;
@@ -6016,6 +7003,3088 @@ bool RenderSceneConverter::ConvertSkeletonImpl(const RenderSceneConverterEnv &en
   PUSH_ERROR_AND_RETURN("`skel:skeleton` path is invalid.");
 }
 
+namespace {
+
+template <typename T>
+bool IsTimeSampled(const TypedAttribute<Animatable<T>> &attr) {
+  const Animatable<T> *v = attr.get_value_ptr();
+  return v && v->has_timesamples();
+}
+
+template <typename T>
+bool IsTimeSampled(const TypedAttributeWithFallback<Animatable<T>> &attr) {
+  if (!attr.authored() || attr.is_blocked() || attr.is_connection()) {
+    return false;
+  }
+  return attr.get_value().has_timesamples();
+}
+
+// Update non-texture parameter of UsdPreviewSurface.
+template <typename T, typename Dty>
+bool UpdateShaderParam(const TypedAttributeWithFallback<Animatable<T>> &param,
+                       const double t,
+                       const value::TimeSampleInterpolationType tinterp,
+                       ShaderParam<Dty> &dst_param, bool *updated) {
+  if (dst_param.is_texture() || !IsTimeSampled(param)) {
+    return true;
+  }
+
+  T val;
+  if (!param.get_value().get(t, &val, tinterp)) {
+    return false;
+  }
+
+  ShaderParam<Dty> tmp;
+  tmp.set_value(val);
+  if (memcmp(&tmp.value, &dst_param.value, sizeof(Dty)) != 0) {
+    dst_param.value = tmp.value;
+    (*updated) = true;
+  }
+
+  return true;
+}
+
+bool IsTimeSampled(const UsdPreviewSurface &surface) {
+  return IsTimeSampled(surface.diffuseColor) ||
+         IsTimeSampled(surface.emissiveColor) ||
+         IsTimeSampled(surface.specularColor) ||
+         IsTimeSampled(surface.metallic) || IsTimeSampled(surface.roughness) ||
+         IsTimeSampled(surface.clearcoat) ||
+         IsTimeSampled(surface.clearcoatRoughness) ||
+         IsTimeSampled(surface.opacity) ||
+         IsTimeSampled(surface.opacityThreshold) ||
+         IsTimeSampled(surface.ior) || IsTimeSampled(surface.normal) ||
+         IsTimeSampled(surface.displacement) ||
+         IsTimeSampled(surface.occlusion);
+}
+
+// Write `src` to vertex attribute at `idx` and record the modified range.
+void UpdateVertexAttributeItem(VertexAttribute &vattr, const size_t idx,
+                               const value::float3 &src,
+                               RenderSceneUpdateResult::Range *range) {
+  uint8_t *dst = vattr.get_data().data() + idx * vattr.stride_bytes();
+  if (memcmp(dst, &src, sizeof(value::float3)) != 0) {
+    memcpy(dst, &src, sizeof(value::float3));
+    range->extend(idx);
+  }
+}
+
+// Source of a vertex attribute in the interleaved vertex buffer.
+struct InterleavedAttributeSource {
+  const std::vector<vec3> *points{nullptr};  // Position
+  const VertexAttribute *attr{nullptr};  // nullptr: use `points` or `fallback`
+  VertexAttributeFormat src_format{VertexAttributeFormat::Float};
+  uint32_t src_components{0};
+  size_t src_stride{0};
+  size_t src_count{0};
+
+  float fallback[4]{0.0f, 0.0f, 0.0f, 0.0f};
+
+  VertexAttributeEncoding encoding{VertexAttributeEncoding::Float};
+  uint32_t num_components{0};
+  uint32_t offset{0};
+};
+
+//
+// Map vertices of the interleaved vertex buffer to the mesh.
+// vertex -> (point index, face vertex index, face index)
+//
+struct InterleavedVertexMap {
+  bool single_indexable{false};
+  size_t num_vertices{0};
+  size_t num_points{0};
+
+  // single_indexable: One of face vertex index which refers to the point.
+  // -1 for unused point.
+  std::vector<int64_t> point_to_corner;
+
+  // USD face index of each triangle.
+  std::vector<uint32_t> triangle_to_face;
+};
+
+bool BuildInterleavedVertexMap(const RenderMesh &mesh,
+                               InterleavedVertexMap *map, std::string *err);
+
+bool SetupInterleavedAttributeSources(
+    const RenderMesh &mesh, const VertexLayout &layout,
+    std::vector<InterleavedAttributeSource> *sources, std::string *err);
+
+bool EncodeInterleavedVertexRange(
+    const RenderMesh &mesh, const InterleavedVertexMap &map,
+    const std::vector<InterleavedAttributeSource> &sources, const size_t begin,
+    const size_t end, BufferData *vertex_buffer, std::string *err);
+
+void ComputeMeshletBounds(const std::vector<vec3> &points,
+                          const uint32_t *vertices, const uint8_t *triangles,
+                          Meshlet *m);
+
+}  // namespace
+
+struct RenderSceneUpdater::VertexBufferSource {
+  InterleavedVertexMap map;
+  std::vector<InterleavedAttributeSource> sources;
+};
+
+RenderSceneUpdater::RenderSceneUpdater() = default;
+
+RenderSceneUpdater::~RenderSceneUpdater() = default;
+
+bool RenderSceneUpdater::Build(const RenderSceneConverterEnv &env,
+                               RenderScene *scene) {
+  _err.clear();
+  _warn.clear();
+  _nodes.clear();
+  _meshes.clear();
+  _materials.clear();
+
+  if (!scene) {
+    PUSH_ERROR_AND_RETURN("nullptr for RenderScene argument.");
+  }
+
+  _stage = &env.stage;
+  _scene = scene;
+  _tinterp = env.tinterp;
+  _normal_weighting = env.mesh_config.normal_weighting;
+  _compute_tangents_and_binormals =
+      env.mesh_config.compute_tangents_and_binormals;
+  _num_threads = env.scene_config.num_threads;
+
+  // Prim lookup in Update() may run concurrently.
+  env.stage.build_prim_path_cache();
+
+  //
+  // Xform
+  //
+  if (!_xform_cache.build(env.stage, env.timecode, _tinterp, _num_threads)) {
+    PUSH_WARN(_xform_cache.get_error());
+  }
+
+  {
+    std::vector<Node *> stack;
+    for (auto &node : scene->nodes) {
+      stack.push_back(&node);
+    }
+
+    while (!stack.empty()) {
+      Node *node = stack.back();
+      stack.pop_back();
+
+      int64_t idx = _xform_cache.find(Path(node->abs_path, ""));
+      if ((idx >= 0) && _xform_cache.is_time_varying(size_t(idx))) {
+        _nodes.push_back(std::make_pair(node, uint32_t(idx)));
+      }
+
+      for (auto &child : node->children) {
+        stack.push_back(&child);
+      }
+    }
+  }
+
+  //
+  // Mesh
+  //
+  for (size_t i = 0; i < scene->meshes.size(); i++) {
+    const Prim *prim{nullptr};
+    std::string err;
+    if (!env.stage.find_prim_at_path(Path(scene->meshes[i].abs_path, ""),
+                                     prim, &err) ||
+        !prim) {
+      PUSH_WARN(fmt::format("GeomMesh Prim {} not found in Stage.",
+                            scene->meshes[i].abs_path));
+      continue;
+    }
+
+    const GeomMesh *mesh = prim->as<GeomMesh>();
+    if (!mesh) {
+      continue;
+    }
+
+    AnimatedMesh amesh;
+    if (!BuildAnimatedMesh(uint32_t(i), *mesh, &amesh)) {
+      return false;
+    }
+
+    if (amesh.animated_points || amesh.animated_normals) {
+      _meshes.emplace_back(std::move(amesh));
+    }
+  }
+
+  //
+  // Material
+  //
+  for (size_t i = 0; i < scene->materials.size(); i++) {
+    const Prim *prim{nullptr};
+    std::string err;
+    if (!env.stage.find_prim_at_path(Path(scene->materials[i].abs_path, ""),
+                                     prim, &err) ||
+        !prim) {
+      continue;
+    }
+
+    const Material *material = prim->as<Material>();
+    if (!material || !material->surface.authored()) {
+      continue;
+    }
+
+    const std::vector<Path> &paths = material->surface.get_connections();
+    if (paths.size() != 1) {
+      continue;
+    }
+
+    const Prim *shaderPrim{nullptr};
+    if (!env.stage.find_prim_at_path(Path(paths[0].prim_part(), ""),
+                                     shaderPrim, &err) ||
+        !shaderPrim) {
+      continue;
+    }
+
+    const Shader *shader = shaderPrim->as<Shader>();
+    if (!shader) {
+      continue;
+    }
+
+    const UsdPreviewSurface *psurface = shader->value.as<UsdPreviewSurface>();
+    if (psurface && IsTimeSampled(*psurface)) {
+      _materials.push_back(std::make_pair(uint32_t(i), psurface));
+    }
+  }
+
+  return true;
+}
+
+bool RenderSceneUpdater::BuildAnimatedMesh(const uint32_t mesh_id,
+                                           const GeomMesh &mesh,
+                                           AnimatedMesh *dst) {
+  const RenderMesh &rmesh = _scene->meshes[mesh_id];
+
+  dst->mesh_id = mesh_id;
+  dst->mesh = &mesh;
+  dst->animated_points = IsTimeSampled(mesh.points);
+
+  bool has_normals{false};
+  if (mesh.has_primvar("normals")) {  // primvars:normals
+    GeomPrimvar pvar;
+    if (!GetGeomPrimvar(*_stage, &mesh, "normals", &pvar, &_err)) {
+      return false;
+    }
+    has_normals = true;
+    dst->animated_normals = pvar.get_attribute().has_timesamples() ||
+                            pvar.has_timesampled_indices();
+  } else if (mesh.normals.authored()) {
+    has_normals = true;
+    dst->animated_normals = IsTimeSampled(mesh.normals);
+  }
+
+  if (rmesh.normals.vertex_count() == 0) {
+    dst->animated_normals = false;
+  } else if (!rmesh.normals.indices.empty() ||
+             ((rmesh.normals.variability != VertexVariability::Vertex) &&
+              (rmesh.normals.variability != VertexVariability::FaceVarying))) {
+    PUSH_WARN(fmt::format(
+        "Updating {} normals of {} is not supported.",
+        to_string(rmesh.normals.variability), rmesh.abs_path));
+    dst->animated_normals = false;
+  } else if (!has_normals) {
+    dst->compute_normals = dst->animated_points;
+  }
+
+  dst->normals_interpolation = mesh.get_normalsInterpolation();
+
+  // Tangents and binormals are computed by RenderSceneConverter under the
+  // same condition.
+  if (_compute_tangents_and_binormals && !rmesh.tangents.empty() &&
+      !rmesh.binormals.empty() && !rmesh.normals.empty() &&
+      rmesh.texcoords.count(0)) {
+    const VertexAttribute &texcoords = rmesh.texcoords.at(0);
+    if ((texcoords.format != VertexAttributeFormat::Vec2) ||
+        (texcoords.elementSize != 1) || !texcoords.indices.empty() ||
+        (!texcoords.is_vertex() && !texcoords.is_facevarying()) ||
+        !rmesh.normals.indices.empty() ||
+        (!rmesh.normals.is_vertex() && !rmesh.normals.is_facevarying())) {
+      PUSH_WARN(fmt::format("Updating tangents of {} is not supported.",
+                            rmesh.abs_path));
+    } else {
+      dst->compute_tangents = true;
+    }
+  }
+
+  if (!dst->animated_points && !dst->animated_normals) {
+    return true;
+  }
+
+  if (IsTimeSampled(mesh.faceVertexIndices) ||
+      IsTimeSampled(mesh.faceVertexCounts)) {
+    PUSH_WARN(fmt::format(
+        "Topology of {} is time-varying. Mesh is not updated.",
+        rmesh.abs_path));
+    dst->animated_points = false;
+    dst->animated_normals = false;
+    return true;
+  }
+
+  std::vector<int32_t> indices;
+  std::vector<int32_t> counts;
+  if (!EvaluateTypedAnimatableAttribute(*_stage, mesh.faceVertexIndices,
+                                        "faceVertexIndices", &indices, &_err)) {
+    return false;
+  }
+  if (!EvaluateTypedAnimatableAttribute(*_stage, mesh.faceVertexCounts,
+                                        "faceVertexCounts", &counts, &_err)) {
+    return false;
+  }
+
+  dst->usd_face_vertex_indices.resize(indices.size());
+  dst->usd_face_ids.resize(indices.size());
+  size_t offset = 0;
+  for (size_t f = 0; f < counts.size(); f++) {
+    if ((counts[f] < 0) || ((offset + size_t(counts[f])) > indices.size())) {
+      PUSH_ERROR_AND_RETURN(
+          fmt::format("Invalid faceVertexCounts in {}", rmesh.abs_path));
+    }
+    for (size_t k = 0; k < size_t(counts[f]); k++) {
+      if (indices[offset + k] < 0) {
+        PUSH_ERROR_AND_RETURN(
+            fmt::format("Invalid faceVertexIndices in {}", rmesh.abs_path));
+      }
+      dst->usd_face_vertex_indices[offset + k] = uint32_t(indices[offset + k]);
+      dst->usd_face_ids[offset + k] = uint32_t(f);
+    }
+    offset += size_t(counts[f]);
+  }
+
+  if (offset != indices.size()) {
+    PUSH_ERROR_AND_RETURN(
+        fmt::format("Invalid faceVertexCounts in {}", rmesh.abs_path));
+  }
+
+  //
+  // RenderMesh face vertex -> USD face vertex.
+  // Welding in `build_vertex_indices` does not change the order of face
+  // vertices.
+  //
+  const std::vector<uint32_t> &fvIndices = rmesh.faceVertexIndices();
+  dst->face_vertex_sources.resize(fvIndices.size());
+  if (rmesh.is_triangulated()) {
+    if (rmesh.triangulatedToOrigFaceVertexIndexMap.size() !=
+        fvIndices.size()) {
+      PUSH_ERROR_AND_RETURN(fmt::format(
+          "Invalid triangulatedToOrigFaceVertexIndexMap in {}",
+          rmesh.abs_path));
+    }
+    for (size_t i = 0; i < fvIndices.size(); i++) {
+      dst->face_vertex_sources[i] =
+          uint32_t(rmesh.triangulatedToOrigFaceVertexIndexMap[i]);
+    }
+  } else {
+    std::iota(dst->face_vertex_sources.begin(),
+              dst->face_vertex_sources.end(), 0);
+  }
+
+  for (size_t i = 0; i < fvIndices.size(); i++) {
+    if ((dst->face_vertex_sources[i] >= indices.size()) ||
+        (fvIndices[i] >= rmesh.points.size())) {
+      PUSH_ERROR_AND_RETURN(fmt::format(
+          "Topology of {} does not match with GeomMesh.", rmesh.abs_path));
+    }
+  }
+
+  //
+  // RenderMesh point -> USD point.
+  // Points not referenced by faces keep its index.
+  //
+  const uint32_t kInvalid = ~0u;
+  dst->point_face_vertex_sources.assign(rmesh.points.size(), kInvalid);
+  for (size_t i = 0; i < fvIndices.size(); i++) {
+    uint32_t &src = dst->point_face_vertex_sources[fvIndices[i]];
+    if (src == kInvalid) {
+      src = dst->face_vertex_sources[i];
+    }
+  }
+
+  dst->point_sources.resize(rmesh.points.size());
+  for (size_t i = 0; i < rmesh.points.size(); i++) {
+    uint32_t src = dst->point_face_vertex_sources[i];
+    dst->point_sources[i] =
+        (src == kInvalid) ? uint32_t(i) : dst->usd_face_vertex_indices[src];
+  }
+
+  //
+  // Vertex map and attribute sources of the interleaved vertex buffer.
+  // Topology and attribute formats are constant, so they are built once.
+  //
+  if ((rmesh.vertex_buffer_id >= 0) &&
+      (size_t(rmesh.vertex_buffer_id) < _scene->buffers.size())) {
+    std::unique_ptr<VertexBufferSource> vbs(new VertexBufferSource());
+    std::string vb_err;
+    if (!BuildInterleavedVertexMap(rmesh, &vbs->map, &vb_err) ||
+        !SetupInterleavedAttributeSources(rmesh, rmesh.vertex_layout,
+                                          &vbs->sources, &vb_err)) {
+      PUSH_ERROR_AND_RETURN(
+          fmt::format("Failed to setup the vertex buffer of {}: {}",
+                      rmesh.abs_path, vb_err));
+    }
+    dst->vertex_buffer_source = std::move(vbs);
+  }
+
+  return true;
+}
+
+bool RenderSceneUpdater::UpdateMesh(const AnimatedMesh &amesh, const double t,
+                                    RenderSceneUpdateResult::MeshUpdate *update,
+                                    std::string *err) {
+  RenderMesh &rmesh = _scene->meshes[amesh.mesh_id];
+  const GeomMesh &mesh = *amesh.mesh;
+  const uint32_t kInvalid = ~0u;
+
+  update->mesh_id = amesh.mesh_id;
+
+  //
+  // points
+  //
+  std::vector<value::point3f> points_buf;
+  value::ArrayView<value::point3f> points;
+  if (amesh.animated_points) {
+    if (!EvaluateTypedAnimatableAttributeView(*_stage, mesh.points, "points",
+                                              &points, &points_buf, err, t,
+                                              _tinterp)) {
+      return false;
+    }
+
+    for (size_t i = 0; i < rmesh.points.size(); i++) {
+      const uint32_t src = amesh.point_sources[i];
+      if (src >= points.size()) {
+        (*err) += fmt::format(
+            "points.size of {} is changed. Topology must be constant.\n",
+            rmesh.abs_path);
+        return false;
+      }
+
+      if (memcmp(&rmesh.points[i], &points[src], sizeof(value::float3)) !=
+          0) {
+        memcpy(&rmesh.points[i], &points[src], sizeof(value::float3));
+        update->points.extend(i);
+      }
+    }
+  }
+
+  //
+  // normals
+  //
+  const bool is_facevarying =
+      rmesh.normals.variability == VertexVariability::FaceVarying;
+  const std::vector<uint32_t> &fvIndices = rmesh.faceVertexIndices();
+
+  // faceVertexIndices(before welding) to USD points.
+  std::vector<uint32_t> point_indices;
+  if (amesh.compute_normals || amesh.compute_tangents) {
+    point_indices.resize(fvIndices.size());
+    for (size_t i = 0; i < fvIndices.size(); i++) {
+      point_indices[i] = amesh.point_sources[fvIndices[i]];
+    }
+  }
+
+  if (amesh.animated_normals) {
+    std::vector<value::normal3f> normals;
+    if (mesh.has_primvar("normals")) {
+      GeomPrimvar pvar;
+      if (!GetGeomPrimvar(*_stage, &mesh, "normals", &pvar, err)) {
+        return false;
+      }
+      if (!pvar.flatten_with_indices(t, &normals, _tinterp, err)) {
+        return false;
+      }
+    } else {
+      if (!EvaluateTypedAnimatableAttribute(*_stage, mesh.normals, "normals",
+                                            &normals, err, t, _tinterp)) {
+        return false;
+      }
+    }
+
+    // Get a normal of USD face vertex.
+    auto GetNormal = [&](const uint32_t fv, value::float3 *n) -> bool {
+      size_t idx;
+      switch (amesh.normals_interpolation) {
+        case Interpolation::Constant:
+          idx = 0;
+          break;
+        case Interpolation::Uniform:
+          idx = amesh.usd_face_ids[fv];
+          break;
+        case Interpolation::Vertex:
+        case Interpolation::Varying:
+          idx = amesh.usd_face_vertex_indices[fv];
+          break;
+        case Interpolation::FaceVarying:
+        default:
+          idx = fv;
+          break;
+      }
+      if (idx >= normals.size()) {
+        return false;
+      }
+      memcpy(n, &normals[idx], sizeof(value::float3));
+      return true;
+    };
+
+    const size_t n = is_facevarying ? fvIndices.size() : rmesh.points.size();
+    if (rmesh.normals.vertex_count() != n) {
+      (*err) += fmt::format("Invalid normals.size in {}.\n", rmesh.abs_path);
+      return false;
+    }
+
+    for (size_t i = 0; i < n; i++) {
+      uint32_t fv = is_facevarying ? amesh.face_vertex_sources[i]
+                                   : amesh.point_face_vertex_sources[i];
+      value::float3 nrm;
+      if (fv == kInvalid) {
+        // 'vertex' normals of the point not referenced by faces.
+        if (((amesh.normals_interpolation != Interpolation::Vertex) &&
+             (amesh.normals_interpolation != Interpolation::Varying)) ||
+            (i >= normals.size())) {
+          continue;
+        }
+        memcpy(&nrm, &normals[i], sizeof(value::float3));
+      } else if (!GetNormal(fv, &nrm)) {
+        (*err) += fmt::format(
+            "normals.size of {} is changed. Topology must be constant.\n",
+            rmesh.abs_path);
+        return false;
+      }
+
+      UpdateVertexAttributeItem(rmesh.normals, i, nrm, &update->normals);
+    }
+
+  } else if (amesh.compute_normals) {
+    std::vector<vec3> usd_points(points.size());
+    memcpy(usd_points.data(), points.data(), sizeof(vec3) * points.size());
+
+    std::vector<vec3> normals;
+    if (!ComputeNormals(usd_points, rmesh.faceVertexCounts(), point_indices,
+                        _normal_weighting, /* num_threads */ 1, normals,
+                        err)) {
+      return false;
+    }
+
+    const size_t n = is_facevarying ? fvIndices.size() : rmesh.points.size();
+    if (rmesh.normals.vertex_count() != n) {
+      (*err) += fmt::format("Invalid normals.size in {}.\n", rmesh.abs_path);
+      return false;
+    }
+
+    for (size_t i = 0; i < n; i++) {
+      uint32_t pidx =
+          is_facevarying ? point_indices[i] : amesh.point_sources[i];
+      UpdateVertexAttributeItem(rmesh.normals, i, normals[pidx],
+                                &update->normals);
+    }
+  }
+
+  //
+  // tangents and binormals
+  //
+  if (amesh.compute_tangents &&
+      (!update->points.empty() || !update->normals.empty())) {
+    // Compute tangents on USD points and facevarying texcoords/normals, so
+    // that face vertices are merged in the same way as RenderSceneConverter.
+    const VertexAttribute &src_texcoords = rmesh.texcoords.at(0);
+    std::vector<vec3> usd_points;
+    std::vector<vec2> texcoords(fvIndices.size());
+    std::vector<vec3> normals(fvIndices.size());
+    for (size_t i = 0; i < fvIndices.size(); i++) {
+      const uint32_t pidx = point_indices[i];
+      if (pidx >= usd_points.size()) {
+        usd_points.resize(pidx + 1, {0.0f, 0.0f, 0.0f});
+      }
+      usd_points[pidx] = rmesh.points[fvIndices[i]];
+
+      const size_t tidx = src_texcoords.is_vertex() ? fvIndices[i] : i;
+      const size_t nidx = rmesh.normals.is_vertex() ? fvIndices[i] : i;
+      if ((tidx >= src_texcoords.vertex_count()) ||
+          (nidx >= rmesh.normals.vertex_count())) {
+        (*err) += fmt::format("Invalid texcoords or normals in {}.\n",
+                              rmesh.abs_path);
+        return false;
+      }
+      memcpy(&texcoords[i],
+             src_texcoords.get_data().data() +
+                 tidx * src_texcoords.stride_bytes(),
+             sizeof(vec2));
+      memcpy(&normals[i],
+             rmesh.normals.get_data().data() +
+                 nidx * rmesh.normals.stride_bytes(),
+             sizeof(vec3));
+    }
+
+    std::vector<vec3> tangents;
+    std::vector<vec3> binormals;
+    std::vector<uint32_t> vertex_indices;
+    if (!ComputeTangentsAndBinormals(usd_points, rmesh.faceVertexCounts(),
+                                     point_indices, texcoords, normals,
+                                     /* is_facevarying_input */ true,
+                                     /* num_threads */ 1, &tangents,
+                                     &binormals, &vertex_indices, err)) {
+      return false;
+    }
+
+    const size_t n =
+        rmesh.tangents.is_vertex() ? rmesh.points.size() : fvIndices.size();
+    if ((rmesh.tangents.vertex_count() != n) ||
+        (rmesh.binormals.vertex_count() != n)) {
+      (*err) += fmt::format("Invalid tangents.size in {}.\n", rmesh.abs_path);
+      return false;
+    }
+
+    for (size_t i = 0; i < fvIndices.size(); i++) {
+      const size_t idx = rmesh.tangents.is_vertex() ? fvIndices[i] : i;
+      UpdateVertexAttributeItem(rmesh.tangents, idx,
+                                tangents[vertex_indices[i]], &update->tangents);
+      UpdateVertexAttributeItem(rmesh.binormals, idx,
+                                binormals[vertex_indices[i]],
+                                &update->tangents);
+    }
+  }
+
+  return true;
+}
+
+bool RenderSceneUpdater::UpdateMaterial(const uint32_t material_id,
+                                        const UsdPreviewSurface *surface,
+                                        const double t, bool *updated) {
+  PreviewSurfaceShader &pss = _scene->materials[material_id].surfaceShader;
+
+#define UPDATE_PARAM(__name)                                                 \
+  if (!UpdateShaderParam(surface->__name, t, _tinterp, pss.__name, updated)) { \
+    PUSH_ERROR_AND_RETURN(                                                   \
+        fmt::format("Failed to evaluate {} of {}", #__name,                  \
+                    _scene->materials[material_id].abs_path));               \
+  }
+
+  UPDATE_PARAM(diffuseColor)
+  UPDATE_PARAM(emissiveColor)
+  UPDATE_PARAM(specularColor)
+  UPDATE_PARAM(metallic)
+  UPDATE_PARAM(roughness)
+  UPDATE_PARAM(clearcoat)
+  UPDATE_PARAM(clearcoatRoughness)
+  UPDATE_PARAM(opacity)
+  UPDATE_PARAM(opacityThreshold)
+  UPDATE_PARAM(ior)
+  UPDATE_PARAM(normal)
+  UPDATE_PARAM(displacement)
+  UPDATE_PARAM(occlusion)
+
+#undef UPDATE_PARAM
+
+  return true;
+}
+
+bool RenderSceneUpdater::UpdateVertexBuffer(
+    const AnimatedMesh &amesh, RenderSceneUpdateResult::MeshUpdate *update,
+    std::string *err) {
+  if (!amesh.vertex_buffer_source) {
+    return true;
+  }
+
+  const RenderMesh &mesh = _scene->meshes[amesh.mesh_id];
+
+  if (update->points.empty() && update->normals.empty() &&
+      update->tangents.empty()) {
+    return true;
+  }
+
+  RenderSceneUpdateResult::Range &range = update->vertex_buffer;
+  if (mesh.is_single_indexable &&
+      (mesh.normals.empty() || mesh.normals.is_vertex()) &&
+      (mesh.tangents.empty() || mesh.tangents.is_vertex())) {
+    // Vertices in the buffer are points.
+    if (!update->points.empty()) {
+      range.extend(update->points.begin);
+      range.extend(update->points.end - 1);
+    }
+    if (!update->normals.empty()) {
+      range.extend(update->normals.begin);
+      range.extend(update->normals.end - 1);
+    }
+    if (!update->tangents.empty()) {
+      range.extend(update->tangents.begin);
+      range.extend(update->tangents.end - 1);
+    }
+  } else {
+    range.begin = 0;
+    range.end = mesh.num_buffer_vertices;
+  }
+
+  range.end = (std::min)(range.end, size_t(mesh.num_buffer_vertices));
+  if (range.empty()) {
+    return true;
+  }
+
+  return EncodeInterleavedVertexRange(
+      mesh, amesh.vertex_buffer_source->map,
+      amesh.vertex_buffer_source->sources, range.begin, range.end,
+      &_scene->buffers[size_t(mesh.vertex_buffer_id)], err);
+}
+
+bool RenderSceneUpdater::UpdateMeshletBounds(
+    const AnimatedMesh &amesh, RenderSceneUpdateResult::MeshUpdate *update,
+    std::string *err) {
+  RenderMesh &mesh = _scene->meshes[amesh.mesh_id];
+  if (mesh.meshlets.empty() || update->points.empty()) {
+    return true;
+  }
+
+  if ((mesh.meshlet_vertices_buffer_id < 0) ||
+      (size_t(mesh.meshlet_vertices_buffer_id) >= _scene->buffers.size()) ||
+      (mesh.meshlet_triangles_buffer_id < 0) ||
+      (size_t(mesh.meshlet_triangles_buffer_id) >= _scene->buffers.size())) {
+    (*err) += fmt::format("Invalid meshlet buffers in {}.\n", mesh.abs_path);
+    return false;
+  }
+
+  const std::vector<uint8_t> &vb =
+      _scene->buffers[size_t(mesh.meshlet_vertices_buffer_id)].data;
+  const std::vector<uint8_t> &tb =
+      _scene->buffers[size_t(mesh.meshlet_triangles_buffer_id)].data;
+
+  std::vector<uint32_t> vertices;
+  for (size_t i = 0; i < mesh.meshlets.size(); i++) {
+    Meshlet &m = mesh.meshlets[i];
+    if ((size_t(m.vertex_offset) + m.vertex_count) * sizeof(uint32_t) >
+            vb.size() ||
+        (size_t(m.triangle_offset) + m.triangle_count) * 3 > tb.size()) {
+      (*err) += fmt::format("Invalid meshlet {} in {}.\n", i, mesh.abs_path);
+      return false;
+    }
+
+    vertices.resize(m.vertex_count);
+    if (m.vertex_count > 0) {
+      memcpy(vertices.data(), vb.data() + m.vertex_offset * sizeof(uint32_t),
+             m.vertex_count * sizeof(uint32_t));
+    }
+    for (uint32_t v : vertices) {
+      if (v >= mesh.points.size()) {
+        (*err) += fmt::format("Invalid meshlet {} in {}.\n", i, mesh.abs_path);
+        return false;
+      }
+    }
+
+    Meshlet updated = m;
+    ComputeMeshletBounds(mesh.points, vertices.data(),
+                         tb.data() + 3 * size_t(m.triangle_offset), &updated);
+    if (memcmp(&updated, &m, sizeof(Meshlet)) != 0) {
+      m = updated;
+      update->meshlets.extend(i);
+    }
+  }
+
+  return true;
+}
+
+bool RenderSceneUpdater::Update(const double t,
+                                RenderSceneUpdateResult *result) {
+  _err.clear();
+
+  if (!_stage || !_scene) {
+    PUSH_ERROR_AND_RETURN("RenderSceneUpdater is not built.");
+  }
+
+  RenderSceneUpdateResult local_result;
+  RenderSceneUpdateResult &res = result ? (*result) : local_result;
+  res.clear();
+
+  //
+  // 1. Xform
+  //
+  if (!_nodes.empty()) {
+    if (!_xform_cache.set_time(t)) {
+      PUSH_WARN(_xform_cache.get_error());
+    }
+
+    const XformHierarchy &h = _xform_cache.hierarchy();
+    for (const auto &it : _nodes) {
+      Node *node = it.first;
+      const value::matrix4d &local = h.local_matrices[it.second];
+      const value::matrix4d &world = h.world_matrices[it.second];
+
+      if ((memcmp(&node->local_matrix, &local, sizeof(value::matrix4d)) !=
+           0) ||
+          (memcmp(&node->global_matrix, &world, sizeof(value::matrix4d)) !=
+           0)) {
+        node->local_matrix = local;
+        node->global_matrix = world;
+        res.nodes.push_back(node);
+      }
+    }
+  }
+
+  //
+  // 2. Mesh
+  //
+  {
+    std::vector<RenderSceneUpdateResult::MeshUpdate> updates(_meshes.size());
+    std::vector<std::string> errs(_meshes.size());
+    std::vector<uint8_t> rets(_meshes.size(), 0);
+
+    parallel::ParallelFor(
+        0, _meshes.size(), parallel::GetNumThreads(_num_threads),
+        [&](size_t i, uint32_t tid) {
+          (void)tid;
+          rets[i] = UpdateMesh(_meshes[i], t, &updates[i], &errs[i]) ? 1 : 0;
+          if (rets[i]) {
+            rets[i] = UpdateVertexBuffer(_meshes[i], &updates[i], &errs[i])
+                          ? 1
+                          : 0;
+          }
+          if (rets[i]) {
+            rets[i] = UpdateMeshletBounds(_meshes[i], &updates[i], &errs[i])
+                          ? 1
+                          : 0;
+          }
+        },
+        /* grain_size */ 1);
+
+    for (size_t i = 0; i < _meshes.size(); i++) {
+      if (!rets[i]) {
+        PUSH_ERROR_AND_RETURN(errs[i]);
+      }
+
+      if (!updates[i].points.empty() || !updates[i].normals.empty() ||
+          !updates[i].tangents.empty()) {
+        res.meshes.push_back(updates[i]);
+      }
+    }
+  }
+
+  //
+  // 3. Material
+  //
+  for (const auto &it : _materials) {
+    bool updated{false};
+    if (!UpdateMaterial(it.first, it.second, t, &updated)) {
+      return false;
+    }
+    if (updated) {
+      res.materials.push_back(it.first);
+    }
+  }
+
+  return true;
+}
+
+namespace {
+
+uint32_t NumSemanticComponents(const VertexAttributeSemantic semantic) {
+  switch (semantic) {
+    case VertexAttributeSemantic::Position:
+    case VertexAttributeSemantic::Normal:
+    case VertexAttributeSemantic::Tangent:
+    case VertexAttributeSemantic::Binormal:
+    case VertexAttributeSemantic::Color:
+      return 3;
+    case VertexAttributeSemantic::Texcoord0:
+    case VertexAttributeSemantic::Texcoord1:
+      return 2;
+    case VertexAttributeSemantic::Opacity:
+      return 1;
+  }
+  return 0;
+}
+
+// Format of `n` encoded components.
+bool GetEncodedFormat(const VertexAttributeEncoding encoding, const uint32_t n,
+                      VertexAttributeFormat *format) {
+  if ((n < 1) || (n > 4)) {
+    return false;
+  }
+
+  static const VertexAttributeFormat kFormats[6][4] = {
+      {VertexAttributeFormat::Float, VertexAttributeFormat::Vec2,
+       VertexAttributeFormat::Vec3, VertexAttributeFormat::Vec4},
+      {VertexAttributeFormat::Half, VertexAttributeFormat::Half2,
+       VertexAttributeFormat::Half3, VertexAttributeFormat::Half4},
+      {VertexAttributeFormat::Char, VertexAttributeFormat::Char2,
+       VertexAttributeFormat::Char3, VertexAttributeFormat::Char4},
+      {VertexAttributeFormat::Short, VertexAttributeFormat::Short2,
+       VertexAttributeFormat::Short3, VertexAttributeFormat::Short4},
+      {VertexAttributeFormat::Byte, VertexAttributeFormat::Byte2,
+       VertexAttributeFormat::Byte3, VertexAttributeFormat::Byte4},
+      {VertexAttributeFormat::Ushort, VertexAttributeFormat::Ushort2,
+       VertexAttributeFormat::Ushort3, VertexAttributeFormat::Ushort4},
+  };
+
+  switch (encoding) {
+    case VertexAttributeEncoding::Float:
+      (*format) = kFormats[0][n - 1];
+      return true;
+    case VertexAttributeEncoding::Half:
+      (*format) = kFormats[1][n - 1];
+      return true;
+    case VertexAttributeEncoding::Snorm8:
+      (*format) = kFormats[2][n - 1];
+      return true;
+    case VertexAttributeEncoding::Snorm16:
+      (*format) = kFormats[3][n - 1];
+      return true;
+    case VertexAttributeEncoding::Unorm8:
+      (*format) = kFormats[4][n - 1];
+      return true;
+    case VertexAttributeEncoding::Unorm16:
+      (*format) = kFormats[5][n - 1];
+      return true;
+    case VertexAttributeEncoding::Oct8:
+      if (n != 3) {
+        return false;
+      }
+      (*format) = VertexAttributeFormat::Char2;
+      return true;
+    case VertexAttributeEncoding::Oct16:
+      if (n != 3) {
+        return false;
+      }
+      (*format) = VertexAttributeFormat::Short2;
+      return true;
+  }
+  return false;
+}
+
+// Octahedral encoding of a unit vector.
+// "A Survey of Efficient Representations for Independent Unit Vectors"
+// (Cigolle et al. 2014)
+void OctEncode(const float v[3], float ret[2]) {
+  const float l1 = std::fabs(v[0]) + std::fabs(v[1]) + std::fabs(v[2]);
+  if (l1 <= std::numeric_limits<float>::min()) {
+    ret[0] = 0.0f;
+    ret[1] = 0.0f;
+    return;
+  }
+
+  float x = v[0] / l1;
+  float y = v[1] / l1;
+  if (v[2] < 0.0f) {
+    const float ox = x;
+    x = (1.0f - std::fabs(y)) * ((ox >= 0.0f) ? 1.0f : -1.0f);
+    y = (1.0f - std::fabs(ox)) * ((y >= 0.0f) ? 1.0f : -1.0f);
+  }
+  ret[0] = x;
+  ret[1] = y;
+}
+
+template <typename T>
+void StoreNormalized(const float *v, const uint32_t n, const float lo,
+                     const float scale, uint8_t *dst) {
+  for (uint32_t k = 0; k < n; k++) {
+    const float f = (std::min)(1.0f, (std::max)(lo, v[k]));
+    const T q = static_cast<T>(std::round(f * scale));
+    memcpy(dst + k * sizeof(T), &q, sizeof(T));
+  }
+}
+
+void EncodeVertexAttribute(const VertexAttributeEncoding encoding,
+                           const float v[4], const uint32_t n, uint8_t *dst) {
+  switch (encoding) {
+    case VertexAttributeEncoding::Float:
+      memcpy(dst, v, sizeof(float) * n);
+      break;
+    case VertexAttributeEncoding::Half:
+      for (uint32_t k = 0; k < n; k++) {
+        const value::half h = value::float_to_half_full(v[k]);
+        memcpy(dst + k * sizeof(uint16_t), &h.value, sizeof(uint16_t));
+      }
+      break;
+    case VertexAttributeEncoding::Snorm8:
+      StoreNormalized<int8_t>(v, n, -1.0f, 127.0f, dst);
+      break;
+    case VertexAttributeEncoding::Snorm16:
+      StoreNormalized<int16_t>(v, n, -1.0f, 32767.0f, dst);
+      break;
+    case VertexAttributeEncoding::Unorm8:
+      StoreNormalized<uint8_t>(v, n, 0.0f, 255.0f, dst);
+      break;
+    case VertexAttributeEncoding::Unorm16:
+      StoreNormalized<uint16_t>(v, n, 0.0f, 65535.0f, dst);
+      break;
+    case VertexAttributeEncoding::Oct8: {
+      float oct[2];
+      OctEncode(v, oct);
+      StoreNormalized<int8_t>(oct, 2, -1.0f, 127.0f, dst);
+      break;
+    }
+    case VertexAttributeEncoding::Oct16: {
+      float oct[2];
+      OctEncode(v, oct);
+      StoreNormalized<int16_t>(oct, 2, -1.0f, 32767.0f, dst);
+      break;
+    }
+  }
+}
+
+bool GetSourceComponents(const VertexAttributeFormat format, uint32_t *n) {
+  switch (format) {
+    case VertexAttributeFormat::Float:
+    case VertexAttributeFormat::Half:
+    case VertexAttributeFormat::Double:
+      (*n) = 1;
+      return true;
+    case VertexAttributeFormat::Vec2:
+    case VertexAttributeFormat::Half2:
+    case VertexAttributeFormat::Dvec2:
+      (*n) = 2;
+      return true;
+    case VertexAttributeFormat::Vec3:
+    case VertexAttributeFormat::Half3:
+    case VertexAttributeFormat::Dvec3:
+      (*n) = 3;
+      return true;
+    case VertexAttributeFormat::Vec4:
+    case VertexAttributeFormat::Half4:
+    case VertexAttributeFormat::Dvec4:
+      (*n) = 4;
+      return true;
+    default:
+      return false;
+  }
+}
+
+void ReadSourceValue(const InterleavedAttributeSource &src, const size_t idx,
+                     float v[4]) {
+  const uint8_t *p = src.attr->get_data().data() + idx * src.src_stride;
+  switch (src.src_format) {
+    case VertexAttributeFormat::Half:
+    case VertexAttributeFormat::Half2:
+    case VertexAttributeFormat::Half3:
+    case VertexAttributeFormat::Half4:
+      for (uint32_t k = 0; k < src.src_components; k++) {
+        value::half h;
+        memcpy(&h.value, p + k * sizeof(uint16_t), sizeof(uint16_t));
+        v[k] = value::half_to_float(h);
+      }
+      break;
+    case VertexAttributeFormat::Double:
+    case VertexAttributeFormat::Dvec2:
+    case VertexAttributeFormat::Dvec3:
+    case VertexAttributeFormat::Dvec4:
+      for (uint32_t k = 0; k < src.src_components; k++) {
+        double d;
+        memcpy(&d, p + k * sizeof(double), sizeof(double));
+        v[k] = float(d);
+      }
+      break;
+    default:
+      memcpy(v, p, sizeof(float) * src.src_components);
+      break;
+  }
+}
+
+bool BuildInterleavedVertexMap(const RenderMesh &mesh,
+                               InterleavedVertexMap *map, std::string *err) {
+  const std::vector<uint32_t> &indices = mesh.faceVertexIndices();
+  const std::vector<uint32_t> &counts = mesh.faceVertexCounts();
+
+  if ((indices.size() % 3) != 0) {
+    if (err) {
+      (*err) += "Mesh is not triangulated.\n";
+    }
+    return false;
+  }
+
+  const size_t num_triangles = indices.size() / 3;
+
+  if (mesh.triangulatedToOrigFaceIndexMap.size() == num_triangles) {
+    // Triangles are reordered.
+    map->triangle_to_face = mesh.triangulatedToOrigFaceIndexMap;
+  } else if (mesh.is_triangulated()) {
+    // # of triangles of each USD face.
+    const std::vector<uint32_t> &face_counts = mesh.triangulatedFaceCounts;
+    map->triangle_to_face.reserve(num_triangles);
+    for (size_t f = 0; f < face_counts.size(); f++) {
+      map->triangle_to_face.insert(map->triangle_to_face.end(),
+                                   size_t(face_counts[f]), uint32_t(f));
+    }
+  } else {
+    for (size_t f = 0; f < counts.size(); f++) {
+      if (counts[f] != 3) {
+        if (err) {
+          (*err) += "Mesh is not triangulated.\n";
+        }
+        return false;
+      }
+    }
+  }
+
+  for (size_t i = 0; i < indices.size(); i++) {
+    if (indices[i] >= mesh.points.size()) {
+      if (err) {
+        (*err) += fmt::format("faceVertexIndex {} out of range.\n", indices[i]);
+      }
+      return false;
+    }
+  }
+
+  map->num_points = mesh.points.size();
+  map->single_indexable = mesh.is_single_indexable;
+
+  if (map->single_indexable) {
+    map->num_vertices = mesh.points.size();
+    map->point_to_corner.assign(mesh.points.size(), -1);
+    for (size_t i = 0; i < indices.size(); i++) {
+      if (map->point_to_corner[indices[i]] < 0) {
+        map->point_to_corner[indices[i]] = int64_t(i);
+      }
+    }
+  } else {
+    map->num_vertices = indices.size();
+  }
+
+  return true;
+}
+
+bool SetupInterleavedAttributeSources(
+    const RenderMesh &mesh, const VertexLayout &layout,
+    std::vector<InterleavedAttributeSource> *sources, std::string *err) {
+  sources->resize(layout.elements.size());
+
+  for (size_t i = 0; i < layout.elements.size(); i++) {
+    const VertexLayoutElement &elem = layout.elements[i];
+    InterleavedAttributeSource &src = (*sources)[i];
+
+    src.encoding = elem.encoding;
+    src.num_components = NumSemanticComponents(elem.semantic);
+    src.offset = elem.offset;
+
+    switch (elem.semantic) {
+      case VertexAttributeSemantic::Position:
+        src.points = &mesh.points;
+        break;
+      case VertexAttributeSemantic::Normal:
+        src.attr = &mesh.normals;
+        break;
+      case VertexAttributeSemantic::Tangent:
+        src.attr = &mesh.tangents;
+        break;
+      case VertexAttributeSemantic::Binormal:
+        src.attr = &mesh.binormals;
+        break;
+      case VertexAttributeSemantic::Texcoord0:
+      case VertexAttributeSemantic::Texcoord1: {
+        const uint32_t slot =
+            (elem.semantic == VertexAttributeSemantic::Texcoord0) ? 0 : 1;
+        auto it = mesh.texcoords.find(slot);
+        if (it != mesh.texcoords.end()) {
+          src.attr = &it->second;
+        }
+        break;
+      }
+      case VertexAttributeSemantic::Color:
+        src.attr = &mesh.vertex_colors;
+        src.fallback[0] = mesh.displayColor[0];
+        src.fallback[1] = mesh.displayColor[1];
+        src.fallback[2] = mesh.displayColor[2];
+        break;
+      case VertexAttributeSemantic::Opacity:
+        src.attr = &mesh.vertex_opacities;
+        src.fallback[0] = mesh.displayOpacity;
+        break;
+    }
+
+    if (src.attr && src.attr->empty()) {
+      src.attr = nullptr;
+    }
+
+    if (src.attr) {
+      if (!GetSourceComponents(src.attr->format, &src.src_components)) {
+        if (err) {
+          (*err) += fmt::format(
+              "Unsupported vertex attribute format for interleaved vertex "
+              "buffer: {}\n",
+              to_string(src.attr->format));
+        }
+        return false;
+      }
+      src.src_format = src.attr->format;
+      src.src_components = (std::min)(src.src_components, src.num_components);
+      src.src_stride = src.attr->stride_bytes();
+      src.src_count = src.attr->vertex_count();
+    }
+  }
+
+  return true;
+}
+
+// Encode vertices [begin, end) to `dst`(`dst` points to the vertex `begin`).
+bool EncodeInterleavedVertices(
+    const RenderMesh &mesh, const InterleavedVertexMap &map,
+    const std::vector<InterleavedAttributeSource> &sources,
+    const uint32_t stride, const size_t begin, const size_t end, uint8_t *dst,
+    std::string *err) {
+  const std::vector<uint32_t> &indices = mesh.faceVertexIndices();
+
+  for (size_t v = begin; v < end; v++) {
+    // point index, face vertex index(-1 = N/A), face index(-1 = N/A)
+    size_t p;
+    int64_t c;
+    if (map.single_indexable) {
+      p = v;
+      c = map.point_to_corner[v];
+    } else {
+      p = indices[v];
+      c = int64_t(v);
+    }
+
+    int64_t f = -1;
+    if (c >= 0) {
+      const size_t tri = size_t(c) / 3;
+      if (map.triangle_to_face.empty()) {
+        f = int64_t(tri);
+      } else if (tri < map.triangle_to_face.size()) {
+        f = int64_t(map.triangle_to_face[tri]);
+      }
+    }
+
+    uint8_t *vdst = dst + (v - begin) * stride;
+
+    for (const auto &src : sources) {
+      float val[4];
+      memcpy(val, src.fallback, sizeof(float) * 4);
+
+      if (src.attr) {
+        int64_t idx = -1;
+        switch (src.attr->variability) {
+          case VertexVariability::Constant:
+            idx = 0;
+            break;
+          case VertexVariability::Uniform:
+            idx = f;
+            break;
+          case VertexVariability::Vertex:
+          case VertexVariability::Varying:
+            idx = int64_t(p);
+            break;
+          case VertexVariability::FaceVarying:
+            idx = c;
+            break;
+          case VertexVariability::Indexed: {
+            const std::vector<uint32_t> &attr_indices = src.attr->indices;
+            if (attr_indices.size() == indices.size()) {
+              idx = (c >= 0) ? int64_t(attr_indices[size_t(c)]) : -1;
+            } else if (p < attr_indices.size()) {
+              idx = int64_t(attr_indices[p]);
+            }
+            break;
+          }
+        }
+
+        if (idx >= 0) {
+          if (size_t(idx) >= src.src_count) {
+            if (err) {
+              (*err) += fmt::format(
+                  "Vertex attribute index {} out of range(# of items {}).\n",
+                  idx, src.src_count);
+            }
+            return false;
+          }
+          val[0] = val[1] = val[2] = val[3] = 0.0f;
+          ReadSourceValue(src, size_t(idx), val);
+        }
+      } else if (src.points) {
+        memcpy(val, &(*src.points)[p], sizeof(vec3));
+      }
+
+      EncodeVertexAttribute(src.encoding, val, src.num_components,
+                            vdst + src.offset);
+    }
+  }
+
+  return true;
+}
+
+// Re-encode vertices [begin, end) of the vertex buffer built with
+// `mesh.vertex_layout`.
+bool EncodeInterleavedVertexRange(
+    const RenderMesh &mesh, const InterleavedVertexMap &map,
+    const std::vector<InterleavedAttributeSource> &sources, const size_t begin,
+    const size_t end, BufferData *vertex_buffer, std::string *err) {
+  const VertexLayout &layout = mesh.vertex_layout;
+  if ((begin >= end) || (end > mesh.num_buffer_vertices)) {
+    if (err) {
+      (*err) += fmt::format("Invalid vertex range [{}, {}).\n", begin, end);
+    }
+    return false;
+  }
+
+  if (vertex_buffer->data.size() !=
+      size_t(mesh.num_buffer_vertices) * layout.stride) {
+    if (err) {
+      (*err) += "Vertex buffer size mismatch.\n";
+    }
+    return false;
+  }
+
+  if (map.num_vertices != mesh.num_buffer_vertices) {
+    if (err) {
+      (*err) += "Topology of the mesh has been changed.\n";
+    }
+    return false;
+  }
+
+  return EncodeInterleavedVertices(
+      mesh, map, sources, layout.stride, begin, end,
+      vertex_buffer->data.data() + begin * layout.stride, err);
+}
+
+}  // namespace
+
+bool ResolveVertexLayout(VertexLayout *layout, std::string *err) {
+  if (!layout) {
+    if (err) {
+      (*err) += "`layout` argument is nullptr.\n";
+    }
+    return false;
+  }
+
+  if ((layout->alignment == 0) ||
+      ((layout->alignment & (layout->alignment - 1)) != 0)) {
+    if (err) {
+      (*err) += fmt::format("alignment must be power of two, but got {}.\n",
+                            layout->alignment);
+    }
+    return false;
+  }
+
+  const uint32_t align = layout->alignment;
+  uint32_t offset = 0;
+
+  for (auto &elem : layout->elements) {
+    const uint32_t n = NumSemanticComponents(elem.semantic);
+    if (!GetEncodedFormat(elem.encoding, n, &elem.format)) {
+      if (err) {
+        (*err) +=
+            "Octahedral encoding is only applicable to 3 component "
+            "attribute(normal, tangent, binormal).\n";
+      }
+      return false;
+    }
+
+    elem.offset = offset;
+    offset += uint32_t(VertexAttributeFormatSize(elem.format));
+    offset = (offset + align - 1) & ~(align - 1);
+  }
+
+  if (layout->stride == 0) {
+    layout->stride = offset;
+  } else if (layout->stride < offset) {
+    if (err) {
+      (*err) += fmt::format(
+          "stride {} is smaller than the size of vertex attributes {}.\n",
+          layout->stride, offset);
+    }
+    return false;
+  }
+
+  return true;
+}
+
+bool BuildInterleavedVertexBuffer(const RenderMesh &mesh,
+                                  const VertexLayout &layout,
+                                  const bool use_16bit_indices,
+                                  BufferData *vertex_buffer,
+                                  BufferData *index_buffer,
+                                  uint32_t *num_vertices, std::string *err) {
+  if (!vertex_buffer || !index_buffer || !num_vertices) {
+    if (err) {
+      (*err) += "Output argument is nullptr.\n";
+    }
+    return false;
+  }
+
+  if ((layout.stride == 0) || layout.elements.empty()) {
+    if (err) {
+      (*err) += "Vertex layout is empty or not resolved.\n";
+    }
+    return false;
+  }
+
+  InterleavedVertexMap map;
+  if (!BuildInterleavedVertexMap(mesh, &map, err)) {
+    return false;
+  }
+
+  if (map.num_vertices > size_t((std::numeric_limits<uint32_t>::max)())) {
+    if (err) {
+      (*err) += "Too many vertices.\n";
+    }
+    return false;
+  }
+
+  std::vector<InterleavedAttributeSource> sources;
+  if (!SetupInterleavedAttributeSources(mesh, layout, &sources, err)) {
+    return false;
+  }
+
+  vertex_buffer->componentType = ComponentType::UInt8;
+  vertex_buffer->data.assign(map.num_vertices * layout.stride, 0);
+
+  if (!EncodeInterleavedVertices(mesh, map, sources, layout.stride, 0,
+                                 map.num_vertices, vertex_buffer->data.data(),
+                                 err)) {
+    return false;
+  }
+
+  //
+  // Index buffer(triangle list)
+  //
+  const std::vector<uint32_t> &indices = mesh.faceVertexIndices();
+  const bool use_16bit = use_16bit_indices && (map.num_vertices <= 65536);
+
+  StoreIndexBuffer(map.single_indexable ? indices.data() : nullptr,
+                   indices.size(), use_16bit, index_buffer);
+
+  (*num_vertices) = uint32_t(map.num_vertices);
+
+  return true;
+}
+
+bool UpdateInterleavedVertexBuffer(const RenderMesh &mesh, const size_t begin,
+                                   const size_t end, BufferData *vertex_buffer,
+                                   std::string *err) {
+  if (!vertex_buffer) {
+    if (err) {
+      (*err) += "`vertex_buffer` argument is nullptr.\n";
+    }
+    return false;
+  }
+
+  InterleavedVertexMap map;
+  if (!BuildInterleavedVertexMap(mesh, &map, err)) {
+    return false;
+  }
+
+  std::vector<InterleavedAttributeSource> sources;
+  if (!SetupInterleavedAttributeSources(mesh, mesh.vertex_layout, &sources,
+                                        err)) {
+    return false;
+  }
+
+  return EncodeInterleavedVertexRange(mesh, map, sources, begin, end,
+                                      vertex_buffer, err);
+}
+
+namespace {
+
+// Scoring function of "Linear-Speed Vertex Cache Optimisation"(Tom Forsyth).
+float ForsythVertexScore(const int32_t cache_pos, const uint32_t live_triangles,
+                         const uint32_t cache_size) {
+  if (live_triangles == 0) {
+    // No triangle needs this vertex.
+    return -1.0f;
+  }
+
+  float score = 0.0f;
+  if (cache_pos >= 0) {
+    if (cache_pos < 3) {
+      // Vertices used by the last triangle. Fixed score so that the triangle
+      // sharing the edge is not preferred too much.
+      score = 0.75f;
+    } else {
+      const float scaler = 1.0f / float(cache_size - 3);
+      score = std::pow(1.0f - float(cache_pos - 3) * scaler, 1.5f);
+    }
+  }
+
+  // Bonus for vertices with few remaining triangles, to get rid of them
+  // quickly.
+  score += 2.0f * (1.0f / std::sqrt(float(live_triangles)));
+
+  return score;
+}
+
+// Move `count` items of `stride` bytes: dst[i] = src[src_indices[i]]
+void GatherBytes(const std::vector<uint8_t> &src, const size_t stride,
+                 const std::vector<uint32_t> &src_indices,
+                 std::vector<uint8_t> *dst) {
+  dst->resize(src_indices.size() * stride);
+  for (size_t i = 0; i < src_indices.size(); i++) {
+    memcpy(dst->data() + i * stride,
+           src.data() + size_t(src_indices[i]) * stride, stride);
+  }
+}
+
+void GatherVertexAttribute(const std::vector<uint32_t> &src_indices,
+                           VertexAttribute *attr) {
+  std::vector<uint8_t> buf;
+  GatherBytes(attr->get_data(), attr->stride_bytes(), src_indices, &buf);
+  attr->get_data().swap(buf);
+}
+
+}  // namespace
+
+bool OptimizeVertexCacheOrder(const std::vector<uint32_t> &indices,
+                              const size_t num_vertices,
+                              const uint32_t cache_size,
+                              std::vector<uint32_t> *triangle_order,
+                              std::string *err) {
+  constexpr uint32_t kMaxCacheSize = 64;
+
+  if (!triangle_order) {
+    if (err) {
+      (*err) += "`triangle_order` argument is nullptr.\n";
+    }
+    return false;
+  }
+
+  if ((indices.size() % 3) != 0) {
+    if (err) {
+      (*err) += "The number of indices must be multiple of 3.\n";
+    }
+    return false;
+  }
+
+  if ((cache_size < 4) || (cache_size > kMaxCacheSize)) {
+    if (err) {
+      (*err) += fmt::format("cache_size must be in [4, {}], but got {}.\n",
+                            kMaxCacheSize, cache_size);
+    }
+    return false;
+  }
+
+  const size_t num_tris = indices.size() / 3;
+  if (num_tris > size_t((std::numeric_limits<uint32_t>::max)())) {
+    if (err) {
+      (*err) += "Too many triangles.\n";
+    }
+    return false;
+  }
+
+  for (size_t i = 0; i < indices.size(); i++) {
+    if (indices[i] >= num_vertices) {
+      if (err) {
+        (*err) += fmt::format("Vertex index {} out of range.\n", indices[i]);
+      }
+      return false;
+    }
+  }
+
+  //
+  // Vertex -> triangles(CSR). Emitted triangles are removed from the list by
+  // swapping with the last live one.
+  //
+  std::vector<uint32_t> live_count(num_vertices, 0);
+  for (size_t i = 0; i < indices.size(); i++) {
+    live_count[indices[i]]++;
+  }
+
+  std::vector<size_t> offsets(num_vertices + 1, 0);
+  for (size_t v = 0; v < num_vertices; v++) {
+    offsets[v + 1] = offsets[v] + live_count[v];
+  }
+
+  std::vector<uint32_t> vertex_tris(indices.size());
+  {
+    std::vector<size_t> cursor(offsets.begin(), offsets.end() - 1);
+    for (size_t i = 0; i < indices.size(); i++) {
+      vertex_tris[cursor[indices[i]]++] = uint32_t(i / 3);
+    }
+  }
+
+  std::vector<int32_t> cache_pos(num_vertices, -1);
+  std::vector<float> vertex_score(num_vertices);
+  for (size_t v = 0; v < num_vertices; v++) {
+    vertex_score[v] = ForsythVertexScore(-1, live_count[v], cache_size);
+  }
+
+  std::vector<float> tri_score(num_tris);
+  std::vector<uint8_t> emitted(num_tris, 0);
+
+  int64_t best_tri = -1;
+  float best_score = -1.0f;
+  for (size_t t = 0; t < num_tris; t++) {
+    tri_score[t] = vertex_score[indices[3 * t + 0]] +
+                   vertex_score[indices[3 * t + 1]] +
+                   vertex_score[indices[3 * t + 2]];
+    if (tri_score[t] > best_score) {
+      best_score = tri_score[t];
+      best_tri = int64_t(t);
+    }
+  }
+
+  uint32_t cache[kMaxCacheSize + 3];
+  uint32_t new_cache[kMaxCacheSize + 3];
+  uint32_t cache_count = 0;
+
+  size_t next_unemitted = 0;
+
+  triangle_order->clear();
+  triangle_order->reserve(num_tris);
+
+  while (triangle_order->size() < num_tris) {
+    if (best_tri < 0) {
+      // No candidate in the cache. Restart from the next triangle in the input
+      // order.
+      while (emitted[next_unemitted]) {
+        next_unemitted++;
+      }
+      best_tri = int64_t(next_unemitted);
+    }
+
+    const size_t t = size_t(best_tri);
+    emitted[t] = 1;
+    triangle_order->push_back(uint32_t(t));
+
+    // Vertices of the triangle go to the front of the cache.
+    uint32_t n = 0;
+    for (size_t k = 0; k < 3; k++) {
+      const uint32_t v = indices[3 * t + k];
+
+      uint32_t *tris = &vertex_tris[offsets[v]];
+      const uint32_t count = live_count[v];
+      for (uint32_t j = 0; j < count; j++) {
+        if (tris[j] == uint32_t(t)) {
+          std::swap(tris[j], tris[count - 1]);
+          break;
+        }
+      }
+      live_count[v]--;
+
+      if (std::find(new_cache, new_cache + n, v) == (new_cache + n)) {
+        new_cache[n++] = v;
+      }
+    }
+    const uint32_t num_tri_verts = n;
+
+    for (uint32_t j = 0; j < cache_count; j++) {
+      const uint32_t v = cache[j];
+      if (std::find(new_cache, new_cache + num_tri_verts, v) ==
+          (new_cache + num_tri_verts)) {
+        new_cache[n++] = v;
+      }
+    }
+
+    // Update scores of vertices in the cache(and evicted ones).
+    for (uint32_t j = 0; j < n; j++) {
+      const uint32_t v = new_cache[j];
+      cache_pos[v] = (j < cache_size) ? int32_t(j) : -1;
+      vertex_score[v] = ForsythVertexScore(cache_pos[v], live_count[v],
+                                           cache_size);
+    }
+
+    // Rescore live triangles touching these vertices and pick the best one.
+    best_tri = -1;
+    best_score = -1.0f;
+    for (uint32_t j = 0; j < n; j++) {
+      const uint32_t v = new_cache[j];
+      const uint32_t *tris = &vertex_tris[offsets[v]];
+      for (uint32_t k = 0; k < live_count[v]; k++) {
+        const uint32_t u = tris[k];
+        tri_score[u] = vertex_score[indices[3 * u + 0]] +
+                       vertex_score[indices[3 * u + 1]] +
+                       vertex_score[indices[3 * u + 2]];
+        if (tri_score[u] > best_score) {
+          best_score = tri_score[u];
+          best_tri = int64_t(u);
+        }
+      }
+    }
+
+    cache_count = (std::min)(n, cache_size);
+    memcpy(cache, new_cache, sizeof(uint32_t) * cache_count);
+  }
+
+  return true;
+}
+
+float ComputeACMR(const std::vector<uint32_t> &indices,
+                  const uint32_t cache_size) {
+  const size_t num_tris = indices.size() / 3;
+  if ((num_tris == 0) || (cache_size == 0)) {
+    return 0.0f;
+  }
+
+  const uint32_t max_index =
+      *std::max_element(indices.begin(), indices.begin() + 3 * num_tris);
+
+  // FIFO cache: a vertex is in the cache when it was loaded within the last
+  // `cache_size` misses.
+  std::vector<size_t> timestamps(size_t(max_index) + 1, 0);
+  size_t misses = 0;
+
+  for (size_t i = 0; i < 3 * num_tris; i++) {
+    const uint32_t v = indices[i];
+    if ((timestamps[v] == 0) || ((misses + 1 - timestamps[v]) > cache_size)) {
+      misses++;
+      timestamps[v] = misses;
+    }
+  }
+
+  return float(misses) / float(num_tris);
+}
+
+bool OptimizeRenderMeshVertexCache(RenderMesh *mesh, const uint32_t cache_size,
+                                   std::string *err) {
+  if (!mesh) {
+    if (err) {
+      (*err) += "`mesh` argument is nullptr.\n";
+    }
+    return false;
+  }
+
+  if (!mesh->is_triangulated()) {
+    if (err) {
+      (*err) += "Mesh is not triangulated.\n";
+    }
+    return false;
+  }
+
+  const std::vector<uint32_t> &indices = mesh->triangulatedFaceVertexIndices;
+  if ((indices.size() % 3) != 0) {
+    if (err) {
+      (*err) += "Invalid triangulatedFaceVertexIndices.\n";
+    }
+    return false;
+  }
+
+  const size_t num_tris = indices.size() / 3;
+  const size_t num_points = mesh->points.size();
+
+  if (num_tris == 0) {
+    return true;
+  }
+
+  //
+  // Validate vertex attributes before modifying the mesh.
+  //
+  std::vector<VertexAttribute *> attrs{&mesh->normals, &mesh->tangents,
+                                       &mesh->binormals, &mesh->vertex_colors,
+                                       &mesh->vertex_opacities};
+  for (auto &it : mesh->texcoords) {
+    attrs.push_back(&it.second);
+  }
+
+  for (const VertexAttribute *attr : attrs) {
+    if (attr->empty()) {
+      continue;
+    }
+    if (attr->is_indexed()) {
+      if (err) {
+        (*err) += fmt::format("Indexed vertex attribute `{}` is not supported.\n",
+                              attr->name);
+      }
+      return false;
+    }
+    if (attr->is_vertex() && (attr->vertex_count() != num_points)) {
+      if (err) {
+        (*err) += fmt::format(
+            "The number of items of `{}` must be equal to the number of "
+            "points.\n",
+            attr->name);
+      }
+      return false;
+    }
+    if (attr->is_facevarying() && (attr->vertex_count() != indices.size())) {
+      if (err) {
+        (*err) += fmt::format(
+            "The number of items of `{}` must be equal to the number of face "
+            "vertices.\n",
+            attr->name);
+      }
+      return false;
+    }
+  }
+
+  //
+  // 1. Group triangles by MaterialSubset(triangles not in any subset form the
+  // last group), then optimize the triangle order in each group.
+  //
+  const uint32_t kNoGroup = (std::numeric_limits<uint32_t>::max)();
+  const uint32_t num_groups = uint32_t(mesh->material_subsetMap.size()) + 1;
+  std::vector<uint32_t> tri_groups(num_tris, kNoGroup);
+  {
+    uint32_t gid = 0;
+    for (const auto &it : mesh->material_subsetMap) {
+      for (int t : it.second.triangulatedIndices) {
+        if ((t >= 0) && (size_t(t) < num_tris) &&
+            (tri_groups[size_t(t)] == kNoGroup)) {
+          tri_groups[size_t(t)] = gid;
+        }
+      }
+      gid++;
+    }
+  }
+
+  std::vector<size_t> group_offsets(size_t(num_groups) + 1, 0);
+  for (size_t t = 0; t < num_tris; t++) {
+    if (tri_groups[t] == kNoGroup) {
+      tri_groups[t] = num_groups - 1;
+    }
+    group_offsets[tri_groups[t] + 1]++;
+  }
+  for (size_t g = 0; g < num_groups; g++) {
+    group_offsets[g + 1] += group_offsets[g];
+  }
+
+  std::vector<uint32_t> group_tris(num_tris);
+  {
+    std::vector<size_t> cursor(group_offsets.begin(), group_offsets.end() - 1);
+    for (size_t t = 0; t < num_tris; t++) {
+      group_tris[cursor[tri_groups[t]]++] = uint32_t(t);
+    }
+  }
+
+  // new triangle index -> old triangle index
+  std::vector<uint32_t> tri_order;
+  tri_order.reserve(num_tris);
+  {
+    const uint32_t kInvalid = ~0u;
+    std::vector<uint32_t> local_ids(num_points, kInvalid);
+    std::vector<uint32_t> local_to_point;
+    std::vector<uint32_t> local_indices;
+    std::vector<uint32_t> local_order;
+    std::vector<uint32_t> reordered_indices;
+
+    for (size_t g = 0; g < num_groups; g++) {
+      local_to_point.clear();
+      local_indices.clear();
+
+      for (size_t i = group_offsets[g]; i < group_offsets[g + 1]; i++) {
+        const size_t t = group_tris[i];
+        for (size_t k = 0; k < 3; k++) {
+          const uint32_t p = indices[3 * t + k];
+          if (p >= num_points) {
+            if (err) {
+              (*err) += fmt::format("Vertex index {} out of range.\n", p);
+            }
+            return false;
+          }
+          if (local_ids[p] == kInvalid) {
+            local_ids[p] = uint32_t(local_to_point.size());
+            local_to_point.push_back(p);
+          }
+          local_indices.push_back(local_ids[p]);
+        }
+      }
+
+      if (!OptimizeVertexCacheOrder(local_indices, local_to_point.size(),
+                                    cache_size, &local_order, err)) {
+        return false;
+      }
+
+      // Keep the input order when it is already better(e.g. a small group
+      // which fits in the cache).
+      {
+        reordered_indices.resize(local_indices.size());
+        for (size_t i = 0; i < local_order.size(); i++) {
+          for (size_t k = 0; k < 3; k++) {
+            reordered_indices[3 * i + k] =
+                local_indices[3 * size_t(local_order[i]) + k];
+          }
+        }
+        if (ComputeACMR(reordered_indices, cache_size) >
+            ComputeACMR(local_indices, cache_size)) {
+          for (size_t i = 0; i < local_order.size(); i++) {
+            local_order[i] = uint32_t(i);
+          }
+        }
+      }
+
+      for (uint32_t lt : local_order) {
+        tri_order.push_back(group_tris[group_offsets[g] + lt]);
+      }
+
+      for (uint32_t p : local_to_point) {
+        local_ids[p] = kInvalid;
+      }
+    }
+  }
+
+  //
+  // 2. Reorder vertices in the order of the first use.
+  //
+  // old point index -> new point index
+  const uint32_t kUnused = ~0u;
+  std::vector<uint32_t> point_remap(num_points, kUnused);
+  // new point index -> old point index
+  std::vector<uint32_t> point_order;
+  point_order.reserve(num_points);
+
+  for (uint32_t t : tri_order) {
+    for (size_t k = 0; k < 3; k++) {
+      const uint32_t p = indices[3 * t + k];
+      if (point_remap[p] == kUnused) {
+        point_remap[p] = uint32_t(point_order.size());
+        point_order.push_back(p);
+      }
+    }
+  }
+
+  // Unreferenced points are kept at the end.
+  for (size_t p = 0; p < num_points; p++) {
+    if (point_remap[p] == kUnused) {
+      point_remap[p] = uint32_t(point_order.size());
+      point_order.push_back(uint32_t(p));
+    }
+  }
+
+  //
+  // 3. Apply
+  //
+
+  // new face vertex index -> old face vertex index
+  std::vector<uint32_t> fv_order(indices.size());
+  for (size_t t = 0; t < num_tris; t++) {
+    for (size_t k = 0; k < 3; k++) {
+      fv_order[3 * t + k] = 3 * tri_order[t] + uint32_t(k);
+    }
+  }
+
+  {
+    std::vector<uint32_t> new_indices(indices.size());
+    for (size_t i = 0; i < fv_order.size(); i++) {
+      new_indices[i] = point_remap[indices[fv_order[i]]];
+    }
+    mesh->triangulatedFaceVertexIndices.swap(new_indices);
+  }
+
+  if (mesh->triangulatedToOrigFaceVertexIndexMap.size() == fv_order.size()) {
+    std::vector<size_t> buf(fv_order.size());
+    for (size_t i = 0; i < fv_order.size(); i++) {
+      buf[i] = mesh->triangulatedToOrigFaceVertexIndexMap[fv_order[i]];
+    }
+    mesh->triangulatedToOrigFaceVertexIndexMap.swap(buf);
+  }
+
+  {
+    std::vector<uint32_t> &face_map = mesh->triangulatedToOrigFaceIndexMap;
+    if (face_map.empty()) {
+      for (size_t f = 0; f < mesh->triangulatedFaceCounts.size(); f++) {
+        face_map.insert(face_map.end(),
+                        size_t(mesh->triangulatedFaceCounts[f]), uint32_t(f));
+      }
+    }
+
+    if (face_map.size() == num_tris) {
+      std::vector<uint32_t> buf(num_tris);
+      for (size_t t = 0; t < num_tris; t++) {
+        buf[t] = face_map[tri_order[t]];
+      }
+      face_map.swap(buf);
+    } else {
+      face_map.clear();
+    }
+  }
+
+  {
+    std::vector<value::float3> buf(num_points);
+    for (size_t i = 0; i < num_points; i++) {
+      buf[i] = mesh->points[point_order[i]];
+    }
+    mesh->points.swap(buf);
+  }
+
+  for (VertexAttribute *attr : attrs) {
+    if (attr->empty()) {
+      continue;
+    }
+    if (attr->is_vertex()) {
+      GatherVertexAttribute(point_order, attr);
+    } else if (attr->is_facevarying()) {
+      GatherVertexAttribute(fv_order, attr);
+    }
+  }
+
+  JointAndWeight &jw = mesh->joint_and_weights;
+  if ((jw.elementSize > 0) &&
+      (jw.jointIndices.size() == num_points * size_t(jw.elementSize)) &&
+      (jw.jointWeights.size() == jw.jointIndices.size())) {
+    const size_t esize = size_t(jw.elementSize);
+    std::vector<int> tmp_indices(jw.jointIndices.size());
+    std::vector<float> tmp_weights(jw.jointWeights.size());
+    for (size_t i = 0; i < num_points; i++) {
+      const size_t src = size_t(point_order[i]);
+      for (size_t k = 0; k < esize; k++) {
+        tmp_indices[i * esize + k] = jw.jointIndices[src * esize + k];
+        tmp_weights[i * esize + k] = jw.jointWeights[src * esize + k];
+      }
+    }
+    jw.jointIndices.swap(tmp_indices);
+    jw.jointWeights.swap(tmp_weights);
+  }
+
+  for (auto &it : mesh->targets) {
+    for (auto &idx : it.second.pointIndices) {
+      if (idx < num_points) {
+        idx = point_remap[idx];
+      }
+    }
+  }
+
+  {
+    // old triangle index -> new triangle index
+    std::vector<uint32_t> tri_remap(num_tris);
+    for (size_t t = 0; t < num_tris; t++) {
+      tri_remap[tri_order[t]] = uint32_t(t);
+    }
+
+    for (auto &it : mesh->material_subsetMap) {
+      for (int &t : it.second.triangulatedIndices) {
+        if ((t >= 0) && (size_t(t) < num_tris)) {
+          t = int(tri_remap[size_t(t)]);
+        }
+      }
+      std::sort(it.second.triangulatedIndices.begin(),
+                it.second.triangulatedIndices.end());
+    }
+  }
+
+  return true;
+}
+
+namespace {
+
+// Symmetric 4x4 matrix of the quadric error metric.
+struct Quadric {
+  // a00, a01, a02, a03, a11, a12, a13, a22, a23, a33
+  double m[10]{0.0, 0.0, 0.0, 0.0, 0.0, 0.0, 0.0, 0.0, 0.0, 0.0};
+  double w{0.0};  // Sum of plane weights.
+
+  // Plane: n.x * x + n.y * y + n.z * z + d = 0
+  void add_plane(const double n[3], const double d, const double weight) {
+    m[0] += weight * n[0] * n[0];
+    m[1] += weight * n[0] * n[1];
+    m[2] += weight * n[0] * n[2];
+    m[3] += weight * n[0] * d;
+    m[4] += weight * n[1] * n[1];
+    m[5] += weight * n[1] * n[2];
+    m[6] += weight * n[1] * d;
+    m[7] += weight * n[2] * n[2];
+    m[8] += weight * n[2] * d;
+    m[9] += weight * d * d;
+    w += weight;
+  }
+
+  void add(const Quadric &q) {
+    for (size_t i = 0; i < 10; i++) {
+      m[i] += q.m[i];
+    }
+    w += q.w;
+  }
+
+  // Weighted mean of squared distance to the planes.
+  double error(const vec3 &p) const {
+    const double x = double(p[0]);
+    const double y = double(p[1]);
+    const double z = double(p[2]);
+    const double e = m[0] * x * x + 2.0 * m[1] * x * y + 2.0 * m[2] * x * z +
+                     2.0 * m[3] * x + m[4] * y * y + 2.0 * m[5] * y * z +
+                     2.0 * m[6] * y + m[7] * z * z + 2.0 * m[8] * z + m[9];
+    return (w > 0.0) ? (std::max)(0.0, e / w) : 0.0;
+  }
+};
+
+void TriangleNormal(const vec3 &p0, const vec3 &p1, const vec3 &p2,
+                    double n[3]) {
+  const double e1[3] = {double(p1[0]) - double(p0[0]),
+                        double(p1[1]) - double(p0[1]),
+                        double(p1[2]) - double(p0[2])};
+  const double e2[3] = {double(p2[0]) - double(p0[0]),
+                        double(p2[1]) - double(p0[1]),
+                        double(p2[2]) - double(p0[2])};
+  n[0] = e1[1] * e2[2] - e1[2] * e2[1];
+  n[1] = e1[2] * e2[0] - e1[0] * e2[2];
+  n[2] = e1[0] * e2[1] - e1[1] * e2[0];
+}
+
+struct EdgeCollapse {
+  double cost{0.0};
+  uint32_t from{0};
+  uint32_t to{0};
+};
+
+//
+// Half-edge collapse simplifier. Vertices are never moved(a vertex is merged
+// into its neighbor), so LODs can share the vertex buffer of the mesh.
+//
+class MeshSimplifier {
+ public:
+  bool init(const RenderMesh &mesh, std::string *err);
+
+  // Simplify to `target_tris` triangles or `max_error_sq`(squared distance).
+  void simplify(const size_t target_tris, const double max_error_sq);
+
+  // Current triangles sorted by group.
+  void get_lod(const RenderMesh &mesh, MeshLOD *lod) const;
+
+  double extent() const { return _extent; }
+  double max_collapse_error() const { return _max_error_sq; }
+  size_t num_triangles() const { return _tri_groups.size(); }
+
+ private:
+  bool flips(const uint32_t from, const uint32_t to) const;
+
+  bool has_edge(const uint32_t a, const uint32_t b) const;
+
+  const std::vector<vec3> *_points{nullptr};
+
+  std::vector<uint32_t> _indices;     // Current triangles.
+  std::vector<uint32_t> _tri_groups;  // Group(MaterialSubset) id of triangle.
+  uint32_t _num_groups{0};
+
+  std::vector<uint32_t> _pos_ids;    // Vertex -> unique position id.
+  std::vector<Quadric> _quadrics;    // per position id.
+  std::vector<uint8_t> _locked;      // per vertex.
+
+  // Vertex -> the other vertex at the same position when the position has
+  // exactly two vertices(UV/normal seam). ~0u = not on a seam.
+  std::vector<uint32_t> _seam_pairs;
+
+  // Vertex -> triangles of current triangles(CSR).
+  std::vector<size_t> _adj_offsets;
+  std::vector<uint32_t> _adj_tris;
+
+  double _extent{1.0};
+  double _max_error_sq{0.0};
+};
+
+bool MeshSimplifier::init(const RenderMesh &mesh, std::string *err) {
+  if (!mesh.is_triangulated() || !mesh.is_single_indexable) {
+    if (err) {
+      (*err) += "Mesh must be triangulated and single-indexable.\n";
+    }
+    return false;
+  }
+
+  _points = &mesh.points;
+  _indices = mesh.faceVertexIndices();
+
+  const size_t num_vertices = mesh.points.size();
+  const size_t num_tris = _indices.size() / 3;
+
+  if ((_indices.size() % 3) != 0) {
+    if (err) {
+      (*err) += "Invalid faceVertexIndices.\n";
+    }
+    return false;
+  }
+
+  for (uint32_t idx : _indices) {
+    if (idx >= num_vertices) {
+      if (err) {
+        (*err) += fmt::format("Vertex index {} out of range.\n", idx);
+      }
+      return false;
+    }
+  }
+
+  //
+  // Group of each triangle. Triangles not in any MaterialSubset form the last
+  // group.
+  //
+  const uint32_t kNoGroup = (std::numeric_limits<uint32_t>::max)();
+  _num_groups = uint32_t(mesh.material_subsetMap.size()) + 1;
+  _tri_groups.assign(num_tris, kNoGroup);
+  {
+    uint32_t gid = 0;
+    for (const auto &it : mesh.material_subsetMap) {
+      for (int t : it.second.triangulatedIndices) {
+        if ((t >= 0) && (size_t(t) < num_tris) &&
+            (_tri_groups[size_t(t)] == kNoGroup)) {
+          _tri_groups[size_t(t)] = gid;
+        }
+      }
+      gid++;
+    }
+  }
+  for (auto &g : _tri_groups) {
+    if (g == kNoGroup) {
+      g = _num_groups - 1;
+    }
+  }
+
+  //
+  // Unique position id. Vertices sharing a position(UV/normal seams) get the
+  // same id.
+  //
+  _pos_ids.resize(num_vertices);
+  size_t num_positions = 0;
+  {
+    std::vector<uint32_t> order(num_vertices);
+    for (size_t i = 0; i < num_vertices; i++) {
+      order[i] = uint32_t(i);
+    }
+    const std::vector<vec3> &pts = mesh.points;
+    auto less = [&pts](const uint32_t a, const uint32_t b) {
+      return memcmp(&pts[a], &pts[b], sizeof(vec3)) < 0;
+    };
+    std::sort(order.begin(), order.end(), less);
+
+    for (size_t i = 0; i < num_vertices; i++) {
+      if ((i > 0) &&
+          (memcmp(&pts[order[i]], &pts[order[i - 1]], sizeof(vec3)) == 0)) {
+        _pos_ids[order[i]] = _pos_ids[order[i - 1]];
+      } else {
+        _pos_ids[order[i]] = uint32_t(num_positions++);
+      }
+    }
+  }
+
+  //
+  // Lock vertices shared by more than two seams, open borders, non-manifold
+  // edges and group boundaries. A vertex on a single seam can be collapsed
+  // along the seam together with its pair(See `simplify`).
+  //
+  _locked.assign(num_vertices, 0);
+  _seam_pairs.assign(num_vertices, ~0u);
+  {
+    const uint32_t kInvalid = ~0u;
+    std::vector<uint32_t> pos_count(num_positions, 0);
+    std::vector<uint32_t> pos_first(num_positions, kInvalid);
+    for (size_t v = 0; v < num_vertices; v++) {
+      const uint32_t p = _pos_ids[v];
+      pos_count[p]++;
+      if (pos_first[p] == kInvalid) {
+        pos_first[p] = uint32_t(v);
+      }
+    }
+    for (size_t v = 0; v < num_vertices; v++) {
+      const uint32_t p = _pos_ids[v];
+      if (pos_count[p] > 2) {
+        _locked[v] = 1;
+      } else if ((pos_count[p] == 2) && (pos_first[p] != v)) {
+        _seam_pairs[v] = pos_first[p];
+        _seam_pairs[pos_first[p]] = uint32_t(v);
+      }
+    }
+  }
+
+  {
+    // Directed edges of positions.
+    std::unordered_map<uint64_t, uint32_t> edge_counts;
+    edge_counts.reserve(_indices.size());
+    auto key = [](const uint32_t a, const uint32_t b) {
+      return (uint64_t(a) << 32) | uint64_t(b);
+    };
+
+    for (size_t t = 0; t < num_tris; t++) {
+      for (size_t k = 0; k < 3; k++) {
+        const uint32_t a = _pos_ids[_indices[3 * t + k]];
+        const uint32_t b = _pos_ids[_indices[3 * t + ((k + 1) % 3)]];
+        edge_counts[key(a, b)]++;
+      }
+    }
+
+    for (size_t t = 0; t < num_tris; t++) {
+      for (size_t k = 0; k < 3; k++) {
+        const uint32_t va = _indices[3 * t + k];
+        const uint32_t vb = _indices[3 * t + ((k + 1) % 3)];
+        const uint32_t a = _pos_ids[va];
+        const uint32_t b = _pos_ids[vb];
+        const uint32_t c = edge_counts[key(a, b)];
+        auto rit = edge_counts.find(key(b, a));
+        const uint32_t rc = (rit == edge_counts.end()) ? 0 : rit->second;
+        if ((c != 1) || (rc != 1)) {
+          _locked[va] = 1;
+          _locked[vb] = 1;
+        }
+      }
+    }
+  }
+
+  {
+    std::vector<uint32_t> vertex_groups(num_vertices, kNoGroup);
+    for (size_t t = 0; t < num_tris; t++) {
+      for (size_t k = 0; k < 3; k++) {
+        const uint32_t v = _indices[3 * t + k];
+        if (vertex_groups[v] == kNoGroup) {
+          vertex_groups[v] = _tri_groups[t];
+        } else if (vertex_groups[v] != _tri_groups[t]) {
+          _locked[v] = 1;
+        }
+      }
+    }
+  }
+
+  //
+  // Area weighted plane quadrics.
+  //
+  _quadrics.assign(num_positions, Quadric());
+
+  vec3 bmin = mesh.points.empty() ? vec3{0.0f, 0.0f, 0.0f} : mesh.points[0];
+  vec3 bmax = bmin;
+  for (const auto &p : mesh.points) {
+    for (size_t k = 0; k < 3; k++) {
+      bmin[k] = (std::min)(bmin[k], p[k]);
+      bmax[k] = (std::max)(bmax[k], p[k]);
+    }
+  }
+  const double dx = double(bmax[0]) - double(bmin[0]);
+  const double dy = double(bmax[1]) - double(bmin[1]);
+  const double dz = double(bmax[2]) - double(bmin[2]);
+  _extent = std::sqrt(dx * dx + dy * dy + dz * dz);
+  if (!(_extent > 0.0)) {
+    _extent = 1.0;
+  }
+
+  for (size_t t = 0; t < num_tris; t++) {
+    const vec3 &p0 = mesh.points[_indices[3 * t + 0]];
+    const vec3 &p1 = mesh.points[_indices[3 * t + 1]];
+    const vec3 &p2 = mesh.points[_indices[3 * t + 2]];
+
+    double n[3];
+    TriangleNormal(p0, p1, p2, n);
+    const double len = std::sqrt(n[0] * n[0] + n[1] * n[1] + n[2] * n[2]);
+    if (!(len > 0.0)) {
+      continue;
+    }
+    n[0] /= len;
+    n[1] /= len;
+    n[2] /= len;
+    const double d = -(n[0] * double(p0[0]) + n[1] * double(p0[1]) +
+                       n[2] * double(p0[2]));
+    const double area = 0.5 * len;
+
+    Quadric q;
+    q.add_plane(n, d, area);
+    for (size_t k = 0; k < 3; k++) {
+      _quadrics[_pos_ids[_indices[3 * t + k]]].add(q);
+    }
+  }
+
+  _max_error_sq = 0.0;
+
+  return true;
+}
+
+// true when replacing `from` with `to` flips(or degenerates) a triangle which
+// survives the collapse.
+bool MeshSimplifier::flips(const uint32_t from, const uint32_t to) const {
+  const std::vector<vec3> &pts = *_points;
+
+  for (size_t i = _adj_offsets[from]; i < _adj_offsets[from + 1]; i++) {
+    const size_t t = _adj_tris[i];
+    const uint32_t *tri = &_indices[3 * t];
+    if ((tri[0] == to) || (tri[1] == to) || (tri[2] == to)) {
+      // Removed by the collapse.
+      continue;
+    }
+
+    uint32_t moved[3] = {tri[0], tri[1], tri[2]};
+    for (size_t k = 0; k < 3; k++) {
+      if (moved[k] == from) {
+        moved[k] = to;
+      }
+    }
+
+    double n0[3], n1[3];
+    TriangleNormal(pts[tri[0]], pts[tri[1]], pts[tri[2]], n0);
+    TriangleNormal(pts[moved[0]], pts[moved[1]], pts[moved[2]], n1);
+
+    const double d = n0[0] * n1[0] + n0[1] * n1[1] + n0[2] * n1[2];
+    const double l0 = std::sqrt(n0[0] * n0[0] + n0[1] * n0[1] + n0[2] * n0[2]);
+    const double l1 = std::sqrt(n1[0] * n1[0] + n1[1] * n1[1] + n1[2] * n1[2]);
+
+    // Reject when the normal rotates more than ~75 degrees.
+    if (d <= 0.25 * l0 * l1) {
+      return true;
+    }
+  }
+
+  return false;
+}
+
+bool MeshSimplifier::has_edge(const uint32_t a, const uint32_t b) const {
+  for (size_t i = _adj_offsets[a]; i < _adj_offsets[a + 1]; i++) {
+    const uint32_t *tri = &_indices[3 * _adj_tris[i]];
+    if ((tri[0] == b) || (tri[1] == b) || (tri[2] == b)) {
+      return true;
+    }
+  }
+  return false;
+}
+
+void MeshSimplifier::simplify(const size_t target_tris,
+                              const double max_error_sq) {
+  const std::vector<vec3> &pts = *_points;
+  const size_t num_vertices = pts.size();
+
+  std::vector<uint32_t> remap(num_vertices);
+  std::vector<uint8_t> touched(num_vertices);
+  std::vector<EdgeCollapse> collapses;
+
+  while (num_triangles() > target_tris) {
+    const size_t num_tris = num_triangles();
+
+    // Vertex -> triangles.
+    _adj_offsets.assign(num_vertices + 1, 0);
+    for (uint32_t v : _indices) {
+      _adj_offsets[v + 1]++;
+    }
+    for (size_t v = 0; v < num_vertices; v++) {
+      _adj_offsets[v + 1] += _adj_offsets[v];
+    }
+    _adj_tris.resize(_indices.size());
+    {
+      std::vector<size_t> cursor(_adj_offsets.begin(), _adj_offsets.end() - 1);
+      for (size_t i = 0; i < _indices.size(); i++) {
+        _adj_tris[cursor[_indices[i]]++] = uint32_t(i / 3);
+      }
+    }
+
+    // Collapse candidates(each half-edge).
+    collapses.clear();
+    for (size_t t = 0; t < num_tris; t++) {
+      for (size_t k = 0; k < 3; k++) {
+        const uint32_t a = _indices[3 * t + k];
+        const uint32_t b = _indices[3 * t + ((k + 1) % 3)];
+        if (a == b) {
+          continue;
+        }
+
+        for (size_t dir = 0; dir < 2; dir++) {
+          const uint32_t from = dir ? b : a;
+          const uint32_t to = dir ? a : b;
+          if (_locked[from]) {
+            continue;
+          }
+          // A seam vertex only moves along the seam.
+          if ((_seam_pairs[from] != ~0u) && (_seam_pairs[to] == ~0u)) {
+            continue;
+          }
+          Quadric q = _quadrics[_pos_ids[from]];
+          q.add(_quadrics[_pos_ids[to]]);
+
+          EdgeCollapse c;
+          c.cost = q.error(pts[to]);
+          c.from = from;
+          c.to = to;
+          collapses.push_back(c);
+        }
+      }
+    }
+
+    std::sort(collapses.begin(), collapses.end(),
+              [](const EdgeCollapse &x, const EdgeCollapse &y) {
+                if (x.cost != y.cost) {
+                  return x.cost < y.cost;
+                }
+                if (x.from != y.from) {
+                  return x.from < y.from;
+                }
+                return x.to < y.to;
+              });
+
+    for (size_t v = 0; v < num_vertices; v++) {
+      remap[v] = uint32_t(v);
+    }
+    std::fill(touched.begin(), touched.end(), 0);
+
+    size_t remaining = num_tris;
+    size_t num_collapsed = 0;
+
+    for (const auto &c : collapses) {
+      if (remaining <= target_tris) {
+        break;
+      }
+      if (c.cost > max_error_sq) {
+        break;
+      }
+      if (touched[c.from] || touched[c.to]) {
+        continue;
+      }
+
+      // The pair of a seam vertex is collapsed to the pair of `to` along the
+      // other side of the seam, so the seam does not open.
+      uint32_t pair_from = ~0u;
+      uint32_t pair_to = ~0u;
+      if (_seam_pairs[c.from] != ~0u) {
+        pair_from = _seam_pairs[c.from];
+        pair_to = _seam_pairs[c.to];
+        if ((pair_from == c.to) || (pair_to == c.from) || touched[pair_from] ||
+            touched[pair_to] || !has_edge(pair_from, pair_to)) {
+          continue;
+        }
+        if (flips(pair_from, pair_to)) {
+          continue;
+        }
+      }
+      if (flips(c.from, c.to)) {
+        continue;
+      }
+
+      remap[c.from] = c.to;
+      if (pair_from != ~0u) {
+        remap[pair_from] = pair_to;
+      }
+      _quadrics[_pos_ids[c.to]].add(_quadrics[_pos_ids[c.from]]);
+      _max_error_sq = (std::max)(_max_error_sq, c.cost);
+      num_collapsed++;
+
+      // Lock the 1-ring of `from`(and its pair) for this pass so that
+      // adjacency and flip tests of later collapses are valid.
+      for (const uint32_t v : {c.from, pair_from}) {
+        if (v == ~0u) {
+          continue;
+        }
+        const uint32_t dst = (v == c.from) ? c.to : pair_to;
+        for (size_t i = _adj_offsets[v]; i < _adj_offsets[v + 1]; i++) {
+          const uint32_t *tri = &_indices[3 * _adj_tris[i]];
+          if ((tri[0] == dst) || (tri[1] == dst) || (tri[2] == dst)) {
+            remaining--;
+          }
+          touched[tri[0]] = 1;
+          touched[tri[1]] = 1;
+          touched[tri[2]] = 1;
+        }
+      }
+    }
+
+    if (num_collapsed == 0) {
+      break;
+    }
+
+    // Apply collapses and remove degenerated triangles.
+    size_t dst = 0;
+    for (size_t t = 0; t < num_tris; t++) {
+      const uint32_t v0 = remap[_indices[3 * t + 0]];
+      const uint32_t v1 = remap[_indices[3 * t + 1]];
+      const uint32_t v2 = remap[_indices[3 * t + 2]];
+      if ((v0 == v1) || (v1 == v2) || (v2 == v0)) {
+        continue;
+      }
+      _indices[3 * dst + 0] = v0;
+      _indices[3 * dst + 1] = v1;
+      _indices[3 * dst + 2] = v2;
+      _tri_groups[dst] = _tri_groups[t];
+      dst++;
+    }
+    _indices.resize(3 * dst);
+    _tri_groups.resize(dst);
+  }
+}
+
+void MeshSimplifier::get_lod(const RenderMesh &mesh, MeshLOD *lod) const {
+  const size_t num_tris = num_triangles();
+
+  std::vector<size_t> group_offsets(size_t(_num_groups) + 1, 0);
+  for (uint32_t g : _tri_groups) {
+    group_offsets[g + 1]++;
+  }
+  for (size_t g = 0; g < _num_groups; g++) {
+    group_offsets[g + 1] += group_offsets[g];
+  }
+
+  lod->indices.resize(_indices.size());
+  {
+    std::vector<size_t> cursor(group_offsets.begin(), group_offsets.end() - 1);
+    for (size_t t = 0; t < num_tris; t++) {
+      const size_t dst = cursor[_tri_groups[t]]++;
+      lod->indices[3 * dst + 0] = _indices[3 * t + 0];
+      lod->indices[3 * dst + 1] = _indices[3 * t + 1];
+      lod->indices[3 * dst + 2] = _indices[3 * t + 2];
+    }
+  }
+
+  lod->material_subset_indices.clear();
+  uint32_t gid = 0;
+  for (const auto &it : mesh.material_subsetMap) {
+    std::vector<int> &tris = lod->material_subset_indices[it.first];
+    for (size_t t = group_offsets[gid]; t < group_offsets[gid + 1]; t++) {
+      tris.push_back(int(t));
+    }
+    gid++;
+  }
+}
+
+}  // namespace
+
+bool BuildMeshLODs(const RenderMesh &mesh, const std::vector<float> &ratios,
+                   const float max_error, const uint32_t vertex_cache_size,
+                   std::vector<MeshLOD> *lods, std::string *err) {
+  if (!lods) {
+    if (err) {
+      (*err) += "`lods` argument is nullptr.\n";
+    }
+    return false;
+  }
+
+  lods->clear();
+
+  for (float r : ratios) {
+    if (!(r > 0.0f) || (r > 1.0f)) {
+      if (err) {
+        (*err) += fmt::format("LOD ratio must be in (0.0, 1.0], but got {}.\n",
+                              r);
+      }
+      return false;
+    }
+  }
+
+  MeshSimplifier simplifier;
+  if (!simplifier.init(mesh, err)) {
+    return false;
+  }
+
+  const size_t num_tris = simplifier.num_triangles();
+  const double max_error_sq = double(max_error) * simplifier.extent() *
+                              double(max_error) * simplifier.extent();
+
+  // Simplify from finer LOD.
+  std::vector<float> sorted_ratios = ratios;
+  std::sort(sorted_ratios.begin(), sorted_ratios.end(), std::greater<float>());
+
+  for (float r : sorted_ratios) {
+    const size_t target = size_t(double(num_tris) * double(r));
+    simplifier.simplify(target, max_error_sq);
+
+    MeshLOD lod;
+    lod.ratio = r;
+    lod.error = float(std::sqrt(simplifier.max_collapse_error()) /
+                      simplifier.extent());
+    simplifier.get_lod(mesh, &lod);
+
+    if (vertex_cache_size > 0) {
+      // Optimize triangles in each MaterialSubset(and the rest) separately.
+      std::vector<size_t> ranges{0};
+      for (const auto &it : lod.material_subset_indices) {
+        ranges.push_back(ranges.back() + it.second.size());
+      }
+      ranges.push_back(lod.indices.size() / 3);
+
+      std::vector<uint32_t> group_indices;
+      std::vector<uint32_t> order;
+      for (size_t g = 0; (g + 1) < ranges.size(); g++) {
+        group_indices.assign(
+            lod.indices.begin() + std::ptrdiff_t(3 * ranges[g]),
+            lod.indices.begin() + std::ptrdiff_t(3 * ranges[g + 1]));
+        if (!OptimizeVertexCacheOrder(group_indices, mesh.points.size(),
+                                      vertex_cache_size, &order, err)) {
+          return false;
+        }
+        for (size_t t = 0; t < order.size(); t++) {
+          for (size_t k = 0; k < 3; k++) {
+            lod.indices[3 * (ranges[g] + t) + k] =
+                group_indices[3 * order[t] + k];
+          }
+        }
+      }
+    }
+
+    lods->emplace_back(std::move(lod));
+  }
+
+  return true;
+}
+
+namespace {
+
+// Approximate bounding sphere of points(Ritter's algorithm).
+void ComputeBoundingSphere(const std::vector<vec3> &points,
+                           const uint32_t *indices, const size_t n,
+                           vec3 *center, float *radius) {
+  auto dist2 = [](const vec3 &a, const vec3 &b) {
+    const double dx = double(a[0]) - double(b[0]);
+    const double dy = double(a[1]) - double(b[1]);
+    const double dz = double(a[2]) - double(b[2]);
+    return dx * dx + dy * dy + dz * dz;
+  };
+
+  // Extremal points along each axis.
+  size_t pmin[3] = {0, 0, 0};
+  size_t pmax[3] = {0, 0, 0};
+  for (size_t i = 0; i < n; i++) {
+    const vec3 &p = points[indices[i]];
+    for (size_t k = 0; k < 3; k++) {
+      if (p[k] < points[indices[pmin[k]]][k]) {
+        pmin[k] = i;
+      }
+      if (p[k] > points[indices[pmax[k]]][k]) {
+        pmax[k] = i;
+      }
+    }
+  }
+
+  // Start from the most distant pair.
+  size_t axis = 0;
+  double max_d2 = -1.0;
+  for (size_t k = 0; k < 3; k++) {
+    const double d2 =
+        dist2(points[indices[pmin[k]]], points[indices[pmax[k]]]);
+    if (d2 > max_d2) {
+      max_d2 = d2;
+      axis = k;
+    }
+  }
+
+  const vec3 &p0 = points[indices[pmin[axis]]];
+  const vec3 &p1 = points[indices[pmax[axis]]];
+  double c[3] = {(double(p0[0]) + double(p1[0])) * 0.5,
+                 (double(p0[1]) + double(p1[1])) * 0.5,
+                 (double(p0[2]) + double(p1[2])) * 0.5};
+  double r = std::sqrt(max_d2) * 0.5;
+
+  // Grow the sphere to include all points.
+  for (size_t i = 0; i < n; i++) {
+    const vec3 &p = points[indices[i]];
+    const double d[3] = {double(p[0]) - c[0], double(p[1]) - c[1],
+                         double(p[2]) - c[2]};
+    const double dl = std::sqrt(d[0] * d[0] + d[1] * d[1] + d[2] * d[2]);
+    if (dl > r) {
+      const double nr = (r + dl) * 0.5;
+      const double t = (nr - r) / dl;
+      c[0] += d[0] * t;
+      c[1] += d[1] * t;
+      c[2] += d[2] * t;
+      r = nr;
+    }
+  }
+
+  (*center) = {float(c[0]), float(c[1]), float(c[2])};
+  // Pad for the precision of float.
+  (*radius) = float(r) * (1.0f + std::numeric_limits<float>::epsilon() * 4.0f);
+}
+
+// Compute bounding sphere and normal cone of the meshlet.
+void ComputeMeshletBounds(const std::vector<vec3> &points,
+                          const uint32_t *vertices, const uint8_t *triangles,
+                          Meshlet *m) {
+  ComputeBoundingSphere(points, vertices, m->vertex_count, &m->center,
+                        &m->radius);
+
+  m->cone_apex = m->center;
+  m->cone_axis = {0.0f, 0.0f, 0.0f};
+  m->cone_cutoff = 1.0f;
+
+  struct TriNormal {
+    double n[3];
+    double c[3];  // centroid
+  };
+  std::vector<TriNormal> tris;
+  tris.reserve(m->triangle_count);
+
+  double axis[3] = {0.0, 0.0, 0.0};
+  for (size_t t = 0; t < m->triangle_count; t++) {
+    const vec3 &p0 = points[vertices[triangles[3 * t + 0]]];
+    const vec3 &p1 = points[vertices[triangles[3 * t + 1]]];
+    const vec3 &p2 = points[vertices[triangles[3 * t + 2]]];
+
+    TriNormal tn;
+    TriangleNormal(p0, p1, p2, tn.n);
+    const double len =
+        std::sqrt(tn.n[0] * tn.n[0] + tn.n[1] * tn.n[1] + tn.n[2] * tn.n[2]);
+    if (!(len > 0.0)) {
+      // Degenerated triangle does not affect culling.
+      continue;
+    }
+    for (size_t k = 0; k < 3; k++) {
+      tn.n[k] /= len;
+      tn.c[k] = (double(p0[k]) + double(p1[k]) + double(p2[k])) / 3.0;
+      axis[k] += tn.n[k];
+    }
+    tris.push_back(tn);
+  }
+
+  const double alen =
+      std::sqrt(axis[0] * axis[0] + axis[1] * axis[1] + axis[2] * axis[2]);
+  if (tris.empty() || !(alen > 0.0)) {
+    return;
+  }
+  for (size_t k = 0; k < 3; k++) {
+    axis[k] /= alen;
+  }
+
+  double mindp = 1.0;
+  for (const auto &tn : tris) {
+    const double dp =
+        tn.n[0] * axis[0] + tn.n[1] * axis[1] + tn.n[2] * axis[2];
+    mindp = (std::min)(mindp, dp);
+  }
+
+  m->cone_axis = {float(axis[0]), float(axis[1]), float(axis[2])};
+
+  if (mindp <= 0.1) {
+    // Normals spread too much(> ~85 degrees). The cone is useless for culling.
+    return;
+  }
+
+  // Move the apex back so that all triangle planes are in front of it.
+  const double center[3] = {double(m->center[0]), double(m->center[1]),
+                            double(m->center[2])};
+  double maxt = 0.0;
+  for (const auto &tn : tris) {
+    const double dc[3] = {center[0] - tn.c[0], center[1] - tn.c[1],
+                          center[2] - tn.c[2]};
+    const double dn = dc[0] * tn.n[0] + dc[1] * tn.n[1] + dc[2] * tn.n[2];
+    const double an =
+        axis[0] * tn.n[0] + axis[1] * tn.n[1] + axis[2] * tn.n[2];
+    maxt = (std::max)(maxt, dn / an);
+  }
+
+  m->cone_apex = {float(center[0] - axis[0] * maxt),
+                  float(center[1] - axis[1] * maxt),
+                  float(center[2] - axis[2] * maxt)};
+
+  // sin of the max angle between the axis and normals.
+  m->cone_cutoff = float(std::sqrt(1.0 - mindp * mindp));
+}
+
+}  // namespace
+
+bool BuildMeshlets(
+    const RenderMesh &mesh, const uint32_t max_vertices,
+    const uint32_t max_triangles, std::vector<Meshlet> *meshlets,
+    std::vector<uint32_t> *meshlet_vertices,
+    std::vector<uint8_t> *meshlet_triangles,
+    std::map<std::string, std::vector<int>> *material_subset_meshlets,
+    std::string *err) {
+  if (!meshlets || !meshlet_vertices || !meshlet_triangles ||
+      !material_subset_meshlets) {
+    if (err) {
+      (*err) += "Output argument is nullptr.\n";
+    }
+    return false;
+  }
+
+  if ((max_vertices < 3) || (max_vertices > 256)) {
+    if (err) {
+      (*err) += fmt::format("max_vertices must be in [3, 256], but got {}.\n",
+                            max_vertices);
+    }
+    return false;
+  }
+
+  if ((max_triangles < 1) || (max_triangles > 512)) {
+    if (err) {
+      (*err) += fmt::format(
+          "max_triangles must be in [1, 512], but got {}.\n", max_triangles);
+    }
+    return false;
+  }
+
+  if (!mesh.is_triangulated() || !mesh.is_single_indexable) {
+    if (err) {
+      (*err) += "Mesh must be triangulated and single-indexable.\n";
+    }
+    return false;
+  }
+
+  const std::vector<uint32_t> &indices = mesh.faceVertexIndices();
+  const std::vector<vec3> &points = mesh.points;
+  const size_t num_vertices = points.size();
+  const size_t num_tris = indices.size() / 3;
+
+  if ((indices.size() % 3) != 0) {
+    if (err) {
+      (*err) += "Invalid faceVertexIndices.\n";
+    }
+    return false;
+  }
+
+  for (uint32_t idx : indices) {
+    if (idx >= num_vertices) {
+      if (err) {
+        (*err) += fmt::format("Vertex index {} out of range.\n", idx);
+      }
+      return false;
+    }
+  }
+
+  meshlets->clear();
+  meshlet_vertices->clear();
+  meshlet_triangles->clear();
+  material_subset_meshlets->clear();
+
+  //
+  // Group of each triangle. Triangles not in any MaterialSubset form the last
+  // group.
+  //
+  const uint32_t kNoGroup = (std::numeric_limits<uint32_t>::max)();
+  const uint32_t num_groups = uint32_t(mesh.material_subsetMap.size()) + 1;
+  std::vector<uint32_t> tri_groups(num_tris, kNoGroup);
+  {
+    uint32_t gid = 0;
+    for (const auto &it : mesh.material_subsetMap) {
+      for (int t : it.second.triangulatedIndices) {
+        if ((t >= 0) && (size_t(t) < num_tris) &&
+            (tri_groups[size_t(t)] == kNoGroup)) {
+          tri_groups[size_t(t)] = gid;
+        }
+      }
+      gid++;
+    }
+  }
+  for (auto &g : tri_groups) {
+    if (g == kNoGroup) {
+      g = num_groups - 1;
+    }
+  }
+
+  // Triangles of each group(CSR) in the input order.
+  std::vector<size_t> group_offsets(size_t(num_groups) + 1, 0);
+  for (uint32_t g : tri_groups) {
+    group_offsets[g + 1]++;
+  }
+  for (size_t g = 0; g < num_groups; g++) {
+    group_offsets[g + 1] += group_offsets[g];
+  }
+  std::vector<uint32_t> group_tris(num_tris);
+  {
+    std::vector<size_t> cursor(group_offsets.begin(), group_offsets.end() - 1);
+    for (size_t t = 0; t < num_tris; t++) {
+      group_tris[cursor[tri_groups[t]]++] = uint32_t(t);
+    }
+  }
+
+  // Vertex -> triangles(CSR).
+  std::vector<size_t> adj_offsets(num_vertices + 1, 0);
+  for (uint32_t v : indices) {
+    adj_offsets[v + 1]++;
+  }
+  for (size_t v = 0; v < num_vertices; v++) {
+    adj_offsets[v + 1] += adj_offsets[v];
+  }
+  std::vector<uint32_t> adj_tris(indices.size());
+  {
+    std::vector<size_t> cursor(adj_offsets.begin(), adj_offsets.end() - 1);
+    for (size_t i = 0; i < indices.size(); i++) {
+      adj_tris[cursor[indices[i]]++] = uint32_t(i / 3);
+    }
+  }
+
+  std::vector<uint8_t> emitted(num_tris, 0);
+
+  // Local vertex index in the current meshlet. -1 = not in the meshlet.
+  std::vector<int32_t> local_ids(num_vertices, -1);
+
+  std::vector<uint32_t> candidates;
+
+  for (uint32_t g = 0; g < num_groups; g++) {
+    const size_t first_meshlet = meshlets->size();
+    const size_t group_end = group_offsets[g + 1];
+    size_t seed_cursor = group_offsets[g];
+    size_t num_remaining = group_end - group_offsets[g];
+
+    while (num_remaining > 0) {
+      Meshlet m;
+      m.vertex_offset = uint32_t(meshlet_vertices->size());
+      m.triangle_offset = uint32_t(meshlet_triangles->size() / 3);
+
+      candidates.clear();
+      double centroid[3] = {0.0, 0.0, 0.0};
+
+      auto add_triangle = [&](const uint32_t t) {
+        emitted[t] = 1;
+        num_remaining--;
+        for (size_t k = 0; k < 3; k++) {
+          const uint32_t v = indices[3 * t + k];
+          if (local_ids[v] < 0) {
+            local_ids[v] = int32_t(m.vertex_count++);
+            meshlet_vertices->push_back(v);
+            for (size_t j = 0; j < 3; j++) {
+              centroid[j] += double(points[v][j]);
+            }
+            // Triangles sharing the new vertex become candidates.
+            for (size_t i = adj_offsets[v]; i < adj_offsets[v + 1]; i++) {
+              const uint32_t u = adj_tris[i];
+              if (!emitted[u] && (tri_groups[u] == g)) {
+                candidates.push_back(u);
+              }
+            }
+          }
+          meshlet_triangles->push_back(uint8_t(local_ids[v]));
+        }
+        m.triangle_count++;
+      };
+
+      while (m.triangle_count < max_triangles) {
+        // Pick the candidate which adds the fewest vertices, then the closest
+        // one to the centroid of the meshlet.
+        int64_t best = -1;
+        uint32_t best_new = 4;
+        double best_dist = 0.0;
+
+        size_t n = 0;
+        for (size_t i = 0; i < candidates.size(); i++) {
+          const uint32_t t = candidates[i];
+          if (emitted[t]) {
+            continue;
+          }
+          candidates[n++] = t;
+
+          uint32_t new_verts = 0;
+          double d2 = 0.0;
+          for (size_t k = 0; k < 3; k++) {
+            const uint32_t v = indices[3 * t + k];
+            if (local_ids[v] < 0) {
+              new_verts++;
+            }
+            if (m.vertex_count > 0) {
+              for (size_t j = 0; j < 3; j++) {
+                const double d = double(points[v][j]) -
+                                 centroid[j] / double(m.vertex_count);
+                d2 += d * d;
+              }
+            }
+          }
+
+          if ((m.vertex_count + new_verts) > max_vertices) {
+            continue;
+          }
+
+          if ((new_verts < best_new) ||
+              ((new_verts == best_new) && (d2 < best_dist))) {
+            best = int64_t(t);
+            best_new = new_verts;
+            best_dist = d2;
+          }
+        }
+        candidates.resize(n);
+
+        if (best < 0) {
+          if (!candidates.empty()) {
+            // Meshlet is full(vertices).
+            break;
+          }
+
+          // No connected triangles. Continue with the next triangle in the
+          // input order when the meshlet has enough room.
+          if ((m.vertex_count + 3) > max_vertices ||
+              (m.triangle_count * 2 > max_triangles)) {
+            break;
+          }
+
+          while ((seed_cursor < group_end) &&
+                 emitted[group_tris[seed_cursor]]) {
+            seed_cursor++;
+          }
+          if (seed_cursor >= group_end) {
+            break;
+          }
+          best = int64_t(group_tris[seed_cursor]);
+        }
+
+        add_triangle(uint32_t(best));
+      }
+
+      for (size_t i = m.vertex_offset; i < meshlet_vertices->size(); i++) {
+        local_ids[(*meshlet_vertices)[i]] = -1;
+      }
+
+      ComputeMeshletBounds(points, meshlet_vertices->data() + m.vertex_offset,
+                           meshlet_triangles->data() + 3 * m.triangle_offset,
+                           &m);
+
+      meshlets->push_back(m);
+    }
+
+    if (g < mesh.material_subsetMap.size()) {
+      auto it = mesh.material_subsetMap.begin();
+      std::advance(it, g);
+      std::vector<int> &ids = (*material_subset_meshlets)[it->first];
+      for (size_t i = first_meshlet; i < meshlets->size(); i++) {
+        ids.push_back(int(i));
+      }
+    }
+  }
+
+  return true;
+}
+
 bool DefaultTextureImageLoaderFunction(
     const value::AssetPath &assetPath, const AssetInfo &assetInfo,
     const AssetResolutionResolver &assetResolver, TextureImage *texImageOut,
@@ -8,6 +8,7 @@
 
 #include <algorithm>
 #include <cmath>
+#include <memory>
 #include <unordered_map>
 
 #include "asset-resolution.hh"
@@ -19,6 +20,7 @@
 
 // tydra
 #include "scene-access.hh"
+#include "xform-cache.hh"
 
 namespace tinyusdz {
 
@@ -505,6 +507,68 @@ struct VertexAttribute {
   bool is_indexed() const { return variability == VertexVariability::Indexed; }
 };
 
+///
+/// Vertex attribute stored in the interleaved vertex buffer.
+///
+enum class VertexAttributeSemantic {
+  Position,   // RenderMesh::points. 3 components.
+  Normal,     // RenderMesh::normals. 3 components.
+  Tangent,    // RenderMesh::tangents. 3 components.
+  Binormal,   // RenderMesh::binormals. 3 components.
+  Texcoord0,  // RenderMesh::texcoords[0]. 2 components.
+  Texcoord1,  // RenderMesh::texcoords[1]. 2 components.
+  Color,      // RenderMesh::vertex_colors. 3 components.
+  Opacity,    // RenderMesh::vertex_opacities. 1 component.
+};
+
+///
+/// Encoding of the vertex attribute in the interleaved vertex buffer.
+/// Values are clamped to [-1, 1](snorm) or [0, 1](unorm) for normalized
+/// integer encodings.
+///
+enum class VertexAttributeEncoding {
+  Float,    // float x N
+  Half,     // half x N
+  Snorm8,   // int8 x N. [-1, 1] => [-127, 127]
+  Snorm16,  // int16 x N. [-1, 1] => [-32767, 32767]
+  Unorm8,   // uint8 x N. [0, 1] => [0, 255]
+  Unorm16,  // uint16 x N. [0, 1] => [0, 65535]
+  Oct8,     // Octahedral encoded unit vector(3 components only). snorm8 x 2
+  Oct16,    // Octahedral encoded unit vector(3 components only). snorm16 x 2
+};
+
+struct VertexLayoutElement {
+  VertexAttributeSemantic semantic{VertexAttributeSemantic::Position};
+  VertexAttributeEncoding encoding{VertexAttributeEncoding::Float};
+
+  // Assigned in ResolveVertexLayout.
+  uint32_t offset{0};  // Byte offset in a vertex.
+  VertexAttributeFormat format{
+      VertexAttributeFormat::Vec3};  // Format of the encoded attribute.
+};
+
+///
+/// Layout of the interleaved vertex buffer.
+///
+struct VertexLayout {
+  // Vertex attributes in the order of the memory layout.
+  std::vector<VertexLayoutElement> elements;
+
+  // Alignment(in bytes) of each element and the stride.
+  uint32_t alignment{4};
+
+  // Bytes per vertex. 0 = computed from elements in ResolveVertexLayout.
+  uint32_t stride{0};
+};
+
+///
+/// Assign `offset` and `format` of each element and `stride`.
+///
+/// @return false when the layout is invalid(e.g. `stride` is smaller than the
+/// size of elements, Oct encoding for non-3 component attribute).
+///
+bool ResolveVertexLayout(VertexLayout *layout, std::string *err = nullptr);
+
 #if 0  // TODO: Implement
 ///
 /// Flatten(expand by vertexCounts and vertexIndices) VertexAttribute.
@@ -810,6 +874,54 @@ struct MaterialSubset {
 
 };
 
+///
+/// Simplified level of detail of RenderMesh.
+/// LOD shares vertices(`points` and 'vertex' varying attributes) with the
+/// RenderMesh, and only has its own triangle list.
+///
+struct MeshLOD {
+  float ratio{1.0f};  // Requested ratio of the number of triangles.
+  float error{0.0f};  // Geometric error(distance) relative to the mesh extent.
+
+  // Triangle list. Index to RenderMesh::points. Triangles are sorted by
+  // MaterialSubset.
+  std::vector<uint32_t> indices;
+
+  // Key = GeomSubset name. Triangle indices(index to `indices` / 3) of each
+  // MaterialSubset in RenderMesh::material_subsetMap.
+  std::map<std::string, std::vector<int>> material_subset_indices;
+
+  // Index to RenderScene::buffers(UInt16 or UInt32). Filled when
+  // `MeshConverterConfig::build_interleaved_vertex_buffer` is true.
+  int64_t index_buffer_id{-1};
+};
+
+///
+/// Meshlet(cluster of triangles) for GPU-driven rendering.
+///
+struct Meshlet {
+  // Offset and the number of items in the meshlet vertices buffer(uint32 index
+  // to RenderMesh::points).
+  uint32_t vertex_offset{0};
+  uint32_t vertex_count{0};
+
+  // Offset and the number of triangles(not bytes) in the meshlet triangles
+  // buffer(uint8 x 3 local vertex indices per triangle).
+  uint32_t triangle_offset{0};
+  uint32_t triangle_count{0};
+
+  // Bounding sphere.
+  vec3 center{0.0f, 0.0f, 0.0f};
+  float radius{0.0f};
+
+  // Normal cone for backface culling. The meshlet can be culled when
+  // `dot(normalize(cone_apex - camera_position), cone_axis) >= cone_cutoff`.
+  // cone_cutoff = 1 when the meshlet cannot be culled by the cone.
+  vec3 cone_apex{0.0f, 0.0f, 0.0f};
+  vec3 cone_axis{0.0f, 0.0f, 0.0f};
+  float cone_cutoff{1.0f};
+};
+
 // Currently normals and texcoords are converted as facevarying attribute.
 struct RenderMesh {
 #if 0 // deprecated.
@@ -872,6 +984,14 @@ struct RenderMesh {
       triangulatedFaceCounts;  // used for rearrange face indices(e.g GeomSubset
                                // indices)
 
+  ///
+  /// USD face index of each triangle. Filled only when triangles are reordered
+  /// by `MeshConverterConfig::optimize_vertex_cache`(triangles of a USD face
+  /// are no longer contiguous, so `triangulatedFaceCounts` cannot be used to
+  /// find the USD face of a triangle).
+  ///
+  std::vector<uint32_t> triangulatedToOrigFaceIndexMap;
+
   const std::vector<uint32_t> &faceVertexIndices() const {
     return is_triangulated() ? triangulatedFaceVertexIndices : usdFaceVertexIndices;
   }
@@ -950,9 +1070,137 @@ struct RenderMesh {
   // If you want to access user-defined primvars or custom property,
   // Plese look into corresponding Prim( stage::find_prim_at_path(abs_path) )
 
+  // Simplified LODs(coarser LOD comes later). Filled when
+  // `MeshConverterConfig::build_lods` is true.
+  std::vector<MeshLOD> lods;
+
+  //
+  // Meshlets. Filled when `MeshConverterConfig::build_meshlets` is true.
+  //
+  std::vector<Meshlet> meshlets;
+  int64_t meshlet_vertices_buffer_id{-1};  // index to RenderScene::buffers(UInt32)
+  int64_t meshlet_triangles_buffer_id{-1};  // index to RenderScene::buffers(UInt8)
+
+  // Key = GeomSubset name. Meshlet indices of each MaterialSubset(Meshlets do
+  // not cross MaterialSubsets).
+  std::map<std::string, std::vector<int>> material_subset_meshlets;
+
+  //
+  // Interleaved vertex buffer and index buffer(triangle list).
+  // Filled when `MeshConverterConfig::build_interleaved_vertex_buffer` is true.
+  //
+  // When the mesh is not single-indexable, vertices are expanded per face
+  // vertex.
+  //
+  VertexLayout vertex_layout;  // Resolved layout of the vertex buffer.
+  int64_t vertex_buffer_id{-1};  // index to RenderScene::buffers.
+  int64_t index_buffer_id{-1};  // index to RenderScene::buffers(UInt16 or UInt32).
+  uint32_t num_buffer_vertices{0};  // # of vertices in the vertex buffer.
+
   uint64_t handle{0};  // Handle ID for Graphics API. 0 = invalid
 };
 
+///
+/// Build an interleaved vertex buffer and an index buffer of the mesh in a
+/// single pass.
+/// The mesh must be triangulated. Attributes in `layout` which are not present
+/// in the mesh are filled with zeros(`displayColor`/`displayOpacity` for
+/// Color/Opacity).
+///
+/// @param[in] mesh RenderMesh.
+/// @param[in] layout Resolved vertex layout(see ResolveVertexLayout).
+/// @param[in] use_16bit_indices Use uint16 indices when the number of vertices
+/// is less than or equal to 65536.
+/// @param[out] vertex_buffer Vertex buffer(UInt8).
+/// @param[out] index_buffer Index buffer(UInt16 or UInt32).
+/// @param[out] num_vertices # of vertices in `vertex_buffer`.
+///
+bool BuildInterleavedVertexBuffer(const RenderMesh &mesh,
+                                  const VertexLayout &layout,
+                                  const bool use_16bit_indices,
+                                  BufferData *vertex_buffer,
+                                  BufferData *index_buffer,
+                                  uint32_t *num_vertices,
+                                  std::string *err = nullptr);
+
+///
+/// Compute the triangle order which improves the post-transform vertex cache
+/// hit rate(Tom Forsyth, "Linear-Speed Vertex Cache Optimisation").
+///
+/// @param[in] indices Triangle list.
+/// @param[in] num_vertices # of vertices referenced by `indices`.
+/// @param[in] cache_size # of entries of the simulated LRU cache(4 ~ 64).
+/// @param[out] triangle_order Old triangle index of each new triangle.
+///
+bool OptimizeVertexCacheOrder(const std::vector<uint32_t> &indices,
+                              const size_t num_vertices,
+                              const uint32_t cache_size,
+                              std::vector<uint32_t> *triangle_order,
+                              std::string *err = nullptr);
+
+///
+/// Average cache miss ratio(# of vertex transforms / # of triangles) of the
+/// triangle list with a FIFO vertex cache of `cache_size` entries.
+/// 0.5 ~ 0.7 is close to optimal for regular meshes, 3.0 is the worst.
+///
+float ComputeACMR(const std::vector<uint32_t> &indices,
+                  const uint32_t cache_size = 16);
+
+///
+/// Reorder triangles and vertices of the triangulated mesh for the vertex
+/// cache and vertex fetch locality(See
+/// `MeshConverterConfig::optimize_vertex_cache`). Vertex attributes, skin
+/// weights, BlendShape targets and MaterialSubset indices are remapped.
+///
+bool OptimizeRenderMeshVertexCache(RenderMesh *mesh, const uint32_t cache_size,
+                                   std::string *err = nullptr);
+
+///
+/// Build simplified LODs of the triangulated and single-indexable mesh using
+/// quadric error metrics(Garland and Heckbert 1997) with half-edge collapses.
+/// Each LOD is simplified from the previous one.
+///
+/// @param[in] mesh RenderMesh.
+/// @param[in] ratios Target ratio of the number of triangles of each LOD.
+/// @param[in] max_error Max error relative to the mesh extent.
+/// @param[in] vertex_cache_size Optimize triangle order of LODs for vertex
+/// cache(See OptimizeVertexCacheOrder). 0 = no optimization.
+/// @param[out] lods LODs.
+///
+bool BuildMeshLODs(const RenderMesh &mesh, const std::vector<float> &ratios,
+                   const float max_error, const uint32_t vertex_cache_size,
+                   std::vector<MeshLOD> *lods, std::string *err = nullptr);
+
+///
+/// Partition the triangulated and single-indexable mesh into meshlets.
+/// Triangles are greedily added to a meshlet preferring ones sharing more
+/// vertices with the meshlet, and closer to the meshlet.
+///
+/// @param[in] mesh RenderMesh.
+/// @param[in] max_vertices Max # of vertices in a meshlet(3 ~ 256).
+/// @param[in] max_triangles Max # of triangles in a meshlet(1 ~ 512).
+/// @param[out] meshlets Meshlets.
+/// @param[out] meshlet_vertices Index to RenderMesh::points of meshlet vertices.
+/// @param[out] meshlet_triangles Local vertex indices of meshlet triangles.
+/// @param[out] material_subset_meshlets Meshlet indices of each MaterialSubset.
+///
+bool BuildMeshlets(
+    const RenderMesh &mesh, const uint32_t max_vertices,
+    const uint32_t max_triangles, std::vector<Meshlet> *meshlets,
+    std::vector<uint32_t> *meshlet_vertices,
+    std::vector<uint8_t> *meshlet_triangles,
+    std::map<std::string, std::vector<int>> *material_subset_meshlets,
+    std::string *err = nullptr);
+
+///
+/// Re-encode vertices [begin, end) of the interleaved vertex buffer from the
+/// vertex attributes of the mesh(e.g. after updating `points`).
+/// Uses `mesh.vertex_layout`.
+///
+bool UpdateInterleavedVertexBuffer(const RenderMesh &mesh, const size_t begin,
+                                   const size_t end, BufferData *vertex_buffer,
+                                   std::string *err = nullptr);
+
 enum class UVReaderFloatComponentType {
   COMPONENT_FLOAT,
   COMPONENT_FLOAT2,
@@ -1249,6 +1497,11 @@ class RenderScene {
 /// @return true upon success.
 /// termination of visiting Prims.
 ///
+/// NOTE: When `MaterialConverterConfig::texture_load_num_threads` is not 1,
+/// the callback is called concurrently from multiple threads(with the same
+/// `userdata`), so the callback must be thread-safe. Each texture asset is
+/// loaded only once.
+///
 typedef bool (*TextureImageLoaderFunction)(
     const value::AssetPath &assetPath, const AssetInfo &assetInfo,
     const AssetResolutionResolver &assetResolver, TextureImage *imageOut,
@@ -1267,6 +1520,77 @@ bool DefaultTextureImageLoaderFunction(const value::AssetPath &assetPath,
 /// TODO: UDIM loder
 ///
 
+enum class NormalWeighting {
+  Area,   // Weighted by the area of the face.
+  Angle,  // Weighted by the angle of the face corner at the vertex.
+};
+
+///
+/// Build vertex -> face vertices adjacency in CSR form.
+/// Face vertices of vertex `v` are `corners[offsets[v]:offsets[v+1]]`, in
+/// ascending order.
+///
+/// @param[in] vertex_indices Vertex index of each face vertex(corner).
+/// @param[in] num_corners The number of face vertices.
+/// @param[in] num_vertices The number of vertices. All of `vertex_indices`
+/// must be less than this value.
+/// @param[out] offsets `num_vertices + 1` offsets into `corners`.
+/// @param[out] corners Face vertex indices grouped by vertex.
+///
+void BuildVertexToCorners(const uint32_t *vertex_indices,
+                          const size_t num_corners, const size_t num_vertices,
+                          std::vector<size_t> *offsets,
+                          std::vector<uint32_t> *corners);
+
+///
+/// Compute smoothed vertex normals. Face normals are computed from the first
+/// three vertices of each face and accumulated to its vertices, weighted by
+/// the area of the face or the angle of the face corner at the vertex.
+/// The result does not depend on `num_threads`.
+///
+/// @param[in] vertices Vertex points.
+/// @param[in] faceVertexCounts faceVertexCounts of the mesh.
+/// @param[in] faceVertexIndices faceVertexIndices of the mesh.
+/// @param[in] weighting Weighting of face normals.
+/// @param[in] num_threads # of threads. -1 = use system's # of threads.
+/// @param[out] normals Normals(`vertex` variability).
+/// @param[out] err Error message.
+///
+bool ComputeNormals(const std::vector<vec3> &vertices,
+                    const std::vector<uint32_t> &faceVertexCounts,
+                    const std::vector<uint32_t> &faceVertexIndices,
+                    const NormalWeighting weighting, const int num_threads,
+                    std::vector<vec3> &normals, std::string *err);
+
+///
+/// Compute tangents and binormals from per-face UV derivatives. Face
+/// vertices which have the same point index, normal and texcoord are merged
+/// into a vertex, and its tangent frame is orthogonalized with the normal.
+/// The result does not depend on `num_threads`.
+///
+/// @param[in] vertices Vertex points.
+/// @param[in] faceVertexCounts faceVertexCounts of the mesh. Can be empty for
+/// a triangle mesh.
+/// @param[in] faceVertexIndices faceVertexIndices of the mesh.
+/// @param[in] texcoords Primary texcoords.
+/// @param[in] normals Normals.
+/// @param[in] is_facevarying_input false = texcoords and normals are 'vertex'
+/// variability. true = 'facevarying' variability.
+/// @param[in] num_threads # of threads. -1 = use system's # of threads.
+/// @param[out] tangents Tangents of merged vertices.
+/// @param[out] binormals Binormals of merged vertices.
+/// @param[out] out_vertex_indices Merged vertex index of each face vertex.
+/// @param[out] err Error message.
+///
+bool ComputeTangentsAndBinormals(
+    const std::vector<vec3> &vertices,
+    const std::vector<uint32_t> &faceVertexCounts,
+    const std::vector<uint32_t> &faceVertexIndices,
+    const std::vector<vec2> &texcoords, const std::vector<vec3> &normals,
+    bool is_facevarying_input, const int num_threads,
+    std::vector<vec3> *tangents, std::vector<vec3> *binormals,
+    std::vector<uint32_t> *out_vertex_indices, std::string *err);
+
 struct MeshConverterConfig {
   bool triangulate{true};
 
@@ -1324,6 +1648,75 @@ struct MeshConverterConfig {
   //
   bool compute_tangents_and_binormals{true};
 
+  //
+  // Weighting of face normals when computing(smoothed) vertex normals.
+  //
+  NormalWeighting normal_weighting{NormalWeighting::Area};
+
+  //
+  // # of threads used in the conversion of a single large mesh(building
+  // vertex indices, computing normals and tangents/binormals).
+  // 1 = serial. -1 = use system's # of threads.
+  // Ignored(1 is used) for meshes converted concurrently when
+  // `RenderSceneConverterConfig::num_threads` is not 1, so this is useful when
+  // converting a few meshes with a large number of faces.
+  //
+  int num_threads{1};
+
+  //
+  // Reorder triangles for the locality of the post-transform vertex cache
+  // (Forsyth's linear-speed vertex cache optimization), then reorder vertices
+  // in the order of the first use for the locality of vertex fetch.
+  // Triangles in each GeomSubset(MaterialSubset) are kept contiguous.
+  // Applied to triangulated meshes only.
+  //
+  bool optimize_vertex_cache{false};
+
+  // # of entries of the simulated(LRU) vertex cache.
+  uint32_t vertex_cache_size{32};
+
+  //
+  // Build simplified LODs(RenderMesh::lods) of triangulated and
+  // single-indexable meshes using quadric error metrics. Vertices on open
+  // borders and MaterialSubset boundaries are preserved. Vertices on UV/normal
+  // seams are only collapsed along the seam(both sides together).
+  //
+  bool build_lods{false};
+
+  // Target ratio of the number of triangles of each LOD(0.0 ~ 1.0].
+  std::vector<float> lod_ratios{0.5f, 0.25f, 0.125f};
+
+  // Max geometric error relative to the mesh extent(diagonal of the bounding
+  // box). Simplification stops when the error exceeds this value, so the
+  // number of triangles of LOD could be larger than the target.
+  float lod_max_error{0.01f};
+
+  //
+  // Partition triangulated and single-indexable meshes into meshlets
+  // (RenderMesh::meshlets) with bounding spheres and normal cones.
+  //
+  bool build_meshlets{false};
+
+  uint32_t meshlet_max_vertices{64};    // up to 256
+  uint32_t meshlet_max_triangles{124};  // up to 512
+
+  //
+  // Build an interleaved vertex buffer and an index buffer of each RenderMesh
+  // in `interleaved_vertex_layout`, and store them to RenderScene::buffers.
+  // (See RenderMesh::vertex_buffer_id). `triangulate` must be true.
+  //
+  bool build_interleaved_vertex_buffer{false};
+
+  // Default: position(float3), normal(float3), texcoord0(float2)
+  VertexLayout interleaved_vertex_layout{
+      {{VertexAttributeSemantic::Position, VertexAttributeEncoding::Float},
+       {VertexAttributeSemantic::Normal, VertexAttributeEncoding::Float},
+       {VertexAttributeSemantic::Texcoord0, VertexAttributeEncoding::Float}}};
+
+  // Use uint16 indices when the number of vertices is less than or equal to
+  // 65536.
+  bool use_16bit_indices{true};
+
   //
   // Allowed relative error to check if vertex data is the same.
   // Used for 'facevarying' variability to `vertex` variability conversion in
@@ -1341,6 +1734,12 @@ struct MaterialConverterConfig {
   TextureImageLoaderFunction texture_image_loader_function{nullptr};
   void *texture_image_loader_function_userdata{nullptr};
 
+  // # of threads for loading(decoding) texture images concurrently.
+  // 1 = load serially. -1 = use system's # of threads.
+  // `texture_image_loader_function` must be thread-safe when this is not 1.
+  // Image ids are assigned in the same order regardless of the # of threads.
+  int texture_load_num_threads{1};
+
   // For UsdUVTexture.
   //
   // Default configuration:
@@ -1395,6 +1794,14 @@ struct RenderSceneConverterConfig {
   // false: no actual texture file/asset access.
   // App/User must setup TextureImage manually after the conversion.
   bool load_texture_assets{true};
+
+  // # of threads for converting meshes concurrently.
+  // 1 = convert meshes serially. -1 = use system's # of threads.
+  // Material ids and mesh ids are assigned in the Prim traversal order
+  // regardless of the # of threads. Meshes referring to Prims outside of
+  // their subtree(Skeleton, BlendShape targets, connections) are always
+  // converted serially.
+  int num_threads{1};
 };
 
 //
@@ -1604,6 +2011,9 @@ class RenderSceneConverterEnv {
 
 };
 
+// Work item of GeomMesh conversion(internal use).
+struct MeshConvertItem;
+
 //
 // Convert USD scenegraph at specified time
 // TODO: Use RenderSceneConverterEnv(RenderSceneConverterEnv::timecode)
@@ -1810,8 +2220,9 @@ class RenderSceneConverter {
   /// Limitation: Currently we only supports texcoords up to two(primary(0) and secondary(1)).
   ///
   /// @param[inout] mesh
+  /// @param[in] num_threads # of threads. 1 = serial.
   ///
-  bool BuildVertexIndicesImpl(RenderMesh &mesh);
+  bool BuildVertexIndicesImpl(RenderMesh &mesh, const int num_threads);
 
   //
   // Get Skeleton assigned to the GeomMesh Prim and convert it to SkelHierarchy.
@@ -1826,6 +2237,68 @@ class RenderSceneConverter {
     const XformNode &node,
     Node &out_rnode);
 
+  ///
+  /// Convert GeomMeshes collected in the Prim traversal, and append them to
+  /// `meshes` in the order of `items`.
+  /// Meshes are converted concurrently when
+  /// `RenderSceneConverterConfig::num_threads` is not 1.
+  ///
+  bool ConvertMeshesImpl(const RenderSceneConverterEnv &env,
+                         const std::vector<MeshConvertItem> &items,
+                         std::string *err);
+
+  ///
+  /// Build interleaved vertex buffer and index buffer of converted meshes
+  /// (`MeshConverterConfig::build_interleaved_vertex_buffer`).
+  ///
+  ///
+  /// Build LODs of converted meshes concurrently
+  /// (`MeshConverterConfig::build_lods`).
+  ///
+  bool BuildLODsImpl(const RenderSceneConverterEnv &env);
+
+  ///
+  /// Build meshlets of converted meshes concurrently
+  /// (`MeshConverterConfig::build_meshlets`).
+  ///
+  bool BuildMeshletsImpl(const RenderSceneConverterEnv &env);
+
+  bool BuildInterleavedVertexBuffersImpl(const RenderSceneConverterEnv &env);
+
+  ///
+  /// Load texture image of UsdUVTexture and convert its texel format and
+  /// color space according to MaterialConverterConfig.
+  ///
+  /// @param[out] texImage TextureImage(`buffer_id` is not assigned)
+  /// @param[out] imageBuffer Texel data
+  /// @param[out] tex_loaded true when the texture image is loaded. false when
+  /// loading failed but `allow_texture_load_failure` is true.
+  ///
+  bool LoadTextureImageImpl(const RenderSceneConverterEnv &env,
+                            const Path &tex_abs_path,
+                            const value::AssetPath &assetPath,
+                            const AssetInfo &assetInfo,
+                            const UsdUVTexture &texture,
+                            TextureImage *texImage, BufferData *imageBuffer,
+                            bool *tex_loaded);
+
+  ///
+  /// Append TextureImage and its BufferData to `images` and `buffers`.
+  ///
+  /// @return id of TextureImage.
+  ///
+  int64_t AddTextureImage(const std::string &asset_path,
+                          TextureImage &&texImage, BufferData &&imageBuffer);
+
+  ///
+  /// Load texture images requested in ConvertUVTexture(concurrently when
+  /// `RenderSceneConverterConfig::num_threads` is not 1), and replace
+  /// `UVTexture::texture_image_id` of `textures[first_texture_id:]` with the
+  /// id of loaded TextureImage.
+  ///
+  bool LoadTexturesImpl(const RenderSceneConverterEnv &env,
+                        const size_t first_texture_id, std::string *err);
+
   void PushInfo(const std::string &msg) { _info += msg; }
   void PushWarn(const std::string &msg) { _warn += msg; }
   void PushError(const std::string &msg) { _err += msg; }
@@ -1833,6 +2306,230 @@ class RenderSceneConverter {
   std::string _info;
   std::string _err;
   std::string _warn;
+
+  // Texture image load request.
+  struct TextureImageRequest {
+    Path tex_abs_path;
+    value::AssetPath asset_path;
+    AssetInfo asset_info;
+    const UsdUVTexture *texture{nullptr};
+  };
+
+  // When true, ConvertUVTexture does not load the texture image but adds it
+  // to `_texture_requests`(used in ConvertToRenderScene).
+  bool _defer_texture_loading{false};
+  std::vector<TextureImageRequest> _texture_requests;
+
+  // key: resolved asset path + colorSpace settings, value: index to
+  // `_texture_requests`
+  std::map<std::string, size_t> _texture_request_map;
+
+  // Converter which owns `materials` and `textures` read in ConvertMesh.
+  // Set for the converter of a worker thread in ConvertMeshesImpl.
+  const RenderSceneConverter *_parent{nullptr};
+};
+
+///
+/// Buffers of RenderScene modified by RenderSceneUpdater::Update.
+///
+struct RenderSceneUpdateResult {
+  // Modified element range [begin, end) of an array.
+  struct Range {
+    size_t begin{0};
+    size_t end{0};
+
+    bool empty() const { return begin >= end; }
+
+    void extend(const size_t i) {
+      if (empty()) {
+        begin = i;
+        end = i + 1;
+      } else {
+        begin = (std::min)(begin, i);
+        end = (std::max)(end, i + 1);
+      }
+    }
+  };
+
+  struct MeshUpdate {
+    uint32_t mesh_id{0};  // index to RenderScene::meshes
+    Range points;         // element range of RenderMesh::points
+    Range normals;        // element range of RenderMesh::normals
+    Range tangents;       // element range of RenderMesh::tangents and
+                          // RenderMesh::binormals
+    Range vertex_buffer;  // vertex range of the interleaved vertex buffer
+                          // (RenderMesh::vertex_buffer_id)
+    Range meshlets;       // element range of RenderMesh::meshlets whose
+                          // bounds are re-computed
+  };
+
+  // Nodes whose `local_matrix` and/or `global_matrix` are modified.
+  std::vector<Node *> nodes;
+
+  std::vector<MeshUpdate> meshes;
+
+  // index to RenderScene::materials whose shader parameters are modified.
+  std::vector<uint32_t> materials;
+
+  bool empty() const {
+    return nodes.empty() && meshes.empty() && materials.empty();
+  }
+
+  void clear() {
+    nodes.clear();
+    meshes.clear();
+    materials.clear();
+  }
+};
+
+///
+/// Update time-varying data of a RenderScene converted by RenderSceneConverter
+/// without re-running the whole conversion.
+///
+/// Following data are re-evaluated at the new time:
+///
+/// - `local_matrix` and `global_matrix` of Nodes whose xformOps(or xformOps
+///   of its ancestor) are timeSampled.
+/// - `points` of RenderMesh whose `points` attribute is timeSampled.
+/// - `normals` of RenderMesh whose `normals`(or `primvars:normals`) is
+///   timeSampled. Normals computed by Tydra are re-computed when `points` are
+///   updated.
+/// - `tangents` and `binormals` computed by Tydra
+///   (`MeshConverterConfig::compute_tangents_and_binormals`) are re-computed
+///   when `points` or `normals` are updated.
+/// - Bounding spheres and normal cones of `meshlets` are re-computed when
+///   `points` are updated. Meshlet partitioning and LODs are not changed.
+/// - Non-texture parameters of UsdPreviewSurface(e.g. `diffuseColor`) which
+///   are timeSampled.
+///
+/// Vertices reordered/duplicated by `MeshConverterConfig::build_vertex_indices`
+/// and triangulation are handled, but topology(faceVertexCounts,
+/// faceVertexIndices) must not be time-varying. Please re-run
+/// RenderSceneConverter for such a Stage.
+///
+/// SkelAnimation and BlendShape weights are not handled here since they are
+/// stored as timeSamples in RenderScene::animations.
+///
+/// Node and RenderScene pointers are held, so the structure of RenderScene
+/// (e.g. `nodes`, `meshes`) must not be changed after Build.
+///
+/// Meshes are updated concurrently only when
+/// `RenderSceneConverterConfig::num_threads` of the Env is not 1.
+///
+class RenderSceneUpdater {
+ public:
+  RenderSceneUpdater();
+  ~RenderSceneUpdater();
+
+  RenderSceneUpdater(const RenderSceneUpdater &) = delete;
+  RenderSceneUpdater &operator=(const RenderSceneUpdater &) = delete;
+
+  ///
+  /// Collect time-varying data of `scene`.
+  ///
+  /// @param[in] env Env used to convert `scene`. `env.stage` must be alive
+  /// while using RenderSceneUpdater.
+  /// @param[inout] scene RenderScene converted from `env.stage`.
+  ///
+  bool Build(const RenderSceneConverterEnv &env, RenderScene *scene);
+
+  ///
+  /// Re-evaluate time-varying data at time `t` and update RenderScene.
+  ///
+  /// @param[in] t timecode
+  /// @param[out] result Modified buffers(optional).
+  ///
+  bool Update(const double t, RenderSceneUpdateResult *result);
+
+  // true when the scene has no time-varying data handled by the updater.
+  bool is_static() const {
+    return _nodes.empty() && _meshes.empty() && _materials.empty();
+  }
+
+  const std::string &GetWarning() const { return _warn; }
+  const std::string &GetError() const { return _err; }
+
+ private:
+  // Vertex map and attribute sources of the interleaved vertex buffer of a
+  // mesh(defined in render-data.cc).
+  struct VertexBufferSource;
+
+  // Time-varying mesh.
+  struct AnimatedMesh {
+    uint32_t mesh_id{0};
+    const GeomMesh *mesh{nullptr};
+
+    bool animated_points{false};
+    bool animated_normals{false};  // authored normals are timeSampled.
+    bool compute_normals{false};   // normals are computed by Tydra.
+    bool compute_tangents{false};  // tangents/binormals are computed by Tydra.
+
+    Interpolation normals_interpolation{Interpolation::Vertex};
+
+    size_t num_usd_points{0};
+
+    // USD faceVertexIndices and face id of each USD face vertex.
+    std::vector<uint32_t> usd_face_vertex_indices;
+    std::vector<uint32_t> usd_face_ids;
+
+    // USD face vertex index of each RenderMesh face vertex.
+    std::vector<uint32_t> face_vertex_sources;
+
+    // USD point index of each RenderMesh point.
+    std::vector<uint32_t> point_sources;
+
+    // USD face vertex index of each RenderMesh point(~0u = not referenced).
+    std::vector<uint32_t> point_face_vertex_sources;
+
+    // nullptr when the mesh has no interleaved vertex buffer.
+    std::unique_ptr<VertexBufferSource> vertex_buffer_source;
+  };
+
+  bool BuildAnimatedMesh(const uint32_t mesh_id, const GeomMesh &mesh,
+                         AnimatedMesh *dst);
+
+  bool UpdateMesh(const AnimatedMesh &amesh, const double t,
+                  RenderSceneUpdateResult::MeshUpdate *update,
+                  std::string *err);
+
+  // Re-encode updated vertices of the interleaved vertex buffer.
+  bool UpdateVertexBuffer(const AnimatedMesh &amesh,
+                          RenderSceneUpdateResult::MeshUpdate *update,
+                          std::string *err);
+
+  // Re-compute bounds of meshlets after `points` are updated.
+  bool UpdateMeshletBounds(const AnimatedMesh &amesh,
+                           RenderSceneUpdateResult::MeshUpdate *update,
+                           std::string *err);
+
+  bool UpdateMaterial(const uint32_t material_id,
+                      const UsdPreviewSurface *surface, const double t,
+                      bool *updated);
+
+  void PushWarn(const std::string &msg) { _warn += msg; }
+  void PushError(const std::string &msg) { _err += msg; }
+
+  const Stage *_stage{nullptr};
+  RenderScene *_scene{nullptr};
+
+  value::TimeSampleInterpolationType _tinterp{
+      value::TimeSampleInterpolationType::Linear};
+  NormalWeighting _normal_weighting{NormalWeighting::Area};
+  bool _compute_tangents_and_binormals{false};
+  int _num_threads{1};
+
+  XformCache _xform_cache;
+
+  // Node and corresponding node index in `_xform_cache`.
+  std::vector<std::pair<Node *, uint32_t>> _nodes;
+
+  std::vector<AnimatedMesh> _meshes;
+
+  // Material and its UsdPreviewSurface.
+  std::vector<std::pair<uint32_t, const UsdPreviewSurface *>> _materials;
+
+  std::string _err;
+  std::string _warn;
 };
 
 // For debug
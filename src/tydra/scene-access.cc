@@ -36,13 +36,15 @@ namespace {
 // Typed TimeSamples to typeless TimeSamples
 template <typename T>
 value::TimeSamples ToTypelessTimeSamples(const TypedTimeSamples<T> &ts) {
-  const std::vector<typename TypedTimeSamples<T>::Sample> &samples =
-      ts.get_samples();
+  const std::vector<double> &times = ts.get_times();
 
   value::TimeSamples dst;
+  dst.reserve(times.size());
 
-  for (size_t i = 0; i < samples.size(); i++) {
-    dst.add_sample(samples[i].t, samples[i].value);
+  for (size_t i = 0; i < times.size(); i++) {
+    T v{};
+    ts.get_value(i, &v);
+    dst.add_sample(times[i], value::Value(std::move(v)));
   }
 
   return dst;
@@ -52,15 +54,17 @@ value::TimeSamples ToTypelessTimeSamples(const TypedTimeSamples<T> &ts) {
 template <typename T>
 value::TimeSamples EnumTimeSamplesToTypelessTimeSamples(
     const TypedTimeSamples<T> &ts) {
-  const std::vector<typename TypedTimeSamples<T>::Sample> &samples =
-      ts.get_samples();
+  const std::vector<double> &times = ts.get_times();
 
   value::TimeSamples dst;
+  dst.reserve(times.size());
 
-  for (size_t i = 0; i < samples.size(); i++) {
+  T v{};
+  for (size_t i = 0; i < times.size(); i++) {
+    ts.get_value(i, &v);
     // to token
-    value::token tok(to_string(samples[i].value));
-    dst.add_sample(samples[i].t, tok);
+    value::token tok(to_string(v));
+    dst.add_sample(times[i], tok);
   }
 
   return dst;
@@ -2090,76 +2094,58 @@ bool ListSceneNames(const tinyusdz::Prim &root,
 
 namespace {
 
-bool BuildXformNodeFromStageRec(
-    const tinyusdz::Stage &stage, const Path &parent_abs_path, const Prim *prim,
-    XformNode *nodeOut, /* out */
-    value::matrix4d rootMat, const double t,
-    const tinyusdz::value::TimeSampleInterpolationType tinterp) {
-  if (!nodeOut) {
-    return false;
-  }
-
-  XformNode node;
+void BuildXformHierarchyRec(const Prim *prim, const int32_t parent,
+                            XformHierarchy *h) {
+  const size_t idx = h->size();
+  const Path &parent_abs_path = h->absolute_paths[size_t(parent)];
 
   if (prim->element_name().empty()) {
     // TODO: report error
   }
 
-  node.element_name = prim->element_name();
-  node.absolute_path = parent_abs_path.AppendPrim(prim->element_name());
-  node.prim_id = prim->prim_id();
-  node.prim = prim;  // Assume Prim's address does not change.
+  h->element_names.push_back(prim->element_name());
+  h->absolute_paths.push_back(
+      parent_abs_path.AppendPrim(prim->element_name()));
+  h->prims.push_back(prim);  // Assume Prim's address does not change.
+  h->prim_ids.push_back(prim->prim_id());
+  h->parents.push_back(parent);
+  h->subtree_ends.push_back(0);  // filled after visiting children.
 
-  DCOUT(prim->element_name() << ": IsXformablePrim" << IsXformablePrim(*prim));
-
-  if (IsXformablePrim(*prim)) {
-    bool resetXformStack{false};
-
-    value::matrix4d localMat =
-        GetLocalTransform(*prim, &resetXformStack, t, tinterp);
-    DCOUT("local mat = " << localMat);
-
-    value::matrix4d worldMat = rootMat;
-    node.has_resetXformStack() = resetXformStack;
+  for (const auto &childPrim : prim->children()) {
+    BuildXformHierarchyRec(&childPrim, int32_t(idx), h);
+  }
 
-    value::matrix4d m;
+  h->subtree_ends[idx] = uint32_t(h->size());
+}
 
-    if (resetXformStack) {
-      // Ignore parent Xform.
-      m = localMat;
-    } else {
-      // matrix is row-major, so local first
-      m = localMat * worldMat;
-    }
+// Build XformNode tree from the subtree of `idx` in place(no subtree copy).
+void BuildXformNodeFromHierarchyRec(const XformHierarchy &h, const size_t idx,
+                                    XformNode *parent, XformNode *node) {
+  node->element_name = h.element_names[idx];
+  node->absolute_path = h.absolute_paths[idx];
+  node->prim = h.prims[idx];
+  node->prim_id = h.prim_ids[idx];
+  node->parent = parent;
+  node->has_xform() = h.has_xform[idx];
+  node->has_resetXformStack() = h.has_resetXformStack[idx];
+  node->set_parent_world_matrix(h.get_parent_world_matrix(idx));
+  node->set_local_matrix(h.local_matrices[idx]);
+  node->set_world_matrix(h.world_matrices[idx]);
 
-    node.set_parent_world_matrix(rootMat);
-    node.set_local_matrix(localMat);
-    node.set_world_matrix(m);
-    node.has_xform() = true;
-  } else {
-    DCOUT("Not xformable");
-    node.has_xform() = false;
-    node.has_resetXformStack() = false;
-    node.set_parent_world_matrix(rootMat);
-    node.set_world_matrix(rootMat);
-    node.set_local_matrix(value::matrix4d::identity());
+  size_t num_children = 0;
+  for (size_t c = idx + 1; c < h.subtree_ends[idx]; c = h.subtree_ends[c]) {
+    num_children++;
   }
 
-  for (const auto &childPrim : prim->children()) {
-    XformNode childNode;
-    if (!BuildXformNodeFromStageRec(stage, node.absolute_path, &childPrim,
-                                    &childNode, node.get_world_matrix(), t,
-                                    tinterp)) {
-      return false;
-    }
+  // `resize` first so that the address of children does not change.
+  node->children.clear();
+  node->children.resize(num_children);
 
-    childNode.parent = &node;
-    node.children.emplace_back(std::move(childNode));
+  size_t i = 0;
+  for (size_t c = idx + 1; c < h.subtree_ends[idx]; c = h.subtree_ends[c]) {
+    BuildXformNodeFromHierarchyRec(h, c, node, &node->children[i]);
+    i++;
   }
-
-  (*nodeOut) = node;
-
-  return true;
 }
 
 std::string DumpXformNodeRec(const XformNode &node, uint32_t indent) {
@@ -2186,40 +2172,110 @@ std::string DumpXformNodeRec(const XformNode &node, uint32_t indent) {
 
 }  // namespace local
 
-bool BuildXformNodeFromStage(
-    const tinyusdz::Stage &stage, XformNode *rootNode, /* out */
+bool BuildXformHierarchyFromStage(
+    const tinyusdz::Stage &stage, XformHierarchy *hierarchy, /* out */
     const double t,
     const tinyusdz::value::TimeSampleInterpolationType tinterp) {
-  if (!rootNode) {
+  if (!BuildXformHierarchyNodes(stage, hierarchy)) {
     return false;
   }
 
-  XformNode stage_root;
-  stage_root.element_name = "";  // Stage root element name is empty.
-  stage_root.absolute_path = Path("/", "");
-  stage_root.has_xform() = false;
-  stage_root.parent = nullptr;
-  stage_root.prim = nullptr;  // No prim for stage root.
-  stage_root.prim_id = -1;
-  stage_root.has_resetXformStack() = false;
-  stage_root.set_parent_world_matrix(value::matrix4d::identity());
-  stage_root.set_world_matrix(value::matrix4d::identity());
-  stage_root.set_local_matrix(value::matrix4d::identity());
+  return UpdateXformHierarchy(hierarchy, t, tinterp);
+}
+
+bool BuildXformHierarchyNodes(const tinyusdz::Stage &stage,
+                              XformHierarchy *hierarchy /* out */) {
+  if (!hierarchy) {
+    return false;
+  }
+
+  XformHierarchy &h = *hierarchy;
+  h.clear();
+
+  // Stage root. Element name is empty and no prim.
+  h.element_names.push_back("");
+  h.absolute_paths.push_back(Path("/", ""));
+  h.prims.push_back(nullptr);
+  h.prim_ids.push_back(-1);
+  h.parents.push_back(-1);
+  h.subtree_ends.push_back(0);
 
   for (const auto &root : stage.root_prims()) {
-    XformNode node;
+    BuildXformHierarchyRec(&root, /* parent */ 0, &h);
+  }
 
-    value::matrix4d rootMat{value::matrix4d::identity()};
+  h.subtree_ends[0] = uint32_t(h.size());
 
-    if (!BuildXformNodeFromStageRec(stage, stage_root.absolute_path, &root,
-                                    &node, rootMat, t, tinterp)) {
-      return false;
+  return true;
+}
+
+bool UpdateXformHierarchy(
+    XformHierarchy *hierarchy, /* inout */
+    const double t,
+    const tinyusdz::value::TimeSampleInterpolationType tinterp) {
+  if (!hierarchy) {
+    return false;
+  }
+
+  XformHierarchy &h = *hierarchy;
+  const size_t n = h.size();
+
+  h.has_xform.resize(n);
+  h.has_resetXformStack.resize(n);
+  h.local_matrices.resize(n);
+  h.world_matrices.resize(n);
+
+  // Nodes are topologically sorted, so the world matrix of the parent is
+  // always computed before its children.
+  for (size_t i = 0; i < n; i++) {
+    const Prim *prim = h.prims[i];
+    const value::matrix4d &parentMat =
+        (h.parents[i] < 0) ? value::matrix4d::identity()
+                           : h.world_matrices[size_t(h.parents[i])];
+
+    if (prim && IsXformablePrim(*prim)) {
+      bool resetXformStack{false};
+
+      value::matrix4d localMat =
+          GetLocalTransform(*prim, &resetXformStack, t, tinterp);
+      DCOUT("local mat = " << localMat);
+
+      h.has_xform[i] = 1;
+      h.has_resetXformStack[i] = resetXformStack ? 1 : 0;
+      h.local_matrices[i] = localMat;
+
+      if (resetXformStack) {
+        // Ignore parent Xform.
+        h.world_matrices[i] = localMat;
+      } else {
+        // matrix is row-major, so local first
+        h.world_matrices[i] = localMat * parentMat;
+      }
+    } else {
+      h.has_xform[i] = 0;
+      h.has_resetXformStack[i] = 0;
+      h.local_matrices[i] = value::matrix4d::identity();
+      h.world_matrices[i] = parentMat;
     }
+  }
+
+  return true;
+}
 
-    stage_root.children.emplace_back(std::move(node));
+bool BuildXformNodeFromStage(
+    const tinyusdz::Stage &stage, XformNode *rootNode, /* out */
+    const double t,
+    const tinyusdz::value::TimeSampleInterpolationType tinterp) {
+  if (!rootNode) {
+    return false;
+  }
+
+  XformHierarchy h;
+  if (!BuildXformHierarchyFromStage(stage, &h, t, tinterp)) {
+    return false;
   }
 
-  (*rootNode) = stage_root;
+  BuildXformNodeFromHierarchyRec(h, 0, /* parent */ nullptr, rootNode);
 
   return true;
 }
@@ -244,6 +244,9 @@ bool HasRelationship(const tinyusdz::Prim &prim, const std::string &rel_name);
 /// removed/added from/to Stage. If you change the content of Stage, please
 /// rebuild XformNode using BuildXformNodeFromStage() again
 ///
+/// `parent` pointer is valid until the XformNode tree is copied or moved.
+/// Use XformHierarchy for index-based access.
+///
 /// TODO: Use prim_id and deprecate the pointer to Prim.
 ///
 struct XformNode {
@@ -308,6 +311,82 @@ bool BuildXformNodeFromStage(
 
 std::string DumpXformNode(const XformNode &root);
 
+///
+/// Flat(index-based) Xform hierarchy.
+///
+/// Nodes are stored in depth-first order, so the parent of a node always has
+/// a smaller index(topologically sorted) and the subtree of node `i` occupies
+/// [i, subtree_ends[i]). Node 0 is the Stage root("/").
+///
+/// Matrices can be re-evaluated at another timecode with
+/// UpdateXformHierarchy() without traversing the Stage. As with XformNode,
+/// please rebuild it when the content of Stage is changed.
+///
+struct XformHierarchy {
+  std::vector<std::string> element_names;  // e.g. "geom0"
+  std::vector<Path> absolute_paths;        // e.g. "/xform/geom0"
+  std::vector<const Prim *> prims;         // nullptr for Stage root
+  std::vector<int64_t> prim_ids;
+  std::vector<int32_t> parents;  // -1 for Stage root
+  std::vector<uint32_t> subtree_ends;
+
+  // 1: Prim with Xform(e.g. GeomMesh), 0: Prim with no Xform(e.g. Scope)
+  std::vector<uint8_t> has_xform;
+  std::vector<uint8_t> has_resetXformStack;  // !resetXformStack! in xformOps
+
+  std::vector<value::matrix4d> local_matrices;
+  // world matrix = parent_world_matrix x local_matrix
+  std::vector<value::matrix4d> world_matrices;
+
+  size_t size() const { return parents.size(); }
+
+  void clear() {
+    element_names.clear();
+    absolute_paths.clear();
+    prims.clear();
+    prim_ids.clear();
+    parents.clear();
+    subtree_ends.clear();
+    has_xform.clear();
+    has_resetXformStack.clear();
+    local_matrices.clear();
+    world_matrices.clear();
+  }
+
+  const value::matrix4d &get_parent_world_matrix(size_t idx) const {
+    return (parents[idx] < 0) ? world_matrices[idx]
+                              : world_matrices[size_t(parents[idx])];
+  }
+};
+
+///
+/// Build flat Xform hierarchy from Stage in one pass.
+///
+/// Xform value is evaluated at specified time and timeSample interpolation
+/// type.
+///
+bool BuildXformHierarchyFromStage(
+    const tinyusdz::Stage &stage, XformHierarchy *hierarchy, /* out */
+    const double t = tinyusdz::value::TimeCode::Default(),
+    const tinyusdz::value::TimeSampleInterpolationType tinterp =
+        tinyusdz::value::TimeSampleInterpolationType::Linear);
+
+///
+/// Build nodes(paths, Prims and parent indices) of the hierarchy only.
+/// Matrices are not evaluated. Use UpdateXformHierarchy() to evaluate them.
+///
+bool BuildXformHierarchyNodes(const tinyusdz::Stage &stage,
+                              XformHierarchy *hierarchy /* out */);
+
+///
+/// Re-evaluate local and world matrices of the hierarchy at specified time.
+///
+bool UpdateXformHierarchy(
+    XformHierarchy *hierarchy, /* inout */
+    const double t = tinyusdz::value::TimeCode::Default(),
+    const tinyusdz::value::TimeSampleInterpolationType tinterp =
+        tinyusdz::value::TimeSampleInterpolationType::Linear);
+
 ///
 /// Get GeomSubset children of the given Prim path
 ///
@@ -0,0 +1,232 @@
+// SPDX-License-Identifier: Apache 2.0
+// Copyright 2024-Present Light Transport Entertainment, Inc.
+//
+#include "xform-cache.hh"
+
+#include "parallel-util.hh"
+#include "prim-types.hh"
+#include "stage.hh"
+#include "xform.hh"
+
+namespace tinyusdz {
+namespace tydra {
+
+namespace {
+
+// Sort `nodes`(in topological order) by depth.
+void SortByDepth(const std::vector<uint32_t> &nodes,
+                 const std::vector<uint32_t> &depths,
+                 std::vector<uint32_t> *sorted,
+                 std::vector<size_t> *level_offsets) {
+  uint32_t max_depth = 0;
+  for (uint32_t idx : nodes) {
+    max_depth = (std::max)(max_depth, depths[idx]);
+  }
+
+  // Counting sort. Order in the same depth is preserved.
+  std::vector<size_t> offsets(size_t(max_depth) + 2, 0);
+  for (uint32_t idx : nodes) {
+    offsets[depths[idx] + 1]++;
+  }
+  for (size_t d = 1; d < offsets.size(); d++) {
+    offsets[d] += offsets[d - 1];
+  }
+
+  (*level_offsets) = offsets;
+
+  sorted->resize(nodes.size());
+  for (uint32_t idx : nodes) {
+    (*sorted)[offsets[depths[idx]]++] = idx;
+  }
+}
+
+}  // namespace
+
+bool XformCache::build(const Stage &stage, const double t,
+                       const value::TimeSampleInterpolationType tinterp,
+                       const int num_threads) {
+  _err.clear();
+  _t = t;
+  _tinterp = tinterp;
+  _num_threads = num_threads;
+
+  if (!BuildXformHierarchyNodes(stage, &_h)) {
+    _err = "Failed to build Xform hierarchy.\n";
+    return false;
+  }
+
+  const size_t n = _h.size();
+
+  _h.has_xform.assign(n, 0);
+  _h.has_resetXformStack.assign(n, 0);
+  _h.local_matrices.assign(n, value::matrix4d::identity());
+  _h.world_matrices.assign(n, value::matrix4d::identity());
+
+  _programs.assign(n, XformOpProgram());
+  _animated.assign(n, 0);
+  _all_nodes.resize(n);
+  _animated_nodes.clear();
+  _path_to_index.clear();
+
+  std::vector<uint32_t> depths(n, 0);
+  _time_varying.assign(n, 0);
+  std::vector<uint32_t> tv_nodes;
+
+  for (size_t i = 0; i < n; i++) {
+    _all_nodes[i] = uint32_t(i);
+    _path_to_index[_h.absolute_paths[i].full_path_name()] = uint32_t(i);
+
+    if (_h.parents[i] >= 0) {
+      const size_t parent = size_t(_h.parents[i]);
+      depths[i] = depths[parent] + 1;
+      _time_varying[i] = _time_varying[parent];
+    }
+
+    const Prim *prim = _h.prims[i];
+    if (prim && IsXformablePrim(*prim)) {
+      _h.has_xform[i] = 1;
+
+      const Xformable *xformable{nullptr};
+      if (CastToXformable(*prim, &xformable) && xformable) {
+        std::string err;
+        if (!xformable->CompileXformOps(&_programs[i], &err)) {
+          // Identity matrix is used.
+          _programs[i].clear();
+          _err += _h.absolute_paths[i].full_path_name() + ": " + err;
+        } else if (!_programs[i].is_constant()) {
+          _animated[i] = 1;
+          _time_varying[i] = 1;
+          _animated_nodes.push_back(uint32_t(i));
+        }
+      }
+    }
+
+    if (_time_varying[i]) {
+      tv_nodes.push_back(uint32_t(i));
+    }
+  }
+
+  SortByDepth(_all_nodes, depths, &_levels, &_level_offsets);
+  SortByDepth(tv_nodes, depths, &_tv_levels, &_tv_level_offsets);
+
+  evaluate_local_matrices(_all_nodes);
+  propagate_world_matrices(_levels, _level_offsets);
+
+  return _err.empty();
+}
+
+bool XformCache::set_time(const double t) {
+  _err.clear();
+  _t = t;
+
+  if (_animated_nodes.empty()) {
+    return true;
+  }
+
+  evaluate_local_matrices(_animated_nodes);
+  propagate_world_matrices(_tv_levels, _tv_level_offsets);
+
+  return _err.empty();
+}
+
+void XformCache::evaluate_local_matrices(const std::vector<uint32_t> &nodes) {
+  const uint32_t nthreads = parallel::GetNumThreads(_num_threads);
+
+  // Per-thread error message.
+  std::vector<std::string> errs(nthreads);
+
+  parallel::ParallelFor(
+      0, nodes.size(), nthreads,
+      [&](size_t k, uint32_t tid) {
+        const size_t idx = nodes[k];
+        const XformOpProgram &program = _programs[idx];
+
+        value::matrix4d m;
+        std::string err;
+        if (program.evaluate(_t, _tinterp, &m, &err)) {
+          _h.local_matrices[idx] = m;
+          _h.has_resetXformStack[idx] = program.reset_xform_stack() ? 1 : 0;
+        } else {
+          _h.local_matrices[idx] = value::matrix4d::identity();
+          _h.has_resetXformStack[idx] = 0;
+          errs[tid] += _h.absolute_paths[idx].full_path_name() + ": " + err;
+        }
+      },
+      /* grain_size */ 32);
+
+  for (const auto &err : errs) {
+    _err += err;
+  }
+}
+
+void XformCache::propagate_world_matrices(
+    const std::vector<uint32_t> &nodes,
+    const std::vector<size_t> &level_offsets) {
+  const uint32_t nthreads = parallel::GetNumThreads(_num_threads);
+
+  // Nodes in the same level does not depend on each other.
+  for (size_t level = 0; (level + 1) < level_offsets.size(); level++) {
+    parallel::ParallelFor(
+        level_offsets[level], level_offsets[level + 1], nthreads,
+        [&](size_t k, uint32_t tid) {
+          (void)tid;
+          const size_t idx = nodes[k];
+
+          if (_h.parents[idx] < 0) {
+            // Stage root
+            _h.world_matrices[idx] = value::matrix4d::identity();
+            return;
+          }
+
+          const value::matrix4d &parentMat =
+              _h.world_matrices[size_t(_h.parents[idx])];
+
+          if (!_h.has_xform[idx]) {
+            _h.world_matrices[idx] = parentMat;
+          } else if (_h.has_resetXformStack[idx]) {
+            // Ignore parent Xform.
+            _h.world_matrices[idx] = _h.local_matrices[idx];
+          } else {
+            // matrix is row-major, so local first
+            _h.world_matrices[idx] = _h.local_matrices[idx] * parentMat;
+          }
+        },
+        /* grain_size */ 1024);
+  }
+}
+
+int64_t XformCache::find(const Path &abs_path) const {
+  auto it = _path_to_index.find(abs_path.full_path_name());
+  if (it == _path_to_index.end()) {
+    return -1;
+  }
+  return int64_t(it->second);
+}
+
+bool XformCache::get_local_matrix(const Path &abs_path, value::matrix4d *m,
+                                  bool *resetXformStack) const {
+  int64_t idx = find(abs_path);
+  if ((idx < 0) || !m) {
+    return false;
+  }
+
+  (*m) = _h.local_matrices[size_t(idx)];
+  if (resetXformStack) {
+    (*resetXformStack) = _h.has_resetXformStack[size_t(idx)];
+  }
+  return true;
+}
+
+bool XformCache::get_world_matrix(const Path &abs_path,
+                                  value::matrix4d *m) const {
+  int64_t idx = find(abs_path);
+  if ((idx < 0) || !m) {
+    return false;
+  }
+
+  (*m) = _h.world_matrices[size_t(idx)];
+  return true;
+}
+
+}  // namespace tydra
+}  // namespace tinyusdz
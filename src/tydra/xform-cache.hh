@@ -0,0 +1,127 @@
+// SPDX-License-Identifier: Apache 2.0
+// Copyright 2024-Present Light Transport Entertainment, Inc.
+//
+// XformCache: Evaluate local/world matrices of all Prims in a Stage.
+// (similar to UsdGeomXformCache in pxrUSD)
+//
+#pragma once
+
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "scene-access.hh"
+#include "xform.hh"
+
+namespace tinyusdz {
+namespace tydra {
+
+///
+/// Cache of local and world matrices of all Prims in a Stage.
+///
+/// - xformOps of each Prim are compiled into XformOpProgram once.
+/// - Local matrices are evaluated concurrently for all Prims.
+/// - World matrices are propagated level by level(Prims at the same depth
+///   are processed concurrently).
+/// - Prims whose xformOps are not timeSampled are evaluated only once.
+///   `set_time()` re-evaluates animated Prims and world matrices of their
+///   descendants only.
+///
+/// Prim pointers are held, so please rebuild the cache when the content of
+/// Stage is changed.
+///
+class XformCache {
+ public:
+  XformCache() = default;
+
+  ///
+  /// Build cache from Stage and evaluate matrices at time `t`.
+  ///
+  /// @param[in] num_threads # of threads. -1 = use all threads, 1 = serial.
+  ///
+  bool build(const Stage &stage, const double t = value::TimeCode::Default(),
+             const value::TimeSampleInterpolationType tinterp =
+                 value::TimeSampleInterpolationType::Linear,
+             const int num_threads = -1);
+
+  ///
+  /// Re-evaluate matrices at time `t`.
+  ///
+  bool set_time(const double t);
+
+  double get_time() const { return _t; }
+
+  void set_num_threads(const int num_threads) { _num_threads = num_threads; }
+
+  const XformHierarchy &hierarchy() const { return _h; }
+
+  ///
+  /// Find node index of the Prim. Returns -1 when not found.
+  ///
+  int64_t find(const Path &abs_path) const;
+
+  ///
+  /// Get local matrix of the Prim. Returns false when the Prim is not found.
+  ///
+  bool get_local_matrix(const Path &abs_path, value::matrix4d *m,
+                        bool *resetXformStack = nullptr) const;
+
+  ///
+  /// Get world(local-to-world) matrix of the Prim. Returns false when the Prim
+  /// is not found.
+  ///
+  bool get_world_matrix(const Path &abs_path, value::matrix4d *m) const;
+
+  // true when xformOps of the node is timeSampled.
+  bool is_animated(const size_t idx) const {
+    return (idx < _animated.size()) && _animated[idx];
+  }
+
+  size_t num_animated() const { return _animated_nodes.size(); }
+
+  // true when the world matrix of the node is time-varying(the node or its
+  // ancestor is animated).
+  bool is_time_varying(const size_t idx) const {
+    return (idx < _time_varying.size()) && _time_varying[idx];
+  }
+
+  // Error message of xformOps evaluation(identity matrix is used for such
+  // Prims).
+  const std::string &get_error() const { return _err; }
+
+ private:
+  void evaluate_local_matrices(const std::vector<uint32_t> &nodes);
+  void propagate_world_matrices(const std::vector<uint32_t> &nodes,
+                                const std::vector<size_t> &level_offsets);
+
+  XformHierarchy _h;
+
+  // Empty program(identity matrix) for non-Xformable Prims.
+  std::vector<XformOpProgram> _programs;
+  std::vector<uint8_t> _animated;
+  std::vector<uint8_t> _time_varying;
+
+  // Node indices sorted by depth, and the range of each depth.
+  std::vector<uint32_t> _levels;
+  std::vector<size_t> _level_offsets;
+
+  // Nodes whose world matrix is time-varying(animated node or its
+  // descendants), sorted by depth.
+  std::vector<uint32_t> _tv_levels;
+  std::vector<size_t> _tv_level_offsets;
+
+  std::vector<uint32_t> _all_nodes;
+  std::vector<uint32_t> _animated_nodes;
+
+  std::unordered_map<std::string, uint32_t> _path_to_index;
+
+  double _t{value::TimeCode::Default()};
+  value::TimeSampleInterpolationType _tinterp{
+      value::TimeSampleInterpolationType::Linear};
+  int _num_threads{-1};
+
+  std::string _err;
+};
+
+}  // namespace tydra
+}  // namespace tinyusdz
@@ -330,10 +330,10 @@ void GeomPrimvar::set_indices(const std::vector<int32_t> &indices, const double
   if (value::TimeCode(t).is_default()) {
     _indices = indices;
   } else {
-    TypedTimeSamples<std::vector<int32_t>>::Sample *psample{nullptr};
-    if (_ts_indices.get_sample_at(t, &psample)) {
+    size_t idx{0};
+    if (_ts_indices.find_sample_at(t, &idx)) {
       // overwrite content
-      psample->value = indices;
+      _ts_indices.set_value(idx, indices);
     } else {
       _ts_indices.add_sample(t, indices);
     }
@@ -501,7 +501,7 @@ bool GeomPrimvar::get_value(T *dest, std::string *err) const {
       return false;
     }
     
-    if (auto pv =ts.get_samples().at(0).value.as<T>()) {
+    if (auto pv = ts.get_values()[0].as<T>()) {
       (*dest) = (*pv);
       return true;
     }
@@ -663,8 +663,12 @@ bool GPrim::set_primvar(const GeomPrimvar &primvar,
     }
 
     if (primvar.has_timesampled_indices()) {
-      for (const auto &sample : primvar.get_timesampled_indices().get_samples()) {
-        var.set_timesample(sample.t, sample.value);
+      const TypedTimeSamples<std::vector<int32_t>> &ts_indices = primvar.get_timesampled_indices();
+      const std::vector<double> &times = ts_indices.get_times();
+      std::vector<int32_t> indices;
+      for (size_t i = 0; i < times.size(); i++) {
+        ts_indices.get_value(i, &indices);
+        var.set_timesample(times[i], indices);
       }
     }
 
@@ -254,6 +254,24 @@ class GeomPrimvar {
 
   bool get_value(double timecode, value::Value *dst, const value::TimeSampleInterpolationType interp = value::TimeSampleInterpolationType::Linear, std::string *err = nullptr) const;
 
+  ///
+  /// Zero-copy access to the Attribute's array value at specified time.
+  /// Indices are not applied(use get_indices() to look up the value).
+  ///
+  /// Returns false when the value needs to be interpolated from timesamples
+  /// or type mismatch. Use get_value() in that case.
+  ///
+  template <typename T>
+  bool get_array_view(double timecode, value::ArrayView<T> *dst, const value::TimeSampleInterpolationType interp = value::TimeSampleInterpolationType::Linear) const {
+    static_assert(tinyusdz::value::TypeTraits<T>::type_id() != value::TypeTraits<value::token>::type_id(), "`token` type is not supported as a GeomPrimvar");
+
+    if (!_has_value) {
+      return false;
+    }
+
+    return _attr.get_array_view(timecode, dst, interp);
+  }
+
   ///
   /// Set Attribute value.
   ///
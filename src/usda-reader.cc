@@ -515,7 +515,7 @@ class USDAReader::Impl {
     _parser.RegisterPrimSpecFunction(
          [&](const Path &full_path, const Specifier spec, const std::string &typeName, const Path &prim_name, const int64_t primIdx,
             const int64_t parentPrimIdx,
-            const prim::PropertyMap &properties,
+            prim::PropertyMap &properties,
             const ascii::AsciiParser::PrimMetaMap &in_meta,
             const ascii::AsciiParser::VariantSetList &in_variants)
             -> nonstd::expected<bool, std::string> {
@@ -559,7 +559,7 @@ class USDAReader::Impl {
                 "Failed to process Prim metadataum.");
           }
 
-          primspec.props() = properties;
+          primspec.props() = std::move(properties);
 
           //
           // variants
@@ -614,7 +614,7 @@ class USDAReader::Impl {
           DCOUT("primspec[" << primIdx << "].ty = "
                         << _primspec_nodes[size_t(primIdx)].primSpec.typeName());
           _primspec_nodes[size_t(primIdx)].parent = parentPrimIdx;
-          _primspec_nodes[size_t(primIdx)].variantNodeMap = variantSets;
+          _primspec_nodes[size_t(primIdx)].variantNodeMap = std::move(variantSets);
 
           if (parentPrimIdx == -1) {
             _toplevel_primspecs.push_back(size_t(primIdx));
@@ -1301,19 +1301,20 @@ bool ToPrimSpecRec(const size_t primSpecIdx,
     return false;
   }
 
-  const PrimSpecNode &node = primspec_nodes[primSpecIdx];
+  // Each PrimSpecNode is visited only once, so move its contents.
+  PrimSpecNode &node = primspec_nodes[primSpecIdx];
 
-  PrimSpec primspec = node.primSpec;
+  PrimSpec primspec = std::move(node.primSpec);
 
   // Firstly process variants.
   std::set<int64_t> variantChildrenIndices; // record variantChildren indices
   {
 
     std::map<std::string, VariantSetSpec> variantSets;
-    for (const auto &variantNodes : node.variantNodeMap) {
+    for (auto &variantNodes : node.variantNodeMap) {
       DCOUT("variantSet " << variantNodes.first);
       VariantSetSpec variantSet;
-      for (const auto &item : variantNodes.second) {
+      for (auto &item : variantNodes.second) {
         DCOUT("variant " << item.first);
         PrimSpec variant; // variantNode can be represented as PrimSpec.
         for (const int64_t vidx : item.second.primChildren) {
@@ -1333,7 +1334,7 @@ bool ToPrimSpecRec(const size_t primSpecIdx,
               }
 
               DCOUT(fmt::format("Added prim {} to variantSet {} : variant {}", variantChildPrim.name(), variantNodes.first, item.first));
-              variant.children().emplace_back(variantChildPrim);
+              variant.children().emplace_back(std::move(variantChildPrim));
             } else {
               if (err) {
                 (*err) = "primIndex exceeds prim_nodes.size()\n";
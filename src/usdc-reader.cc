@@ -2955,12 +2955,12 @@ bool USDCReader::Impl::ReconstructPrimSpecNode(int parent, int current, int leve
         if (!BuildPropertyMap(node.GetChildren(), psmap, &props)) {
           PUSH_ERROR_AND_RETURN_TAG(kTag, "Failed to build PropertyMap.");
         }
-        primspec.props() = props;
-        primspec.metas() = primMeta;
+        primspec.props() = std::move(props);
+        primspec.metas() = std::move(primMeta);
         // TODO: primChildren, properties
 
         if (primOut) {
-          (*primOut) = primspec;
+          (*primOut) = std::move(primspec);
         }
 #endif
       }
@@ -3616,7 +3616,7 @@ bool USDCReader::Impl::ReconstructPrimSpecRecursively(
     if (vs.name.empty()) {
       vs.name = variantSetName;
     }
-    vs.variantSet[variantName] = variant;
+    vs.variantSet[variantName] = std::move(variant);
 
   }
 
@@ -3638,7 +3638,8 @@ bool USDCReader::Impl::ReconstructPrimSpecRecursively(
         PUSH_ERROR_AND_RETURN("Internal error: variant Prim children not found.");
       }
 
-      const PrimSpec &vp = _variantPrimSpecs.at(item);
+      // Variant PrimSpec is added to its parent only once, so move it.
+      PrimSpec &vp = _variantPrimSpecs.at(item);
 
       DCOUT(fmt::format("  variantPrim name {}", vp.name()));
 
@@ -3660,7 +3661,7 @@ bool USDCReader::Impl::ReconstructPrimSpecRecursively(
       if (vs.name.empty()) {
         vs.name = variantSetName;
       }
-      vs.variantSet[variantName].metas() = vp.metas();
+      vs.variantSet[variantName].metas() = std::move(vp.metas());
       DCOUT("# of primChildren = " << vp.children().size());
       vs.variantSet[variantName].children() = std::move(vp.children());
 
@@ -0,0 +1,179 @@
+// SPDX-License-Identifier: Apache 2.0
+// Copyright 2024-Present Light Transport Entertainment, Inc.
+//
+// Array lerp kernels.
+//
+// SIMD path is selected at compile time(SSE2 is always available on x86-64,
+// AVX/F16C requires e.g. `-mavx -mf16c`, NEON on AArch64), otherwise a plain
+// loop is used.
+//
+#include "value-eval-util.hh"
+#include "linear-algebra.hh"
+
+#if defined(__AVX__) || defined(__F16C__)
+#include <immintrin.h>
+#endif
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && (_M_IX86_FP >= 2))
+#include <emmintrin.h>
+#define TINYUSDZ_LERP_USE_SSE2
+#endif
+
+#if defined(__ARM_NEON) || defined(__ARM_NEON__)
+#include <arm_neon.h>
+#define TINYUSDZ_LERP_USE_NEON
+#endif
+
+namespace tinyusdz {
+
+// lerp_array() reinterprets these types as an array of scalars.
+static_assert(sizeof(value::point3f) == sizeof(float) * 3, "");
+static_assert(sizeof(value::normal3f) == sizeof(float) * 3, "");
+static_assert(sizeof(value::texcoord2h) == sizeof(value::half) * 2, "");
+static_assert(sizeof(value::color4d) == sizeof(double) * 4, "");
+static_assert(sizeof(value::matrix4d) == sizeof(double) * 16, "");
+
+void LerpArray(const float *a, const float *b, const size_t n, const float t,
+               float *dst) {
+  const float s = 1.0f - t;
+
+  size_t i = 0;
+
+#if defined(__AVX__)
+  {
+    const __m256 vs = _mm256_set1_ps(s);
+    const __m256 vt = _mm256_set1_ps(t);
+    for (; (i + 8) <= n; i += 8) {
+      const __m256 va = _mm256_loadu_ps(a + i);
+      const __m256 vb = _mm256_loadu_ps(b + i);
+      _mm256_storeu_ps(dst + i, _mm256_add_ps(_mm256_mul_ps(vs, va),
+                                              _mm256_mul_ps(vt, vb)));
+    }
+  }
+#endif
+
+#if defined(TINYUSDZ_LERP_USE_SSE2)
+  {
+    const __m128 vs = _mm_set1_ps(s);
+    const __m128 vt = _mm_set1_ps(t);
+    for (; (i + 4) <= n; i += 4) {
+      const __m128 va = _mm_loadu_ps(a + i);
+      const __m128 vb = _mm_loadu_ps(b + i);
+      _mm_storeu_ps(dst + i,
+                    _mm_add_ps(_mm_mul_ps(vs, va), _mm_mul_ps(vt, vb)));
+    }
+  }
+#elif defined(TINYUSDZ_LERP_USE_NEON)
+  {
+    const float32x4_t vs = vdupq_n_f32(s);
+    const float32x4_t vt = vdupq_n_f32(t);
+    for (; (i + 4) <= n; i += 4) {
+      const float32x4_t va = vld1q_f32(a + i);
+      const float32x4_t vb = vld1q_f32(b + i);
+      vst1q_f32(dst + i, vaddq_f32(vmulq_f32(vs, va), vmulq_f32(vt, vb)));
+    }
+  }
+#endif
+
+  for (; i < n; i++) {
+    dst[i] = s * a[i] + t * b[i];
+  }
+}
+
+void LerpArray(const double *a, const double *b, const size_t n,
+               const double t, double *dst) {
+  const double s = 1.0 - t;
+
+  size_t i = 0;
+
+#if defined(__AVX__)
+  {
+    const __m256d vs = _mm256_set1_pd(s);
+    const __m256d vt = _mm256_set1_pd(t);
+    for (; (i + 4) <= n; i += 4) {
+      const __m256d va = _mm256_loadu_pd(a + i);
+      const __m256d vb = _mm256_loadu_pd(b + i);
+      _mm256_storeu_pd(dst + i, _mm256_add_pd(_mm256_mul_pd(vs, va),
+                                              _mm256_mul_pd(vt, vb)));
+    }
+  }
+#endif
+
+#if defined(TINYUSDZ_LERP_USE_SSE2)
+  {
+    const __m128d vs = _mm_set1_pd(s);
+    const __m128d vt = _mm_set1_pd(t);
+    for (; (i + 2) <= n; i += 2) {
+      const __m128d va = _mm_loadu_pd(a + i);
+      const __m128d vb = _mm_loadu_pd(b + i);
+      _mm_storeu_pd(dst + i,
+                    _mm_add_pd(_mm_mul_pd(vs, va), _mm_mul_pd(vt, vb)));
+    }
+  }
+#elif defined(TINYUSDZ_LERP_USE_NEON) && defined(__aarch64__)
+  {
+    const float64x2_t vs = vdupq_n_f64(s);
+    const float64x2_t vt = vdupq_n_f64(t);
+    for (; (i + 2) <= n; i += 2) {
+      const float64x2_t va = vld1q_f64(a + i);
+      const float64x2_t vb = vld1q_f64(b + i);
+      vst1q_f64(dst + i, vaddq_f64(vmulq_f64(vs, va), vmulq_f64(vt, vb)));
+    }
+  }
+#endif
+
+  for (; i < n; i++) {
+    dst[i] = s * a[i] + t * b[i];
+  }
+}
+
+void LerpArray(const value::half *a, const value::half *b, const size_t n,
+               const float t, value::half *dst) {
+  const float s = 1.0f - t;
+
+  size_t i = 0;
+
+#if defined(__F16C__)
+  {
+    const __m128 vs = _mm_set1_ps(s);
+    const __m128 vt = _mm_set1_ps(t);
+    for (; (i + 4) <= n; i += 4) {
+      const __m128 va = _mm_cvtph_ps(
+          _mm_loadl_epi64(reinterpret_cast<const __m128i *>(a + i)));
+      const __m128 vb = _mm_cvtph_ps(
+          _mm_loadl_epi64(reinterpret_cast<const __m128i *>(b + i)));
+      const __m128 vc = _mm_add_ps(_mm_mul_ps(vs, va), _mm_mul_ps(vt, vb));
+      _mm_storel_epi64(reinterpret_cast<__m128i *>(dst + i),
+                       _mm_cvtps_ph(vc, _MM_FROUND_TO_NEAREST_INT));
+    }
+  }
+#endif
+
+  for (; i < n; i++) {
+    dst[i] = value::float_to_half_full(s * value::half_to_float(a[i]) +
+                                       t * value::half_to_float(b[i]));
+  }
+}
+
+void SlerpArray(const value::quath *a, const value::quath *b, const size_t n,
+                const float t, value::quath *dst) {
+  for (size_t i = 0; i < n; i++) {
+    dst[i] = slerp(a[i], b[i], t);
+  }
+}
+
+void SlerpArray(const value::quatf *a, const value::quatf *b, const size_t n,
+                const float t, value::quatf *dst) {
+  for (size_t i = 0; i < n; i++) {
+    dst[i] = slerp(a[i], b[i], t);
+  }
+}
+
+void SlerpArray(const value::quatd *a, const value::quatd *b, const size_t n,
+                const double t, value::quatd *dst) {
+  for (size_t i = 0; i < n; i++) {
+    dst[i] = slerp(a[i], b[i], t);
+  }
+}
+
+}  // namespace tinyusdz
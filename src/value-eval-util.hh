@@ -1861,29 +1861,6 @@ TUSD_INLINED_LERP(value::frame4d, double)
 
 
 
-// for generic vector data.
-template <typename T>
-inline std::vector<T> lerp(const std::vector<T> &a, const std::vector<T> &b,
-                           const double t) {
-  std::vector<T> dst;
-
-  // Choose shorter one
-  size_t n = std::min(a.size(), b.size());
-  if (n == 0) {
-    return dst;
-  }
-
-  dst.resize(n);
-
-  if (a.size() != b.size()) {
-    return dst;
-  }
-  for (size_t i = 0; i < n; i++) {
-    dst[i] = lerp(a[i], b[i], t);
-  }
-
-  return dst;
-}
 
 template <>
 inline value::quath lerp(const value::quath &a, const value::quath &b, const double t) {
@@ -1945,4 +1922,137 @@ inline std::vector<value::AssetPath> lerp(
 #endif
 
 
+//
+// Array lerp kernels(value-eval-util.cc). SIMD accelerated when available.
+// `n` is the number of scalar(or quaternion) elements. `dst` can be the same
+// pointer as `a` or `b`.
+//
+void LerpArray(const float *a, const float *b, size_t n, float t, float *dst);
+void LerpArray(const double *a, const double *b, size_t n, double t,
+               double *dst);
+
+// Convert to float, blend and convert back to half.
+void LerpArray(const value::half *a, const value::half *b, size_t n, float t,
+               value::half *dst);
+
+void SlerpArray(const value::quath *a, const value::quath *b, size_t n,
+                float t, value::quath *dst);
+void SlerpArray(const value::quatf *a, const value::quatf *b, size_t n,
+                float t, value::quatf *dst);
+void SlerpArray(const value::quatd *a, const value::quatd *b, size_t n,
+                double t, value::quatd *dst);
+
+//
+// Interpolate `n` elements of `a` and `b` into `dst`.
+// Generic version uses the scalar lerp. Types consisting of float, double or
+// half components use LerpArray(), quaternions use SlerpArray().
+//
+template <typename T>
+inline void lerp_array(const T *a, const T *b, const size_t n, const double t,
+                       T *dst) {
+  for (size_t i = 0; i < n; i++) {
+    dst[i] = lerp(a[i], b[i], t);
+  }
+}
+
+#define TUSD_ARRAY_LERP(__ty, __basety, __interp_ty, __ncomps)         \
+  template <>                                                          \
+  inline void lerp_array(const __ty *a, const __ty *b, const size_t n, \
+                         const double t, __ty *dst) {                  \
+    LerpArray(reinterpret_cast<const __basety *>(a),                   \
+              reinterpret_cast<const __basety *>(b), n * (__ncomps),   \
+              __interp_ty(t), reinterpret_cast<__basety *>(dst));      \
+  }
+
+TUSD_ARRAY_LERP(value::half, value::half, float, 1)
+TUSD_ARRAY_LERP(value::half2, value::half, float, 2)
+TUSD_ARRAY_LERP(value::half3, value::half, float, 3)
+TUSD_ARRAY_LERP(value::half4, value::half, float, 4)
+TUSD_ARRAY_LERP(value::normal3h, value::half, float, 3)
+TUSD_ARRAY_LERP(value::vector3h, value::half, float, 3)
+TUSD_ARRAY_LERP(value::point3h, value::half, float, 3)
+TUSD_ARRAY_LERP(value::color3h, value::half, float, 3)
+TUSD_ARRAY_LERP(value::color4h, value::half, float, 4)
+TUSD_ARRAY_LERP(value::texcoord2h, value::half, float, 2)
+TUSD_ARRAY_LERP(value::texcoord3h, value::half, float, 3)
+TUSD_ARRAY_LERP(float, float, float, 1)
+TUSD_ARRAY_LERP(value::float2, float, float, 2)
+TUSD_ARRAY_LERP(value::float3, float, float, 3)
+TUSD_ARRAY_LERP(value::float4, float, float, 4)
+TUSD_ARRAY_LERP(value::normal3f, float, float, 3)
+TUSD_ARRAY_LERP(value::vector3f, float, float, 3)
+TUSD_ARRAY_LERP(value::point3f, float, float, 3)
+TUSD_ARRAY_LERP(value::color3f, float, float, 3)
+TUSD_ARRAY_LERP(value::color4f, float, float, 4)
+TUSD_ARRAY_LERP(value::texcoord2f, float, float, 2)
+TUSD_ARRAY_LERP(value::texcoord3f, float, float, 3)
+TUSD_ARRAY_LERP(double, double, double, 1)
+TUSD_ARRAY_LERP(value::double2, double, double, 2)
+TUSD_ARRAY_LERP(value::double3, double, double, 3)
+TUSD_ARRAY_LERP(value::double4, double, double, 4)
+TUSD_ARRAY_LERP(value::normal3d, double, double, 3)
+TUSD_ARRAY_LERP(value::vector3d, double, double, 3)
+TUSD_ARRAY_LERP(value::point3d, double, double, 3)
+TUSD_ARRAY_LERP(value::color3d, double, double, 3)
+TUSD_ARRAY_LERP(value::color4d, double, double, 4)
+TUSD_ARRAY_LERP(value::texcoord2d, double, double, 2)
+TUSD_ARRAY_LERP(value::texcoord3d, double, double, 3)
+TUSD_ARRAY_LERP(value::matrix2d, double, double, 4)
+TUSD_ARRAY_LERP(value::matrix3d, double, double, 9)
+TUSD_ARRAY_LERP(value::matrix4d, double, double, 16)
+
+#undef TUSD_ARRAY_LERP
+
+template <>
+inline void lerp_array(const value::quath *a, const value::quath *b,
+                       const size_t n, const double t, value::quath *dst) {
+  SlerpArray(a, b, n, float(t), dst);
+}
+
+template <>
+inline void lerp_array(const value::quatf *a, const value::quatf *b,
+                       const size_t n, const double t, value::quatf *dst) {
+  SlerpArray(a, b, n, float(t), dst);
+}
+
+template <>
+inline void lerp_array(const value::quatd *a, const value::quatd *b,
+                       const size_t n, const double t, value::quatd *dst) {
+  SlerpArray(a, b, n, t, dst);
+}
+
+///
+/// Output-buffer variant of lerp for arrays. The storage of `dst` is reused.
+///
+/// When the length of `a` and `b` differs, `dst` is filled with the default
+/// value of the shorter length and returns false.
+///
+template <typename T>
+inline bool lerp(const std::vector<T> &a, const std::vector<T> &b,
+                 const double t, std::vector<T> *dst) {
+  // Choose shorter one
+  size_t n = (std::min)(a.size(), b.size());
+
+  if (a.size() != b.size()) {
+    dst->assign(n, T());
+    return false;
+  }
+
+  dst->resize(n);
+  if (n > 0) {
+    lerp_array(a.data(), b.data(), n, t, dst->data());
+  }
+
+  return true;
+}
+
+// for generic vector data.
+template <typename T>
+inline std::vector<T> lerp(const std::vector<T> &a, const std::vector<T> &b,
+                           const double t) {
+  std::vector<T> dst;
+  lerp(a, b, t, &dst);
+  return dst;
+}
+
 } // namespace tinyusdz
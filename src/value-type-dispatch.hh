@@ -0,0 +1,121 @@
+// SPDX-License-Identifier: Apache 2.0
+// Copyright 2024 - Present, Light Transport Entertainment Inc.
+//
+// O(1) dispatch on value::TypeId.
+//
+// Replaces `if (tyid == TypeTraits<T0>::type_id()) {...} else if (...)`
+// chains with a function table indexed by TypeId, which is generated at
+// compile time from the list of types.
+//
+#pragma once
+
+#include <cstdint>
+#include <utility>
+
+#include "value-types.hh"
+
+namespace tinyusdz {
+namespace value {
+
+///
+/// Function table indexed by the base(non-array) TypeId of value types.
+///
+/// `Fn<T>::call(args...)` (returns bool) is registered for each `T` in `Ts`.
+///
+/// Example:
+///
+///   template <typename T>
+///   struct PrintFn {
+///     static bool call(const value::Value &v) { ... }
+///   };
+///
+///   using PrintDispatcher = TypeIdDispatcher<PrintFn, float, double>;
+///
+///   bool found = PrintDispatcher::dispatch(v.type_id(), &ret, v);
+///
+template <template <typename> class Fn, typename... Ts>
+class TypeIdDispatcher {
+ public:
+  static constexpr uint32_t kTableSize = TYPE_ID_VALUE_END;
+
+  ///
+  /// @return true when the base TypeId of `tyid` is one of `Ts`.
+  ///
+  static bool contains(const uint32_t tyid) {
+    const uint32_t base_tyid = tyid & (~TYPE_ID_1D_ARRAY_BIT);
+    return (base_tyid < kTableSize) && kContains.flags[base_tyid];
+  }
+
+  ///
+  /// Call `Fn<T>::call(args...)` where `T` is the type of base TypeId of
+  /// `tyid`(array bit is ignored, so `Fn` is responsible for handling both
+  /// `T` and `std::vector<T>`).
+  ///
+  /// @param[out] ret Return value of `Fn<T>::call`.
+  /// @return false when the type is not one of `Ts`(`Fn` is not called).
+  ///
+  template <typename... Args>
+  static bool dispatch(const uint32_t tyid, bool *ret, Args &&... args) {
+    using FuncPtr = bool (*)(Args &&...);
+
+    static constexpr FuncTable<FuncPtr> kTable = BuildTable<Args...>();
+
+    const uint32_t base_tyid = tyid & (~TYPE_ID_1D_ARRAY_BIT);
+    if (base_tyid >= kTableSize) {
+      return false;
+    }
+
+    FuncPtr f = kTable.funcs[base_tyid];
+    if (!f) {
+      return false;
+    }
+
+    bool r = f(std::forward<Args>(args)...);
+    if (ret) {
+      (*ret) = r;
+    }
+    return true;
+  }
+
+ private:
+  template <typename FuncPtr>
+  struct FuncTable {
+    FuncPtr funcs[kTableSize];
+  };
+
+  struct ContainsTable {
+    bool flags[kTableSize];
+  };
+
+  template <typename T, typename... Args>
+  static bool Thunk(Args &&... args) {
+    return Fn<T>::call(std::forward<Args>(args)...);
+  }
+
+  // Out-of-range TypeId(non value types) fails constant evaluation.
+  template <typename... Args>
+  static constexpr FuncTable<bool (*)(Args &&...)> BuildTable() {
+    FuncTable<bool (*)(Args &&...)> table{};
+    using expand = int[];
+    (void)expand{0, (table.funcs[TypeTraits<Ts>::type_id()] =
+                         &Thunk<Ts, Args...>,
+                     0)...};
+    return table;
+  }
+
+  static constexpr ContainsTable BuildContainsTable() {
+    ContainsTable table{};
+    using expand = int[];
+    (void)expand{0, (table.flags[TypeTraits<Ts>::type_id()] = true, 0)...};
+    return table;
+  }
+
+  static constexpr ContainsTable kContains = BuildContainsTable();
+};
+
+template <template <typename> class Fn, typename... Ts>
+constexpr typename TypeIdDispatcher<Fn, Ts...>::ContainsTable
+    TypeIdDispatcher<Fn, Ts...>::kContains;
+
+}  // namespace value
+}  // namespace tinyusdz
@@ -6,6 +6,7 @@
 #include "str-util.hh"
 #include "value-pprint.hh"
 #include "value-eval-util.hh"
+#include "value-type-dispatch.hh"
 
 //
 #include "common-macros.inc"
@@ -22,93 +23,58 @@ namespace value {
 //
 // Supported type for `Linear` interpolation
 //
-// half, float, double, TimeCode(double)
-// matrix2d, matrix3d, matrix4d,
+// half, float, double
+// matrix2d, matrix3d, matrix4d, frame4d
 // float2h, float3h, float4h
 // float2f, float3f, float4f
 // float2d, float3d, float4d
 // quath, quatf, quatd
 // (use slerp for quaternion type)
-bool IsLerpSupportedType(uint32_t tyid) {
+// and their role types(e.g. color3f) and 1D arrays.
 
-  // TODO: Directly get underlying_typeid
-  bool has_underlying_tyid{false};
-  uint32_t underlying_tyid{TYPE_ID_INVALID};
-
-  if (auto pv = TryGetUnderlyingTypeName(tyid)) {
-    underlying_tyid = GetTypeId(pv.value());
-    has_underlying_tyid = true;
-  } 
-
-  // See also for underlying_type_id to simplify check for Role types(e.g. color3f)
-#define IS_SUPPORTED_TYPE(__tyid, __ty) \
-  if (__tyid == value::TypeTraits<__ty>::type_id()) { \
-    return true; \
-  } else if (__tyid == value::TypeTraits<__ty>::underlying_type_id()) { \
-    return true; \
-  } else if (__tyid & value::TYPE_ID_1D_ARRAY_BIT) { \
-    if ((__tyid & (~value::TYPE_ID_1D_ARRAY_BIT)) == (value::TypeTraits<__ty>::type_id())) { \
-      return true; \
-    } else if ((__tyid & (~value::TYPE_ID_1D_ARRAY_BIT)) == (value::TypeTraits<__ty>::underlying_type_id())) { \
-      return true; \
-    } \
-  }
-
-  // Assume __uty is underlying_type.
-#define IS_SUPPORTED_UNDERLYING_TYPE(__utyid, __uty) \
-  if (__utyid == value::TypeTraits<__uty>::type_id()) { \
-    return true; \
-  } else if (__utyid & value::TYPE_ID_1D_ARRAY_BIT) { \
-    if ((__utyid & (~value::TYPE_ID_1D_ARRAY_BIT)) == (value::TypeTraits<__uty>::type_id())) { \
-      return true; \
-    } \
-  }
+namespace {
 
-  IS_SUPPORTED_TYPE(tyid, value::half)
-  IS_SUPPORTED_TYPE(tyid, value::half2)
-  IS_SUPPORTED_TYPE(tyid, value::half3)
-  IS_SUPPORTED_TYPE(tyid, value::half4)
-  IS_SUPPORTED_TYPE(tyid, float)
-  IS_SUPPORTED_TYPE(tyid, value::float2)
-  IS_SUPPORTED_TYPE(tyid, value::float3)
-  IS_SUPPORTED_TYPE(tyid, value::float4)
-  IS_SUPPORTED_TYPE(tyid, double)
-  IS_SUPPORTED_TYPE(tyid, value::double2)
-  IS_SUPPORTED_TYPE(tyid, value::double3)
-  IS_SUPPORTED_TYPE(tyid, value::double4)
-  IS_SUPPORTED_TYPE(tyid, value::quath)
-  IS_SUPPORTED_TYPE(tyid, value::quatf)
-  IS_SUPPORTED_TYPE(tyid, value::quatd)
-  IS_SUPPORTED_TYPE(tyid, value::matrix2d)
-  IS_SUPPORTED_TYPE(tyid, value::matrix3d)
-  IS_SUPPORTED_TYPE(tyid, value::matrix4d)
-
-  if (has_underlying_tyid) {
-    IS_SUPPORTED_UNDERLYING_TYPE(underlying_tyid, value::half)
-    IS_SUPPORTED_UNDERLYING_TYPE(underlying_tyid, value::half2)
-    IS_SUPPORTED_UNDERLYING_TYPE(underlying_tyid, value::half3)
-    IS_SUPPORTED_UNDERLYING_TYPE(underlying_tyid, value::half4)
-    IS_SUPPORTED_UNDERLYING_TYPE(underlying_tyid, float)
-    IS_SUPPORTED_UNDERLYING_TYPE(underlying_tyid, value::float2)
-    IS_SUPPORTED_UNDERLYING_TYPE(underlying_tyid, value::float3)
-    IS_SUPPORTED_UNDERLYING_TYPE(underlying_tyid, value::float4)
-    IS_SUPPORTED_UNDERLYING_TYPE(underlying_tyid, double)
-    IS_SUPPORTED_UNDERLYING_TYPE(underlying_tyid, value::double2)
-    IS_SUPPORTED_UNDERLYING_TYPE(underlying_tyid, value::double3)
-    IS_SUPPORTED_UNDERLYING_TYPE(underlying_tyid, value::double4)
-    IS_SUPPORTED_UNDERLYING_TYPE(underlying_tyid, value::quath)
-    IS_SUPPORTED_UNDERLYING_TYPE(underlying_tyid, value::quatf)
-    IS_SUPPORTED_UNDERLYING_TYPE(underlying_tyid, value::quatd)
-    IS_SUPPORTED_UNDERLYING_TYPE(underlying_tyid, value::matrix2d)
-    IS_SUPPORTED_UNDERLYING_TYPE(underlying_tyid, value::matrix3d)
-    IS_SUPPORTED_UNDERLYING_TYPE(underlying_tyid, value::matrix4d)
+template <typename T>
+struct LerpFn {
+  static bool call(const value::Value &a, const value::Value &b,
+                   const double dt, value::Value *result) {
+    if (a.type_id() & value::TYPE_ID_1D_ARRAY_BIT) {
+      const std::vector<T> *v0 = a.as<std::vector<T>>();
+      const std::vector<T> *v1 = b.as<std::vector<T>>();
+      if (v0 && v1) {
+        std::vector<T> c;
+        lerp(*v0, *v1, dt, &c);
+        (*result) = std::move(c);
+        return true;
+      }
+    } else {
+      const T *v0 = a.as<T>();
+      const T *v1 = b.as<T>();
+      if (v0 && v1) {
+        (*result) = lerp(*v0, *v1, dt);
+        return true;
+      }
+    }
+    return false;
   }
+};
 
-#undef IS_SUPPORTED_TYPE
-#undef IS_SUPPORTED_UNDERLYING_TYPE
+using LerpDispatcher = TypeIdDispatcher<
+    LerpFn, value::half, value::half2, value::half3, value::half4, float,
+    value::float2, value::float3, value::float4, double, value::double2,
+    value::double3, value::double4, value::quath, value::quatf, value::quatd,
+    value::matrix2d, value::matrix3d, value::matrix4d, value::frame4d,
+    value::color3h, value::color3f, value::color3d, value::color4h,
+    value::color4f, value::color4d, value::point3h, value::point3f,
+    value::point3d, value::normal3h, value::normal3f, value::normal3d,
+    value::vector3h, value::vector3f, value::vector3d, value::texcoord2h,
+    value::texcoord2f, value::texcoord2d, value::texcoord3h,
+    value::texcoord3f, value::texcoord3d>;
 
-  return false;
+}  // namespace
 
+bool IsLerpSupportedType(uint32_t tyid) {
+  return LerpDispatcher::contains(tyid);
 }
 
 bool Lerp(const value::Value &a, const value::Value &b, double dt, value::Value *dst) {
@@ -120,80 +86,16 @@ bool Lerp(const value::Value &a, const value::Value &b, double dt, value::Value
     return false;
   }
 
-  uint32_t tyid = a.type_id();
-
-  if (!IsLerpSupportedType(tyid)) {
-    return false;
-  }
-
   bool ok{false};
   value::Value result;
 
-#define DO_LERP(__ty) \
-  if (tyid == value::TypeTraits<__ty>::type_id()) { \
-    const __ty *v0 = a.as<__ty>(); \
-    const __ty *v1 = b.as<__ty>(); \
-    __ty c; \
-    if (v0 && v1) { \
-      c = lerp(*v0, *v1, dt); \
-      result = c; \
-      ok = true; \
-    } \
-  } else if (tyid == value::TypeTraits<std::vector<__ty>>::type_id()) { \
-    const std::vector<__ty> *v0 = a.as<std::vector<__ty>>(); \
-    const std::vector<__ty> *v1 = b.as<std::vector<__ty>>(); \
-    std::vector<__ty> c; \
-    if (v0 && v1) { \
-      c = lerp(*v0, *v1, dt); \
-      result = c; \
-      ok = true; \
-    } \
-  } else
-
-  DO_LERP(value::half)
-  DO_LERP(value::half2)
-  DO_LERP(value::half3)
-  DO_LERP(value::half4)
-  DO_LERP(float)
-  DO_LERP(value::float2)
-  DO_LERP(value::float3)
-  DO_LERP(value::float4)
-  DO_LERP(double)
-  DO_LERP(value::double2)
-  DO_LERP(value::double3)
-  DO_LERP(value::double4)
-  DO_LERP(value::quath)
-  DO_LERP(value::quatf)
-  DO_LERP(value::quatd)
-  DO_LERP(value::color3h)
-  DO_LERP(value::color3f)
-  DO_LERP(value::color3d)
-  DO_LERP(value::color4h)
-  DO_LERP(value::color4f)
-  DO_LERP(value::color4d)
-  DO_LERP(value::point3h)
-  DO_LERP(value::point3f)
-  DO_LERP(value::point3d)
-  DO_LERP(value::normal3h)
-  DO_LERP(value::normal3f)
-  DO_LERP(value::normal3d)
-  DO_LERP(value::vector3h)
-  DO_LERP(value::vector3f)
-  DO_LERP(value::vector3d)
-  DO_LERP(value::texcoord2h)
-  DO_LERP(value::texcoord2f)
-  DO_LERP(value::texcoord2d)
-  DO_LERP(value::texcoord3h)
-  DO_LERP(value::texcoord3f)
-  DO_LERP(value::texcoord3d)
-  {
-    DCOUT("TODO: type " << GetTypeName(tyid));
+  if (!LerpDispatcher::dispatch(a.type_id(), &ok, a, b, dt, &result)) {
+    DCOUT("TODO: type " << GetTypeName(a.type_id()));
+    return false;
   }
 
-#undef DO_LERP
-
   if (ok) {
-    (*dst) = result;
+    (*dst) = std::move(result);
   }
 
   return ok;
@@ -1077,34 +979,27 @@ bool FlexibleTypeCast(const value::Value &src, value::Value &dst) {
 #endif
 
 bool TimeSamples::has_sample_at(const double t) const {
+  size_t idx;
+  return find_sample_at(t, &idx);
+}
+
+bool TimeSamples::find_sample_at(const double t, size_t *idx) const {
   if (_dirty) {
     update();
   }
 
-  const auto it = std::find_if(_samples.begin(), _samples.end(), [&t](const Sample &s) {
-    return math::is_close(t, s.t);
+  const auto it = std::find_if(_times.begin(), _times.end(), [&t](const double st) {
+    return math::is_close(t, st);
   });
 
-  return (it != _samples.end());
-}
-
-bool TimeSamples::get_sample_at(const double t, Sample **dst) {
-  if (!dst) {
+  if (it == _times.end()) {
     return false;
   }
 
-  if (_dirty) {
-    update();
+  if (idx) {
+    (*idx) = size_t(std::distance(_times.begin(), it));
   }
-
-  const auto it = std::find_if(_samples.begin(), _samples.end(), [&t](const Sample &sample) {
-    return math::is_close(t, sample.t);
-  });
-
-  if (it != _samples.end()) {
-    (*dst) = &(*it); 
-  }
-  return false;
+  return true;
 }
 
 }  // namespace value
@@ -2002,6 +2002,42 @@ bool IsRoleType(const uint32_t tyid);
 namespace tinyusdz {
 namespace value {
 
+///
+/// Read-only view of a contiguous array(e.g. `T[]` value stored in Value,
+/// Attribute or TimeSamples). No copy is involved.
+///
+/// ArrayView does not own the data. It is valid as long as the storage it
+/// points to is alive and not modified.
+///
+template <typename T>
+class ArrayView {
+ public:
+  using value_type = T;
+  using const_iterator = const T *;
+
+  ArrayView() = default;
+
+  ArrayView(const T *data, size_t n) : _data(data), _size(n) {}
+
+  ArrayView(const std::vector<T> &v) : _data(v.data()), _size(v.size()) {}
+
+  const T *data() const { return _data; }
+  size_t size() const { return _size; }
+  bool empty() const { return _size == 0; }
+
+  const T &operator[](size_t idx) const { return _data[idx]; }
+
+  const_iterator begin() const { return _data; }
+  const_iterator end() const { return _data + _size; }
+
+  // Copy the content to std::vector.
+  std::vector<T> to_vector() const { return std::vector<T>(begin(), end()); }
+
+ private:
+  const T *_data{nullptr};
+  size_t _size{0};
+};
+
 ///
 /// Generic Value class using any
 /// TODO: Type-check when casting with underlying_type(Need to modify linb::any
@@ -2014,8 +2050,13 @@ class Value {
   template <class T>
   Value(const T &v) : v_(v) {}
 
-  // template <class T>
-  // Value(T &&v) : v_(v) {}
+  // Move `v` into Value(e.g. large arrays and Prim classes).
+  // Only enabled for rvalue so that it does not hijack copy construction.
+  template <class T,
+            typename = typename std::enable_if<
+                !std::is_lvalue_reference<T>::value &&
+                !std::is_same<typename std::decay<T>::type, Value>::value>::type>
+  Value(T &&v) : v_(std::move(v)) {}
 
   const std::string type_name() const { return v_.type_name(); }
   const std::string underlying_type_name() const {
@@ -2112,6 +2153,18 @@ class Value {
     return nonstd::nullopt;
   }
 
+  // Zero-copy access to the array value(`T[]`).
+  // Casting among role type and underlying type is supported as in `as()`.
+  //
+  // Return nullopt when the value is not an array of type T.
+  template <class T>
+  nonstd::optional<ArrayView<T>> get_array_view(bool strict_cast = false) const {
+    if (const std::vector<T> *pv = as<std::vector<T>>(strict_cast)) {
+      return ArrayView<T>(*pv);
+    }
+    return nonstd::nullopt;
+  }
+
 
   template <class T>
   Value &operator=(const T &v) {
@@ -2254,47 +2307,115 @@ bool Lerp(const value::Value &a, const value::Value &b, double dt,
 
 
 
-// Handy, but may not be efficient for large time samples(e.g. 1M samples or
-// more)
+///
+/// Compute the permutation which sorts `times` in ascending order.
+/// Samples with the same time keep their insertion order.
+///
+/// @return false when `times` is already sorted(`order` is not modified).
+///
+inline bool ComputeTimeSampleOrder(const std::vector<double> &times,
+                                   std::vector<size_t> *order) {
+  if (std::is_sorted(times.begin(), times.end())) {
+    return false;
+  }
+
+  order->resize(times.size());
+  for (size_t i = 0; i < times.size(); i++) {
+    (*order)[i] = i;
+  }
+
+  std::stable_sort(order->begin(), order->end(),
+                   [&times](size_t a, size_t b) { return times[a] < times[b]; });
+
+  return true;
+}
+
+///
+/// Reorder the elements of `v` with the permutation computed by ComputeTimeSampleOrder.
+///
+template <typename C>
+inline void ApplyTimeSampleOrder(const std::vector<size_t> &order, C *v) {
+  C dst;
+  dst.reserve(order.size());
+  for (size_t idx : order) {
+    dst.push_back(std::move((*v)[idx]));
+  }
+  (*v) = std::move(dst);
+}
+
+///
+/// Cursor for sequential TimeSamples evaluation.
+///
+/// Remembers the last bracketing interval, so evaluating with monotonically
+/// increasing time(e.g. playback, baking) does not need a binary search for
+/// each call. The cursor is only a hint and it is safe to keep using it after
+/// TimeSamples are modified.
+///
+struct TimeSampleCursor {
+  size_t index{0};
+};
+
+//
+// TimeSamples are stored in struct-of-arrays layout: sorted `times`, blocked
+// flags(bitset) and type-erased values, so the time lookup only touches a
+// contiguous `double` array.
+//
+// Each value is still held by `value::Value`(linb::any), so a sample with a
+// large value(e.g. array) requires a heap allocation. Use TypedTimeSamples<T>
+// to store typed values in a single contiguous buffer.
 //
 // For the runtime speed, with "-O2 -g" optimization, adding 10M `double`
 // samples to linb::any takes roughly 1.8 ms on Threadripper 1950X, whereas
 // simple vector<double> push_back takes 390 us(roughly x4 times faster). (Build
 // benchmarks to see the numbers on your CPU)
 //
-// We assume having large time samples is rare situlation, and above benchmark
-// speed is acceptable in general  usecases.
-//
-// `None`(ValueBlock) is represented by setting `Sample::blocked` true.
+// `None`(ValueBlock) is represented by setting the blocked flag true.
 //
 struct TimeSamples {
+  // Materialized sample. Only used for the interface.
   struct Sample {
     double t;
     value::Value value;
     bool blocked{false};
   };
 
-  bool empty() const { return _samples.empty(); }
+  bool empty() const { return _times.empty(); }
 
-  size_t size() const { return _samples.size(); }
+  size_t size() const { return _times.size(); }
 
   void clear() {
-    _samples.clear();
-    _dirty = true;
+    _times.clear();
+    _values.clear();
+    _blocked.clear();
+    _dirty = false;
+  }
+
+  void reserve(size_t n) {
+    _times.reserve(n);
+    _values.reserve(n);
+    _blocked.reserve(n);
   }
 
   void update() const {
-    std::sort(_samples.begin(), _samples.end(),
-              [](const Sample &a, const Sample &b) { return a.t < b.t; });
+    std::vector<size_t> order;
+    if (ComputeTimeSampleOrder(_times, &order)) {
+      ApplyTimeSampleOrder(order, &_times);
+      ApplyTimeSampleOrder(order, &_values);
+      ApplyTimeSampleOrder(order, &_blocked);
+    }
 
     _dirty = false;
   }
 
   bool has_sample_at(const double t) const;
-  bool get_sample_at(const double t, Sample **s);
+
+  ///
+  /// Find the index of the sample at time `t`.
+  ///
+  bool find_sample_at(const double t, size_t *idx) const;
 
   nonstd::optional<double> get_time(size_t idx) const {
-    if (idx >= _samples.size()) {
+    if (idx >= _times.size()) {
       return nonstd::nullopt;
     }
 
@@ -2302,11 +2423,11 @@ struct TimeSamples {
       update();
     }
 
-    return _samples[idx].t;
+    return _times[idx];
   }
 
   nonstd::optional<value::Value> get_value(size_t idx) const {
-    if (idx >= _samples.size()) {
+    if (idx >= _values.size()) {
       return nonstd::nullopt;
     }
 
@@ -2314,68 +2435,160 @@ struct TimeSamples {
       update();
     }
 
-    return _samples[idx].value;
+    return _values[idx];
+  }
+
+  bool is_blocked(size_t idx) const {
+    if (idx >= _blocked.size()) {
+      return false;
+    }
+
+    if (_dirty) {
+      update();
+    }
+
+    return _blocked[idx];
+  }
+
+  // Sorted time array.
+  const std::vector<double> &get_times() const {
+    if (_dirty) {
+      update();
+    }
+    return _times;
+  }
+
+  // Values in the order of `get_times()`.
+  const std::vector<value::Value> &get_values() const {
+    if (_dirty) {
+      update();
+    }
+    return _values;
   }
 
   uint32_t type_id() const {
-    if (_samples.size()) {
+    if (_values.size()) {
       if (_dirty) {
         update();
       }
-      return _samples[0].value.type_id();
+      return _values[0].type_id();
     } else {
       return value::TypeId::TYPE_ID_INVALID;
     }
   }
 
   std::string type_name() const {
-    if (_samples.size()) {
+    if (_values.size()) {
       if (_dirty) {
         update();
       }
-      return _samples[0].value.type_name();
+      return _values[0].type_name();
     } else {
       return std::string();
     }
   }
 
   void add_sample(const Sample &s) {
-    _samples.push_back(s);
+    _times.push_back(s.t);
+    _values.push_back(s.value);
+    _blocked.push_back(s.blocked);
     _dirty = true;
   }
 
   void add_sample(double t, const value::Value &v) {
-    Sample s;
-    s.t = t;
-    s.value = v;
-    s.blocked = false;
-    _samples.push_back(s);
+    _times.push_back(t);
+    _values.push_back(v);
+    _blocked.push_back(false);
+    _dirty = true;
+  }
+
+  void add_sample(double t, value::Value &&v) {
+    _times.push_back(t);
+    _values.emplace_back(std::move(v));
+    _blocked.push_back(false);
     _dirty = true;
   }
 
   // We still need "dummy" value for type_name() and type_id()
   void add_blocked_sample(double t, const value::Value &v) {
-    Sample s;
-    s.t = t;
-    s.value = v;
-    s.blocked = true;
-
-    _samples.emplace_back(s);
+    _times.push_back(t);
+    _values.push_back(v);
+    _blocked.push_back(true);
     _dirty = true;
   }
 
-  const std::vector<Sample> &get_samples() const {
+  ///
+  /// Materialize samples(compatibility helper).
+  /// NOTE: Returns by value, and copies every sample value. Use get_times(),
+  /// get_values() and is_blocked() to access samples without copying.
+  ///
+  std::vector<Sample> get_samples() const {
     if (_dirty) {
       update();
     }
-    return _samples;
+
+    std::vector<Sample> samples(_times.size());
+    for (size_t i = 0; i < _times.size(); i++) {
+      samples[i].t = _times[i];
+      samples[i].value = _values[i];
+      samples[i].blocked = _blocked[i];
+    }
+    return samples;
   }
 
-  std::vector<Sample> &samples() {
+  // Upper bound index of `t` in the sorted times array.
+  size_t upper_bound_index(const double t) const {
     if (_dirty) {
       update();
     }
-    return _samples;
+    return size_t(std::distance(_times.begin(), std::upper_bound(_times.begin(), _times.end(), t)));
+  }
+
+  // Lower bound index of `t` in the sorted times array.
+  size_t lower_bound_index(const double t) const {
+    if (_dirty) {
+      update();
+    }
+    return size_t(std::distance(_times.begin(), std::lower_bound(_times.begin(), _times.end(), t)));
+  }
+
+  ///
+  /// Zero-copy access to the array value(`T[]`) at specified time.
+  ///
+  /// Only succeeds when the value at `t` is one of the stored samples(Held
+  /// interpolation, non-interpolatable type, or `t` is on/outside of the
+  /// sample times). Returns false when the value needs to be interpolated, so
+  /// use get() in that case.
+  ///
+  template <typename T>
+  bool get_array_view(ArrayView<T> *dst, double t = value::TimeCode::Default(),
+                      TimeSampleInterpolationType interp =
+                          TimeSampleInterpolationType::Linear) const {
+    if (!dst || empty()) {
+      return false;
+    }
+
+    if (_dirty) {
+      update();
+    }
+
+    size_t idx = 0;
+    if (!value::TimeCode(t).is_default()) {
+      idx = upper_bound_index(t);
+      idx = (idx == 0) ? 0 : (idx - 1);
+
+      if ((interp == TimeSampleInterpolationType::Linear) &&
+          value::LerpTraits<std::vector<T>>::supported() &&
+          ((idx + 1) < _times.size()) && (t > _times[idx])) {
+        return false;
+      }
+    }
+
+    if (auto pv = _values[idx].get_array_view<T>()) {
+      (*dst) = pv.value();
+      return true;
+    }
+    return false;
   }
 
 #if 1  // TODO: Write implementation in .cc
@@ -2404,32 +2617,30 @@ struct TimeSamples {
         update();
       }
 
+      // Read through const Value so that array values stay shared(copy-on-write).
+      const std::vector<value::Value> &values = _values;
+
       if (value::TimeCode(t).is_default()) {
         // TODO: Handle bloked
-        if (const auto pv = _samples[0].value.as<T>()) {
+        if (const auto pv = values[0].as<T>()) {
           (*dst) = *pv;
           return true;
         }
         return false;
       } else {
 
-        if (_samples.size() == 1) {
-          if (const auto pv = _samples[0].value.as<T>()) {
+        if (values.size() == 1) {
+          if (const auto pv = values[0].as<T>()) {
             (*dst) = *pv;
             return true;
           }
           return false;
         }
 
-        auto it = std::upper_bound(
-          _samples.begin(), _samples.end(), t,
-          [](double tval, const Sample &a) { return tval < a.t; });
+        size_t idx = upper_bound_index(t);
+        idx = (idx == 0) ? 0 : (idx - 1);
 
-        const auto it_minus_1 = (it == _samples.begin()) ? _samples.begin() : (it - 1);
-
-        const value::Value &v = it_minus_1->value;
-
-        if (const T *pv = v.as<T>()) {
+        if (const T *pv = values[idx].as<T>()) {
           (*dst) = *pv;
           return true;
         }
@@ -2456,44 +2667,35 @@ struct TimeSamples {
       update();
     }
 
+    // Read through const Value so that array values stay shared(copy-on-write).
+    const std::vector<value::Value> &values = _values;
+
     if (value::TimeCode(t).is_default()) {
       // FIXME: Use the first item for now.
       // TODO: Handle bloked
-      if (const auto pv = _samples[0].value.as<T>()) {
+      if (const auto pv = values[0].as<T>()) {
         (*dst) = *pv;
         return true;
       }
       return false;
     } else {
 
-      if (_samples.size() == 1) {
-        if (const auto pv = _samples[0].value.as<T>()) {
+      if (values.size() == 1) {
+        if (const auto pv = values[0].as<T>()) {
           (*dst) = *pv;
           return true;
         }
-        return true;
+        return false;
       }
 
       if (interp == TimeSampleInterpolationType::Linear) {
-        auto it = std::lower_bound(
-            _samples.begin(), _samples.end(), t,
-            [](const Sample &a, double tval) { return a.t < tval; });
-
+        size_t idx = lower_bound_index(t);
 
-        // MS STL does not allow seek vector iterator before begin
-        // Issue #110
-        const auto it_minus_1 = (it == _samples.begin()) ? _samples.begin() : (it - 1);
+        size_t idx0 = (std::min)(_times.size() - 1, (idx == 0) ? 0 : (idx - 1));
+        size_t idx1 = (std::min)(_times.size() - 1, idx0 + 1);
 
-        size_t idx0 = size_t(std::max(
-            int64_t(0),
-            std::min(int64_t(_samples.size() - 1),
-                     int64_t(std::distance(_samples.begin(), it_minus_1)))));
-        size_t idx1 =
-            size_t(std::max(int64_t(0), std::min(int64_t(_samples.size() - 1),
-                                                 int64_t(idx0) + 1)));
-
-        double tl = _samples[idx0].t;
-        double tu = _samples[idx1].t;
+        double tl = _times[idx0];
+        double tu = _times[idx1];
 
         double dt = (t - tl);
         if (std::fabs(tu - tl) < std::numeric_limits<double>::epsilon()) {
@@ -2506,8 +2708,8 @@ struct TimeSamples {
         // Just in case.
         dt = std::max(0.0, std::min(1.0, dt));
 
-        const value::Value &p0 = _samples[idx0].value;
-        const value::Value &p1 = _samples[idx1].value;
+        const value::Value &p0 = _values[idx0];
+        const value::Value &p1 = _values[idx1];
 
         value::Value p;
         if (!Lerp(p0, p1, dt, &p)) {
@@ -2521,15 +2723,10 @@ struct TimeSamples {
         return false;
       } else {
         // Held
-        auto it = std::upper_bound(
-          _samples.begin(), _samples.end(), t,
-          [](double tval, const Sample &a) { return tval < a.t; });
-
-        const auto it_minus_1 = (it == _samples.begin()) ? _samples.begin() : (it - 1);
-
-        const value::Value &v = it_minus_1->value;
+        size_t idx = upper_bound_index(t);
+        idx = (idx == 0) ? 0 : (idx - 1);
 
-        if (const T *pv = v.as<T>()) {
+        if (const T *pv = values[idx].as<T>()) {
           (*dst) = *pv;
           return true;
         }
@@ -2543,7 +2740,10 @@ struct TimeSamples {
 #endif
 
  private:
-  mutable std::vector<Sample> _samples;
+  // Need to be sorted when looking up the value.
+  mutable std::vector<double> _times;
+  mutable std::vector<value::Value> _values;
+  mutable std::vector<bool> _blocked;
   mutable bool _dirty{false};
 };
 
@@ -13,11 +13,26 @@
 #pragma clang diagnostic pop
 #endif
 
+#if defined(__AVX__)
+#include <immintrin.h>
+#endif
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && (_M_IX86_FP >= 2))
+#include <emmintrin.h>
+#define TINYUSDZ_XFORM_USE_SSE2
+#endif
+
+#if (defined(__ARM_NEON) || defined(__ARM_NEON__)) && defined(__aarch64__)
+#include <arm_neon.h>
+#define TINYUSDZ_XFORM_USE_NEON
+#endif
+
 #include "math-util.inc"
 #include "pprinter.hh"
 #include "value-pprint.hh"
 #include "prim-types.hh"
 #include "tiny-format.hh"
+#include "value-eval-util.hh"
 #include "value-types.hh"
 #include "xform.hh"
 #include "common-macros.inc"
@@ -623,555 +638,796 @@ class XformEvaluator {
   value::matrix4d m;
 };
 
-}  // namespace
+std::string XformOpName(const XformOp &x) {
+  if (x.suffix.empty()) {
+    return to_string(x.op_type);
+  }
+  return fmt::format("{}:{}", to_string(x.op_type), x.suffix);
+}
 
-bool Xformable::EvaluateXformOps(double t,
-                                 value::TimeSampleInterpolationType tinterp,
-                                 value::matrix4d *out_matrix,
-                                 bool *resetXformStack,
-                                 std::string *err) const {
-  const auto RotateABC =
-      [](const XformOp &x) -> nonstd::expected<value::matrix4d, std::string> {
-    value::double3 v;
-    if (auto h = x.get_value<value::half3>()) {
-      v[0] = double(half_to_float(h.value()[0]));
-      v[1] = double(half_to_float(h.value()[1]));
-      v[2] = double(half_to_float(h.value()[2]));
-    } else if (auto f = x.get_value<value::float3>()) {
-      v[0] = double(f.value()[0]);
-      v[1] = double(f.value()[1]);
-      v[2] = double(f.value()[2]);
-    } else if (auto d = x.get_value<value::double3>()) {
-      v = d.value();
-    } else {
-      if (x.suffix.empty()) {
-        return nonstd::make_unexpected(
-            fmt::format("`{}` is not half3, float3 or double3 type.\n",
-                        to_string(x.op_type)));
-      } else {
-        return nonstd::make_unexpected(
-            fmt::format("`{}:{}` is not half3, float3 or double3 type.\n",
-                        to_string(x.op_type), x.suffix));
-      }
-    }
+value::double3 ToDouble3(const value::half3 &v) {
+  return {double(half_to_float(v[0])), double(half_to_float(v[1])),
+          double(half_to_float(v[2]))};
+}
 
-    // invert input, and compute concatenated matrix
-    // inv(ABC) = inv(A) x inv(B) x inv(C)
-    // as done in pxrUSD.
+value::double3 ToDouble3(const value::float3 &v) {
+  return {double(v[0]), double(v[1]), double(v[2])};
+}
 
-    if (x.inverted) {
-      v[0] = -v[0];
-      v[1] = -v[1];
-      v[2] = -v[2];
+value::double3 ToDouble3(const value::double3 &v) { return v; }
+
+double ToDouble(const value::half &v) { return double(half_to_float(v)); }
+double ToDouble(const float v) { return double(v); }
+double ToDouble(const double v) { return v; }
+
+value::matrix4d ToMatrix4d(const value::matrix4f &mf) {
+  value::matrix4d m;
+  for (size_t j = 0; j < 4; j++) {
+    for (size_t k = 0; k < 4; k++) {
+      m.m[j][k] = double(mf.m[j][k]);
     }
+  }
+  return m;
+}
 
-    double xAngle = v[0];
-    double yAngle = v[1];
-    double zAngle = v[2];
+value::matrix4d ToMatrix4d(const value::matrix4d &m) { return m; }
+
+// invert input, and compute concatenated matrix
+// inv(ABC) = inv(A) x inv(B) x inv(C)
+// as done in pxrUSD.
+bool RotateABCMatrix(const XformOp::OpType op_type, const bool inverted,
+                     value::double3 v, value::matrix4d *m) {
+  if (inverted) {
+    v[0] = -v[0];
+    v[1] = -v[1];
+    v[2] = -v[2];
+  }
 
-    XformEvaluator eval;
+  double xAngle = v[0];
+  double yAngle = v[1];
+  double zAngle = v[2];
 
-    DCOUT("angles = " << xAngle << ", " << yAngle << ", " << zAngle);
-    if (x.inverted) {
-      DCOUT("!inverted!\n");
-      if (x.op_type == XformOp::OpType::RotateXYZ) {
-        // TODO: Apply defined switch for all Rotate*** op.
+  XformEvaluator eval;
+
+  DCOUT("angles = " << xAngle << ", " << yAngle << ", " << zAngle);
+  if (inverted) {
+    DCOUT("!inverted!\n");
+    if (op_type == XformOp::OpType::RotateXYZ) {
+      // TODO: Apply defined switch for all Rotate*** op.
 #if defined(PXR_COMPATIBLE_ROTATE_MATRIX_GENERATION)
-        eval.Rotation({0.0, 0.0, 1.0}, zAngle);
-        eval.Rotation({0.0, 1.0, 0.0}, yAngle);
-        eval.Rotation({1.0, 0.0, 0.0}, xAngle);
+      eval.Rotation({0.0, 0.0, 1.0}, zAngle);
+      eval.Rotation({0.0, 1.0, 0.0}, yAngle);
+      eval.Rotation({1.0, 0.0, 0.0}, xAngle);
 #else
-        eval.RotateZ(zAngle);
-        eval.RotateY(yAngle);
-        eval.RotateX(xAngle);
+      eval.RotateZ(zAngle);
+      eval.RotateY(yAngle);
+      eval.RotateX(xAngle);
 #endif
-      } else if (x.op_type == XformOp::OpType::RotateXZY) {
+    } else if (op_type == XformOp::OpType::RotateXZY) {
 #if defined(PXR_COMPATIBLE_ROTATE_MATRIX_GENERATION)
-        eval.Rotation({0.0, 1.0, 0.0}, yAngle);
-        eval.Rotation({0.0, 0.0, 1.0}, zAngle);
-        eval.Rotation({1.0, 0.0, 0.0}, xAngle);
+      eval.Rotation({0.0, 1.0, 0.0}, yAngle);
+      eval.Rotation({0.0, 0.0, 1.0}, zAngle);
+      eval.Rotation({1.0, 0.0, 0.0}, xAngle);
 #else
-        eval.RotateY(yAngle);
-        eval.RotateZ(zAngle);
-        eval.RotateX(xAngle);
+      eval.RotateY(yAngle);
+      eval.RotateZ(zAngle);
+      eval.RotateX(xAngle);
 #endif
-      } else if (x.op_type == XformOp::OpType::RotateYXZ) {
+    } else if (op_type == XformOp::OpType::RotateYXZ) {
 #if defined(PXR_COMPATIBLE_ROTATE_MATRIX_GENERATION)
-        eval.Rotation({0.0, 0.0, 1.0}, zAngle);
-        eval.Rotation({1.0, 0.0, 0.0}, xAngle);
-        eval.Rotation({0.0, 1.0, 0.0}, yAngle);
+      eval.Rotation({0.0, 0.0, 1.0}, zAngle);
+      eval.Rotation({1.0, 0.0, 0.0}, xAngle);
+      eval.Rotation({0.0, 1.0, 0.0}, yAngle);
 #else
-        eval.RotateZ(zAngle);
-        eval.RotateX(xAngle);
-        eval.RotateY(yAngle);
+      eval.RotateZ(zAngle);
+      eval.RotateX(xAngle);
+      eval.RotateY(yAngle);
 #endif
-      } else if (x.op_type == XformOp::OpType::RotateYZX) {
+    } else if (op_type == XformOp::OpType::RotateYZX) {
 #if defined(PXR_COMPATIBLE_ROTATE_MATRIX_GENERATION)
-        eval.Rotation({1.0, 0.0, 0.0}, xAngle);
-        eval.Rotation({0.0, 0.0, 1.0}, zAngle);
-        eval.Rotation({0.0, 1.0, 0.0}, yAngle);
+      eval.Rotation({1.0, 0.0, 0.0}, xAngle);
+      eval.Rotation({0.0, 0.0, 1.0}, zAngle);
+      eval.Rotation({0.0, 1.0, 0.0}, yAngle);
 #else
-        eval.RotateX(xAngle);
-        eval.RotateZ(zAngle);
-        eval.RotateY(yAngle);
+      eval.RotateX(xAngle);
+      eval.RotateZ(zAngle);
+      eval.RotateY(yAngle);
 #endif
-      } else if (x.op_type == XformOp::OpType::RotateZYX) {
+    } else if (op_type == XformOp::OpType::RotateZYX) {
 #if defined(PXR_COMPATIBLE_ROTATE_MATRIX_GENERATION)
-        eval.Rotation({1.0, 0.0, 0.0}, xAngle);
-        eval.Rotation({0.0, 1.0, 0.0}, yAngle);
-        eval.Rotation({0.0, 0.0, 1.0}, zAngle);
+      eval.Rotation({1.0, 0.0, 0.0}, xAngle);
+      eval.Rotation({0.0, 1.0, 0.0}, yAngle);
+      eval.Rotation({0.0, 0.0, 1.0}, zAngle);
 #else
-        eval.RotateX(xAngle);
-        eval.RotateY(yAngle);
-        eval.RotateZ(zAngle);
+      eval.RotateX(xAngle);
+      eval.RotateY(yAngle);
+      eval.RotateZ(zAngle);
 #endif
-      } else if (x.op_type == XformOp::OpType::RotateZXY) {
+    } else if (op_type == XformOp::OpType::RotateZXY) {
 #if defined(PXR_COMPATIBLE_ROTATE_MATRIX_GENERATION)
-        eval.Rotation({0.0, 1.0, 0.0}, yAngle);
-        eval.Rotation({1.0, 0.0, 0.0}, xAngle);
-        eval.Rotation({0.0, 0.0, 1.0}, zAngle);
+      eval.Rotation({0.0, 1.0, 0.0}, yAngle);
+      eval.Rotation({1.0, 0.0, 0.0}, xAngle);
+      eval.Rotation({0.0, 0.0, 1.0}, zAngle);
 #else
-        eval.RotateY(yAngle);
-        eval.RotateX(xAngle);
-        eval.RotateZ(zAngle);
+      eval.RotateY(yAngle);
+      eval.RotateX(xAngle);
+      eval.RotateZ(zAngle);
 #endif
-      } else {
-        /// ???
-        return nonstd::make_unexpected("[InternalError] RotateABC");
-      }
     } else {
-      if (x.op_type == XformOp::OpType::RotateXYZ) {
-
+      /// ???
+      return false;
+    }
+  } else {
+    if (op_type == XformOp::OpType::RotateXYZ) {
 #if defined(PXR_COMPATIBLE_ROTATE_MATRIX_GENERATION)
-        eval.Rotation({1.0, 0.0, 0.0}, xAngle);
-        eval.Rotation({0.0, 1.0, 0.0}, yAngle);
-        eval.Rotation({0.0, 0.0, 1.0}, zAngle);
+      eval.Rotation({1.0, 0.0, 0.0}, xAngle);
+      eval.Rotation({0.0, 1.0, 0.0}, yAngle);
+      eval.Rotation({0.0, 0.0, 1.0}, zAngle);
 #else
-        eval.RotateX(xAngle);
-        eval.RotateY(yAngle);
-        eval.RotateZ(zAngle);
+      eval.RotateX(xAngle);
+      eval.RotateY(yAngle);
+      eval.RotateZ(zAngle);
 #endif
-      } else if (x.op_type == XformOp::OpType::RotateXZY) {
+    } else if (op_type == XformOp::OpType::RotateXZY) {
 #if defined(PXR_COMPATIBLE_ROTATE_MATRIX_GENERATION)
-        eval.Rotation({1.0, 0.0, 0.0}, xAngle);
-        eval.Rotation({0.0, 0.0, 1.0}, zAngle);
-        eval.Rotation({0.0, 1.0, 0.0}, yAngle);
+      eval.Rotation({1.0, 0.0, 0.0}, xAngle);
+      eval.Rotation({0.0, 0.0, 1.0}, zAngle);
+      eval.Rotation({0.0, 1.0, 0.0}, yAngle);
 #else
-        eval.RotateX(xAngle);
-        eval.RotateZ(zAngle);
-        eval.RotateY(yAngle);
+      eval.RotateX(xAngle);
+      eval.RotateZ(zAngle);
+      eval.RotateY(yAngle);
 #endif
-      } else if (x.op_type == XformOp::OpType::RotateYXZ) {
+    } else if (op_type == XformOp::OpType::RotateYXZ) {
 #if defined(PXR_COMPATIBLE_ROTATE_MATRIX_GENERATION)
-        eval.Rotation({0.0, 1.0, 0.0}, yAngle);
-        eval.Rotation({1.0, 0.0, 0.0}, xAngle);
-        eval.Rotation({0.0, 0.0, 1.0}, zAngle);
+      eval.Rotation({0.0, 1.0, 0.0}, yAngle);
+      eval.Rotation({1.0, 0.0, 0.0}, xAngle);
+      eval.Rotation({0.0, 0.0, 1.0}, zAngle);
 #else
-        eval.RotateY(yAngle);
-        eval.RotateX(xAngle);
-        eval.RotateZ(zAngle);
+      eval.RotateY(yAngle);
+      eval.RotateX(xAngle);
+      eval.RotateZ(zAngle);
 #endif
-      } else if (x.op_type == XformOp::OpType::RotateYZX) {
+    } else if (op_type == XformOp::OpType::RotateYZX) {
 #if defined(PXR_COMPATIBLE_ROTATE_MATRIX_GENERATION)
-        eval.Rotation({0.0, 1.0, 0.0}, yAngle);
-        eval.Rotation({0.0, 0.0, 1.0}, zAngle);
-        eval.Rotation({1.0, 0.0, 0.0}, xAngle);
+      eval.Rotation({0.0, 1.0, 0.0}, yAngle);
+      eval.Rotation({0.0, 0.0, 1.0}, zAngle);
+      eval.Rotation({1.0, 0.0, 0.0}, xAngle);
 #else
-        eval.RotateY(yAngle);
-        eval.RotateZ(zAngle);
-        eval.RotateX(xAngle);
+      eval.RotateY(yAngle);
+      eval.RotateZ(zAngle);
+      eval.RotateX(xAngle);
 #endif
-      } else if (x.op_type == XformOp::OpType::RotateZYX) {
+    } else if (op_type == XformOp::OpType::RotateZYX) {
 #if defined(PXR_COMPATIBLE_ROTATE_MATRIX_GENERATION)
-        eval.Rotation({0.0, 0.0, 1.0}, zAngle);
-        eval.Rotation({0.0, 1.0, 0.0}, yAngle);
-        eval.Rotation({1.0, 0.0, 0.0}, xAngle);
+      eval.Rotation({0.0, 0.0, 1.0}, zAngle);
+      eval.Rotation({0.0, 1.0, 0.0}, yAngle);
+      eval.Rotation({1.0, 0.0, 0.0}, xAngle);
 #else
-        eval.RotateZ(zAngle);
-        eval.RotateY(yAngle);
-        eval.RotateX(xAngle);
+      eval.RotateZ(zAngle);
+      eval.RotateY(yAngle);
+      eval.RotateX(xAngle);
 #endif
-      } else if (x.op_type == XformOp::OpType::RotateZXY) {
+    } else if (op_type == XformOp::OpType::RotateZXY) {
 #if defined(PXR_COMPATIBLE_ROTATE_MATRIX_GENERATION)
-        eval.Rotation({0.0, 0.0, 1.0}, zAngle);
-        eval.Rotation({1.0, 0.0, 0.0}, xAngle);
-        eval.Rotation({0.0, 1.0, 0.0}, yAngle);
+      eval.Rotation({0.0, 0.0, 1.0}, zAngle);
+      eval.Rotation({1.0, 0.0, 0.0}, xAngle);
+      eval.Rotation({0.0, 1.0, 0.0}, yAngle);
 #else
-        eval.RotateZ(zAngle);
-        eval.RotateX(xAngle);
-        eval.RotateY(yAngle);
+      eval.RotateZ(zAngle);
+      eval.RotateX(xAngle);
+      eval.RotateY(yAngle);
 #endif
-      } else {
-        /// ???
-        return nonstd::make_unexpected("[InternalError] RotateABC");
+    } else {
+      /// ???
+      return false;
+    }
+  }
+
+  (*m) = eval.m;
+  return true;
+}
+
+//
+// Compute the matrix of a single xformOp from its resolved value.
+//
+
+// translate, scale, rotateXYZ, ...
+bool ComputeXformOpMatrix(const XformOp &x, const value::double3 &v,
+                          value::matrix4d *m, std::string *err) {
+  (*m) = value::matrix4d::identity();
+
+  if (x.op_type == XformOp::OpType::Translate) {
+    double s = x.inverted ? -1.0 : 1.0;
+    m->m[3][0] = s * v[0];
+    m->m[3][1] = s * v[1];
+    m->m[3][2] = s * v[2];
+  } else if (x.op_type == XformOp::OpType::Scale) {
+    if (x.inverted) {
+      // FIXME: Safe division
+      m->m[0][0] = 1.0 / v[0];
+      m->m[1][1] = 1.0 / v[1];
+      m->m[2][2] = 1.0 / v[2];
+    } else {
+      m->m[0][0] = v[0];
+      m->m[1][1] = v[1];
+      m->m[2][2] = v[2];
+    }
+  } else {
+    if (!RotateABCMatrix(x.op_type, x.inverted, v, m)) {
+      if (err) {
+        (*err) += "[InternalError] RotateABC\n";
       }
+      return false;
     }
+  }
 
-    return eval.result();
-  };
+  return true;
+}
 
-  // Concat matrices
-  //
-  // Matrix concatenation ordering is its appearance order(right to left)
-  // This is same with a notation in math equation: i.e,
-  //
-  // xformOpOrder = [A, B, C]
-  //
-  // M = A x B x C
-  //
-  // p' = A x B x C x p
-  //
-  // in post-multiply order.
-  //
-  // But in pre-multiply order system(pxrUSD and TinyUSDZ),
-  // C++ code is
-  //
-  // p' = p x C x B x A
-  //
-  //
-  value::matrix4d cm;
-  Identity(&cm);
+// rotateX, rotateY, rotateZ
+// FIXME: Validate ROTATE_X, _Y, _Z implementation
+bool ComputeXformOpMatrix(const XformOp &x, const double angle /* degrees */,
+                          value::matrix4d *m, std::string *err) {
+  (void)err;
 
-  for (size_t i = 0; i < xformOps.size(); i++) {
-    const auto x = xformOps[i];
+  XformEvaluator xe;
+  if (x.op_type == XformOp::OpType::RotateX) {
+#if defined(PXR_COMPATIBLE_ROTATE_MATRIX_GENERATION)
+    xe.Rotation({1.0, 0.0, 0.0}, angle);
+#else
+    xe.RotateX(angle);
+#endif
+  } else if (x.op_type == XformOp::OpType::RotateY) {
+#if defined(PXR_COMPATIBLE_ROTATE_MATRIX_GENERATION)
+    xe.Rotation({0.0, 1.0, 0.0}, angle);
+#else
+    xe.RotateY(angle);
+#endif
+  } else {
+#if defined(PXR_COMPATIBLE_ROTATE_MATRIX_GENERATION)
+    xe.Rotation({0.0, 0.0, 1.0}, angle);
+#else
+    xe.RotateZ(angle);
+#endif
+  }
+
+  (*m) = xe.m;
+  return true;
+}
 
-    value::matrix4d m;  // local matrix
-    Identity(&m);
+// orient
+bool ComputeXformOpMatrix(const XformOp &x, const value::matrix3d &rot,
+                          value::matrix4d *m, std::string *err) {
+  value::matrix3d rm = rot;
 
-    if (x.is_timesamples()) {
-      (void)t;
-      (void)tinterp;
+  // FIXME: invert before getting matrix.
+  if (x.inverted) {
+    value::matrix3d inv_rm;
+    if (!inverse(rm, inv_rm)) {
       if (err) {
-        (*err) += "TODO: xformOp property with timeSamples.\n";
+        (*err) += fmt::format("`{}` is singular and cannot be inverted.\n",
+                              XformOpName(x));
       }
       return false;
     }
 
-    switch (x.op_type) {
-      case XformOp::OpType::ResetXformStack: {
-        if (i != 0) {
-          if (err) {
-            (*err) +=
-                "!resetXformStack! should only appear at the first element of "
-                "xformOps\n";
-          }
-          return false;
-        }
+    rm = inv_rm;
+  }
 
-        // Notify resetting previous(parent node's) matrices
-        if (resetXformStack) {
-          (*resetXformStack) = true;
-        }
-        break;
-      }
-      case XformOp::OpType::Transform: {
-        if (auto sxf = x.get_value<value::matrix4f>()) {
-          value::matrix4f mf = sxf.value();
-          for (size_t j = 0; j < 4; j++) {
-            for (size_t k = 0; k < 4; k++) {
-              m.m[j][k] = double(mf.m[j][k]);
-            }
-          }
-        } else if (auto sxd = x.get_value<value::matrix4d>()) {
-          m = sxd.value();
-        } else {
-          if (err) {
-            (*err) += "`xformOp:transform` is not matrix4f or matrix4d type.\n";
-          }
-          return false;
-        }
+  (*m) = to_matrix(rm, {0.0, 0.0, 0.0});
+  return true;
+}
 
-        if (x.inverted) {
-          // Singular check.
-          // pxrUSD uses 1e-9
-          double det = determinant(m);
-
-          if (std::fabs(det) < 1e-9) {
-            if (err) {
-              if (x.suffix.empty()) {
-                (*err) +=
-                    "`xformOp:transform` is singular matrix and cannot be "
-                    "inverted.\n";
-              } else {
-                (*err) += fmt::format(
-                    "`xformOp:transform:{}` is singular matrix and cannot be "
-                    "inverted.\n",
-                    x.suffix);
-              }
-            }
-
-            return false;
-          }
-
-          m = inverse(m);
-        }
+// transform
+bool ComputeXformOpMatrix(const XformOp &x, const value::matrix4d &xf,
+                          value::matrix4d *m, std::string *err) {
+  if (x.inverted) {
+    // Singular check.
+    // pxrUSD uses 1e-9
+    double det = determinant(xf);
 
-        break;
+    if (std::fabs(det) < 1e-9) {
+      if (err) {
+        (*err) += fmt::format(
+            "`{}` is singular matrix and cannot be inverted.\n",
+            XformOpName(x));
       }
-      case XformOp::OpType::Scale: {
-        double sx, sy, sz;
-
-        if (auto sxh = x.get_value<value::half3>()) {
-          sx = double(half_to_float(sxh.value()[0]));
-          sy = double(half_to_float(sxh.value()[1]));
-          sz = double(half_to_float(sxh.value()[2]));
-        } else if (auto sxf = x.get_value<value::float3>()) {
-          sx = double(sxf.value()[0]);
-          sy = double(sxf.value()[1]);
-          sz = double(sxf.value()[2]);
-        } else if (auto sxd = x.get_value<value::double3>()) {
-          sx = sxd.value()[0];
-          sy = sxd.value()[1];
-          sz = sxd.value()[2];
-        } else {
-          if (err) {
-            (*err) += "`xformOp:scale` is not half3, float3 or double3 type.\n";
-          }
-          return false;
-        }
 
-        if (x.inverted) {
-          // FIXME: Safe division
-          sx = 1.0 / sx;
-          sy = 1.0 / sy;
-          sz = 1.0 / sz;
-        }
+      return false;
+    }
 
-        m.m[0][0] = sx;
-        m.m[1][1] = sy;
-        m.m[2][2] = sz;
+    (*m) = inverse(xf);
+  } else {
+    (*m) = xf;
+  }
 
-        break;
-      }
-      case XformOp::OpType::Translate: {
-        double tx, ty, tz;
-        if (auto txh = x.get_value<value::half3>()) {
-          tx = double(half_to_float(txh.value()[0]));
-          ty = double(half_to_float(txh.value()[1]));
-          tz = double(half_to_float(txh.value()[2]));
-        } else if (auto txf = x.get_value<value::float3>()) {
-          tx = double(txf.value()[0]);
-          ty = double(txf.value()[1]);
-          tz = double(txf.value()[2]);
-        } else if (auto txd = x.get_value<value::double3>()) {
-          tx = txd.value()[0];
-          ty = txd.value()[1];
-          tz = txd.value()[2];
-        } else {
-          if (err) {
-            (*err) +=
-                "`xformOp:translate` is not half3, float3 or double3 type.\n";
-          }
-          return false;
-        }
+  return true;
+}
 
-        if (x.inverted) {
-          tx = -tx;
-          ty = -ty;
-          tz = -tz;
-        }
+template <typename T>
+bool ComputeXformOpMatrixT(const XformOp &x, const T &v, value::matrix4d *m,
+                           std::string *err);
 
-        m.m[3][0] = tx;
-        m.m[3][1] = ty;
-        m.m[3][2] = tz;
+#define XFORMOP_MATRIX_T(__ty, __conv)                                     \
+  template <>                                                              \
+  bool ComputeXformOpMatrixT(const XformOp &x, const __ty &v,              \
+                             value::matrix4d *m, std::string *err) {       \
+    return ComputeXformOpMatrix(x, __conv(v), m, err);                     \
+  }
 
-        break;
+XFORMOP_MATRIX_T(value::half, ToDouble)
+XFORMOP_MATRIX_T(float, ToDouble)
+XFORMOP_MATRIX_T(double, ToDouble)
+XFORMOP_MATRIX_T(value::half3, ToDouble3)
+XFORMOP_MATRIX_T(value::float3, ToDouble3)
+XFORMOP_MATRIX_T(value::double3, ToDouble3)
+XFORMOP_MATRIX_T(value::quath, to_matrix3x3)
+XFORMOP_MATRIX_T(value::quatf, to_matrix3x3)
+XFORMOP_MATRIX_T(value::quatd, to_matrix3x3)
+XFORMOP_MATRIX_T(value::matrix4f, ToMatrix4d)
+XFORMOP_MATRIX_T(value::matrix4d, ToMatrix4d)
+
+#undef XFORMOP_MATRIX_T
+
+///
+/// Typed version of TimeSamples::get(). Does not allocate a temporary Value
+/// for interpolation. TimeSamples must be sorted(i.e. `update()` was called).
+///
+template <typename T>
+bool GetTimeSampleValue(const value::TimeSamples &ts, const double t,
+                        const value::TimeSampleInterpolationType tinterp,
+                        T *dst) {
+  const std::vector<double> &times = ts.get_times();
+  const std::vector<value::Value> &values = ts.get_values();
+
+  if (times.empty()) {
+    return false;
+  }
+
+  size_t idx0 = 0;
+  size_t idx1 = 0;
+  double dt = 0.0;
+
+  if (value::TimeCode(t).is_default() || (times.size() == 1)) {
+    // Use the first item.
+  } else if (tinterp == value::TimeSampleInterpolationType::Linear) {
+    size_t idx = size_t(std::distance(
+        times.begin(), std::lower_bound(times.begin(), times.end(), t)));
+
+    idx0 = (std::min)(times.size() - 1, (idx == 0) ? 0 : (idx - 1));
+    idx1 = (std::min)(times.size() - 1, idx0 + 1);
+
+    double tl = times[idx0];
+    double tu = times[idx1];
+
+    if (std::fabs(tu - tl) >= std::numeric_limits<double>::epsilon()) {
+      dt = (t - tl) / (tu - tl);
+    }
+    dt = (std::max)(0.0, (std::min)(1.0, dt));
+  } else {
+    // Held
+    size_t idx = size_t(std::distance(
+        times.begin(), std::upper_bound(times.begin(), times.end(), t)));
+    idx0 = (idx == 0) ? 0 : (idx - 1);
+    idx1 = idx0;
+  }
+
+  const T *p0 = values[idx0].as<T>();
+  if (!p0) {
+    return false;
+  }
+
+  if (idx0 == idx1) {
+    (*dst) = *p0;
+    return true;
+  }
+
+  const T *p1 = values[idx1].as<T>();
+  if (!p1) {
+    return false;
+  }
+
+  (*dst) = lerp(*p0, *p1, dt);
+  return true;
+}
+
+template <typename T>
+bool IsTimeSamplesOf(const value::TimeSamples &ts) {
+  for (const auto &v : ts.get_values()) {
+    if (!v.as<T>()) {
+      return false;
+    }
+  }
+  return true;
+}
+
+template <typename T>
+bool EvaluateInstruction(const XformOpProgram::Instruction &inst,
+                         const double t,
+                         const value::TimeSampleInterpolationType tinterp,
+                         value::matrix4d *m, std::string *err) {
+  T v{};
+  if (!GetTimeSampleValue(*inst.ts, t, tinterp, &v)) {
+    if (err) {
+      (*err) += fmt::format("Failed to evaluate timeSamples of `{}`.\n",
+                            XformOpName(*inst.op));
+    }
+    return false;
+  }
+
+  return ComputeXformOpMatrixT(*inst.op, v, m, err);
+}
+
+// Returns true when the value(default value or all timeSamples) of xformOp
+// is `T` type.
+template <typename T>
+bool IsXformOpValueOf(const XformOp &x) {
+  if (x.has_timesamples()) {
+    return IsTimeSamplesOf<T>(x.get_var().ts_raw());
+  }
+  return x.get_var().get_default_value<T>().has_value();
+}
+
+// Setup an instruction for the xformOp of `T` type. The matrix of constant
+// xformOp(or the `default` value of timeSampled xformOp) is computed here.
+template <typename T>
+bool CompileXformOp(const XformOp &x, const XformOpProgram::ValueType ty,
+                    XformOpProgram::Instruction *inst, std::string *err) {
+  inst->value_type = ty;
+  if (x.has_timesamples()) {
+    inst->ts = &x.get_var().ts_raw();
+
+    // Sort here so that evaluate() does not modify TimeSamples.
+    inst->ts->update();
+  }
+
+  if (auto v = x.get_var().get_default_value<T>()) {
+    inst->has_default = true;
+    return ComputeXformOpMatrixT(x, v.value(), &inst->matrix, err);
+  }
+
+  return true;
+}
+
+// Evaluate the matrix of xformOp of `T` type at time `t` without compiling
+// it(same result with CompileXformOp + XformOpProgram::evaluate).
+template <typename T>
+bool EvaluateXformOp(const XformOp &x, const double t,
+                     const value::TimeSampleInterpolationType tinterp,
+                     value::matrix4d *m, std::string *err) {
+  nonstd::optional<T> dv = x.get_var().get_default_value<T>();
+
+  if (x.has_timesamples() && !(dv && value::TimeCode(t).is_default())) {
+    T v{};
+    if (!GetTimeSampleValue(x.get_var().ts_raw(), t, tinterp, &v)) {
+      if (err) {
+        (*err) += fmt::format("Failed to evaluate timeSamples of `{}`.\n",
+                              XformOpName(x));
       }
-      // FIXME: Validate ROTATE_X, _Y, _Z implementation
-      case XformOp::OpType::RotateX: {
-        double angle;  // in degrees
-        if (auto h = x.get_value<value::half>()) {
-          angle = double(half_to_float(h.value()));
-        } else if (auto f = x.get_value<float>()) {
-          angle = double(f.value());
-        } else if (auto d = x.get_value<double>()) {
-          angle = d.value();
-        } else {
-          if (err) {
-            if (x.suffix.empty()) {
-              (*err) +=
-                  "`xformOp:rotateX` is not half, float or double type.\n";
-            } else {
-              (*err) += fmt::format(
-                  "`xformOp:rotateX:{}` is not half, float or double type.\n",
-                  x.suffix);
-            }
-          }
-          return false;
-        }
+      return false;
+    }
+    return ComputeXformOpMatrixT(x, v, m, err);
+  }
 
-        XformEvaluator xe;
-#if defined(PXR_COMPATIBLE_ROTATE_MATRIX_GENERATION)
-        xe.Rotation({1.0, 0.0, 0.0}, angle);
-#else
-        xe.RotateX(angle);
-#endif
-        auto ret = xe.result();
-
-        if (ret) {
-          m = ret.value();
-        } else {
-          if (err) {
-            (*err) += ret.error();
-          }
-          return false;
-        }
-        break;
+  if (!dv) {
+    return false;
+  }
+
+  return ComputeXformOpMatrixT(x, dv.value(), m, err);
+}
+
+template <typename T>
+struct XformOpValueTag {
+  using type = T;
+};
+
+// Find the value type of xformOp and call `fn(XformOpValueTag<T>(), ValueType)`.
+// Returns false(with an error message) when the value type is not valid for
+// the xformOp. `x` must not be !resetXformStack!.
+template <typename Fn>
+bool DispatchXformOpValueType(const XformOp &x, Fn &&fn, std::string *err) {
+  using ValueType = XformOpProgram::ValueType;
+
+  const char *type_names{""};
+
+#define DISPATCH_XFORMOP(__ty, __vty)                      \
+  if (IsXformOpValueOf<__ty>(x)) {                         \
+    return fn(XformOpValueTag<__ty>(), ValueType::__vty);  \
+  } else
+
+  switch (x.op_type) {
+    case XformOp::OpType::ResetXformStack: {
+      break;
+    }
+    case XformOp::OpType::Transform: {
+      DISPATCH_XFORMOP(value::matrix4f, Matrix4f)
+      DISPATCH_XFORMOP(value::matrix4d, Matrix4d) {
+        type_names = "matrix4f or matrix4d";
       }
-      case XformOp::OpType::RotateY: {
-        double angle;  // in degrees
-        if (auto h = x.get_value<value::half>()) {
-          angle = double(half_to_float(h.value()));
-        } else if (auto f = x.get_value<float>()) {
-          angle = double(f.value());
-        } else if (auto d = x.get_value<double>()) {
-          angle = d.value();
-        } else {
-          if (err) {
-            if (x.suffix.empty()) {
-              (*err) +=
-                  "`xformOp:rotateY` is not half, float or double type.\n";
-            } else {
-              (*err) += fmt::format(
-                  "`xformOp:rotateY:{}` is not half, float or double type.\n",
-                  x.suffix);
-            }
-          }
-          return false;
-        }
+      break;
+    }
+    case XformOp::OpType::Translate:
+    case XformOp::OpType::Scale:
+    case XformOp::OpType::RotateXYZ:
+    case XformOp::OpType::RotateXZY:
+    case XformOp::OpType::RotateYXZ:
+    case XformOp::OpType::RotateYZX:
+    case XformOp::OpType::RotateZXY:
+    case XformOp::OpType::RotateZYX: {
+      DISPATCH_XFORMOP(value::half3, Half3)
+      DISPATCH_XFORMOP(value::float3, Float3)
+      DISPATCH_XFORMOP(value::double3, Double3) {
+        type_names = "half3, float3 or double3";
+      }
+      break;
+    }
+    case XformOp::OpType::RotateX:
+    case XformOp::OpType::RotateY:
+    case XformOp::OpType::RotateZ: {
+      DISPATCH_XFORMOP(value::half, Half)
+      DISPATCH_XFORMOP(float, Float)
+      DISPATCH_XFORMOP(double, Double) {
+        type_names = "half, float or double";
+      }
+      break;
+    }
+    case XformOp::OpType::Orient: {
+      DISPATCH_XFORMOP(value::quath, Quath)
+      DISPATCH_XFORMOP(value::quatf, Quatf)
+      DISPATCH_XFORMOP(value::quatd, Quatd) {
+        type_names = "quath, quatf or quatd";
+      }
+      break;
+    }
+  }
 
-        XformEvaluator xe;
-#if defined(PXR_COMPATIBLE_ROTATE_MATRIX_GENERATION)
-        xe.Rotation({0.0, 1.0, 0.0}, angle);
-#else
-        xe.RotateY(angle);
-#endif
-        auto ret = xe.result();
-
-        if (ret) {
-          m = ret.value();
-        } else {
-          if (err) {
-            (*err) += ret.error();
-          }
-          return false;
-        }
+#undef DISPATCH_XFORMOP
+
+  if (err) {
+    (*err) +=
+        fmt::format("`{}` is not {} type.\n", XformOpName(x), type_names);
+  }
+  return false;
+}
+
+}  // namespace
+
+bool XformOpProgram::evaluate(const double t,
+                              const value::TimeSampleInterpolationType tinterp,
+                              value::matrix4d *out_matrix,
+                              std::string *err) const {
+  if (!out_matrix) {
+    return false;
+  }
+
+  // See the comment in Xformable::EvaluateXformOps for the ordering.
+  value::matrix4d cm = value::matrix4d::identity();
+
+  for (size_t i = 0; i < _instructions.size(); i++) {
+    const Instruction &inst = _instructions[i];
+
+    if (!inst.ts || (inst.has_default && value::TimeCode(t).is_default())) {
+      // Folded constant matrix.
+      cm = (i == 0) ? inst.matrix : inst.matrix * cm;
+      continue;
+    }
+
+    value::matrix4d m;
+    bool ret{false};
+
+    switch (inst.value_type) {
+      case ValueType::Matrix:
         break;
-      }
-      case XformOp::OpType::RotateZ: {
-        double angle;  // in degrees
-        if (auto h = x.get_value<value::half>()) {
-          angle = double(half_to_float(h.value()));
-        } else if (auto f = x.get_value<float>()) {
-          angle = double(f.value());
-        } else if (auto d = x.get_value<double>()) {
-          angle = d.value();
-        } else {
-          if (err) {
-            if (x.suffix.empty()) {
-              (*err) +=
-                  "`xformOp:rotateZ` is not half, float or double type.\n";
-            } else {
-              (*err) += fmt::format(
-                  "`xformOp:rotateZ:{}` is not half, float or double type.\n",
-                  x.suffix);
-            }
-          }
-          return false;
-        }
+      case ValueType::Half:
+        ret = EvaluateInstruction<value::half>(inst, t, tinterp, &m, err);
+        break;
+      case ValueType::Float:
+        ret = EvaluateInstruction<float>(inst, t, tinterp, &m, err);
+        break;
+      case ValueType::Double:
+        ret = EvaluateInstruction<double>(inst, t, tinterp, &m, err);
+        break;
+      case ValueType::Half3:
+        ret = EvaluateInstruction<value::half3>(inst, t, tinterp, &m, err);
+        break;
+      case ValueType::Float3:
+        ret = EvaluateInstruction<value::float3>(inst, t, tinterp, &m, err);
+        break;
+      case ValueType::Double3:
+        ret = EvaluateInstruction<value::double3>(inst, t, tinterp, &m, err);
+        break;
+      case ValueType::Quath:
+        ret = EvaluateInstruction<value::quath>(inst, t, tinterp, &m, err);
+        break;
+      case ValueType::Quatf:
+        ret = EvaluateInstruction<value::quatf>(inst, t, tinterp, &m, err);
+        break;
+      case ValueType::Quatd:
+        ret = EvaluateInstruction<value::quatd>(inst, t, tinterp, &m, err);
+        break;
+      case ValueType::Matrix4f:
+        ret = EvaluateInstruction<value::matrix4f>(inst, t, tinterp, &m, err);
+        break;
+      case ValueType::Matrix4d:
+        ret = EvaluateInstruction<value::matrix4d>(inst, t, tinterp, &m, err);
+        break;
+    }
 
-        XformEvaluator xe;
-#if defined(PXR_COMPATIBLE_ROTATE_MATRIX_GENERATION)
-        xe.Rotation({0.0, 0.0, 1.0}, angle);
-#else
-        xe.RotateZ(angle);
-#endif
-        auto ret = xe.result();
-
-        if (ret) {
-          m = ret.value();
-        } else {
-          if (err) {
-            (*err) += ret.error();
-          }
-          return false;
+    if (!ret) {
+      return false;
+    }
+
+    cm = m * cm;  // `m` fist for pre-multiply system.
+  }
+
+  (*out_matrix) = cm;
+
+  return true;
+}
+
+size_t XformOpProgram::num_animated() const {
+  size_t n = 0;
+  for (const auto &inst : _instructions) {
+    if (inst.ts) {
+      n++;
+    }
+  }
+  return n;
+}
+
+bool Xformable::CompileXformOps(XformOpProgram *program,
+                                std::string *err) const {
+  if (!program) {
+    return false;
+  }
+
+  program->clear();
+
+  using ValueType = XformOpProgram::ValueType;
+
+  // Constant matrix being folded.
+  bool folding{false};
+  value::matrix4d cm = value::matrix4d::identity();
+
+  for (size_t i = 0; i < xformOps.size(); i++) {
+    const auto &x = xformOps[i];
+
+    if (x.op_type == XformOp::OpType::ResetXformStack) {
+      if (i != 0) {
+        if (err) {
+          (*err) +=
+              "!resetXformStack! should only appear at the first element of "
+              "xformOps\n";
         }
-        break;
+        return false;
       }
-      case XformOp::OpType::Orient: {
-        // value::quat stores elements in (x, y, z, w)
-        // linalg::quat also stores elements in (x, y, z, w)
-
-        value::matrix3d rm;
-        if (auto h = x.get_value<value::quath>()) {
-          rm = to_matrix3x3(h.value());
-        } else if (auto f = x.get_value<value::quatf>()) {
-          rm = to_matrix3x3(f.value());
-        } else if (auto d = x.get_value<value::quatd>()) {
-          rm = to_matrix3x3(d.value());
-        } else {
-          if (err) {
-            if (x.suffix.empty()) {
-              (*err) += "`xformOp:orient` is not quath, quatf or quatd type.\n";
-            } else {
-              (*err) += fmt::format(
-                  "`xformOp:orient:{}` is not quath, quatf or quatd type.\n",
-                  x.suffix);
-            }
-          }
-          return false;
-        }
 
-        // FIXME: invert before getting matrix.
-        if (x.inverted) {
-          value::matrix3d inv_rm;
-          if (inverse(rm, inv_rm)) {
-          } else {
-            if (err) {
-              if (x.suffix.empty()) {
-                (*err) +=
-                    "`xformOp:orient` is singular and cannot be inverted.\n";
-              } else {
-                (*err) += fmt::format(
-                    "`xformOp:orient:{}` is singular and cannot be inverted.\n",
-                    x.suffix);
-              }
-            }
-          }
-
-          rm = inv_rm;
-        }
+      // Notify resetting previous(parent node's) matrices
+      program->_resetXformStack = true;
+      continue;
+    }
 
-        m = to_matrix(rm, {0.0, 0.0, 0.0});
+    XformOpProgram::Instruction inst;
+    inst.op = &x;
 
-        break;
+    bool ret = DispatchXformOpValueType(
+        x,
+        [&](auto tag, ValueType ty) {
+          using T = typename decltype(tag)::type;
+          return CompileXformOp<T>(x, ty, &inst, err);
+        },
+        err);
+
+    if (!ret) {
+      return false;
+    }
+
+    if (inst.ts) {
+      if (folding) {
+        XformOpProgram::Instruction c;
+        c.matrix = cm;
+        program->_instructions.push_back(c);
+        folding = false;
       }
+      program->_instructions.push_back(inst);
+    } else {
+      cm = folding ? (inst.matrix * cm) : inst.matrix;
+      folding = true;
+    }
+  }
+
+  if (folding) {
+    XformOpProgram::Instruction c;
+    c.matrix = cm;
+    program->_instructions.push_back(c);
+  }
+
+  return true;
+}
+
+bool Xformable::EvaluateXformOps(double t,
+                                 value::TimeSampleInterpolationType tinterp,
+                                 value::matrix4d *out_matrix,
+                                 bool *resetXformStack,
+                                 std::string *err) const {
+  // Concat matrices
+  //
+  // Matrix concatenation ordering is its appearance order(right to left)
+  // This is same with a notation in math equation: i.e,
+  //
+  // xformOpOrder = [A, B, C]
+  //
+  // M = A x B x C
+  //
+  // p' = A x B x C x p
+  //
+  // in post-multiply order.
+  //
+  // But in pre-multiply order system(pxrUSD and TinyUSDZ),
+  // C++ code is
+  //
+  // p' = p x C x B x A
+  //
+  //
+  // Use CompileXformOps() and XformOpProgram::evaluate() to evaluate
+  // xformOps at many time samples. Here xformOps are evaluated directly so
+  // that one-shot evaluation does not allocate a program.
+  value::matrix4d cm = value::matrix4d::identity();
 
-      case XformOp::OpType::RotateXYZ:
-      case XformOp::OpType::RotateXZY:
-      case XformOp::OpType::RotateYXZ:
-      case XformOp::OpType::RotateYZX:
-      case XformOp::OpType::RotateZXY:
-      case XformOp::OpType::RotateZYX: {
-        auto ret = RotateABC(x);
-
-        if (!ret) {
-          (*err) += ret.error();
-          return false;
+  for (size_t i = 0; i < xformOps.size(); i++) {
+    const auto &x = xformOps[i];
+
+    if (x.op_type == XformOp::OpType::ResetXformStack) {
+      if (i != 0) {
+        if (err) {
+          (*err) +=
+              "!resetXformStack! should only appear at the first element of "
+              "xformOps\n";
         }
+        return false;
+      }
 
-        m = ret.value();
+      // Notify resetting previous(parent node's) matrices
+      if (resetXformStack) {
+        (*resetXformStack) = true;
       }
+      continue;
+    }
+
+    value::matrix4d m;
+
+    bool ret = DispatchXformOpValueType(
+        x,
+        [&](auto tag, XformOpProgram::ValueType) {
+          using T = typename decltype(tag)::type;
+          return EvaluateXformOp<T>(x, t, tinterp, &m, err);
+        },
+        err);
+
+    if (!ret) {
+      return false;
     }
 
     cm = m * cm;  // `m` fist for pre-multiply system.
   }
 
-  (*out_matrix) = cm;
+  if (out_matrix) {
+    (*out_matrix) = cm;
+  }
 
   return true;
 }
 
+bool Xformable::has_timesamples() const {
+  for (const auto &x : xformOps) {
+    if (x.has_timesamples()) {
+      return true;
+    }
+  }
+  return false;
+}
+
 std::vector<value::token> Xformable::xformOpOrder() const {
   std::vector<value::token> toks;
 
@@ -1280,6 +1536,300 @@ value::point3d transform_dir(const value::matrix4d &m,
   return value::MultV<value::matrix4d, value::point3d, double, double, 3>(m, p);
 }
 
+//
+// Batch transform kernels.
+//
+// Computed in single precision(matrix elements are converted to float).
+// 4 points are processed at once with SSE2/NEON(8 points with AVX) by
+// transposing xyzxyz... into xxxx, yyyy, zzzz.
+//
+
+namespace {
+
+static_assert(sizeof(value::float3) == sizeof(float) * 3, "");
+static_assert(sizeof(value::point3f) == sizeof(float) * 3, "");
+static_assert(sizeof(value::vector3f) == sizeof(float) * 3, "");
+static_assert(sizeof(value::normal3f) == sizeof(float) * 3, "");
+
+// Row 0-2: upper-left 3x3, row 3: translation
+struct Matrix4x3f {
+  float m[4][3];
+};
+
+Matrix4x3f ToMatrix4x3f(const value::matrix4d &m, const bool translate) {
+  Matrix4x3f r;
+  for (size_t j = 0; j < 4; j++) {
+    for (size_t i = 0; i < 3; i++) {
+      r.m[j][i] = ((j == 3) && !translate) ? 0.0f : float(m.m[j][i]);
+    }
+  }
+  return r;
+}
+
+#if defined(TINYUSDZ_XFORM_USE_SSE2)
+
+// x0 y0 z0 x1 | y1 z1 x2 y2 | z2 x3 y3 z3 -> xxxx, yyyy, zzzz
+inline void LoadXYZ4(const float *p, __m128 *x, __m128 *y, __m128 *z) {
+  const __m128 a = _mm_loadu_ps(p);
+  const __m128 b = _mm_loadu_ps(p + 4);
+  const __m128 c = _mm_loadu_ps(p + 8);
+
+  const __m128 t0 = _mm_shuffle_ps(a, b, _MM_SHUFFLE(2, 0, 3, 0));
+  const __m128 t1 = _mm_shuffle_ps(b, c, _MM_SHUFFLE(1, 1, 2, 2));
+  (*x) = _mm_shuffle_ps(t0, t1, _MM_SHUFFLE(2, 0, 1, 0));
+
+  const __m128 t2 = _mm_shuffle_ps(a, b, _MM_SHUFFLE(0, 0, 1, 1));
+  const __m128 t3 = _mm_shuffle_ps(b, c, _MM_SHUFFLE(2, 2, 3, 3));
+  (*y) = _mm_shuffle_ps(t2, t3, _MM_SHUFFLE(2, 0, 2, 0));
+
+  const __m128 t4 = _mm_shuffle_ps(a, b, _MM_SHUFFLE(1, 1, 2, 2));
+  const __m128 t5 = _mm_shuffle_ps(c, c, _MM_SHUFFLE(3, 3, 0, 0));
+  (*z) = _mm_shuffle_ps(t4, t5, _MM_SHUFFLE(2, 0, 2, 0));
+}
+
+// xxxx, yyyy, zzzz -> x0 y0 z0 x1 | y1 z1 x2 y2 | z2 x3 y3 z3
+inline void StoreXYZ4(const __m128 x, const __m128 y, const __m128 z,
+                      float *p) {
+  const __m128 xy01 = _mm_unpacklo_ps(x, y);
+  const __m128 xy23 = _mm_unpackhi_ps(x, y);
+
+  const __m128 t0 = _mm_shuffle_ps(z, xy01, _MM_SHUFFLE(2, 2, 0, 0));
+  const __m128 a = _mm_shuffle_ps(xy01, t0, _MM_SHUFFLE(2, 0, 1, 0));
+
+  const __m128 t1 = _mm_shuffle_ps(xy01, z, _MM_SHUFFLE(1, 1, 3, 3));
+  const __m128 b = _mm_shuffle_ps(t1, xy23, _MM_SHUFFLE(1, 0, 2, 0));
+
+  const __m128 t2 = _mm_shuffle_ps(z, xy23, _MM_SHUFFLE(2, 2, 2, 2));
+  const __m128 t3 = _mm_shuffle_ps(xy23, z, _MM_SHUFFLE(3, 3, 3, 3));
+  const __m128 c = _mm_shuffle_ps(t2, t3, _MM_SHUFFLE(2, 0, 2, 0));
+
+  _mm_storeu_ps(p, a);
+  _mm_storeu_ps(p + 4, b);
+  _mm_storeu_ps(p + 8, c);
+}
+
+#endif
+
+// `in` and `out` may be the same buffer.
+void TransformFloat3Array(const Matrix4x3f &mat, const float *in,
+                          const size_t n, const bool normalize, float *out) {
+  const float(*m)[3] = mat.m;
+
+  size_t i = 0;
+
+#if defined(__AVX__)
+  {
+    __m256 vm[4][3];
+    for (size_t j = 0; j < 4; j++) {
+      for (size_t k = 0; k < 3; k++) {
+        vm[j][k] = _mm256_set1_ps(m[j][k]);
+      }
+    }
+    const __m256 vzero = _mm256_setzero_ps();
+
+    for (; (i + 8) <= n; i += 8) {
+      __m128 x0, y0, z0, x1, y1, z1;
+      LoadXYZ4(in + 3 * i, &x0, &y0, &z0);
+      LoadXYZ4(in + 3 * (i + 4), &x1, &y1, &z1);
+
+      const __m256 x = _mm256_insertf128_ps(_mm256_castps128_ps256(x0), x1, 1);
+      const __m256 y = _mm256_insertf128_ps(_mm256_castps128_ps256(y0), y1, 1);
+      const __m256 z = _mm256_insertf128_ps(_mm256_castps128_ps256(z0), z1, 1);
+
+      __m256 r[3];
+      for (size_t k = 0; k < 3; k++) {
+        r[k] = _mm256_add_ps(
+            _mm256_add_ps(_mm256_mul_ps(x, vm[0][k]), _mm256_mul_ps(y, vm[1][k])),
+            _mm256_add_ps(_mm256_mul_ps(z, vm[2][k]), vm[3][k]));
+      }
+
+      if (normalize) {
+        const __m256 len2 = _mm256_add_ps(
+            _mm256_add_ps(_mm256_mul_ps(r[0], r[0]), _mm256_mul_ps(r[1], r[1])),
+            _mm256_mul_ps(r[2], r[2]));
+        // Keep zero vector as is.
+        const __m256 mask = _mm256_cmp_ps(len2, vzero, _CMP_GT_OQ);
+        const __m256 len =
+            _mm256_blendv_ps(_mm256_set1_ps(1.0f), _mm256_sqrt_ps(len2), mask);
+        for (size_t k = 0; k < 3; k++) {
+          r[k] = _mm256_div_ps(r[k], len);
+        }
+      }
+
+      StoreXYZ4(_mm256_castps256_ps128(r[0]), _mm256_castps256_ps128(r[1]),
+                _mm256_castps256_ps128(r[2]), out + 3 * i);
+      StoreXYZ4(_mm256_extractf128_ps(r[0], 1), _mm256_extractf128_ps(r[1], 1),
+                _mm256_extractf128_ps(r[2], 1), out + 3 * (i + 4));
+    }
+  }
+#endif
+
+#if defined(TINYUSDZ_XFORM_USE_SSE2)
+  {
+    __m128 vm[4][3];
+    for (size_t j = 0; j < 4; j++) {
+      for (size_t k = 0; k < 3; k++) {
+        vm[j][k] = _mm_set1_ps(m[j][k]);
+      }
+    }
+    const __m128 vzero = _mm_setzero_ps();
+    const __m128 vone = _mm_set1_ps(1.0f);
+
+    for (; (i + 4) <= n; i += 4) {
+      __m128 x, y, z;
+      LoadXYZ4(in + 3 * i, &x, &y, &z);
+
+      __m128 r[3];
+      for (size_t k = 0; k < 3; k++) {
+        r[k] = _mm_add_ps(_mm_add_ps(_mm_mul_ps(x, vm[0][k]), _mm_mul_ps(y, vm[1][k])),
+                          _mm_add_ps(_mm_mul_ps(z, vm[2][k]), vm[3][k]));
+      }
+
+      if (normalize) {
+        const __m128 len2 =
+            _mm_add_ps(_mm_add_ps(_mm_mul_ps(r[0], r[0]), _mm_mul_ps(r[1], r[1])),
+                       _mm_mul_ps(r[2], r[2]));
+        // Keep zero vector as is.
+        const __m128 mask = _mm_cmpgt_ps(len2, vzero);
+        const __m128 len = _mm_or_ps(_mm_and_ps(mask, _mm_sqrt_ps(len2)),
+                                     _mm_andnot_ps(mask, vone));
+        for (size_t k = 0; k < 3; k++) {
+          r[k] = _mm_div_ps(r[k], len);
+        }
+      }
+
+      StoreXYZ4(r[0], r[1], r[2], out + 3 * i);
+    }
+  }
+#elif defined(TINYUSDZ_XFORM_USE_NEON)
+  {
+    const float32x4_t vzero = vdupq_n_f32(0.0f);
+    const float32x4_t vone = vdupq_n_f32(1.0f);
+
+    for (; (i + 4) <= n; i += 4) {
+      // vld3q deinterleaves xyz.
+      const float32x4x3_t v = vld3q_f32(in + 3 * i);
+
+      float32x4x3_t r;
+      for (size_t k = 0; k < 3; k++) {
+        r.val[k] = vaddq_f32(
+            vaddq_f32(vmulq_n_f32(v.val[0], m[0][k]), vmulq_n_f32(v.val[1], m[1][k])),
+            vaddq_f32(vmulq_n_f32(v.val[2], m[2][k]), vdupq_n_f32(m[3][k])));
+      }
+
+      if (normalize) {
+        const float32x4_t len2 = vaddq_f32(
+            vaddq_f32(vmulq_f32(r.val[0], r.val[0]), vmulq_f32(r.val[1], r.val[1])),
+            vmulq_f32(r.val[2], r.val[2]));
+        // Keep zero vector as is.
+        const uint32x4_t mask = vcgtq_f32(len2, vzero);
+        const float32x4_t len = vbslq_f32(mask, vsqrtq_f32(len2), vone);
+        for (size_t k = 0; k < 3; k++) {
+          r.val[k] = vdivq_f32(r.val[k], len);
+        }
+      }
+
+      vst3q_f32(out + 3 * i, r);
+    }
+  }
+#endif
+
+  for (; i < n; i++) {
+    const float x = in[3 * i + 0];
+    const float y = in[3 * i + 1];
+    const float z = in[3 * i + 2];
+
+    float r[3];
+    for (size_t k = 0; k < 3; k++) {
+      r[k] = ((x * m[0][k]) + (y * m[1][k])) + ((z * m[2][k]) + m[3][k]);
+    }
+
+    if (normalize) {
+      const float len2 = r[0] * r[0] + r[1] * r[1] + r[2] * r[2];
+      if (len2 > 0.0f) {
+        const float len = std::sqrt(len2);
+        r[0] /= len;
+        r[1] /= len;
+        r[2] /= len;
+      }
+    }
+
+    out[3 * i + 0] = r[0];
+    out[3 * i + 1] = r[1];
+    out[3 * i + 2] = r[2];
+  }
+}
+
+}  // namespace
+
+void transform_points(const value::matrix4d &m, const value::float3 *in,
+                      value::float3 *out, const size_t n) {
+  if (!in || !out) {
+    return;
+  }
+  TransformFloat3Array(ToMatrix4x3f(m, /* translate */ true),
+                       reinterpret_cast<const float *>(in), n,
+                       /* normalize */ false, reinterpret_cast<float *>(out));
+}
+
+void transform_points(const value::matrix4d &m, const value::point3f *in,
+                      value::point3f *out, const size_t n) {
+  if (!in || !out) {
+    return;
+  }
+  TransformFloat3Array(ToMatrix4x3f(m, /* translate */ true),
+                       reinterpret_cast<const float *>(in), n,
+                       /* normalize */ false, reinterpret_cast<float *>(out));
+}
+
+void transform_points(const value::matrix4d &m, const value::double3 *in,
+                      value::double3 *out, const size_t n) {
+  if (!in || !out) {
+    return;
+  }
+  for (size_t i = 0; i < n; i++) {
+    out[i] = transform(m, in[i]);
+  }
+}
+
+void transform_dirs(const value::matrix4d &m, const value::float3 *in,
+                    value::float3 *out, const size_t n) {
+  if (!in || !out) {
+    return;
+  }
+  TransformFloat3Array(ToMatrix4x3f(m, /* translate */ false),
+                       reinterpret_cast<const float *>(in), n,
+                       /* normalize */ false, reinterpret_cast<float *>(out));
+}
+
+void transform_dirs(const value::matrix4d &m, const value::vector3f *in,
+                    value::vector3f *out, const size_t n) {
+  if (!in || !out) {
+    return;
+  }
+  TransformFloat3Array(ToMatrix4x3f(m, /* translate */ false),
+                       reinterpret_cast<const float *>(in), n,
+                       /* normalize */ false, reinterpret_cast<float *>(out));
+}
+
+void transform_normals(const value::matrix4d &m, const value::normal3f *in,
+                       value::normal3f *out, const size_t n) {
+  if (!in || !out) {
+    return;
+  }
+
+  // transpose(inverse(M)) of upper-left 3x3
+  value::matrix4d nm = upper_left_3x3_only(m);
+  value::matrix4d inv_nm;
+  if (inverse(nm, inv_nm)) {
+    nm = transpose(inv_nm);
+  }
+
+  TransformFloat3Array(ToMatrix4x3f(nm, /* translate */ false),
+                       reinterpret_cast<const float *>(in), n,
+                       /* normalize */ true, reinterpret_cast<float *>(out));
+}
+
 value::matrix4d upper_left_3x3_only(const value::matrix4d &m) {
   value::matrix4d dst;
 
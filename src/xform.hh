@@ -114,6 +114,26 @@ value::vector3d transform_dir(const value::matrix4d &m, const value::vector3d &p
 value::normal3d transform_dir(const value::matrix4d &m, const value::normal3d &p);
 value::point3d transform_dir(const value::matrix4d &m, const value::point3d &p);
 
+//
+// Batch version of transform() and transform_dir() for arrays.
+// `in` and `out` can be the same buffer.
+//
+// float3 variants are SIMD-vectorized(SSE2/AVX/NEON) and computed in single
+// precision, so results may differ from transform() in the last bits.
+//
+void transform_points(const value::matrix4d &m, const value::float3 *in, value::float3 *out, size_t n);
+void transform_points(const value::matrix4d &m, const value::point3f *in, value::point3f *out, size_t n);
+void transform_points(const value::matrix4d &m, const value::double3 *in, value::double3 *out, size_t n);
+
+void transform_dirs(const value::matrix4d &m, const value::float3 *in, value::float3 *out, size_t n);
+void transform_dirs(const value::matrix4d &m, const value::vector3f *in, value::vector3f *out, size_t n);
+
+//
+// Transform normals with transpose(inverse(upper_left_3x3_only(m))) and
+// normalize them. Zero-length normals are kept as is.
+//
+void transform_normals(const value::matrix4d &m, const value::normal3f *in, value::normal3f *out, size_t n);
+
 // tx, ty, tz = [inout]
 // default eps is grabbed from pxrUSD. 
 bool orthonormalize_basis(value::double3 &tx, value::double3 &ty, value::double3 &tz, const bool normalize, const double eps = 1e-6);
@@ -146,10 +166,78 @@ value::matrix4d trs_rot_axis(
   const value::double3 &rotation_z_axis,
   const value::double3 &scale);
 
+///
+/// Precompiled xformOps(built by Xformable::CompileXformOps()).
+///
+/// Value types of xformOps are resolved at compile time, and consecutive
+/// non-timeSampled xformOps are folded into a single matrix. `evaluate()`
+/// only interpolates timeSampled xformOps and concatenates matrices, so it
+/// does not allocate memory(except for error messages).
+///
+/// NOTE: timeSampled xformOps refer to the TimeSamples of the Xformable, so
+/// the program is valid while the Xformable is alive and not modified.
+///
+class XformOpProgram {
+ public:
+  enum class ValueType : uint8_t {
+    Matrix,  // Folded constant matrix
+    Half,
+    Float,
+    Double,
+    Half3,
+    Float3,
+    Double3,
+    Quath,
+    Quatf,
+    Quatd,
+    Matrix4f,
+    Matrix4d,
+  };
+
+  struct Instruction {
+    ValueType value_type{ValueType::Matrix};
+    const XformOp *op{nullptr};  // nullptr for folded constant matrix
+    const value::TimeSamples *ts{nullptr};  // nullptr for constant matrix
+
+    // true when timeSampled xformOp also has `default` value.
+    bool has_default{false};
+
+    // Constant matrix, or matrix of `default` value of timeSampled xformOp.
+    value::matrix4d matrix{value::matrix4d::identity()};
+  };
+
+  ///
+  /// Evaluate concatenated matrix at time `t`.
+  /// Thread-safe(program is not modified).
+  ///
+  bool evaluate(double t, value::TimeSampleInterpolationType tinterp,
+                value::matrix4d *out_matrix, std::string *err = nullptr) const;
+
+  // true when xformOpOrder contains !resetXformStack!
+  bool reset_xform_stack() const { return _resetXformStack; }
+
+  // # of timeSampled xformOps.
+  size_t num_animated() const;
+
+  bool is_constant() const { return num_animated() == 0; }
+
+  const std::vector<Instruction> &instructions() const { return _instructions; }
+
+  void clear() {
+    _instructions.clear();
+    _resetXformStack = false;
+  }
+
+ private:
+  friend struct Xformable;
+
+  std::vector<Instruction> _instructions;
+  bool _resetXformStack{false};
+};
+
 ///
 /// For usdGeom, usdSkel, usdLux
 ///
-/// TODO: TimeSample support.
 struct Xformable {
   ///
   /// Evaluate XformOps and output evaluated(concatenated) matrix to `out_matrix`
@@ -161,6 +249,15 @@ struct Xformable {
   ///
   bool EvaluateXformOps(double t, value::TimeSampleInterpolationType tinterp, value::matrix4d *out_matrix, bool *resetXformStack, std::string *err) const;
 
+  ///
+  /// Compile xformOps into XformOpProgram, which can be evaluated at
+  /// arbitrary time without resolving value types of xformOps again.
+  /// TimeSamples of xformOps are sorted(TimeSamples::update()) here, so
+  /// `program->evaluate()` does not modify the Xformable and can be called
+  /// concurrently.
+  ///
+  bool CompileXformOps(XformOpProgram *program, std::string *err) const;
+
   ///
   /// Global = Parent x Local
   ///
@@ -189,23 +286,60 @@ struct Xformable {
   ///
   /// @param[out] resetTransformStack Is xformOpOrder contains !resetTransformStack!? 
   ///
+  /// The matrix is cached unless xformOps are timeSampled. timeSampled
+  /// xformOps are compiled into XformOpProgram once and the program is
+  /// evaluated for each call. Call `set_dirty(true)` after modifying xformOps.
+  /// NOTE: Not thread-safe because of the cache. Use EvaluateXformOps() to
+  /// evaluate Xformables concurrently.
+  ///
   nonstd::expected<value::matrix4d, std::string> GetLocalMatrix(double t = value::TimeCode::Default(), value::TimeSampleInterpolationType tinterp = value::TimeSampleInterpolationType::Linear, bool *resetTransformStack = nullptr) const {
-    if (_dirty) {
+    if (has_timesamples()) {
+      // The program refers to xformOps, so recompile it when xformOps are
+      // copied/reallocated.
+      if (_dirty || (_program_ops != xformOps.data()) ||
+          (_program_num_ops != xformOps.size())) {
+        std::string err;
+        if (!CompileXformOps(&_program, &err)) {
+          _program_ops = nullptr;
+          return nonstd::make_unexpected(err);
+        }
+        _program_ops = xformOps.data();
+        _program_num_ops = xformOps.size();
+      }
+
+      value::matrix4d m;
+      std::string err;
+      if (!_program.evaluate(t, tinterp, &m, &err)) {
+        return nonstd::make_unexpected(err);
+      }
+      _matrix = m;
+      _resetXformStack = _program.reset_xform_stack();
+      _dirty = false;
+    } else if (_dirty) {
       value::matrix4d m;
+      bool rxs{false};
       std::string err;
-      if (EvaluateXformOps(t, tinterp, &m, resetTransformStack, &err)) {
+      if (EvaluateXformOps(t, tinterp, &m, &rxs, &err)) {
         _matrix = m;
+        _resetXformStack = rxs;
         _dirty = false;
       } else {
         return nonstd::make_unexpected(err);
       }
     }
 
+    if (resetTransformStack) {
+      (*resetTransformStack) = _resetXformStack;
+    }
+
     return _matrix;
   }
 
   void set_dirty(bool onoff) { _dirty = onoff; }
 
+  // true when any of xformOps is timeSampled(time-varying).
+  bool has_timesamples() const;
+
   // Return `token[]` representation of `xformOps`
   std::vector<value::token> xformOpOrder() const;
 
@@ -213,6 +347,12 @@ struct Xformable {
 
   mutable bool _dirty{true};
   mutable value::matrix4d _matrix;  // Matrix of this Xform(local matrix)
+  mutable bool _resetXformStack{false};
+
+  // Compiled timeSampled xformOps(GetLocalMatrix()).
+  mutable XformOpProgram _program;
+  mutable const XformOp *_program_ops{nullptr};  // xformOps.data() at compile
+  mutable size_t _program_num_ops{0};
 };
 
 
@@ -0,0 +1,510 @@
+#ifdef _MSC_VER
+#define NOMINMAX
+#endif
+
+#define TEST_NO_MAIN
+#include "acutest.h"
+
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <vector>
+
+#if defined(_WIN32)
+#include <direct.h>
+#else
+#include <unistd.h>
+#endif
+
+#include "unit-composition.h"
+#include "composition.hh"
+#include "prim-types.hh"
+#include "stage.hh"
+#include "usdGeom.hh"
+#include "tinyusdz.hh"
+
+using namespace tinyusdz;
+
+void layer_cache_test(void) {
+
+  {
+    LayerCache cache(/* max_bytes */100);
+
+    auto layer0 = std::make_shared<Layer>();
+    auto layer1 = std::make_shared<Layer>();
+    auto layer2 = std::make_shared<Layer>();
+
+    TEST_CHECK(cache.insert("a.usda", 1, layer0, 40));
+    TEST_CHECK(cache.insert("b.usda", 1, layer1, 40));
+    TEST_CHECK(cache.size() == 2);
+    TEST_CHECK(cache.bytes() == 80);
+
+    // hit
+    TEST_CHECK(cache.find("a.usda", 1) == layer0);
+    TEST_CHECK(cache.num_hits() == 1);
+
+    // "b.usda" is the least recently used, so evicted.
+    TEST_CHECK(cache.insert("c.usda", 1, layer2, 40));
+    TEST_CHECK(cache.size() == 2);
+    TEST_CHECK(cache.find("b.usda", 1) == nullptr);
+    TEST_CHECK(cache.find("a.usda", 1) == layer0);
+    TEST_CHECK(cache.find("c.usda", 1) == layer2);
+
+    // stamp mismatch = asset was modified.
+    TEST_CHECK(cache.find("a.usda", 2) == nullptr);
+    TEST_CHECK(cache.size() == 1);
+    TEST_CHECK(cache.bytes() == 40);
+
+    // Too large to cache.
+    TEST_CHECK(!cache.insert("d.usda", 1, layer0, 200));
+    TEST_CHECK(cache.size() == 1);
+
+    cache.set_max_bytes(10);
+    TEST_CHECK(cache.size() == 0);
+    TEST_CHECK(cache.bytes() == 0);
+  }
+
+}
+
+void layer_find_primspec_test(void) {
+
+  Layer layer;
+
+  {
+    PrimSpec root(Specifier::Def, "root");
+    PrimSpec child(Specifier::Def, "child");
+    root.children().emplace_back(child);
+    TEST_CHECK(layer.add_primspec("root", root));
+  }
+
+  const PrimSpec *ps{nullptr};
+  std::string err;
+  TEST_CHECK(layer.find_primspec_at(Path("/root/child", ""), &ps, &err));
+  TEST_CHECK(ps != nullptr);
+  if (ps) {
+    TEST_CHECK(ps->name() == "child");
+  }
+
+  // cached lookup must also return the PrimSpec.
+  ps = nullptr;
+  TEST_CHECK(layer.find_primspec_at(Path("/root/child", ""), &ps, &err));
+  TEST_CHECK(ps != nullptr);
+
+  TEST_CHECK(!layer.find_primspec_at(Path("/bora", ""), &ps, &err));
+
+  // index is invalidated when the Layer is modified.
+  {
+    PrimSpec bora(Specifier::Over, "bora");
+    TEST_CHECK(layer.add_primspec("bora", bora));
+  }
+  ps = nullptr;
+  TEST_CHECK(layer.find_primspec_at(Path("/bora", ""), &ps, &err));
+  TEST_CHECK(ps != nullptr);
+
+  // index is updated incrementally by replace/remove.
+  {
+    PrimSpec root(Specifier::Def, "root");
+    PrimSpec child2(Specifier::Def, "child2");
+    root.children().emplace_back(child2);
+    TEST_CHECK(layer.replace_primspec("root", root));
+  }
+  TEST_CHECK(!layer.find_primspec_at(Path("/root/child", ""), &ps, &err));
+  ps = nullptr;
+  TEST_CHECK(layer.find_primspec_at(Path("/root/child2", ""), &ps, &err));
+  const Layer &clayer = layer;
+  TEST_CHECK(ps == &clayer.primspecs().at("root").children()[0]);
+
+  TEST_CHECK(layer.remove_primspec("bora"));
+  TEST_CHECK(!layer.find_primspec_at(Path("/bora", ""), &ps, &err));
+
+  // in-place modification of the subtree.
+  {
+    const PrimSpec *root_ps{nullptr};
+    TEST_CHECK(layer.find_primspec_at(Path("/root", ""), &root_ps, &err));
+    PrimSpec &root = const_cast<PrimSpec &>(*root_ps);
+    layer.remove_primspec_index("/root", root);
+    root.children().emplace_back(PrimSpec(Specifier::Def, "child3"));
+    layer.add_primspec_index("/root", root);
+
+    ps = nullptr;
+    TEST_CHECK(layer.find_primspec_at(Path("/root/child3", ""), &ps, &err));
+    TEST_CHECK(ps == &root.children()[1]);
+    TEST_CHECK(layer.find_primspec_at(Path("/root/child2", ""), &ps, &err));
+    TEST_CHECK(ps == &root.children()[0]);
+  }
+
+  // copied Layer must not refer PrimSpecs in the source Layer.
+  Layer layer2 = layer;
+  ps = nullptr;
+  TEST_CHECK(layer2.find_primspec_at(Path("/root/child2", ""), &ps, &err));
+  TEST_CHECK(ps == &layer2.primspecs().at("root").children()[0]);
+}
+
+void composite_specializes_test(void) {
+  const std::string usda = R"(#usda 1.0
+def Xform "base" {
+  float a = 1
+  float b = 2
+}
+
+def Xform "root" (
+  specializes = </base>
+) {
+  float b = 3
+}
+
+def Xform "group" {
+  def Xform "child" (
+    specializes = </base>
+  ) {
+    float b = 4
+  }
+}
+)";
+
+  std::string warn, err;
+  Layer layer;
+  TEST_CHECK(LoadLayerFromMemory(
+      reinterpret_cast<const uint8_t *>(usda.data()), usda.size(),
+      "specializes.usda", &layer, &warn, &err));
+  TEST_MSG("%s", err.c_str());
+
+  Layer composited_layer;
+  TEST_CHECK(CompositeSpecializes(layer, &composited_layer, &warn, &err));
+  TEST_MSG("%s", err.c_str());
+
+  auto get_float = [](const PrimSpec &ps, const std::string &name,
+                      float *v) -> bool {
+    auto it = ps.props().find(name);
+    if (it == ps.props().end()) {
+      return false;
+    }
+    return it->second.get_attribute().get_value(v);
+  };
+
+  // Opinions of the PrimSpec are stronger than the specialized PrimSpec.
+  const PrimSpec *ps{nullptr};
+  TEST_CHECK(composited_layer.find_primspec_at(Path("/root", ""), &ps, &err));
+  TEST_CHECK(ps != nullptr);
+  if (ps) {
+    float a{0.0f}, b{0.0f};
+    TEST_CHECK(get_float(*ps, "a", &a));
+    TEST_CHECK(get_float(*ps, "b", &b));
+    TEST_CHECK(a == 1.0f);
+    TEST_CHECK(b == 3.0f);
+    TEST_CHECK(!ps->metas().specializes);
+  }
+
+  // Nested PrimSpec is found through the path index after the composition.
+  ps = nullptr;
+  TEST_CHECK(
+      composited_layer.find_primspec_at(Path("/group/child", ""), &ps, &err));
+  TEST_CHECK(ps != nullptr);
+  if (ps) {
+    float a{0.0f}, b{0.0f};
+    TEST_CHECK(get_float(*ps, "a", &a));
+    TEST_CHECK(get_float(*ps, "b", &b));
+    TEST_CHECK(a == 1.0f);
+    TEST_CHECK(b == 4.0f);
+    TEST_CHECK(!ps->metas().specializes);
+  }
+
+  // Unknown target.
+  const std::string bad_usda = R"(#usda 1.0
+def Xform "root" (
+  specializes = </nonexistent>
+) {
+}
+)";
+  Layer bad_layer;
+  TEST_CHECK(LoadLayerFromMemory(
+      reinterpret_cast<const uint8_t *>(bad_usda.data()), bad_usda.size(),
+      "bad.usda", &bad_layer, &warn, &err));
+  err.clear();
+  TEST_CHECK(!CompositeSpecializes(bad_layer, &composited_layer, &warn, &err));
+  TEST_CHECK(!err.empty());
+}
+
+static bool WriteTextFile(const std::string &filename, const std::string &s) {
+  std::ofstream ofs(filename);
+  if (!ofs) {
+    return false;
+  }
+  ofs << s;
+  return true;
+}
+
+// Create a unique temporary directory. Returns empty string on failure.
+static std::string MakeTempDir() {
+#if defined(_WIN32)
+  char buf[L_tmpnam];
+  if (!std::tmpnam(buf)) {
+    return std::string();
+  }
+  if (_mkdir(buf) != 0) {
+    return std::string();
+  }
+  return std::string(buf);
+#else
+  const char *tmpdir = std::getenv("TMPDIR");
+  std::string templ = (tmpdir && tmpdir[0]) ? tmpdir : "/tmp";
+  templ += "/tinyusdz-unit-XXXXXX";
+  std::vector<char> buf(templ.begin(), templ.end());
+  buf.push_back('\0');
+  if (!mkdtemp(buf.data())) {
+    return std::string();
+  }
+  return std::string(buf.data());
+#endif
+}
+
+static void RemoveTempDir(const std::string &dir,
+                          const std::vector<std::string> &filenames) {
+  for (const auto &filename : filenames) {
+    std::remove((dir + "/" + filename).c_str());
+  }
+#if defined(_WIN32)
+  _rmdir(dir.c_str());
+#else
+  rmdir(dir.c_str());
+#endif
+}
+
+void threaded_load_test(void) {
+
+  const std::string dir = MakeTempDir();
+  TEST_CHECK(!dir.empty());
+  if (dir.empty()) {
+    return;
+  }
+
+  const size_t kNumAssets = 8;
+
+  std::vector<std::string> filenames;
+  std::string root_usda = "#usda 1.0\n";
+  for (size_t i = 0; i < kNumAssets; i++) {
+    const std::string filename = "ref" + std::to_string(i) + ".usda";
+    filenames.push_back(filename);
+
+    TEST_CHECK(WriteTextFile(dir + "/" + filename,
+                             "#usda 1.0\ndef Xform \"geom\" {\n  def Xform \"child" +
+                                 std::to_string(i) + "\" {\n  }\n}\n"));
+
+    // Two Prims refer the same asset.
+    for (size_t k = 0; k < 2; k++) {
+      root_usda += "def Xform \"prim" + std::to_string(i) + "_" +
+                   std::to_string(k) + "\" (\n  prepend references = @./" +
+                   filename + "@\n) {\n}\n";
+    }
+  }
+
+  std::string warn, err;
+  Layer root_layer;
+  TEST_CHECK(LoadLayerFromMemory(
+      reinterpret_cast<const uint8_t *>(root_usda.data()), root_usda.size(),
+      "root.usda", &root_layer, &warn, &err));
+  TEST_MSG("%s", err.c_str());
+
+  AssetResolutionResolver resolver;
+  resolver.set_current_working_path(dir);
+  resolver.set_search_paths({dir});
+
+  std::string exported[2];
+  const int num_threads[2] = {1, 4};
+
+  for (size_t t = 0; t < 2; t++) {
+    LayerCache layer_cache;
+
+    ReferencesCompositionOptions options;
+    options.layer_cache = &layer_cache;
+    options.num_threads = num_threads[t];
+
+    Layer composited_layer;
+    TEST_CHECK(CompositeReferences(resolver, root_layer, &composited_layer,
+                                   &warn, &err, options));
+    TEST_MSG("%s", err.c_str());
+
+    // Each asset is loaded only once.
+    TEST_CHECK(layer_cache.size() == kNumAssets);
+
+    const PrimSpec *ps{nullptr};
+    TEST_CHECK(composited_layer.find_primspec_at(
+        Path("/prim" + std::to_string(kNumAssets - 1) + "_1/child" +
+                 std::to_string(kNumAssets - 1),
+             ""),
+        &ps, &err));
+
+    Stage stage;
+    TEST_CHECK(LayerToStage(composited_layer, &stage, &warn, &err));
+    exported[t] = stage.ExportToString();
+  }
+
+  // Threaded loading gives the same result as serial loading.
+  TEST_CHECK(exported[0] == exported[1]);
+
+  RemoveTempDir(dir, filenames);
+}
+
+void recomposite_references_test(void) {
+
+  const std::string dir = MakeTempDir();
+  TEST_CHECK(!dir.empty());
+  if (dir.empty()) {
+    return;
+  }
+
+  const std::string ref_basename = "unit-composition-recomposite-ref.usda";
+  const std::string ref_filename = dir + "/" + ref_basename;
+
+  TEST_CHECK(WriteTextFile(ref_filename, R"(#usda 1.0
+def Xform "geom" {
+}
+)"));
+
+  const std::string root_usda = R"(#usda 1.0
+def Xform "root" (
+  prepend references = @./unit-composition-recomposite-ref.usda@
+) {
+}
+
+def Xform "other" {
+}
+)";
+
+  std::string warn, err;
+  Layer root_layer;
+  TEST_CHECK(LoadLayerFromMemory(
+      reinterpret_cast<const uint8_t *>(root_usda.data()), root_usda.size(),
+      "root.usda", &root_layer, &warn, &err));
+
+  AssetResolutionResolver resolver;
+  resolver.set_current_working_path(dir);
+  resolver.set_search_paths({dir});
+
+  LayerCache layer_cache;
+  CompositionDependencyGraph graph;
+
+  ReferencesCompositionOptions options;
+  options.layer_cache = &layer_cache;
+  options.dependency_graph = &graph;
+
+  Layer composited_layer;
+  TEST_CHECK(CompositeReferences(resolver, root_layer, &composited_layer,
+                                 &warn, &err, options));
+  TEST_MSG("%s", err.c_str());
+
+  std::vector<std::string> assets = graph.get_asset_paths();
+  TEST_CHECK(assets.size() == 1);
+  if (assets.size() != 1) {
+    RemoveTempDir(dir, {ref_basename});
+    return;
+  }
+
+  std::vector<Path> dependents = graph.get_dependent_prim_paths(assets[0]);
+  TEST_CHECK(dependents.size() == 1);
+  TEST_CHECK(dependents[0].prim_part() == "/root");
+  TEST_CHECK(graph.has_arc(Path("/root", ""),
+                           static_cast<uint32_t>(LoadState::Reference)));
+  TEST_CHECK(!graph.has_arc(Path("/other", "")));
+
+  Stage stage;
+  TEST_CHECK(LayerToStage(composited_layer, &stage, &warn, &err));
+  TEST_CHECK(stage.root_prims().size() == 2);
+
+  int64_t other_prim_id{-1};
+  TEST_CHECK(stage.find_prim_at_path(Path("/other", ""), &other_prim_id));
+
+  // Modify referenced asset.
+  TEST_CHECK(WriteTextFile(ref_filename, R"(#usda 1.0
+def Xform "geom" {
+  def Xform "child" {
+  }
+}
+)"));
+
+  std::vector<Path> prim_paths;
+  TEST_CHECK(RecompositeReferences(resolver, root_layer, assets,
+                                   &composited_layer, &prim_paths, &warn,
+                                   &err, options));
+  TEST_MSG("%s", err.c_str());
+  TEST_CHECK(prim_paths.size() == 1);
+  if (prim_paths.size() == 1) {
+    TEST_CHECK(prim_paths[0].prim_part() == "/root");
+  }
+
+  const PrimSpec *ps{nullptr};
+  TEST_CHECK(composited_layer.find_primspec_at(Path("/root/child", ""), &ps,
+                                               &err));
+
+  TEST_CHECK(UpdateStageFromLayer(composited_layer, prim_paths, &stage, &warn,
+                                  &err));
+  TEST_MSG("%s", err.c_str());
+
+  const Prim *prim{nullptr};
+  TEST_CHECK(stage.find_prim_at_path(Path("/root/child", ""), prim, &err));
+
+  // Prims not recomposed keep their Prim id.
+  int64_t prim_id{-1};
+  TEST_CHECK(stage.find_prim_at_path(Path("/other", ""), &prim_id));
+  TEST_CHECK(prim_id == other_prim_id);
+
+  // Removed Prim is not found through the path cache of the Stage.
+  {
+    TEST_CHECK(UpdateStageFromLayer(Layer(), {Path("/root", "")}, &stage,
+                                    &warn, &err));
+    TEST_CHECK(!stage.find_prim_at_path(Path("/root/child", ""), prim, &err));
+    TEST_CHECK(!stage.find_prim_at_path(Path("/root", ""), prim, &err));
+    TEST_CHECK(stage.root_prims().size() == 1);
+
+    // Prim name can be reused after the removal.
+    TEST_CHECK(stage.add_root_prim(Prim("root", Xform()), /* rename */ false));
+  }
+
+  RemoveTempDir(dir, {ref_basename});
+}
+
+void layer_to_stage_test(void) {
+
+  const std::string usda = R"(#usda 1.0
+def Xform "root" {
+  def Mesh "mesh" {
+    point3f[] points = [(0, 0, 0), (1, 0, 0), (1, 1, 0)]
+    int[] faceVertexCounts = [3]
+    int[] faceVertexIndices = [0, 1, 2]
+  }
+
+  def "typeless" {
+  }
+}
+)";
+
+  std::string warn, err;
+  Layer layer;
+  TEST_CHECK(LoadLayerFromMemory(reinterpret_cast<const uint8_t *>(usda.data()),
+                                 usda.size(), "test.usda", &layer, &warn,
+                                 &err));
+
+  Stage stage;
+  TEST_CHECK(LayerToStage(layer, &stage, &warn, &err));
+  TEST_MSG("%s", err.c_str());
+
+  Stage moved_stage;
+  TEST_CHECK(LayerToStage(std::move(layer), &moved_stage, &warn, &err));
+  TEST_MSG("%s", err.c_str());
+
+  TEST_CHECK(layer.primspecs().empty());
+
+  const Prim *prim{nullptr};
+  TEST_CHECK(moved_stage.find_prim_at_path(Path("/root/mesh", ""), prim, &err));
+  if (prim) {
+    const GeomMesh *mesh = prim->as<GeomMesh>();
+    TEST_CHECK(mesh != nullptr);
+    if (mesh) {
+      TEST_CHECK(mesh->get_points().size() == 3);
+    }
+  }
+  TEST_CHECK(moved_stage.find_prim_at_path(Path("/root/typeless", ""), prim,
+                                           &err));
+
+  TEST_CHECK(stage.ExportToString() == moved_stage.ExportToString());
+}
@@ -0,0 +1,8 @@
+#pragma once
+
+void layer_cache_test(void);
+void layer_find_primspec_test(void);
+void composite_specializes_test(void);
+void threaded_load_test(void);
+void recomposite_references_test(void);
+void layer_to_stage_test(void);
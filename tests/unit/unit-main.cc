@@ -16,11 +16,17 @@
 #include "unit-strutil.h"
 #include "unit-timesamples.h"
 #include "unit-pprint.h"
+#include "unit-composition.h"
 
 #if defined(TINYUSDZ_WITH_PXR_COMPAT_API)
 #include "unit-pxr-compat-api.h"
 #endif
 
+#if defined(TINYUSDZ_WITH_TYDRA)
+#include "unit-xform-cache.h"
+#include "unit-tydra-render-data.h"
+#endif
+
 
 
 TEST_LIST = {
@@ -34,12 +40,38 @@ TEST_LIST = {
   { "math_cos_pi_test", math_cos_pi_test },
   { "math_sin_pi_test", math_sin_pi_test },
   { "math_sin_cos_pi_test", math_sin_cos_pi_test },
+  { "math_lerp_array_test", math_lerp_array_test },
   { "pathutil_test", pathutil_test },
   { "ioutil_test", ioutil_test },
   { "strutil_test", strutil_test },
   { "timesamples_test", timesamples_test },
+  { "layer_cache_test", layer_cache_test },
+  { "layer_find_primspec_test", layer_find_primspec_test },
+  { "composite_specializes_test", composite_specializes_test },
+  { "threaded_load_test", threaded_load_test },
+  { "recomposite_references_test", recomposite_references_test },
+  { "layer_to_stage_test", layer_to_stage_test },
 #if defined(TINYUSDZ_WITH_PXR_COMPAT_API)
   { "pxr_compat_api_test", pxr_compat_api_test },
+#endif
+#if defined(TINYUSDZ_WITH_TYDRA)
+  { "xform_hierarchy_test", xform_hierarchy_test },
+  { "xform_cache_test", xform_cache_test },
+  { "render_scene_threads_test", render_scene_threads_test },
+  { "texture_load_once_test", texture_load_once_test },
+  { "build_vertex_indices_test", build_vertex_indices_test },
+  { "vertex_to_corners_test", vertex_to_corners_test },
+  { "compute_normals_test", compute_normals_test },
+  { "compute_tangents_test", compute_tangents_test },
+  { "triangulate_test", triangulate_test },
+  { "render_scene_updater_test", render_scene_updater_test },
+  { "vertex_layout_test", vertex_layout_test },
+  { "vertex_encoding_test", vertex_encoding_test },
+  { "vertex_buffer_index_test", vertex_buffer_index_test },
+  { "vertex_buffer_expand_test", vertex_buffer_expand_test },
+  { "vertex_cache_optimize_test", vertex_cache_optimize_test },
+  { "mesh_lod_test", mesh_lod_test },
+  { "meshlet_test", meshlet_test },
 #endif
   { nullptr, nullptr }
 };
@@ -10,6 +10,7 @@
 #include "value-types.hh"
 #include "unit-value-types.h"
 #include "prim-types.hh"
+#include "value-eval-util.hh"
 #include "math-util.inc"
 #include "unit-common.hh"
 
@@ -87,3 +88,83 @@ void math_sin_cos_pi_test(void) {
   TEST_CHECK(math::is_close(math::sin_pi(-360.0/180.0), 0.0, 0.0));
 }
 
+
+void math_lerp_array_test(void) {
+
+  // Odd length to also test the remainder of SIMD loop.
+  constexpr size_t n = 13;
+  constexpr double t = 0.25;
+
+  {
+    std::vector<value::point3f> a(n), b(n);
+    for (size_t i = 0; i < n; i++) {
+      a[i] = {float(i), float(i) * 2.0f, -float(i)};
+      b[i] = {float(i) + 4.0f, 1.0f, float(i) * 3.0f};
+    }
+
+    std::vector<value::point3f> dst;
+    TEST_CHECK(lerp(a, b, t, &dst));
+    TEST_CHECK(dst.size() == n);
+    for (size_t i = 0; i < n; i++) {
+      for (size_t c = 0; c < 3; c++) {
+        float ref = 0.75f * a[i][c] + 0.25f * b[i][c];
+        TEST_CHECK(math::is_close(dst[i][c], ref));
+      }
+    }
+
+    // length mismatch
+    b.resize(n - 1);
+    TEST_CHECK(!lerp(a, b, t, &dst));
+    TEST_CHECK(dst.size() == n - 1);
+  }
+
+  {
+    std::vector<value::double3> a(n), b(n);
+    for (size_t i = 0; i < n; i++) {
+      a[i] = {double(i), 1.0, 2.0};
+      b[i] = {double(i) + 4.0, 3.0, -2.0};
+    }
+
+    std::vector<value::double3> dst = lerp(a, b, t);
+    TEST_CHECK(dst.size() == n);
+    for (size_t i = 0; i < n; i++) {
+      TEST_CHECK(math::is_close(dst[i][0], double(i) + 1.0));
+      TEST_CHECK(math::is_close(dst[i][1], 1.5));
+      TEST_CHECK(math::is_close(dst[i][2], 1.0));
+    }
+  }
+
+  {
+    std::vector<value::half3> a(n), b(n);
+    for (size_t i = 0; i < n; i++) {
+      a[i] = {value::float_to_half_full(0.0f), value::float_to_half_full(1.0f), value::float_to_half_full(float(i))};
+      b[i] = {value::float_to_half_full(4.0f), value::float_to_half_full(2.0f), value::float_to_half_full(float(i))};
+    }
+
+    std::vector<value::half3> dst;
+    TEST_CHECK(lerp(a, b, t, &dst));
+    for (size_t i = 0; i < n; i++) {
+      TEST_CHECK(math::is_close(value::half_to_float(dst[i][0]), 1.0f));
+      TEST_CHECK(math::is_close(value::half_to_float(dst[i][1]), 1.25f));
+      TEST_CHECK(math::is_close(value::half_to_float(dst[i][2]), float(i)));
+    }
+  }
+
+  {
+    std::vector<value::quatf> a(n), b(n);
+    for (size_t i = 0; i < n; i++) {
+      a[i].imag = {0.0f, 0.0f, 0.0f};
+      a[i].real = 1.0f;
+      b[i].imag = {0.0f, 0.0f, 1.0f};
+      b[i].real = 0.0f;
+    }
+
+    std::vector<value::quatf> dst;
+    TEST_CHECK(lerp(a, b, t, &dst));
+    for (size_t i = 0; i < n; i++) {
+      value::quatf ref = slerp(a[i], b[i], float(t));
+      TEST_CHECK(math::is_close(dst[i].real, ref.real));
+      TEST_CHECK(math::is_close(dst[i].imag[2], ref.imag[2]));
+    }
+  }
+}
@@ -3,3 +3,4 @@
 void math_sin_pi_test(void);
 void math_cos_pi_test(void);
 void math_sin_cos_pi_test(void);
+void math_lerp_array_test(void);
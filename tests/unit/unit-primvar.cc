@@ -33,4 +33,44 @@ void primvar_test(void) {
     
   }
 
+  // zero-copy array view
+  {
+    std::vector<point3f> points = {{0.0f, 0.0f, 0.0f}, {1.0f, 2.0f, 3.0f}};
+    tinyusdz::Attribute attr;
+    attr.set_value(points);
+
+    ArrayView<point3f> view;
+    TEST_CHECK(attr.get_array_view(TimeCode::Default(), &view));
+    TEST_CHECK(view.size() == 2);
+    TEST_CHECK(view[1][2] == 3.0f);
+
+    // Points to the storage of the Attribute.
+    const std::vector<point3f> *pv = attr.get_var().as<std::vector<point3f>>();
+    TEST_CHECK(pv != nullptr);
+    TEST_CHECK(view.data() == pv->data());
+
+    // role type cast
+    ArrayView<float3> fview;
+    TEST_CHECK(attr.get_array_view(TimeCode::Default(), &fview));
+    TEST_CHECK(fview.size() == 2);
+
+    // type mismatch
+    ArrayView<float> sview;
+    TEST_CHECK(!attr.get_array_view(TimeCode::Default(), &sview));
+
+    tinyusdz::GeomPrimvar primvar(attr);
+    TEST_CHECK(primvar.get_array_view(TimeCode::Default(), &view));
+    TEST_CHECK(view.size() == 2);
+
+    // timesamples
+    tinyusdz::Attribute tsattr;
+    tsattr.set_timesample(points, 0.0);
+    tsattr.set_timesample(std::vector<point3f>{{4.0f, 5.0f, 6.0f}}, 1.0);
+    TEST_CHECK(tsattr.get_array_view(1.0, &view));
+    TEST_CHECK(view.size() == 1);
+    TEST_CHECK(tsattr.get_array_view(0.5, &view, TimeSampleInterpolationType::Held));
+    TEST_CHECK(view.size() == 2);
+    TEST_CHECK(!tsattr.get_array_view(0.5, &view));
+  }
+
 }
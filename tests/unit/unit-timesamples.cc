@@ -188,6 +188,137 @@ void timesamples_test(void) {
     }      
   }
 
+  // Array samples are stored in a flattened buffer. Add samples out of order.
+  {
+    TypedTimeSamples<std::vector<float>> ts;
+    ts.add_sample(2.0, {20.0f, 40.0f});
+    ts.add_sample(0.0, {0.0f, 0.0f});
+    ts.add_blocked_sample(3.0);
+    ts.add_sample(1.0, {10.0f, 20.0f, 30.0f});
+
+    TEST_CHECK(ts.size() == 4);
+    TEST_CHECK(ts.get_times().size() == 4);
+    TEST_CHECK(math::is_close(ts.get_times()[0], 0.0));
+    TEST_CHECK(math::is_close(ts.get_times()[3], 3.0));
+    TEST_CHECK(!ts.is_blocked(2));
+    TEST_CHECK(ts.is_blocked(3));
+
+    std::vector<float> v;
+    TEST_CHECK(ts.get_value(1, &v));
+    TEST_CHECK(v.size() == 3);
+    TEST_CHECK(math::is_close(v[2], 30.0f));
+
+    // Held
+    TEST_CHECK(ts.get(&v, 1.5, value::TimeSampleInterpolationType::Held));
+    TEST_CHECK(v.size() == 3);
+    TEST_CHECK(math::is_close(v[0], 10.0f));
+
+    // Resize the sample at t=1 so that it can be interpolated with t=2.
+    size_t idx{0};
+    TEST_CHECK(ts.find_sample_at(1.0, &idx));
+    TEST_CHECK(idx == 1);
+    TEST_CHECK(ts.set_value(idx, {10.0f, 20.0f}));
+
+    TEST_CHECK(ts.get(&v, 1.5, value::TimeSampleInterpolationType::Linear));
+    TEST_CHECK(v.size() == 2);
+    TEST_CHECK(math::is_close(v[0], 15.0f));
+    TEST_CHECK(math::is_close(v[1], 30.0f));
+
+    TEST_CHECK(ts.get_value(2, &v));
+    TEST_CHECK(v.size() == 2);
+    TEST_CHECK(math::is_close(v[1], 40.0f));
+
+    TEST_CHECK(!ts.find_sample_at(0.5, &idx));
+  }
+
+  {
+    value::TimeSamples ts;
+    ts.add_sample(1.0, value::Value(10.0f));
+    ts.add_sample(0.0, value::Value(0.0f));
+    TEST_CHECK(math::is_close(ts.get_times()[0], 0.0));
+    TEST_CHECK(ts.get_values()[1].as<float>() != nullptr);
+    TEST_CHECK(math::is_close(*ts.get_values()[1].as<float>(), 10.0f));
+
+    TypedTimeSamples<float> tts;
+    TEST_CHECK(tts.from_timesamples(ts));
+    float f;
+    TEST_CHECK(tts.get(&f, 0.25));
+    TEST_CHECK(math::is_close(f, 2.5f));
+  }
+
+  // Cursor and batch evaluation
+  {
+    TypedTimeSamples<float> ts;
+    ts.add_sample(0.0, 0.0f);
+    ts.add_sample(1.0, 10.0f);
+    ts.add_sample(2.0, 30.0f);
+
+    std::vector<double> times = {-1.0, 0.0, 0.5, 1.0, 1.5, 2.0, 3.0};
+    std::vector<float> expected = {0.0f, 0.0f, 5.0f, 10.0f, 20.0f, 30.0f, 30.0f};
+
+    std::vector<float> dst(times.size());
+    TEST_CHECK(ts.get_batch(times.data(), times.size(), dst.data()));
+    for (size_t i = 0; i < times.size(); i++) {
+      TEST_CHECK(math::is_close(dst[i], expected[i]));
+    }
+
+    // Cursor also works with non-monotonic time.
+    value::TimeSampleCursor cursor;
+    float f;
+    TEST_CHECK(ts.get(&f, 1.5, value::TimeSampleInterpolationType::Linear, &cursor));
+    TEST_CHECK(math::is_close(f, 20.0f));
+    TEST_CHECK(cursor.index == 1);
+    TEST_CHECK(ts.get(&f, 0.5, value::TimeSampleInterpolationType::Linear, &cursor));
+    TEST_CHECK(math::is_close(f, 5.0f));
+    TEST_CHECK(ts.get(&f, 1.5, value::TimeSampleInterpolationType::Held, &cursor));
+    TEST_CHECK(math::is_close(f, 10.0f));
+
+    TypedTimeSamples<float> ts2;
+    ts2.add_sample(0.0, 100.0f);
+    ts2.add_sample(1.0, 200.0f);
+
+    const TypedTimeSamples<float> *samples[2] = {&ts, &ts2};
+    value::TimeSampleCursor cursors[2];
+    float values[2];
+    TEST_CHECK(EvaluateTimeSamples(samples, 2, 0.5, values, value::TimeSampleInterpolationType::Linear, cursors));
+    TEST_CHECK(math::is_close(values[0], 5.0f));
+    TEST_CHECK(math::is_close(values[1], 150.0f));
+  }
+
+  // Zero-copy array view
+  {
+    TypedTimeSamples<std::vector<float>> ts;
+    ts.add_sample(1.0, {1.0f, 2.0f, 3.0f});
+    ts.add_sample(0.0, {0.0f, 1.0f, 2.0f});
+
+    value::ArrayView<float> view;
+    TEST_CHECK(ts.get_value_view(1, &view));
+    TEST_CHECK(view.size() == 3);
+    TEST_CHECK(math::is_close(view[0], 1.0f));
+
+    TEST_CHECK(ts.get_array_view(&view, 0.0));
+    TEST_CHECK(math::is_close(view[2], 2.0f));
+
+    TEST_CHECK(ts.get_array_view(&view, 0.5, value::TimeSampleInterpolationType::Held));
+    TEST_CHECK(math::is_close(view[2], 2.0f));
+
+    // Needs interpolation
+    TEST_CHECK(!ts.get_array_view(&view, 0.5));
+
+    TEST_CHECK(ts.get_array_view(&view, 2.0));
+    TEST_CHECK(math::is_close(view[2], 3.0f));
+
+    Animatable<std::vector<float>> anim;
+    anim.set(std::vector<float>{4.0f, 5.0f});
+    TEST_CHECK(anim.get_array_view(value::TimeCode::Default(), &view));
+    TEST_CHECK(view.size() == 2);
+    TEST_CHECK(math::is_close(view[1], 5.0f));
+
+    anim.set(ts);
+    TEST_CHECK(anim.get_array_view(1.0, &view));
+    TEST_CHECK(view.to_vector() == std::vector<float>({1.0f, 2.0f, 3.0f}));
+  }
+
   {
     TEST_CHECK(value::IsLerpSupportedType(value::TypeTraits<value::float2>::type_id()));
     TEST_CHECK(value::IsLerpSupportedType(value::TypeTraits<std::vector<value::float2>>::type_id()));
@@ -0,0 +1,1838 @@
+#ifdef _MSC_VER
+#define NOMINMAX
+#endif
+
+#define TEST_NO_MAIN
+#include "acutest.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <map>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#include "unit-tydra-render-data.h"
+#include "prim-types.hh"
+#include "stage.hh"
+#include "tinyusdz.hh"
+#include "tydra/render-data.hh"
+
+using namespace tinyusdz;
+
+namespace {
+
+bool LoadStageFromString(const std::string &usda, Stage *stage) {
+  std::string warn, err;
+  bool ret = LoadUSDAFromMemory(reinterpret_cast<const uint8_t *>(usda.data()),
+                                usda.size(), "", stage, &warn, &err);
+  TEST_MSG("%s", err.c_str());
+  return ret;
+}
+
+// 2x2 quad grid mesh at `offset`.
+std::string GridMeshUSDA(const std::string &name, const float offset,
+                         const std::string &extra) {
+  std::string o = std::to_string(offset);
+  std::string s;
+  s += "  def Mesh \"" + name + "\" (\n";
+  s += "    prepend apiSchemas = [\"MaterialBindingAPI\", \"SkelBindingAPI\"]\n";
+  s += "  )\n  {\n";
+  s += "    int[] faceVertexCounts = [4, 4, 4, 4]\n";
+  s += "    int[] faceVertexIndices = [0, 1, 4, 3, 1, 2, 5, 4, 3, 4, 7, 6, 4, 5, 8, 7]\n";
+  s += "    point3f[] points = [";
+  for (int y = 0; y < 3; y++) {
+    for (int x = 0; x < 3; x++) {
+      s += "(" + std::to_string(x) + ", " + std::to_string(y) + ", " + o + ")";
+      s += ((y == 2) && (x == 2)) ? "]\n" : ", ";
+    }
+  }
+  s += "    texCoord2f[] primvars:st = [(0, 0), (0.5, 0), (0.5, 0.5), (0, 0.5), "
+       "(0.5, 0), (1, 0), (1, 0.5), (0.5, 0.5), (0, 0.5), (0.5, 0.5), "
+       "(0.5, 1), (0, 1), (0.5, 0.5), (1, 0.5), (1, 1), (0.5, 1)] (\n";
+  s += "      interpolation = \"faceVarying\"\n    )\n";
+  s += extra;
+  s += "  }\n";
+  return s;
+}
+
+std::string MaterialUSDA(const std::string &name, const std::string &color) {
+  std::string s;
+  s += "  def Material \"" + name + "\"\n  {\n";
+  s += "    token outputs:surface.connect = </Looks/" + name +
+       "/shader.outputs:surface>\n";
+  s += "    def Shader \"shader\"\n    {\n";
+  s += "      uniform token info:id = \"UsdPreviewSurface\"\n";
+  s += "      color3f inputs:diffuseColor = " + color + "\n";
+  s += "      token outputs:surface\n    }\n  }\n";
+  return s;
+}
+
+// Meshes with materials, GeomSubsets and BlendShapes(inside and outside of
+// the mesh's subtree).
+std::string MakeMultiMeshUSDA(const size_t num_meshes) {
+  const char *materials[] = {"Red", "Green", "Blue"};
+
+  std::string s = "#usda 1.0\n\ndef Xform \"root\"\n{\n";
+  for (size_t i = 0; i < num_meshes; i++) {
+    std::string name = "mesh" + std::to_string(i);
+    std::string extra;
+    extra += "    rel material:binding = </Looks/" +
+             std::string(materials[i % 3]) + ">\n";
+
+    if ((i % 4) == 1) {
+      extra += "    uniform token subsetFamily:materialBind:familyType = \"partition\"\n";
+      extra += "    def GeomSubset \"subset0\" (\n";
+      extra += "      prepend apiSchemas = [\"MaterialBindingAPI\"]\n    )\n    {\n";
+      extra += "      uniform token elementName = \"face\"\n";
+      extra += "      uniform token familyName = \"materialBind\"\n";
+      extra += "      int[] indices = [0, 3]\n";
+      extra += "      rel material:binding = </Looks/Blue>\n    }\n";
+      extra += "    def GeomSubset \"subset1\" (\n";
+      extra += "      prepend apiSchemas = [\"MaterialBindingAPI\"]\n    )\n    {\n";
+      extra += "      uniform token elementName = \"face\"\n";
+      extra += "      uniform token familyName = \"materialBind\"\n";
+      extra += "      int[] indices = [1, 2]\n";
+      extra += "      rel material:binding = </Looks/Green>\n    }\n";
+    } else if ((i % 4) == 2) {
+      // BlendShape in the mesh's subtree.
+      extra += "    uniform token[] skel:blendShapes = [\"key\"]\n";
+      extra += "    rel skel:blendShapeTargets = </root/" + name + "/key>\n";
+      extra += "    def BlendShape \"key\"\n    {\n";
+      extra += "      uniform vector3f[] offsets = [(0, 0, 1), (0, 0, 2)]\n";
+      extra += "      uniform int[] pointIndices = [0, 4]\n    }\n";
+    } else if ((i % 4) == 3) {
+      // BlendShape outside of the mesh's subtree.
+      extra += "    uniform token[] skel:blendShapes = [\"shared\"]\n";
+      extra += "    rel skel:blendShapeTargets = </root/shapes/shared>\n";
+    }
+
+    s += GridMeshUSDA(name, float(i), extra);
+  }
+
+  s += "  def Scope \"shapes\"\n  {\n";
+  s += "    def BlendShape \"shared\"\n    {\n";
+  s += "      uniform vector3f[] offsets = [(1, 0, 0)]\n";
+  s += "      uniform int[] pointIndices = [8]\n    }\n  }\n";
+  s += "}\n\ndef Scope \"Looks\"\n{\n";
+  s += MaterialUSDA("Red", "(1, 0, 0)");
+  s += MaterialUSDA("Green", "(0, 1, 0)");
+  s += MaterialUSDA("Blue", "(0, 0, 1)");
+  s += "}\n";
+
+  return s;
+}
+
+bool ConvertStage(const Stage &stage, const int num_threads,
+                  tydra::RenderScene *scene) {
+  tydra::RenderSceneConverterEnv env(stage);
+  env.scene_config.load_texture_assets = false;
+  env.scene_config.num_threads = num_threads;
+  // Ignored for meshes converted concurrently.
+  env.mesh_config.num_threads = num_threads;
+
+  tydra::RenderSceneConverter converter;
+  bool ret = converter.ConvertToRenderScene(env, scene);
+  TEST_MSG("%s", converter.GetError().c_str());
+  return ret;
+}
+
+// UsdPreviewSurface with diffuseColor texture.
+std::string TexturedMaterialUSDA(const std::string &name,
+                                 const std::string &file) {
+  std::string s;
+  s += "  def Material \"" + name + "\"\n  {\n";
+  s += "    token outputs:surface.connect = </Looks/" + name +
+       "/shader.outputs:surface>\n";
+  s += "    def Shader \"shader\"\n    {\n";
+  s += "      uniform token info:id = \"UsdPreviewSurface\"\n";
+  s += "      color3f inputs:diffuseColor.connect = </Looks/" + name +
+       "/tex.outputs:rgb>\n";
+  s += "      token outputs:surface\n    }\n";
+  s += "    def Shader \"tex\"\n    {\n";
+  s += "      uniform token info:id = \"UsdUVTexture\"\n";
+  s += "      asset inputs:file = @" + file + "@\n";
+  s += "      float3 outputs:rgb\n    }\n  }\n";
+  return s;
+}
+
+struct TextureLoadCounter {
+  std::mutex mutex;
+  std::map<std::string, int> counts;
+};
+
+// Returns 1x1 RGBA image without file access, and counts the # of calls for
+// each asset.
+bool CountingTextureLoader(const value::AssetPath &assetPath,
+                           const AssetInfo &assetInfo,
+                           const AssetResolutionResolver &assetResolver,
+                           tydra::TextureImage *imageOut,
+                           std::vector<uint8_t> *imageData, void *userdata,
+                           std::string *warn, std::string *err) {
+  (void)assetInfo;
+  (void)assetResolver;
+  (void)warn;
+  (void)err;
+
+  TextureLoadCounter *counter = reinterpret_cast<TextureLoadCounter *>(userdata);
+  {
+    std::lock_guard<std::mutex> lock(counter->mutex);
+    counter->counts[assetPath.GetAssetPath()]++;
+  }
+
+  imageOut->width = 1;
+  imageOut->height = 1;
+  imageOut->channels = 4;
+  imageOut->texelComponentType = tydra::ComponentType::UInt8;
+  imageOut->assetTexelComponentType = tydra::ComponentType::UInt8;
+  imageData->assign(4, 255);
+
+  return true;
+}
+
+bool NearlyEqual(const tydra::vec3 &a, const tydra::vec3 &b,
+                 const float eps = 1.0e-5f) {
+  return (std::fabs(a[0] - b[0]) < eps) && (std::fabs(a[1] - b[1]) < eps) &&
+         (std::fabs(a[2] - b[2]) < eps);
+}
+
+// Element range [begin, end) of the arrays whose elements differ.
+tydra::RenderSceneUpdateResult::Range DiffRange(const std::vector<uint8_t> &a,
+                                                const std::vector<uint8_t> &b,
+                                                const size_t stride) {
+  tydra::RenderSceneUpdateResult::Range range;
+  const size_t n = (std::min)(a.size(), b.size()) / stride;
+  for (size_t i = 0; i < n; i++) {
+    if (memcmp(a.data() + i * stride, b.data() + i * stride, stride) != 0) {
+      range.extend(i);
+    }
+  }
+  return range;
+}
+
+bool SameRange(const tydra::RenderSceneUpdateResult::Range &a,
+               const tydra::RenderSceneUpdateResult::Range &b) {
+  return (a.empty() && b.empty()) || ((a.begin == b.begin) && (a.end == b.end));
+}
+
+tydra::VertexAttribute MakeVertexAttribute(
+    const std::vector<float> &values, const tydra::VertexAttributeFormat format,
+    const tydra::VertexVariability variability) {
+  tydra::VertexAttribute vattr;
+  vattr.format = format;
+  vattr.variability = variability;
+  vattr.set_buffer(reinterpret_cast<const uint8_t *>(values.data()),
+                   values.size() * sizeof(float));
+  return vattr;
+}
+
+// Read `T` at byte offset `offset` of vertex `v`.
+template <typename T>
+T ReadVertexValue(const tydra::BufferData &vb, const uint32_t stride,
+                  const size_t v, const size_t offset) {
+  T val;
+  memcpy(&val, vb.data.data() + v * stride + offset, sizeof(T));
+  return val;
+}
+
+// UV sphere of `rings` x `segments` quads(triangle fans at the poles). With
+// `seam`, vertices of the first column are duplicated at the last column as
+// UV seam vertices. `canon` receives the vertex index of the first column for
+// each vertex.
+tydra::RenderMesh MakeSphereMesh(const uint32_t rings, const uint32_t segments,
+                                 const bool seam,
+                                 std::vector<uint32_t> *canon) {
+  const uint32_t cols = seam ? segments + 1 : segments;
+  const float kPi = 3.14159265358979f;
+
+  tydra::RenderMesh mesh;
+  canon->clear();
+
+  mesh.points.push_back({0.0f, 1.0f, 0.0f});
+  canon->push_back(0);
+  for (uint32_t i = 1; i < rings; i++) {
+    const float theta = kPi * float(i) / float(rings);
+    for (uint32_t j = 0; j < cols; j++) {
+      const float phi = 2.0f * kPi * float(j % segments) / float(segments);
+      mesh.points.push_back({std::sin(theta) * std::cos(phi), std::cos(theta),
+                             std::sin(theta) * std::sin(phi)});
+      canon->push_back(1 + (i - 1) * cols + (j % segments));
+    }
+  }
+  const uint32_t south = uint32_t(mesh.points.size());
+  mesh.points.push_back({0.0f, -1.0f, 0.0f});
+  canon->push_back(south);
+
+  auto vid = [&](const uint32_t i, const uint32_t j) {
+    const uint32_t c = seam ? j : (j % segments);
+    return 1 + (i - 1) * cols + c;
+  };
+
+  std::vector<uint32_t> indices;
+  for (uint32_t j = 0; j < segments; j++) {
+    indices.insert(indices.end(), {0, vid(1, j + 1), vid(1, j)});
+    indices.insert(indices.end(),
+                   {south, vid(rings - 1, j), vid(rings - 1, j + 1)});
+  }
+  for (uint32_t i = 1; (i + 1) < rings; i++) {
+    for (uint32_t j = 0; j < segments; j++) {
+      indices.insert(indices.end(), {vid(i, j), vid(i, j + 1), vid(i + 1, j)});
+      indices.insert(indices.end(),
+                     {vid(i + 1, j), vid(i, j + 1), vid(i + 1, j + 1)});
+    }
+  }
+
+  mesh.usdFaceVertexIndices = indices;
+  mesh.usdFaceVertexCounts.assign(indices.size() / 3, 3);
+  mesh.triangulatedFaceVertexIndices = indices;
+  mesh.triangulatedFaceVertexCounts.assign(indices.size() / 3, 3);
+  mesh.is_single_indexable = true;
+  return mesh;
+}
+
+// true when every edge(in terms of `canon` vertices) of the triangle list is
+// shared by exactly two triangles.
+bool IsClosedMesh(const std::vector<uint32_t> &indices,
+                  const std::vector<uint32_t> &canon) {
+  std::map<std::pair<uint32_t, uint32_t>, int> edges;
+  for (size_t t = 0; t < indices.size() / 3; t++) {
+    for (size_t k = 0; k < 3; k++) {
+      const uint32_t a = canon[indices[3 * t + k]];
+      const uint32_t b = canon[indices[3 * t + ((k + 1) % 3)]];
+      edges[std::make_pair((std::min)(a, b), (std::max)(a, b))]++;
+    }
+  }
+  for (const auto &it : edges) {
+    if (it.second != 2) {
+      return false;
+    }
+  }
+  return !edges.empty();
+}
+
+}  // namespace
+
+void render_scene_threads_test(void) {
+  const size_t num_meshes = 16;
+
+  Stage stage;
+  TEST_CHECK(LoadStageFromString(MakeMultiMeshUSDA(num_meshes), &stage));
+
+  tydra::RenderScene serial_scene;
+  TEST_CHECK(ConvertStage(stage, /* num_threads */ 1, &serial_scene));
+
+  TEST_CHECK(serial_scene.meshes.size() == num_meshes);
+  TEST_CHECK(serial_scene.materials.size() == 3);
+  if (serial_scene.meshes.size() != num_meshes) {
+    return;
+  }
+
+  // Mesh ids are assigned in the traversal order.
+  for (size_t i = 0; i < num_meshes; i++) {
+    TEST_CHECK(serial_scene.meshes[i].abs_path ==
+               "/root/mesh" + std::to_string(i));
+  }
+  TEST_CHECK(serial_scene.meshes[2].targets.size() == 1);
+  TEST_CHECK(serial_scene.meshes[3].targets.size() == 1);
+
+  const std::string serial_dump = tydra::DumpRenderScene(serial_scene);
+
+  for (int num_threads : {2, 4, -1}) {
+    tydra::RenderScene scene;
+    TEST_CHECK(ConvertStage(stage, num_threads, &scene));
+    TEST_CHECK(tydra::DumpRenderScene(scene) == serial_dump);
+    TEST_MSG("num_threads = %d", num_threads);
+  }
+}
+
+void texture_load_once_test(void) {
+  // 6 meshes bound to 3 materials. 2 materials refer to the same texture.
+  std::string usda = "#usda 1.0\n\ndef Xform \"root\"\n{\n";
+  const char *materials[] = {"A", "B", "C"};
+  for (size_t i = 0; i < 6; i++) {
+    usda += GridMeshUSDA("mesh" + std::to_string(i), float(i),
+                         "    rel material:binding = </Looks/" +
+                             std::string(materials[i % 3]) + ">\n");
+  }
+  usda += "}\n\ndef Scope \"Looks\"\n{\n";
+  usda += TexturedMaterialUSDA("A", "shared.png");
+  usda += TexturedMaterialUSDA("B", "shared.png");
+  usda += TexturedMaterialUSDA("C", "other.png");
+  usda += "}\n";
+
+  Stage stage;
+  TEST_CHECK(LoadStageFromString(usda, &stage));
+
+  for (int num_threads : {1, 4}) {
+    TextureLoadCounter counter;
+
+    tydra::RenderSceneConverterEnv env(stage);
+    env.material_config.texture_image_loader_function = CountingTextureLoader;
+    env.material_config.texture_image_loader_function_userdata = &counter;
+    env.material_config.texture_load_num_threads = num_threads;
+
+    tydra::RenderScene scene;
+    tydra::RenderSceneConverter converter;
+    TEST_CHECK(converter.ConvertToRenderScene(env, &scene));
+    TEST_MSG("%s", converter.GetError().c_str());
+
+    TEST_CHECK(counter.counts.size() == 2);
+    TEST_CHECK(counter.counts["shared.png"] == 1);
+    TEST_CHECK(counter.counts["other.png"] == 1);
+    TEST_MSG("num_threads = %d", num_threads);
+
+    TEST_CHECK(scene.images.size() == 2);
+    TEST_CHECK(scene.textures.size() == 3);
+    if (scene.textures.size() == 3) {
+      TEST_CHECK(scene.textures[0].texture_image_id ==
+                 scene.textures[1].texture_image_id);
+      TEST_CHECK(scene.textures[0].texture_image_id !=
+                 scene.textures[2].texture_image_id);
+    }
+  }
+}
+
+void build_vertex_indices_test(void) {
+  // Face vertex indices refer to points beyond the # of face vertices, and
+  // point 7 has two different texcoords, so face vertices are welded.
+  const std::string usda = R"(#usda 1.0
+def Mesh "tri"
+{
+  int[] faceVertexCounts = [3, 3]
+  int[] faceVertexIndices = [7, 2, 3, 2, 7, 3]
+  point3f[] points = [(9, 9, 9), (9, 9, 9), (1, 0, 0), (0, 1, 0), (9, 9, 9), (9, 9, 9), (9, 9, 9), (0, 0, 0)]
+  texCoord2f[] primvars:st = [(0, 0), (1, 0), (0, 1), (1, 0), (0.5, 0.5), (0, 1)] (
+    interpolation = "faceVarying"
+  )
+}
+)";
+
+  Stage stage;
+  TEST_CHECK(LoadStageFromString(usda, &stage));
+
+  tydra::RenderSceneConverterEnv env(stage);
+  env.scene_config.load_texture_assets = false;
+  env.mesh_config.build_vertex_indices = true;
+
+  tydra::RenderScene scene;
+  tydra::RenderSceneConverter converter;
+  TEST_CHECK(converter.ConvertToRenderScene(env, &scene));
+  TEST_MSG("%s", converter.GetError().c_str());
+
+  TEST_CHECK(scene.meshes.size() == 1);
+  if (scene.meshes.size() != 1) {
+    return;
+  }
+
+  const tydra::RenderMesh &mesh = scene.meshes[0];
+  const std::vector<uint32_t> &indices = mesh.faceVertexIndices();
+  TEST_CHECK(mesh.is_single_indexable);
+  TEST_CHECK(indices.size() == 6);
+  TEST_CHECK(mesh.points.size() == 4);
+  TEST_MSG("# of points = %d", int(mesh.points.size()));
+  if ((indices.size() == 6) && (mesh.points.size() == 4)) {
+    // Positions are reordered along with the vertex indices.
+    const float expected[6][3] = {{0, 0, 0}, {1, 0, 0}, {0, 1, 0},
+                                  {1, 0, 0}, {0, 0, 0}, {0, 1, 0}};
+    for (size_t i = 0; i < 6; i++) {
+      TEST_CHECK(indices[i] < 4);
+      const tydra::vec3 &p = mesh.points[indices[i]];
+      TEST_CHECK((p[0] == expected[i][0]) && (p[1] == expected[i][1]) &&
+                 (p[2] == expected[i][2]));
+    }
+    TEST_CHECK(indices[0] != indices[4]);
+    TEST_CHECK(indices[1] == indices[3]);
+  }
+}
+
+void vertex_to_corners_test(void) {
+  // Vertex 4 is not referenced.
+  const std::vector<uint32_t> indices = {0, 1, 2, 2, 1, 3};
+
+  std::vector<size_t> offsets;
+  std::vector<uint32_t> corners;
+  tydra::BuildVertexToCorners(indices.data(), indices.size(),
+                              /* num_vertices */ 5, &offsets, &corners);
+
+  TEST_CHECK(offsets == std::vector<size_t>({0, 1, 3, 5, 6, 6}));
+  TEST_CHECK(corners == std::vector<uint32_t>({0, 1, 4, 2, 3, 5}));
+}
+
+void compute_normals_test(void) {
+  // Triangle A(0, 1, 2) on the XY plane(area 2) and triangle B(0, 3, 1) on
+  // the XZ plane(area 1) share the edge (0, 1).
+  const std::vector<tydra::vec3> points = {
+      {0.0f, 0.0f, 0.0f}, {2.0f, 0.0f, 0.0f}, {0.0f, 2.0f, 0.0f},
+      {0.0f, 0.0f, 1.0f}};
+  const std::vector<uint32_t> counts = {3, 3};
+  const std::vector<uint32_t> indices = {0, 1, 2, 0, 3, 1};
+
+  const tydra::vec3 nA{0.0f, 0.0f, 1.0f};
+  const tydra::vec3 nB{0.0f, 1.0f, 0.0f};
+
+  for (int num_threads : {1, -1}) {
+    std::vector<tydra::vec3> normals;
+    std::string err;
+
+    // Area: (2 * nA + 1 * nB) / sqrt(5) at the shared vertices.
+    TEST_CHECK(tydra::ComputeNormals(points, counts, indices,
+                                     tydra::NormalWeighting::Area, num_threads,
+                                     normals, &err));
+    TEST_MSG("%s", err.c_str());
+    TEST_CHECK(normals.size() == 4);
+    if (normals.size() == 4) {
+      const float s5 = 1.0f / std::sqrt(5.0f);
+      const tydra::vec3 shared{0.0f, s5, 2.0f * s5};
+      TEST_CHECK(NearlyEqual(normals[0], shared));
+      TEST_CHECK(NearlyEqual(normals[1], shared));
+      TEST_CHECK(NearlyEqual(normals[2], nA));
+      TEST_CHECK(NearlyEqual(normals[3], nB));
+    }
+
+    // Angle: corner angles at vertex 0 are both pi/2. At vertex 1, pi/4 in A
+    // and atan(1/2) in B.
+    TEST_CHECK(tydra::ComputeNormals(points, counts, indices,
+                                     tydra::NormalWeighting::Angle,
+                                     num_threads, normals, &err));
+    TEST_MSG("%s", err.c_str());
+    TEST_CHECK(normals.size() == 4);
+    if (normals.size() == 4) {
+      const float s2 = 1.0f / std::sqrt(2.0f);
+      TEST_CHECK(NearlyEqual(normals[0], {0.0f, s2, s2}));
+
+      const float a = std::atan(0.5f);
+      const float b = std::atan(1.0f);
+      const float l = std::sqrt(a * a + b * b);
+      TEST_CHECK(NearlyEqual(normals[1], {0.0f, a / l, b / l}));
+      TEST_CHECK(NearlyEqual(normals[2], nA));
+      TEST_CHECK(NearlyEqual(normals[3], nB));
+    }
+  }
+}
+
+void compute_tangents_test(void) {
+  // Unit quad on the XY plane as two triangles. Texcoords are rotated by 90
+  // degrees: u = y, v = 1 - x, so tangent(dP/du) = +Y and
+  // binormal(dP/dv) = -X.
+  const std::vector<tydra::vec3> points = {
+      {0.0f, 0.0f, 0.0f}, {1.0f, 0.0f, 0.0f}, {1.0f, 1.0f, 0.0f},
+      {0.0f, 1.0f, 0.0f}};
+  const std::vector<uint32_t> indices = {0, 1, 2, 0, 2, 3};
+
+  std::vector<tydra::vec2> texcoords;
+  std::vector<tydra::vec3> normals;
+  for (uint32_t idx : indices) {
+    texcoords.push_back({points[idx][1], 1.0f - points[idx][0]});
+    normals.push_back({0.0f, 0.0f, 1.0f});
+  }
+
+  std::vector<tydra::vec3> tangents;
+  std::vector<tydra::vec3> binormals;
+  std::vector<uint32_t> vertex_indices;
+  std::string err;
+
+  // Triangle mesh: faceVertexCounts can be empty.
+  TEST_CHECK(tydra::ComputeTangentsAndBinormals(
+      points, {}, indices, texcoords, normals,
+      /* is_facevarying_input */ true, /* num_threads */ 1, &tangents,
+      &binormals, &vertex_indices, &err));
+  TEST_MSG("%s", err.c_str());
+
+  // Face vertices of the shared diagonal have the same texcoord and normal,
+  // so they are merged.
+  TEST_CHECK(tangents.size() == 4);
+  TEST_CHECK(binormals.size() == 4);
+  TEST_CHECK(vertex_indices.size() == 6);
+  if ((tangents.size() == 4) && (vertex_indices.size() == 6)) {
+    TEST_CHECK(vertex_indices[0] == vertex_indices[3]);
+    TEST_CHECK(vertex_indices[2] == vertex_indices[4]);
+    for (size_t v = 0; v < 4; v++) {
+      TEST_CHECK(NearlyEqual(tangents[v], {0.0f, 1.0f, 0.0f}));
+      TEST_CHECK(NearlyEqual(binormals[v], {-1.0f, 0.0f, 0.0f}));
+      TEST_MSG("vertex %d", int(v));
+    }
+  }
+
+  // A UV seam on vertex 0 splits it into two vertices.
+  texcoords[3] = {0.5f, 0.5f};
+  TEST_CHECK(tydra::ComputeTangentsAndBinormals(
+      points, {}, indices, texcoords, normals,
+      /* is_facevarying_input */ true, /* num_threads */ 1, &tangents,
+      &binormals, &vertex_indices, &err));
+  TEST_CHECK(tangents.size() == 5);
+  if (vertex_indices.size() == 6) {
+    TEST_CHECK(vertex_indices[0] != vertex_indices[3]);
+  }
+}
+
+void triangulate_test(void) {
+  // 0: convex quad(kite). The diagonal (1, 3) is shorter.
+  // 1: concave quad(dart). Vertex 6 is reflex.
+  // 2: convex pentagon.
+  // 3: concave pentagon(CCW). Vertex 16 is reflex.
+  // 4: face 3 in CW order.
+  const std::string usda = R"(#usda 1.0
+def Mesh "polys"
+{
+  int[] faceVertexCounts = [4, 4, 5, 5, 5]
+  int[] faceVertexIndices = [0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15, 16, 17, 22, 21, 20, 19, 18]
+  point3f[] points = [(0, 0, 0), (2, -1, 0), (4, 0, 0), (2, 1, 0), (10, 0, 0), (14, -2, 0), (12, 0, 0), (14, 2, 0), (20, 0, 0), (22, 0, 0), (23, 1.5, 0), (21, 3, 0), (19, 1.5, 0), (30, 0, 0), (34, 0, 0), (34, 4, 0), (32, 1, 0), (30, 4, 0), (40, 0, 0), (44, 0, 0), (44, 4, 0), (42, 1, 0), (40, 4, 0)]
+}
+)";
+
+  Stage stage;
+  TEST_CHECK(LoadStageFromString(usda, &stage));
+
+  tydra::RenderSceneConverterEnv env(stage);
+  env.scene_config.load_texture_assets = false;
+  env.mesh_config.triangulate = true;
+  env.mesh_config.build_vertex_indices = false;
+  env.mesh_config.compute_normals = false;
+  env.mesh_config.compute_tangents_and_binormals = false;
+
+  tydra::RenderScene scene;
+  tydra::RenderSceneConverter converter;
+  TEST_CHECK(converter.ConvertToRenderScene(env, &scene));
+  TEST_MSG("%s", converter.GetError().c_str());
+
+  TEST_CHECK(scene.meshes.size() == 1);
+  if (scene.meshes.size() != 1) {
+    return;
+  }
+
+  const tydra::RenderMesh &mesh = scene.meshes[0];
+  TEST_CHECK(mesh.is_triangulated());
+  TEST_CHECK(mesh.triangulatedFaceCounts ==
+             std::vector<uint32_t>({2, 2, 3, 3, 3}));
+
+  const std::vector<uint32_t> &indices = mesh.triangulatedFaceVertexIndices;
+  const std::vector<size_t> &fv_map = mesh.triangulatedToOrigFaceVertexIndexMap;
+  TEST_CHECK(indices.size() == 3 * 13);
+  TEST_CHECK(fv_map.size() == indices.size());
+  if ((indices.size() != 3 * 13) || (fv_map.size() != indices.size())) {
+    return;
+  }
+
+  for (size_t k = 0; k < indices.size(); k++) {
+    TEST_CHECK(indices[k] == mesh.usdFaceVertexIndices[fv_map[k]]);
+  }
+
+  auto Triangles = [&](size_t tri, size_t n) {
+    return std::vector<uint32_t>(indices.begin() + long(3 * tri),
+                                 indices.begin() + long(3 * (tri + n)));
+  };
+
+  // Kite: split at the shorter diagonal.
+  TEST_CHECK(Triangles(0, 2) == std::vector<uint32_t>({1, 2, 3, 1, 3, 0}));
+  // Dart: split at the diagonal through the reflex vertex.
+  TEST_CHECK(Triangles(2, 2) == std::vector<uint32_t>({4, 5, 6, 4, 6, 7}));
+  // Convex pentagon: fan.
+  TEST_CHECK(Triangles(4, 3) ==
+             std::vector<uint32_t>({8, 9, 10, 8, 10, 11, 8, 11, 12}));
+
+  // Concave pentagons: earcut triangles cover the polygon(area 10) and keep
+  // the winding of the input polygon.
+  auto SignedArea = [&](size_t tri) {
+    const tydra::vec3 &p0 = mesh.points[indices[3 * tri + 0]];
+    const tydra::vec3 &p1 = mesh.points[indices[3 * tri + 1]];
+    const tydra::vec3 &p2 = mesh.points[indices[3 * tri + 2]];
+    return 0.5f * ((p1[0] - p0[0]) * (p2[1] - p0[1]) -
+                   (p2[0] - p0[0]) * (p1[1] - p0[1]));
+  };
+
+  for (size_t face = 0; face < 2; face++) {
+    const float sign = (face == 0) ? 1.0f : -1.0f;
+    const uint32_t first_point = (face == 0) ? 13 : 18;
+    float area = 0.0f;
+    for (size_t tri = 7 + 3 * face; tri < 10 + 3 * face; tri++) {
+      for (size_t k = 0; k < 3; k++) {
+        TEST_CHECK((indices[3 * tri + k] >= first_point) &&
+                   (indices[3 * tri + k] < first_point + 5));
+      }
+      TEST_CHECK(sign * SignedArea(tri) > 0.0f);
+      TEST_MSG("face %d, triangle %d", int(face + 3), int(tri));
+      area += SignedArea(tri);
+    }
+    TEST_CHECK(std::fabs(area - sign * 10.0f) < 1.0e-4f);
+  }
+}
+
+void render_scene_updater_test(void) {
+  // "welded": animated points(the choice of the quad diagonals does not
+  // change, so the triangulation matches with a fresh conversion), computed
+  // normals, faceVarying texcoords with a
+  // seam(points 1, 4 and 7 have two texcoords) and tangents/binormals computed
+  // by Tydra. `primvars:st` is read by the textured material "T".
+  // "authored": animated authored normals and a material with an animated
+  // UsdPreviewSurface parameter.
+  const std::string usda = R"(#usda 1.0
+def Xform "root"
+{
+  double3 xformOp:translate.timeSamples = { 0: (0, 0, 0), 1: (2, 0, 0) }
+  uniform token[] xformOpOrder = ["xformOp:translate"]
+
+  def Mesh "welded" (
+    prepend apiSchemas = ["MaterialBindingAPI"]
+  )
+  {
+    int[] faceVertexCounts = [4, 4, 4, 4]
+    int[] faceVertexIndices = [0, 1, 4, 3, 1, 2, 5, 4, 3, 4, 7, 6, 4, 5, 8, 7]
+    point3f[] points.timeSamples = {
+      0: [(0, 0, 0), (1, 0, 0), (2, 0, 0), (0, 1, 0), (1, 1, 0.5), (2, 1, 0), (0, 2, 0), (1, 2, 0), (2, 2, 0)],
+      1: [(0, 0, 0), (1, 0, 0), (2, 0, 0), (0, 1, 0), (1, 1, 1), (2, 1, 0), (0, 2, 0), (1, 2, 0), (2, 2, 0)]
+    }
+    texCoord2f[] primvars:st = [(0, 0), (0.5, 0), (0.5, 0.5), (0, 0.5), (0.6, 0), (1, 0), (1, 0.5), (0.6, 0.5), (0, 0.5), (0.5, 0.5), (0.5, 1), (0, 1), (0.6, 0.5), (1, 0.5), (1, 1), (0.6, 1)] (
+      interpolation = "faceVarying"
+    )
+    float3[] primvars:tangents = [(1, 0, 0), (1, 0, 0), (1, 0, 0), (1, 0, 0), (1, 0, 0), (1, 0, 0), (1, 0, 0), (1, 0, 0), (1, 0, 0), (1, 0, 0), (1, 0, 0), (1, 0, 0), (1, 0, 0), (1, 0, 0), (1, 0, 0), (1, 0, 0)] (
+      interpolation = "faceVarying"
+    )
+    float3[] primvars:binormals = [(0, 1, 0), (0, 1, 0), (0, 1, 0), (0, 1, 0), (0, 1, 0), (0, 1, 0), (0, 1, 0), (0, 1, 0), (0, 1, 0), (0, 1, 0), (0, 1, 0), (0, 1, 0), (0, 1, 0), (0, 1, 0), (0, 1, 0), (0, 1, 0)] (
+      interpolation = "faceVarying"
+    )
+    rel material:binding = </Looks/T>
+  }
+
+  def Mesh "authored" (
+    prepend apiSchemas = ["MaterialBindingAPI"]
+  )
+  {
+    int[] faceVertexCounts = [4, 4, 4, 4]
+    int[] faceVertexIndices = [0, 1, 4, 3, 1, 2, 5, 4, 3, 4, 7, 6, 4, 5, 8, 7]
+    point3f[] points = [(0, 0, 1), (1, 0, 1), (2, 0, 1), (0, 1, 1), (1, 1, 1), (2, 1, 1), (0, 2, 1), (1, 2, 1), (2, 2, 1)]
+    normal3f[] normals.timeSamples = {
+      0: [(0, 0, 1), (0, 0, 1), (0, 0, 1), (0, 0, 1), (0, 0, 1), (0, 0, 1), (0, 0, 1), (0, 0, 1), (0, 0, 1)],
+      1: [(0, 0, 1), (0, 0, 1), (0, 0, 1), (0, 0, 1), (0, 0.6, 0.8), (0, 0, 1), (0, 0, 1), (0, 0, 1), (0, 0, 1)]
+    }
+    uniform token normals:interpolation = "vertex"
+    rel material:binding = </Looks/A>
+  }
+}
+
+def Scope "Looks"
+{
+  def Material "A"
+  {
+    token outputs:surface.connect = </Looks/A/shader.outputs:surface>
+    def Shader "shader"
+    {
+      uniform token info:id = "UsdPreviewSurface"
+      color3f inputs:diffuseColor.timeSamples = { 0: (1, 0, 0), 1: (0, 0, 1) }
+      token outputs:surface
+    }
+  }
+
+  def Material "T"
+  {
+    token outputs:surface.connect = </Looks/T/shader.outputs:surface>
+    def Shader "shader"
+    {
+      uniform token info:id = "UsdPreviewSurface"
+      color3f inputs:diffuseColor.connect = </Looks/T/tex.outputs:rgb>
+      token outputs:surface
+    }
+    def Shader "tex"
+    {
+      uniform token info:id = "UsdUVTexture"
+      asset inputs:file = @tex.png@
+      float2 inputs:st.connect = </Looks/T/uv.outputs:result>
+      float3 outputs:rgb
+    }
+    def Shader "uv"
+    {
+      uniform token info:id = "UsdPrimvarReader_float2"
+      string inputs:varname = "st"
+      float2 outputs:result
+    }
+  }
+}
+)";
+
+  Stage stage;
+  TEST_CHECK(LoadStageFromString(usda, &stage));
+
+  auto Convert = [&](const double t, tydra::RenderScene *scene) {
+    tydra::RenderSceneConverterEnv env(stage);
+    env.timecode = t;
+    env.scene_config.load_texture_assets = false;
+    env.mesh_config.build_interleaved_vertex_buffer = true;
+    env.mesh_config.build_meshlets = true;
+
+    tydra::RenderSceneConverter converter;
+    bool ret = converter.ConvertToRenderScene(env, scene);
+    TEST_MSG("%s", converter.GetError().c_str());
+    return ret;
+  };
+
+  tydra::RenderScene scene;
+  tydra::RenderScene fresh;
+  TEST_CHECK(Convert(0.0, &scene));
+  TEST_CHECK(Convert(1.0, &fresh));
+  if ((scene.meshes.size() != 2) || (fresh.meshes.size() != 2)) {
+    TEST_CHECK(false);
+    return;
+  }
+
+  const tydra::RenderMesh &welded = scene.meshes[0];
+  TEST_CHECK(welded.is_triangulated());
+  TEST_CHECK(welded.is_single_indexable);
+  TEST_CHECK(welded.points.size() == 12);
+  TEST_CHECK(!welded.tangents.empty());
+  TEST_CHECK(welded.vertex_buffer_id >= 0);
+  TEST_CHECK(welded.meshlets.size() == 1);
+
+  const tydra::RenderScene initial = scene;
+
+  tydra::RenderSceneConverterEnv env(stage);
+  env.timecode = 0.0;
+  env.scene_config.load_texture_assets = false;
+  env.mesh_config.build_interleaved_vertex_buffer = true;
+  env.mesh_config.build_meshlets = true;
+
+  tydra::RenderSceneUpdater updater;
+  TEST_CHECK(updater.Build(env, &scene));
+  TEST_MSG("%s", updater.GetError().c_str());
+  TEST_CHECK(!updater.is_static());
+
+  tydra::RenderSceneUpdateResult result;
+  TEST_CHECK(updater.Update(1.0, &result));
+  TEST_MSG("%s", updater.GetError().c_str());
+
+  // Updated scene is identical to the scene converted at the new time.
+  TEST_CHECK(tydra::DumpRenderScene(scene) == tydra::DumpRenderScene(fresh));
+
+  // "/root" and its children(global_matrix).
+  TEST_CHECK(result.nodes.size() == 3);
+  for (const tydra::Node *node : result.nodes) {
+    TEST_CHECK(node->global_matrix.m[3][0] == 2.0);
+    TEST_MSG("%s", node->abs_path.c_str());
+  }
+
+  TEST_CHECK(scene.materials.size() == 2);
+  TEST_CHECK(scene.meshes[1].material_id >= 0);
+  if (scene.meshes[1].material_id >= 0) {
+    const uint32_t material_id = uint32_t(scene.meshes[1].material_id);
+    TEST_CHECK(result.materials == std::vector<uint32_t>({material_id}));
+    TEST_CHECK(
+        scene.materials[material_id].surfaceShader.diffuseColor.value[2] ==
+        1.0f);
+  }
+
+  TEST_CHECK(result.meshes.size() == 2);
+  for (const auto &update : result.meshes) {
+    TEST_CHECK(update.mesh_id < 2);
+    if (update.mesh_id >= 2) {
+      continue;
+    }
+
+    const tydra::RenderMesh &before = initial.meshes[update.mesh_id];
+    const tydra::RenderMesh &after = scene.meshes[update.mesh_id];
+    const tydra::RenderMesh &expected = fresh.meshes[update.mesh_id];
+    TEST_MSG("mesh %d", int(update.mesh_id));
+
+    TEST_CHECK(memcmp(after.points.data(), expected.points.data(),
+                      sizeof(tydra::vec3) * expected.points.size()) == 0);
+    TEST_CHECK(after.normals.get_data() == expected.normals.get_data());
+    TEST_CHECK(after.tangents.get_data() == expected.tangents.get_data());
+    TEST_CHECK(after.binormals.get_data() == expected.binormals.get_data());
+
+    // Dirty ranges cover exactly the modified elements.
+    std::vector<uint8_t> points_before(
+        reinterpret_cast<const uint8_t *>(before.points.data()),
+        reinterpret_cast<const uint8_t *>(before.points.data() +
+                                          before.points.size()));
+    std::vector<uint8_t> points_after(
+        reinterpret_cast<const uint8_t *>(after.points.data()),
+        reinterpret_cast<const uint8_t *>(after.points.data() +
+                                          after.points.size()));
+    TEST_CHECK(SameRange(update.points,
+                         DiffRange(points_before, points_after,
+                                   sizeof(tydra::vec3))));
+    TEST_CHECK(SameRange(update.normals,
+                         DiffRange(before.normals.get_data(),
+                                   after.normals.get_data(),
+                                   before.normals.stride_bytes())));
+
+    tydra::RenderSceneUpdateResult::Range tangents;
+    if (!before.tangents.empty()) {
+      tangents = DiffRange(before.tangents.get_data(),
+                           after.tangents.get_data(),
+                           before.tangents.stride_bytes());
+      const tydra::RenderSceneUpdateResult::Range binormals =
+          DiffRange(before.binormals.get_data(), after.binormals.get_data(),
+                    before.binormals.stride_bytes());
+      if (!binormals.empty()) {
+        tangents.extend(binormals.begin);
+        tangents.extend(binormals.end - 1);
+      }
+    }
+    TEST_CHECK(SameRange(update.tangents, tangents));
+
+    // Interleaved vertex buffer.
+    TEST_CHECK(after.vertex_buffer_id >= 0);
+    if (after.vertex_buffer_id >= 0) {
+      const size_t buffer_id = size_t(after.vertex_buffer_id);
+      const std::vector<uint8_t> &vb = scene.buffers[buffer_id].data;
+      TEST_CHECK(vb == fresh.buffers[buffer_id].data);
+
+      const tydra::RenderSceneUpdateResult::Range vb_diff =
+          DiffRange(initial.buffers[buffer_id].data, vb,
+                    after.vertex_layout.stride);
+      TEST_CHECK(!vb_diff.empty());
+      TEST_CHECK((update.vertex_buffer.begin <= vb_diff.begin) &&
+                 (vb_diff.end <= update.vertex_buffer.end));
+    }
+
+    // Meshlet bounds are re-computed for the new points.
+    TEST_CHECK(after.meshlets.size() == expected.meshlets.size());
+    if (after.meshlets.size() == expected.meshlets.size()) {
+      tydra::RenderSceneUpdateResult::Range meshlets;
+      for (size_t i = 0; i < after.meshlets.size(); i++) {
+        TEST_CHECK(memcmp(&after.meshlets[i], &expected.meshlets[i],
+                          sizeof(tydra::Meshlet)) == 0);
+        if (memcmp(&after.meshlets[i], &before.meshlets[i],
+                   sizeof(tydra::Meshlet)) != 0) {
+          meshlets.extend(i);
+        }
+      }
+      TEST_CHECK(SameRange(update.meshlets, meshlets));
+    }
+  }
+
+  // The welded mesh has the moved point and the tangent frames around it.
+  if (result.meshes.size() == 2) {
+    TEST_CHECK(!result.meshes[0].points.empty());
+    TEST_CHECK(!result.meshes[0].normals.empty());
+    TEST_CHECK(!result.meshes[0].tangents.empty());
+    TEST_CHECK(!result.meshes[0].meshlets.empty());
+    TEST_CHECK(result.meshes[1].points.empty());
+    TEST_CHECK(result.meshes[1].meshlets.empty());
+    TEST_CHECK(!result.meshes[1].normals.empty());
+  }
+
+  // Nothing is modified at the same time.
+  TEST_CHECK(updater.Update(1.0, &result));
+  TEST_CHECK(result.empty());
+}
+
+void vertex_layout_test(void) {
+  using tydra::VertexAttributeEncoding;
+  using tydra::VertexAttributeFormat;
+  using tydra::VertexAttributeSemantic;
+
+  tydra::VertexLayout layout;
+  layout.elements.resize(5);
+  layout.elements[0].semantic = VertexAttributeSemantic::Position;
+  layout.elements[0].encoding = VertexAttributeEncoding::Float;
+  layout.elements[1].semantic = VertexAttributeSemantic::Normal;
+  layout.elements[1].encoding = VertexAttributeEncoding::Oct16;
+  layout.elements[2].semantic = VertexAttributeSemantic::Texcoord0;
+  layout.elements[2].encoding = VertexAttributeEncoding::Half;
+  layout.elements[3].semantic = VertexAttributeSemantic::Color;
+  layout.elements[3].encoding = VertexAttributeEncoding::Unorm8;
+  layout.elements[4].semantic = VertexAttributeSemantic::Opacity;
+  layout.elements[4].encoding = VertexAttributeEncoding::Unorm16;
+
+  // 12 + 4 + 4 + 3(-> 4) + 2(-> 4)
+  tydra::VertexLayout resolved = layout;
+  std::string err;
+  TEST_CHECK(tydra::ResolveVertexLayout(&resolved, &err));
+  TEST_MSG("%s", err.c_str());
+  TEST_CHECK(resolved.stride == 28);
+  const uint32_t offsets4[5] = {0, 12, 16, 20, 24};
+  const VertexAttributeFormat formats[5] = {
+      VertexAttributeFormat::Vec3, VertexAttributeFormat::Short2,
+      VertexAttributeFormat::Half2, VertexAttributeFormat::Byte3,
+      VertexAttributeFormat::Ushort};
+  for (size_t i = 0; i < 5; i++) {
+    TEST_CHECK(resolved.elements[i].offset == offsets4[i]);
+    TEST_CHECK(resolved.elements[i].format == formats[i]);
+    TEST_MSG("element %d", int(i));
+  }
+
+  // Each element starts at 16 bytes boundary.
+  resolved = layout;
+  resolved.alignment = 16;
+  TEST_CHECK(tydra::ResolveVertexLayout(&resolved, &err));
+  TEST_CHECK(resolved.stride == 80);
+  for (size_t i = 0; i < 5; i++) {
+    TEST_CHECK(resolved.elements[i].offset == 16 * i);
+  }
+
+  resolved = layout;
+  resolved.alignment = 1;
+  TEST_CHECK(tydra::ResolveVertexLayout(&resolved, &err));
+  TEST_CHECK(resolved.stride == 25);
+  TEST_CHECK(resolved.elements[4].offset == 23);
+
+  // Alignment must be power of two.
+  resolved = layout;
+  resolved.alignment = 3;
+  TEST_CHECK(!tydra::ResolveVertexLayout(&resolved, &err));
+
+  // Explicit stride is kept when it is large enough.
+  resolved = layout;
+  resolved.stride = 64;
+  TEST_CHECK(tydra::ResolveVertexLayout(&resolved, &err));
+  TEST_CHECK(resolved.stride == 64);
+  TEST_CHECK(resolved.elements[4].offset == 24);
+
+  resolved = layout;
+  resolved.stride = 24;
+  TEST_CHECK(!tydra::ResolveVertexLayout(&resolved, &err));
+
+  // Octahedral encoding is only for 3 component attributes.
+  for (VertexAttributeEncoding encoding :
+       {VertexAttributeEncoding::Oct8, VertexAttributeEncoding::Oct16}) {
+    resolved = layout;
+    resolved.elements[2].encoding = encoding;
+    TEST_CHECK(!tydra::ResolveVertexLayout(&resolved, &err));
+  }
+}
+
+void vertex_encoding_test(void) {
+  using tydra::VertexAttributeEncoding;
+  using tydra::VertexAttributeFormat;
+  using tydra::VertexAttributeSemantic;
+  using tydra::VertexVariability;
+
+  tydra::RenderMesh mesh;
+  mesh.points = {{1.0f, 2.0f, 3.0f}, {4.0f, 5.0f, 6.0f}, {7.0f, 8.0f, 9.0f}};
+  mesh.usdFaceVertexCounts = {3};
+  mesh.usdFaceVertexIndices = {0, 1, 2};
+  mesh.is_single_indexable = true;
+  mesh.normals = MakeVertexAttribute({0.0f, 0.0f, 1.0f, 0.0f, 0.0f, -1.0f,
+                                      1.0f, 0.0f, 0.0f},
+                                     VertexAttributeFormat::Vec3,
+                                     VertexVariability::Vertex);
+  mesh.tangents = MakeVertexAttribute({1.0f, -1.0f, 0.5f, 2.0f, -2.0f, 0.0f,
+                                       0.0f, 0.0f, 0.0f},
+                                      VertexAttributeFormat::Vec3,
+                                      VertexVariability::Vertex);
+  mesh.texcoords[0] = MakeVertexAttribute(
+      {0.5f, -2.0f, 1.0f, 0.0f, 0.0f, 0.0f}, VertexAttributeFormat::Vec2,
+      VertexVariability::Vertex);
+  mesh.vertex_colors = MakeVertexAttribute(
+      {1.0f, 0.5f, 0.0f, -1.0f, 2.0f, 0.25f, 0.0f, 0.0f, 0.0f},
+      VertexAttributeFormat::Vec3, VertexVariability::Vertex);
+  mesh.vertex_opacities =
+      MakeVertexAttribute({0.25f, 1.0f, 0.0f}, VertexAttributeFormat::Float,
+                          VertexVariability::Vertex);
+
+  tydra::VertexLayout layout;
+  const VertexAttributeSemantic semantics[] = {
+      VertexAttributeSemantic::Position, VertexAttributeSemantic::Normal,
+      VertexAttributeSemantic::Normal,   VertexAttributeSemantic::Tangent,
+      VertexAttributeSemantic::Tangent,  VertexAttributeSemantic::Texcoord0,
+      VertexAttributeSemantic::Color,    VertexAttributeSemantic::Opacity};
+  const VertexAttributeEncoding encodings[] = {
+      VertexAttributeEncoding::Float,   VertexAttributeEncoding::Oct8,
+      VertexAttributeEncoding::Oct16,   VertexAttributeEncoding::Snorm8,
+      VertexAttributeEncoding::Snorm16, VertexAttributeEncoding::Half,
+      VertexAttributeEncoding::Unorm8,  VertexAttributeEncoding::Unorm16};
+  for (size_t i = 0; i < 8; i++) {
+    tydra::VertexLayoutElement elem;
+    elem.semantic = semantics[i];
+    elem.encoding = encodings[i];
+    layout.elements.push_back(elem);
+  }
+  std::string err;
+  TEST_CHECK(tydra::ResolveVertexLayout(&layout, &err));
+
+  tydra::BufferData vb, ib;
+  uint32_t num_vertices{0};
+  TEST_CHECK(tydra::BuildInterleavedVertexBuffer(mesh, layout, true, &vb, &ib,
+                                                 &num_vertices, &err));
+  TEST_MSG("%s", err.c_str());
+  TEST_CHECK(num_vertices == 3);
+  TEST_CHECK(vb.data.size() == 3 * layout.stride);
+  if (vb.data.size() != 3 * layout.stride) {
+    return;
+  }
+
+  const uint32_t stride = layout.stride;
+  auto Offset = [&](size_t i) { return layout.elements[i].offset; };
+
+  // Float
+  TEST_CHECK(ReadVertexValue<float>(vb, stride, 1, Offset(0) + 4) == 5.0f);
+
+  // Oct: +Z -> (0, 0), -Z -> (1, 1), +X -> (1, 0)
+  const int8_t oct8[3][2] = {{0, 0}, {127, 127}, {127, 0}};
+  const int16_t oct16[3][2] = {{0, 0}, {32767, 32767}, {32767, 0}};
+  for (size_t v = 0; v < 3; v++) {
+    for (size_t k = 0; k < 2; k++) {
+      TEST_CHECK(ReadVertexValue<int8_t>(vb, stride, v, Offset(1) + k) ==
+                 oct8[v][k]);
+      TEST_CHECK(ReadVertexValue<int16_t>(vb, stride, v, Offset(2) + 2 * k) ==
+                 oct16[v][k]);
+      TEST_MSG("vertex %d, component %d", int(v), int(k));
+    }
+  }
+
+  // Snorm: rounded and clamped to [-1, 1].
+  const int8_t snorm8[2][3] = {{127, -127, 64}, {127, -127, 0}};
+  const int16_t snorm16[2][3] = {{32767, -32767, 16384}, {32767, -32767, 0}};
+  for (size_t v = 0; v < 2; v++) {
+    for (size_t k = 0; k < 3; k++) {
+      TEST_CHECK(ReadVertexValue<int8_t>(vb, stride, v, Offset(3) + k) ==
+                 snorm8[v][k]);
+      TEST_CHECK(ReadVertexValue<int16_t>(vb, stride, v, Offset(4) + 2 * k) ==
+                 snorm16[v][k]);
+    }
+  }
+
+  // Half: 0.5 = 0x3800, -2.0 = 0xc000, 1.0 = 0x3c00
+  TEST_CHECK(ReadVertexValue<uint16_t>(vb, stride, 0, Offset(5)) == 0x3800);
+  TEST_CHECK(ReadVertexValue<uint16_t>(vb, stride, 0, Offset(5) + 2) ==
+             0xc000);
+  TEST_CHECK(ReadVertexValue<uint16_t>(vb, stride, 1, Offset(5)) == 0x3c00);
+
+  // Unorm: rounded and clamped to [0, 1].
+  const uint8_t unorm8[2][3] = {{255, 128, 0}, {0, 255, 64}};
+  for (size_t v = 0; v < 2; v++) {
+    for (size_t k = 0; k < 3; k++) {
+      TEST_CHECK(ReadVertexValue<uint8_t>(vb, stride, v, Offset(6) + k) ==
+                 unorm8[v][k]);
+    }
+  }
+  TEST_CHECK(ReadVertexValue<uint16_t>(vb, stride, 0, Offset(7)) == 16384);
+  TEST_CHECK(ReadVertexValue<uint16_t>(vb, stride, 1, Offset(7)) == 65535);
+}
+
+void vertex_buffer_index_test(void) {
+  using tydra::VertexAttributeSemantic;
+
+  tydra::VertexLayout layout;
+  layout.elements.resize(1);
+  layout.elements[0].semantic = VertexAttributeSemantic::Position;
+  TEST_CHECK(tydra::ResolveVertexLayout(&layout));
+
+  // A strip of triangles which refers to all of `n` points.
+  auto MakeMesh = [](const uint32_t n) {
+    tydra::RenderMesh mesh;
+    mesh.points.resize(n);
+    for (uint32_t i = 0; i < n; i++) {
+      mesh.points[i] = {float(i), float(i & 1), 0.0f};
+    }
+    for (uint32_t i = 0; i + 2 < n; i++) {
+      mesh.usdFaceVertexIndices.insert(mesh.usdFaceVertexIndices.end(),
+                                       {i, i + 1, i + 2});
+      mesh.usdFaceVertexCounts.push_back(3);
+    }
+    mesh.is_single_indexable = true;
+    return mesh;
+  };
+
+  for (uint32_t n : {65536u, 65537u}) {
+    const tydra::RenderMesh mesh = MakeMesh(n);
+    const size_t num_indices = mesh.usdFaceVertexIndices.size();
+
+    tydra::BufferData vb, ib;
+    uint32_t num_vertices{0};
+    std::string err;
+    TEST_CHECK(tydra::BuildInterleavedVertexBuffer(
+        mesh, layout, /* use_16bit_indices */ true, &vb, &ib, &num_vertices,
+        &err));
+    TEST_MSG("%s", err.c_str());
+    TEST_CHECK(num_vertices == n);
+
+    if (n == 65536) {
+      // The largest index 65535 fits in uint16.
+      TEST_CHECK(ib.componentType == tydra::ComponentType::UInt16);
+      TEST_CHECK(ib.data.size() == num_indices * sizeof(uint16_t));
+      if (ib.data.size() == num_indices * sizeof(uint16_t)) {
+        uint16_t last;
+        memcpy(&last, ib.data.data() + ib.data.size() - sizeof(uint16_t),
+               sizeof(uint16_t));
+        TEST_CHECK(last == 65535);
+      }
+    } else {
+      TEST_CHECK(ib.componentType == tydra::ComponentType::UInt32);
+      TEST_CHECK(ib.data.size() == num_indices * sizeof(uint32_t));
+      if (ib.data.size() == num_indices * sizeof(uint32_t)) {
+        uint32_t last;
+        memcpy(&last, ib.data.data() + ib.data.size() - sizeof(uint32_t),
+               sizeof(uint32_t));
+        TEST_CHECK(last == 65536);
+      }
+    }
+    TEST_MSG("# of vertices = %d", int(n));
+
+    // 32bit indices are used when 16bit indices are not requested.
+    TEST_CHECK(tydra::BuildInterleavedVertexBuffer(
+        mesh, layout, /* use_16bit_indices */ false, &vb, &ib, &num_vertices,
+        &err));
+    TEST_CHECK(ib.componentType == tydra::ComponentType::UInt32);
+  }
+}
+
+void vertex_buffer_expand_test(void) {
+  using tydra::VertexAttributeFormat;
+  using tydra::VertexAttributeSemantic;
+  using tydra::VertexVariability;
+
+  // Two triangles sharing the edge (1, 2). Normals are 'facevarying' and
+  // colors are 'uniform', so vertices cannot be shared.
+  tydra::RenderMesh mesh;
+  mesh.points = {{0.0f, 0.0f, 0.0f},
+                 {1.0f, 0.0f, 0.0f},
+                 {0.0f, 1.0f, 0.0f},
+                 {1.0f, 1.0f, 0.0f}};
+  mesh.usdFaceVertexCounts = {3, 3};
+  mesh.usdFaceVertexIndices = {0, 1, 2, 2, 1, 3};
+  mesh.is_single_indexable = false;
+
+  std::vector<float> normals;
+  for (size_t i = 0; i < 6; i++) {
+    normals.insert(normals.end(), {float(i), 0.0f, 1.0f});
+  }
+  mesh.normals = MakeVertexAttribute(normals, VertexAttributeFormat::Vec3,
+                                     VertexVariability::FaceVarying);
+  mesh.vertex_colors = MakeVertexAttribute(
+      {1.0f, 0.0f, 0.0f, 0.0f, 1.0f, 0.0f}, VertexAttributeFormat::Vec3,
+      VertexVariability::Uniform);
+
+  tydra::VertexLayout layout;
+  layout.elements.resize(3);
+  layout.elements[0].semantic = VertexAttributeSemantic::Position;
+  layout.elements[1].semantic = VertexAttributeSemantic::Normal;
+  layout.elements[2].semantic = VertexAttributeSemantic::Color;
+  TEST_CHECK(tydra::ResolveVertexLayout(&layout));
+
+  tydra::BufferData vb, ib;
+  uint32_t num_vertices{0};
+  std::string err;
+  TEST_CHECK(tydra::BuildInterleavedVertexBuffer(mesh, layout, true, &vb, &ib,
+                                                 &num_vertices, &err));
+  TEST_MSG("%s", err.c_str());
+
+  // One vertex per face vertex, and the index buffer is sequential.
+  TEST_CHECK(num_vertices == 6);
+  TEST_CHECK(ib.componentType == tydra::ComponentType::UInt16);
+  TEST_CHECK(ib.data.size() == 6 * sizeof(uint16_t));
+  if ((num_vertices != 6) || (ib.data.size() != 6 * sizeof(uint16_t))) {
+    return;
+  }
+
+  const uint32_t stride = layout.stride;
+  for (size_t v = 0; v < 6; v++) {
+    uint16_t idx;
+    memcpy(&idx, ib.data.data() + v * sizeof(uint16_t), sizeof(uint16_t));
+    TEST_CHECK(idx == v);
+
+    const tydra::vec3 &p = mesh.points[mesh.usdFaceVertexIndices[v]];
+    const tydra::vec3 pos =
+        ReadVertexValue<tydra::vec3>(vb, stride, v, layout.elements[0].offset);
+    const tydra::vec3 nrm =
+        ReadVertexValue<tydra::vec3>(vb, stride, v, layout.elements[1].offset);
+    const tydra::vec3 col =
+        ReadVertexValue<tydra::vec3>(vb, stride, v, layout.elements[2].offset);
+    TEST_CHECK(NearlyEqual(pos, p));
+    TEST_CHECK(NearlyEqual(nrm, {float(v), 0.0f, 1.0f}));
+    TEST_CHECK(NearlyEqual(col, (v < 3) ? tydra::vec3{1.0f, 0.0f, 0.0f}
+                                        : tydra::vec3{0.0f, 1.0f, 0.0f}));
+    TEST_MSG("vertex %d", int(v));
+  }
+}
+
+void vertex_cache_optimize_test(void) {
+  using tydra::VertexAttributeFormat;
+  using tydra::VertexVariability;
+
+  // N x N grid of triangles in a scrambled order. The original point index is
+  // encoded in the point position, so remapped data can be checked against it.
+  const uint32_t N = 16;
+  const uint32_t W = N + 1;
+
+  tydra::RenderMesh mesh;
+  for (uint32_t y = 0; y <= N; y++) {
+    for (uint32_t x = 0; x <= N; x++) {
+      mesh.points.push_back({float(x), float(y), 0.0f});
+    }
+  }
+
+  std::vector<uint32_t> quads(N * N);
+  for (uint32_t i = 0; i < N * N; i++) {
+    quads[i] = i;
+  }
+  uint32_t seed = 12345;
+  for (size_t i = quads.size() - 1; i > 0; i--) {
+    seed = seed * 1664525u + 1013904223u;
+    std::swap(quads[i], quads[(seed >> 8) % (i + 1)]);
+  }
+
+  std::vector<uint32_t> indices;
+  for (uint32_t q : quads) {
+    const uint32_t x = q % N;
+    const uint32_t y = q / N;
+    const uint32_t p = y * W + x;
+    indices.insert(indices.end(), {p, p + 1, p + W, p + W, p + 1, p + W + 1});
+  }
+  const size_t num_tris = indices.size() / 3;
+
+  mesh.usdFaceVertexIndices = indices;
+  mesh.usdFaceVertexCounts.assign(num_tris, 3);
+  mesh.triangulatedFaceVertexIndices = indices;
+  mesh.triangulatedFaceVertexCounts.assign(num_tris, 3);
+  mesh.triangulatedFaceCounts.assign(num_tris, 1);
+  for (size_t i = 0; i < indices.size(); i++) {
+    mesh.triangulatedToOrigFaceVertexIndexMap.push_back(i);
+  }
+  mesh.is_single_indexable = true;
+
+  // 'vertex' normals = position, 'facevarying' texcoords = face vertex index.
+  std::vector<float> normals;
+  for (const auto &p : mesh.points) {
+    normals.insert(normals.end(), {p[0], p[1], p[2]});
+  }
+  mesh.normals = MakeVertexAttribute(normals, VertexAttributeFormat::Vec3,
+                                     VertexVariability::Vertex);
+  std::vector<float> uvs;
+  for (size_t i = 0; i < indices.size(); i++) {
+    uvs.insert(uvs.end(), {float(i), 0.0f});
+  }
+  mesh.texcoords[0] = MakeVertexAttribute(uvs, VertexAttributeFormat::Vec2,
+                                          VertexVariability::FaceVarying);
+
+  mesh.joint_and_weights.elementSize = 2;
+  for (size_t p = 0; p < mesh.points.size(); p++) {
+    mesh.joint_and_weights.jointIndices.insert(
+        mesh.joint_and_weights.jointIndices.end(), {int(p), int(p) + 1});
+    mesh.joint_and_weights.jointWeights.insert(
+        mesh.joint_and_weights.jointWeights.end(), {float(p), -float(p)});
+  }
+
+  const std::vector<uint32_t> target_points{0, 5, 100, W * W - 1};
+  mesh.targets["t"].pointIndices = target_points;
+
+  // 'a' = left half, 'b' = right half except the bottom row, which is not in
+  // any subset.
+  std::map<std::string, std::vector<int>> subset_faces;
+  for (size_t t = 0; t < num_tris; t++) {
+    const uint32_t q = quads[t / 2];
+    if ((q % N) < N / 2) {
+      subset_faces["a"].push_back(int(t));
+    } else if ((q / N) > 0) {
+      subset_faces["b"].push_back(int(t));
+    }
+  }
+  for (const auto &it : subset_faces) {
+    mesh.material_subsetMap[it.first].usdIndices = it.second;
+    mesh.material_subsetMap[it.first].triangulatedIndices = it.second;
+  }
+
+  const tydra::RenderMesh orig = mesh;
+  auto orig_point_index = [&](const tydra::vec3 &p) {
+    return uint32_t(p[1]) * W + uint32_t(p[0]);
+  };
+
+  const float acmr_before = tydra::ComputeACMR(indices, 16);
+
+  std::string err;
+  TEST_CHECK(tydra::OptimizeRenderMeshVertexCache(&mesh, 16, &err));
+  TEST_MSG("%s", err.c_str());
+
+  // ACMR does not increase.
+  const float acmr_after =
+      tydra::ComputeACMR(mesh.triangulatedFaceVertexIndices, 16);
+  TEST_CHECK(acmr_after <= acmr_before);
+  TEST_MSG("ACMR %f -> %f", double(acmr_before), double(acmr_after));
+
+  TEST_CHECK(mesh.points.size() == orig.points.size());
+  TEST_CHECK(mesh.triangulatedFaceVertexIndices.size() == indices.size());
+  TEST_CHECK(mesh.triangulatedToOrigFaceVertexIndexMap.size() ==
+             indices.size());
+  TEST_CHECK(mesh.triangulatedToOrigFaceIndexMap.size() == num_tris);
+  if ((mesh.points.size() != orig.points.size()) ||
+      (mesh.triangulatedFaceVertexIndices.size() != indices.size()) ||
+      (mesh.triangulatedToOrigFaceVertexIndexMap.size() != indices.size()) ||
+      (mesh.triangulatedToOrigFaceIndexMap.size() != num_tris)) {
+    return;
+  }
+
+  TEST_CHECK(mesh.texcoords[0].get_data().size() ==
+             indices.size() * 2 * sizeof(float));
+  if (mesh.texcoords[0].get_data().size() !=
+      indices.size() * 2 * sizeof(float)) {
+    return;
+  }
+
+  // Output triangles are a permutation of the input triangles(with the same
+  // winding), and face vertex maps point to the input triangle.
+  std::vector<int> seen(num_tris, 0);
+  for (size_t t = 0; t < num_tris; t++) {
+    const size_t src = mesh.triangulatedToOrigFaceVertexIndexMap[3 * t] / 3;
+    TEST_CHECK(src < num_tris);
+    if (src >= num_tris) {
+      return;
+    }
+    seen[src]++;
+    TEST_CHECK(mesh.triangulatedToOrigFaceIndexMap[t] == src);
+    for (size_t k = 0; k < 3; k++) {
+      const size_t fv = 3 * t + k;
+      TEST_CHECK(mesh.triangulatedToOrigFaceVertexIndexMap[fv] == 3 * src + k);
+      const uint32_t p = mesh.triangulatedFaceVertexIndices[fv];
+      TEST_CHECK(orig_point_index(mesh.points[p]) == indices[3 * src + k]);
+      float uv[2];
+      memcpy(uv, mesh.texcoords[0].get_data().data() + fv * 2 * sizeof(float),
+             sizeof(uv));
+      TEST_CHECK(uv[0] == float(3 * src + k));
+    }
+  }
+  for (size_t t = 0; t < num_tris; t++) {
+    TEST_CHECK(seen[t] == 1);
+  }
+
+  // 'vertex' attributes and skin weights follow the points.
+  const tydra::JointAndWeight &jw = mesh.joint_and_weights;
+  TEST_CHECK(jw.jointIndices.size() == 2 * mesh.points.size());
+  TEST_CHECK(jw.jointWeights.size() == 2 * mesh.points.size());
+  for (size_t p = 0; (p < mesh.points.size()) &&
+                     (2 * p + 1 < jw.jointIndices.size()) &&
+                     (2 * p + 1 < jw.jointWeights.size());
+       p++) {
+    const uint32_t op = orig_point_index(mesh.points[p]);
+    tydra::vec3 n;
+    memcpy(&n, mesh.normals.get_data().data() + p * sizeof(tydra::vec3),
+           sizeof(tydra::vec3));
+    TEST_CHECK(NearlyEqual(n, mesh.points[p]));
+    TEST_CHECK(jw.jointIndices[2 * p] == int(op));
+    TEST_CHECK(jw.jointIndices[2 * p + 1] == int(op) + 1);
+    TEST_CHECK(jw.jointWeights[2 * p] == float(op));
+    TEST_CHECK(jw.jointWeights[2 * p + 1] == -float(op));
+  }
+
+  // BlendShape point indices are remapped.
+  const std::vector<uint32_t> &pis = mesh.targets["t"].pointIndices;
+  TEST_CHECK(pis.size() == target_points.size());
+  for (size_t i = 0; (i < pis.size()) && (i < target_points.size()); i++) {
+    TEST_CHECK(orig_point_index(mesh.points[pis[i]]) == target_points[i]);
+  }
+
+  // Each MaterialSubset has the same triangles, and is contiguous.
+  for (const auto &it : subset_faces) {
+    const std::vector<int> &tris =
+        mesh.material_subsetMap[it.first].triangulatedIndices;
+    TEST_CHECK(tris.size() == it.second.size());
+    std::vector<int> src_tris;
+    for (size_t i = 0; i < tris.size(); i++) {
+      TEST_CHECK(tris[i] == tris[0] + int(i));
+      src_tris.push_back(
+          int(mesh.triangulatedToOrigFaceIndexMap[size_t(tris[i])]));
+    }
+    std::sort(src_tris.begin(), src_tris.end());
+    TEST_CHECK(src_tris == it.second);
+    TEST_MSG("subset %s", it.first.c_str());
+  }
+
+  // Not triangulated.
+  {
+    tydra::RenderMesh m = orig;
+    m.triangulatedFaceVertexIndices.clear();
+    m.triangulatedFaceVertexCounts.clear();
+    err.clear();
+    TEST_CHECK(!tydra::OptimizeRenderMeshVertexCache(&m, 16, &err));
+    TEST_CHECK(m.usdFaceVertexIndices == orig.usdFaceVertexIndices);
+  }
+
+  // Indexed vertex attribute. The mesh is not modified.
+  {
+    tydra::RenderMesh m = orig;
+    m.normals.variability = VertexVariability::Indexed;
+    m.normals.indices.assign(indices.size(), 0);
+    err.clear();
+    TEST_CHECK(!tydra::OptimizeRenderMeshVertexCache(&m, 16, &err));
+    TEST_CHECK(m.triangulatedFaceVertexIndices == indices);
+    TEST_CHECK(m.points.size() == orig.points.size());
+  }
+}
+
+void mesh_lod_test(void) {
+  const float kMaxError = 0.05f;
+
+  // Closed sphere.
+  {
+    std::vector<uint32_t> canon;
+    const tydra::RenderMesh mesh = MakeSphereMesh(16, 32, false, &canon);
+    const size_t num_tris = mesh.triangulatedFaceVertexIndices.size() / 3;
+    TEST_CHECK(IsClosedMesh(mesh.triangulatedFaceVertexIndices, canon));
+
+    std::vector<tydra::MeshLOD> lods;
+    std::string err;
+    TEST_CHECK(tydra::BuildMeshLODs(mesh, {0.25f, 0.5f}, kMaxError, 16, &lods,
+                                    &err));
+    TEST_MSG("%s", err.c_str());
+    TEST_CHECK(lods.size() == 2);
+    if (lods.size() != 2) {
+      return;
+    }
+
+    // Sorted from the finer LOD.
+    TEST_CHECK(lods[0].ratio == 0.5f);
+    TEST_CHECK(lods[1].ratio == 0.25f);
+
+    size_t prev_tris = num_tris;
+    for (const auto &lod : lods) {
+      const size_t n = lod.indices.size() / 3;
+      TEST_CHECK((lod.indices.size() % 3) == 0);
+      TEST_CHECK(n < prev_tris);
+      TEST_CHECK(lod.error <= kMaxError);
+      TEST_CHECK(IsClosedMesh(lod.indices, canon));
+      TEST_MSG("ratio %f: %d tris, error %f", double(lod.ratio), int(n),
+               double(lod.error));
+      prev_tris = n;
+    }
+  }
+
+  // Sphere with a UV seam. Both sides of the seam are collapsed together, so
+  // the seam does not open.
+  {
+    const uint32_t rings = 16;
+    const uint32_t segments = 32;
+    std::vector<uint32_t> canon;
+    const tydra::RenderMesh mesh = MakeSphereMesh(rings, segments, true, &canon);
+    const size_t num_tris = mesh.triangulatedFaceVertexIndices.size() / 3;
+
+    std::vector<tydra::MeshLOD> lods;
+    std::string err;
+    TEST_CHECK(tydra::BuildMeshLODs(mesh, {0.5f, 0.25f}, kMaxError, 16, &lods,
+                                    &err));
+    TEST_MSG("%s", err.c_str());
+    TEST_CHECK(lods.size() == 2);
+    if (lods.size() != 2) {
+      return;
+    }
+
+    for (const auto &lod : lods) {
+      TEST_CHECK(lod.indices.size() / 3 < num_tris);
+      TEST_CHECK(lod.error <= kMaxError);
+      TEST_CHECK(IsClosedMesh(lod.indices, canon));
+
+      std::vector<uint8_t> used(mesh.points.size(), 0);
+      for (uint32_t v : lod.indices) {
+        used[v] = 1;
+      }
+
+      size_t num_seam_used = 0;
+      for (uint32_t i = 1; i < rings; i++) {
+        const uint32_t first = 1 + (i - 1) * (segments + 1);
+        const uint32_t last = first + segments;
+        TEST_CHECK(used[first] == used[last]);
+        TEST_MSG("ring %d", int(i));
+        num_seam_used += used[first];
+      }
+
+      if (lod.ratio == 0.25f) {
+        // Some seam vertices are collapsed along the seam.
+        TEST_CHECK(num_seam_used < rings - 1);
+        TEST_MSG("%d seam vertices", int(num_seam_used));
+      }
+    }
+  }
+
+  // Flat grid with two MaterialSubsets. Border and subset boundary vertices
+  // are kept, and interior vertices(zero error) are collapsed.
+  {
+    const uint32_t N = 8;
+    const uint32_t W = N + 1;
+
+    tydra::RenderMesh mesh;
+    for (uint32_t y = 0; y <= N; y++) {
+      for (uint32_t x = 0; x <= N; x++) {
+        mesh.points.push_back({float(x), float(y), 0.0f});
+      }
+    }
+
+    // 'a' = left half, 'b' = right half except the top row, which is not in
+    // any subset.
+    std::vector<uint32_t> indices;
+    for (uint32_t y = 0; y < N; y++) {
+      for (uint32_t x = 0; x < N; x++) {
+        const uint32_t p = y * W + x;
+        const int t = int(indices.size() / 3);
+        indices.insert(indices.end(),
+                       {p, p + 1, p + W, p + W, p + 1, p + W + 1});
+        const char *name = (x < N / 2) ? "a" : ((y + 1 < N) ? "b" : nullptr);
+        if (name) {
+          mesh.material_subsetMap[name].triangulatedIndices.push_back(t);
+          mesh.material_subsetMap[name].triangulatedIndices.push_back(t + 1);
+        }
+      }
+    }
+    mesh.usdFaceVertexIndices = indices;
+    mesh.usdFaceVertexCounts.assign(indices.size() / 3, 3);
+    mesh.triangulatedFaceVertexIndices = indices;
+    mesh.triangulatedFaceVertexCounts.assign(indices.size() / 3, 3);
+    mesh.is_single_indexable = true;
+
+    std::vector<tydra::MeshLOD> lods;
+    std::string err;
+    TEST_CHECK(tydra::BuildMeshLODs(mesh, {0.1f}, 0.01f, 0, &lods, &err));
+    TEST_MSG("%s", err.c_str());
+    TEST_CHECK(lods.size() == 1);
+    if (lods.size() != 1) {
+      return;
+    }
+    const tydra::MeshLOD &lod = lods[0];
+    const size_t num_tris = lod.indices.size() / 3;
+    TEST_CHECK(num_tris < indices.size() / 3);
+
+    std::vector<uint8_t> used(mesh.points.size(), 0);
+    for (uint32_t v : lod.indices) {
+      used[v] = 1;
+    }
+    for (uint32_t y = 0; y <= N; y++) {
+      for (uint32_t x = 0; x <= N; x++) {
+        const bool border = (x == 0) || (x == N) || (y == 0) || (y == N);
+        const bool boundary =
+            (x == N / 2) || ((y == N - 1) && (x >= N / 2));
+        if (border || boundary) {
+          TEST_CHECK(used[y * W + x]);
+          TEST_MSG("(%d, %d)", int(x), int(y));
+        }
+      }
+    }
+
+    // The LOD still covers the grid without flipped triangles.
+    double area = 0.0;
+    for (size_t t = 0; t < num_tris; t++) {
+      const tydra::vec3 &p0 = mesh.points[lod.indices[3 * t + 0]];
+      const tydra::vec3 &p1 = mesh.points[lod.indices[3 * t + 1]];
+      const tydra::vec3 &p2 = mesh.points[lod.indices[3 * t + 2]];
+      const double a = 0.5 * (double(p1[0] - p0[0]) * double(p2[1] - p0[1]) -
+                              double(p1[1] - p0[1]) * double(p2[0] - p0[0]));
+      TEST_CHECK(a > 0.0);
+      area += a;
+    }
+    TEST_CHECK(std::fabs(area - double(N * N)) < 1e-6);
+
+    // Subset ranges are contiguous in the order of material_subsetMap, and
+    // triangles not in any subset follow.
+    TEST_CHECK(lod.material_subset_indices.size() == 2);
+    size_t offset = 0;
+    for (const auto &it : lod.material_subset_indices) {
+      const std::vector<int> &tris = it.second;
+      TEST_CHECK(!tris.empty());
+      for (size_t i = 0; i < tris.size(); i++) {
+        TEST_CHECK(tris[i] == int(offset + i));
+        TEST_CHECK(size_t(tris[i]) < num_tris);
+        if (size_t(tris[i]) >= num_tris) {
+          return;
+        }
+        for (size_t k = 0; k < 3; k++) {
+          const tydra::vec3 &p =
+              mesh.points[lod.indices[3 * size_t(tris[i]) + k]];
+          if (it.first == "a") {
+            TEST_CHECK(p[0] <= float(N / 2));
+          } else {
+            TEST_CHECK(p[0] >= float(N / 2));
+            TEST_CHECK(p[1] <= float(N - 1));
+          }
+        }
+      }
+      TEST_MSG("subset %s", it.first.c_str());
+      offset += tris.size();
+    }
+    TEST_CHECK(offset < num_tris);
+    for (size_t t = offset; t < num_tris; t++) {
+      for (size_t k = 0; k < 3; k++) {
+        const tydra::vec3 &p = mesh.points[lod.indices[3 * t + k]];
+        TEST_CHECK(p[0] >= float(N / 2));
+        TEST_CHECK(p[1] >= float(N - 1));
+      }
+    }
+  }
+}
+
+void meshlet_test(void) {
+  const uint32_t kMaxVertices = 64;
+  const uint32_t kMaxTriangles = 124;
+
+  std::vector<uint32_t> canon;
+  tydra::RenderMesh mesh = MakeSphereMesh(16, 32, false, &canon);
+  const std::vector<uint32_t> &indices = mesh.triangulatedFaceVertexIndices;
+  const size_t num_tris = indices.size() / 3;
+
+  // Triangle -> group. 'a' = upper cap, 'b' = lower cap, and the rest is not
+  // in any subset.
+  auto key = [](uint32_t a, uint32_t b, uint32_t c) {
+    // Rotate so that the smallest index comes first(keeps the winding).
+    while ((a > b) || (a > c)) {
+      const uint32_t tmp = a;
+      a = b;
+      b = c;
+      c = tmp;
+    }
+    return std::to_string(a) + "," + std::to_string(b) + "," +
+           std::to_string(c);
+  };
+  std::map<std::string, std::string> tri_groups;
+  for (size_t t = 0; t < num_tris; t++) {
+    float y = 0.0f;
+    for (size_t k = 0; k < 3; k++) {
+      y += mesh.points[indices[3 * t + k]][1] / 3.0f;
+    }
+    std::string group;
+    if (y > 0.3f) {
+      group = "a";
+    } else if (y < -0.3f) {
+      group = "b";
+    }
+    if (!group.empty()) {
+      mesh.material_subsetMap[group].triangulatedIndices.push_back(int(t));
+    }
+    tri_groups[key(indices[3 * t], indices[3 * t + 1], indices[3 * t + 2])] =
+        group;
+  }
+  TEST_CHECK(tri_groups.size() == num_tris);
+
+  std::vector<tydra::Meshlet> meshlets;
+  std::vector<uint32_t> vertices;
+  std::vector<uint8_t> triangles;
+  std::map<std::string, std::vector<int>> subset_meshlets;
+  std::string err;
+  TEST_CHECK(tydra::BuildMeshlets(mesh, kMaxVertices, kMaxTriangles, &meshlets,
+                                  &vertices, &triangles, &subset_meshlets,
+                                  &err));
+  TEST_MSG("%s", err.c_str());
+  TEST_CHECK(!meshlets.empty());
+  TEST_CHECK(subset_meshlets.size() == 2);
+
+  // Group of each meshlet.
+  std::vector<std::string> meshlet_groups(meshlets.size());
+  std::vector<int> meshlet_subset_count(meshlets.size(), 0);
+  for (const auto &it : subset_meshlets) {
+    for (int i : it.second) {
+      TEST_CHECK((i >= 0) && (size_t(i) < meshlets.size()));
+      if ((i >= 0) && (size_t(i) < meshlets.size())) {
+        meshlet_groups[size_t(i)] = it.first;
+        meshlet_subset_count[size_t(i)]++;
+      }
+    }
+  }
+
+  // Camera on +Z. The far side of the sphere is back-facing.
+  const tydra::vec3 camera{0.0f, 0.0f, 10.0f};
+  size_t num_culled = 0;
+
+  std::map<std::string, int> seen;
+  for (size_t i = 0; i < meshlets.size(); i++) {
+    const tydra::Meshlet &m = meshlets[i];
+    TEST_MSG("meshlet %d", int(i));
+
+    TEST_CHECK((m.vertex_count > 0) && (m.vertex_count <= kMaxVertices));
+    TEST_CHECK((m.triangle_count > 0) && (m.triangle_count <= kMaxTriangles));
+    TEST_CHECK(meshlet_subset_count[i] <= 1);
+    TEST_CHECK(size_t(m.vertex_offset) + m.vertex_count <= vertices.size());
+    TEST_CHECK(3 * (size_t(m.triangle_offset) + m.triangle_count) <=
+               triangles.size());
+    if ((size_t(m.vertex_offset) + m.vertex_count > vertices.size()) ||
+        (3 * (size_t(m.triangle_offset) + m.triangle_count) >
+         triangles.size())) {
+      return;
+    }
+
+    // Every vertex is in the bounding sphere.
+    for (size_t v = 0; v < m.vertex_count; v++) {
+      const tydra::vec3 &p = mesh.points[vertices[m.vertex_offset + v]];
+      const float dx = p[0] - m.center[0];
+      const float dy = p[1] - m.center[1];
+      const float dz = p[2] - m.center[2];
+      TEST_CHECK(std::sqrt(dx * dx + dy * dy + dz * dz) <= m.radius);
+    }
+
+    // Is the meshlet culled by the normal cone?
+    bool culled = false;
+    if (m.cone_cutoff < 1.0f) {
+      const float dx = m.cone_apex[0] - camera[0];
+      const float dy = m.cone_apex[1] - camera[1];
+      const float dz = m.cone_apex[2] - camera[2];
+      const float len = std::sqrt(dx * dx + dy * dy + dz * dz);
+      culled = ((dx * m.cone_axis[0] + dy * m.cone_axis[1] +
+                 dz * m.cone_axis[2]) /
+                len) >= m.cone_cutoff;
+    }
+    if (culled) {
+      num_culled++;
+    }
+
+    for (size_t t = 0; t < m.triangle_count; t++) {
+      uint32_t tri[3];
+      for (size_t k = 0; k < 3; k++) {
+        const uint8_t local = triangles[3 * (m.triangle_offset + t) + k];
+        TEST_CHECK(local < m.vertex_count);
+        tri[k] = vertices[m.vertex_offset + (std::min)(uint32_t(local),
+                                                       m.vertex_count - 1)];
+      }
+
+      // The meshlet does not span two subsets.
+      const std::string k = key(tri[0], tri[1], tri[2]);
+      TEST_CHECK(tri_groups.count(k) == 1);
+      TEST_CHECK(tri_groups[k] == meshlet_groups[i]);
+      seen[k]++;
+
+      if (culled) {
+        // All triangles of the culled meshlet face away from the camera.
+        const tydra::vec3 &p0 = mesh.points[tri[0]];
+        const tydra::vec3 &p1 = mesh.points[tri[1]];
+        const tydra::vec3 &p2 = mesh.points[tri[2]];
+        const float e1[3] = {p1[0] - p0[0], p1[1] - p0[1], p1[2] - p0[2]};
+        const float e2[3] = {p2[0] - p0[0], p2[1] - p0[1], p2[2] - p0[2]};
+        const float n[3] = {e1[1] * e2[2] - e1[2] * e2[1],
+                            e1[2] * e2[0] - e1[0] * e2[2],
+                            e1[0] * e2[1] - e1[1] * e2[0]};
+        TEST_CHECK((n[0] * (p0[0] - camera[0]) + n[1] * (p0[1] - camera[1]) +
+                    n[2] * (p0[2] - camera[2])) >= 0.0f);
+      }
+    }
+  }
+
+  // Every triangle appears exactly once.
+  TEST_CHECK(seen.size() == num_tris);
+  for (const auto &it : seen) {
+    TEST_CHECK(it.second == 1);
+  }
+
+  TEST_CHECK(num_culled > 0);
+  TEST_MSG("%d of %d meshlets are culled", int(num_culled),
+           int(meshlets.size()));
+
+  // Flat patch facing +Z. It is culled from behind, and not from the front.
+  {
+    tydra::RenderMesh patch;
+    patch.points = {{0.0f, 0.0f, 0.0f},
+                    {1.0f, 0.0f, 0.0f},
+                    {0.0f, 1.0f, 0.0f},
+                    {1.0f, 1.0f, 0.0f}};
+    patch.usdFaceVertexIndices = {0, 1, 2, 2, 1, 3};
+    patch.usdFaceVertexCounts = {3, 3};
+    patch.triangulatedFaceVertexIndices = patch.usdFaceVertexIndices;
+    patch.triangulatedFaceVertexCounts = patch.usdFaceVertexCounts;
+    patch.is_single_indexable = true;
+
+    TEST_CHECK(tydra::BuildMeshlets(patch, kMaxVertices, kMaxTriangles,
+                                    &meshlets, &vertices, &triangles,
+                                    &subset_meshlets, &err));
+    TEST_CHECK(meshlets.size() == 1);
+    if (meshlets.size() != 1) {
+      return;
+    }
+    const tydra::Meshlet &m = meshlets[0];
+    TEST_CHECK(m.triangle_count == 2);
+    TEST_CHECK(NearlyEqual(m.cone_axis, {0.0f, 0.0f, 1.0f}));
+
+    auto is_culled = [&m](const tydra::vec3 &cam) {
+      const float d[3] = {m.cone_apex[0] - cam[0], m.cone_apex[1] - cam[1],
+                          m.cone_apex[2] - cam[2]};
+      const float len = std::sqrt(d[0] * d[0] + d[1] * d[1] + d[2] * d[2]);
+      return ((d[0] * m.cone_axis[0] + d[1] * m.cone_axis[1] +
+               d[2] * m.cone_axis[2]) /
+              len) >= m.cone_cutoff;
+    };
+    TEST_CHECK(is_culled({0.5f, 0.5f, -5.0f}));
+    TEST_CHECK(is_culled({3.0f, -2.0f, -1.0f}));
+    TEST_CHECK(!is_culled({0.5f, 0.5f, 5.0f}));
+    TEST_CHECK(!is_culled({3.0f, -2.0f, 1.0f}));
+  }
+}
@@ -0,0 +1,17 @@
+#pragma once
+
+void render_scene_threads_test(void);
+void texture_load_once_test(void);
+void build_vertex_indices_test(void);
+void vertex_to_corners_test(void);
+void compute_normals_test(void);
+void compute_tangents_test(void);
+void triangulate_test(void);
+void render_scene_updater_test(void);
+void vertex_layout_test(void);
+void vertex_encoding_test(void);
+void vertex_buffer_index_test(void);
+void vertex_buffer_expand_test(void);
+void vertex_cache_optimize_test(void);
+void mesh_lod_test(void);
+void meshlet_test(void);
@@ -7,10 +7,30 @@
 
 #include "unit-value-types.h"
 #include "value-types.hh"
+#include "value-type-dispatch.hh"
 #include "math-util.inc"
 
 using namespace tinyusdz;
 
+namespace {
+
+template <typename T>
+struct TypeSizeFn {
+  static bool call(const value::Value &v, size_t *size) {
+    if (v.type_id() & value::TYPE_ID_1D_ARRAY_BIT) {
+      (*size) = v.array_size() * sizeof(T);
+    } else {
+      (*size) = sizeof(T);
+    }
+    return true;
+  }
+};
+
+using TypeSizeDispatcher =
+    value::TypeIdDispatcher<TypeSizeFn, float, value::float3, value::matrix4d>;
+
+}  // namespace
+
 void value_types_test(void) {
 
   value::token tok1("bora");
@@ -39,5 +59,162 @@ void value_types_test(void) {
     TEST_CHECK(math::is_close(tex2f->t, 2.0f));
   }
 
+  // Arrays are shared among copies and copied on write.
+  {
+    std::vector<value::float3> pts = {{1.0f, 2.0f, 3.0f}, {4.0f, 5.0f, 6.0f}};
+    value::Value v0(pts);
+    TEST_CHECK(!v0.get_raw().is_shared());
+
+    value::Value v1 = v0;
+    TEST_CHECK(v0.get_raw().is_shared());
+
+    // const access does not copy the array.
+    const value::Value &cv0 = v0;
+    const value::Value &cv1 = v1;
+    TEST_CHECK(cv0.as<std::vector<value::float3>>() == cv1.as<std::vector<value::float3>>());
+
+    std::vector<value::point3f> *p1 = v1.as<std::vector<value::point3f>>();
+    TEST_CHECK(p1 != nullptr);
+    TEST_CHECK(!v0.get_raw().is_shared());
+    if (p1) {
+      (*p1)[0].x = 100.0f;
+    }
+
+    const std::vector<value::float3> *p0 = cv0.as<std::vector<value::float3>>();
+    TEST_CHECK(p0 != nullptr);
+    if (p0) {
+      TEST_CHECK(math::is_close((*p0)[0][0], 1.0f));
+    }
+  }
+
+  // Pointer obtained before copying the Value must not modify the copy.
+  {
+    std::vector<float> arr = {1.0f, 2.0f};
+    value::Value v0(arr);
+
+    std::vector<float> *p0 = v0.as<std::vector<float>>();
+    TEST_CHECK(p0 != nullptr);
+
+    value::Value v1 = v0;
+    TEST_CHECK(!v0.get_raw().is_shared());
+
+    if (p0) {
+      (*p0)[0] = 100.0f;
+    }
+
+    const value::Value &cv0 = v0;
+    const value::Value &cv1 = v1;
+    const std::vector<float> *q0 = cv0.as<std::vector<float>>();
+    const std::vector<float> *q1 = cv1.as<std::vector<float>>();
+    TEST_CHECK((q0 != nullptr) && (q1 != nullptr));
+    if (q0 && q1) {
+      TEST_CHECK(math::is_close((*q0)[0], 100.0f));
+      TEST_CHECK(math::is_close((*q1)[0], 1.0f));
+    }
+
+    // Copy of the copy is shared since no pointer to v1's array was handed out.
+    value::Value v2 = v1;
+    TEST_CHECK(v1.get_raw().is_shared());
+  }
+
+  // Reading samples must not stop sharing.
+  {
+    std::vector<float> arr = {1.0f, 2.0f};
+    value::Value v0(arr);
+
+    value::TimeSamples ts;
+    ts.add_sample(0.0, v0);
+    ts.add_sample(1.0, v0);
+    TEST_CHECK(v0.get_raw().is_shared());
+
+    std::vector<float> sample;
+    TEST_CHECK(ts.get(&sample, value::TimeCode::Default()));
+    TEST_CHECK(ts.get(&sample, 0.5, value::TimeSampleInterpolationType::Held));
+    TEST_CHECK(ts.get(&sample, 0.5));
+    TEST_CHECK(v0.get_value<std::vector<float>>().has_value());
+    TEST_CHECK(v0.get_array_view<float>().has_value());
+
+    // Copy of the read sample still shares the array.
+    value::Value v1 = ts.get_values()[0];
+    TEST_CHECK(v1.get_raw().is_shared());
+
+    // Casting a non-const `any` to const T does not unshare.
+    linb::any a0(arr);
+    linb::any a1 = a0;
+    TEST_CHECK(linb::any_cast<const std::vector<float>>(&a0) != nullptr);
+    TEST_CHECK(a0.is_shared());
+    linb::any a2 = a0;
+    TEST_CHECK(a2.is_shared());
+
+    // Modifying the copy does not alias the samples.
+    std::vector<float> *p1 = v1.as<std::vector<float>>();
+    TEST_CHECK(p1 != nullptr);
+    if (p1) {
+      (*p1)[0] = 100.0f;
+    }
+
+    TEST_CHECK(ts.get(&sample, 0.0, value::TimeSampleInterpolationType::Held));
+    TEST_CHECK((sample.size() == 2) && math::is_close(sample[0], 1.0f));
+    const value::Value &cv0 = v0;
+    const std::vector<float> *q0 = cv0.as<std::vector<float>>();
+    TEST_CHECK((q0 != nullptr) && math::is_close((*q0)[0], 1.0f));
+  }
+
+
+  // TypeId dispatch
+  {
+    TEST_CHECK(TypeSizeDispatcher::contains(value::TYPE_ID_FLOAT3));
+    TEST_CHECK(TypeSizeDispatcher::contains(value::TYPE_ID_FLOAT3 | value::TYPE_ID_1D_ARRAY_BIT));
+    TEST_CHECK(!TypeSizeDispatcher::contains(value::TYPE_ID_DOUBLE));
+    TEST_CHECK(!TypeSizeDispatcher::contains(value::TYPE_ID_LIST_OP_PATH));
+
+    size_t sz{0};
+    bool ret{false};
+    TEST_CHECK(TypeSizeDispatcher::dispatch(value::TYPE_ID_MATRIX4D, &ret, value::Value(value::matrix4d()), &sz));
+    TEST_CHECK(ret);
+    TEST_CHECK(sz == sizeof(double) * 16);
+
+    std::vector<value::float3> arr(3);
+    value::Value varr(arr);
+    TEST_CHECK(TypeSizeDispatcher::dispatch(varr.type_id(), &ret, varr, &sz));
+    TEST_CHECK(sz == sizeof(float) * 9);
+
+    // Not registered. Fn is not called.
+    sz = 0;
+    TEST_CHECK(!TypeSizeDispatcher::dispatch(value::TYPE_ID_INT32, &ret, value::Value(1), &sz));
+    TEST_CHECK(sz == 0);
+  }
+
+  // Lerp
+  {
+    TEST_CHECK(value::IsLerpSupportedType(value::TYPE_ID_COLOR3F));
+    TEST_CHECK(value::IsLerpSupportedType(value::TYPE_ID_POINT3F | value::TYPE_ID_1D_ARRAY_BIT));
+    TEST_CHECK(!value::IsLerpSupportedType(value::TYPE_ID_INT32));
+    TEST_CHECK(!value::IsLerpSupportedType(value::TYPE_ID_TOKEN));
+
+    value::matrix4d m0 = value::matrix4d::identity();
+    value::matrix4d m1 = value::matrix4d::identity();
+    m1.m[3][0] = 2.0;
+
+    value::Value v;
+    TEST_CHECK(value::Lerp(value::Value(m0), value::Value(m1), 0.25, &v));
+    const value::matrix4d *pm = v.as<value::matrix4d>();
+    TEST_CHECK(pm != nullptr);
+    if (pm) {
+      TEST_CHECK(math::is_close(pm->m[3][0], 0.5));
+    }
+
+    std::vector<value::color3f> c0 = {{0.0f, 0.0f, 0.0f}};
+    std::vector<value::color3f> c1 = {{1.0f, 2.0f, 4.0f}};
+    TEST_CHECK(value::Lerp(value::Value(c0), value::Value(c1), 0.5, &v));
+    const std::vector<value::color3f> *pc = v.as<std::vector<value::color3f>>();
+    TEST_CHECK(pc != nullptr);
+    if (pc) {
+      TEST_CHECK(math::is_close((*pc)[0][2], 2.0f));
+    }
+
+    TEST_CHECK(!value::Lerp(value::Value(1), value::Value(2), 0.5, &v));
+  }
+
 }
 
@@ -0,0 +1,244 @@
+#ifdef _MSC_VER
+#define NOMINMAX
+#endif
+
+#define TEST_NO_MAIN
+#include "acutest.h"
+
+#include <string>
+#include <vector>
+
+#include "unit-xform-cache.h"
+#include "prim-types.hh"
+#include "stage.hh"
+#include "tinyusdz.hh"
+#include "xform.hh"
+#include "tydra/scene-access.hh"
+#include "tydra/xform-cache.hh"
+
+using namespace tinyusdz;
+
+namespace {
+
+// /root/anim is animated. /root/scope/reset has !resetXformStack!.
+// /root/anim/c* are added to have enough nodes at the same depth.
+std::string MakeXformStageUSDA(const size_t num_children) {
+  std::string s = R"(#usda 1.0
+def Xform "root" {
+  double3 xformOp:translate = (1, 0, 0)
+  uniform token[] xformOpOrder = ["xformOp:translate"]
+
+  def Xform "anim" {
+    double3 xformOp:translate.timeSamples = { 0: (0, 0, 0), 10: (10, 0, 0) }
+    float xformOp:rotateZ = 90
+    uniform token[] xformOpOrder = ["xformOp:translate", "xformOp:rotateZ"]
+
+    def Xform "child" {
+      double3 xformOp:scale = (2, 2, 2)
+      uniform token[] xformOpOrder = ["xformOp:scale"]
+    }
+)";
+
+  for (size_t i = 0; i < num_children; i++) {
+    s += "    def Xform \"c" + std::to_string(i) + "\" {\n";
+    s += "      double3 xformOp:translate = (0, " + std::to_string(i) +
+         ", 0)\n";
+    s += "      uniform token[] xformOpOrder = [\"xformOp:translate\"]\n";
+    s += "    }\n";
+  }
+
+  s += R"(  }
+
+  def Scope "scope" {
+    def Xform "reset" {
+      double3 xformOp:translate = (0, 5, 0)
+      uniform token[] xformOpOrder = ["!resetXformStack!", "xformOp:translate"]
+    }
+  }
+}
+
+def Xform "root2" {
+}
+)";
+
+  return s;
+}
+
+bool LoadXformStage(const size_t num_children, Stage *stage) {
+  std::string usda = MakeXformStageUSDA(num_children);
+  std::string warn, err;
+  bool ret = LoadUSDAFromMemory(reinterpret_cast<const uint8_t *>(usda.data()),
+                                usda.size(), "", stage, &warn, &err);
+  TEST_MSG("%s", err.c_str());
+  return ret;
+}
+
+void CollectXformNodes(const tydra::XformNode &node,
+                       std::vector<const tydra::XformNode *> *nodes) {
+  nodes->push_back(&node);
+  for (const auto &child : node.children) {
+    CollectXformNodes(child, nodes);
+  }
+}
+
+}  // namespace
+
+void xform_hierarchy_test(void) {
+  Stage stage;
+  TEST_CHECK(LoadXformStage(/* num_children */ 0, &stage));
+
+  tydra::XformHierarchy h;
+  TEST_CHECK(tydra::BuildXformHierarchyFromStage(stage, &h, 5.0));
+
+  // Depth-first order. The Stage root comes first.
+  const std::vector<std::string> expected_paths = {
+      "/",
+      "/root",
+      "/root/anim",
+      "/root/anim/child",
+      "/root/scope",
+      "/root/scope/reset",
+      "/root2",
+  };
+  const std::vector<int32_t> expected_parents = {-1, 0, 1, 2, 1, 4, 0};
+  const std::vector<uint32_t> expected_subtree_ends = {7, 6, 4, 4, 6, 6, 7};
+
+  TEST_CHECK(h.size() == expected_paths.size());
+  if (h.size() != expected_paths.size()) {
+    return;
+  }
+
+  for (size_t i = 0; i < h.size(); i++) {
+    TEST_CHECK(h.absolute_paths[i].full_path_name() == expected_paths[i]);
+    TEST_MSG("[%d] %s", int(i), h.absolute_paths[i].full_path_name().c_str());
+    TEST_CHECK(h.parents[i] == expected_parents[i]);
+    TEST_CHECK(h.subtree_ends[i] == expected_subtree_ends[i]);
+  }
+
+  TEST_CHECK(h.prims[0] == nullptr);
+  TEST_CHECK(h.has_xform[4] == 0);  // Scope
+  TEST_CHECK(h.has_resetXformStack[5] == 1);
+  TEST_CHECK(h.has_resetXformStack[2] == 0);
+
+  // !resetXformStack! ignores parent's matrix.
+  TEST_CHECK(is_close(h.world_matrices[5], h.local_matrices[5]));
+  TEST_CHECK(is_close(h.world_matrices[5], trs_angle_xyz({0.0, 5.0, 0.0},
+                                                         {0.0, 0.0, 0.0},
+                                                         {1.0, 1.0, 1.0})));
+
+  // Compare with XformNode tree.
+  tydra::XformNode root;
+  TEST_CHECK(tydra::BuildXformNodeFromStage(stage, &root, 5.0));
+  std::vector<const tydra::XformNode *> nodes;
+  CollectXformNodes(root, &nodes);
+  TEST_CHECK(nodes.size() == h.size());
+  if (nodes.size() == h.size()) {
+    for (size_t i = 0; i < h.size(); i++) {
+      TEST_CHECK(nodes[i]->absolute_path.full_path_name() == expected_paths[i]);
+      TEST_CHECK(is_close(nodes[i]->get_local_matrix(), h.local_matrices[i], 1e-9));
+      TEST_CHECK(is_close(nodes[i]->get_world_matrix(), h.world_matrices[i], 1e-9));
+    }
+  }
+
+  // p = (1, 0, 0) in /root/anim/child at t = 5:
+  // scale(2) -> rotateZ(90) -> translate(5, 0, 0) -> translate(1, 0, 0)
+  {
+    value::double3 p = transform(h.world_matrices[3], value::double3({1.0, 0.0, 0.0}));
+    TEST_CHECK(std::fabs(p[0] - 6.0) < 1e-9);
+    TEST_CHECK(std::fabs(p[1] - 2.0) < 1e-9);
+    TEST_CHECK(std::fabs(p[2]) < 1e-9);
+  }
+
+  // Re-evaluating at another time gives the same result with building at
+  // that time.
+  tydra::XformHierarchy h10;
+  TEST_CHECK(tydra::BuildXformHierarchyFromStage(stage, &h10, 10.0));
+  TEST_CHECK(tydra::UpdateXformHierarchy(&h, 10.0));
+  for (size_t i = 0; i < h.size(); i++) {
+    TEST_CHECK(is_close(h.local_matrices[i], h10.local_matrices[i]));
+    TEST_CHECK(is_close(h.world_matrices[i], h10.world_matrices[i]));
+  }
+}
+
+void xform_cache_test(void) {
+  // Enough nodes at the same depth to be processed in parallel.
+  Stage stage;
+  TEST_CHECK(LoadXformStage(/* num_children */ 200, &stage));
+
+  tydra::XformCache serial_cache;
+  TEST_CHECK(serial_cache.build(stage, 0.0,
+                                value::TimeSampleInterpolationType::Linear,
+                                /* num_threads */ 1));
+  TEST_MSG("%s", serial_cache.get_error().c_str());
+
+  tydra::XformCache cache;
+  TEST_CHECK(cache.build(stage, 0.0,
+                         value::TimeSampleInterpolationType::Linear,
+                         /* num_threads */ 4));
+
+  const tydra::XformHierarchy &h = cache.hierarchy();
+  TEST_CHECK(h.size() == 207);
+
+  const int64_t root_idx = cache.find(Path("/root", ""));
+  const int64_t anim_idx = cache.find(Path("/root/anim", ""));
+  const int64_t child_idx = cache.find(Path("/root/anim/child", ""));
+  const int64_t reset_idx = cache.find(Path("/root/scope/reset", ""));
+  TEST_CHECK(root_idx > 0);
+  TEST_CHECK(anim_idx > 0);
+  TEST_CHECK(child_idx > 0);
+  TEST_CHECK(reset_idx > 0);
+  TEST_CHECK(cache.find(Path("/root/muda", "")) == -1);
+
+  TEST_CHECK(cache.num_animated() == 1);
+  TEST_CHECK(cache.is_animated(size_t(anim_idx)));
+  TEST_CHECK(!cache.is_animated(size_t(child_idx)));
+  TEST_CHECK(!cache.is_animated(size_t(root_idx)));
+
+  // Descendants of animated node have time-varying world matrix.
+  TEST_CHECK(cache.is_time_varying(size_t(anim_idx)));
+  TEST_CHECK(cache.is_time_varying(size_t(child_idx)));
+  TEST_CHECK(!cache.is_time_varying(size_t(root_idx)));
+  TEST_CHECK(!cache.is_time_varying(size_t(reset_idx)));
+
+  for (double t : {0.0, 2.5, 10.0, 20.0}) {
+    TEST_CHECK(serial_cache.set_time(t));
+    TEST_CHECK(cache.set_time(t));
+    TEST_CHECK(cache.get_time() == t);
+
+    // Reference: recursive evaluation with GetLocalTransform.
+    tydra::XformNode root;
+    TEST_CHECK(tydra::BuildXformNodeFromStage(stage, &root, t));
+    std::vector<const tydra::XformNode *> nodes;
+    CollectXformNodes(root, &nodes);
+    TEST_CHECK(nodes.size() == h.size());
+    if (nodes.size() != h.size()) {
+      return;
+    }
+
+    for (size_t i = 0; i < h.size(); i++) {
+      const Path &path = nodes[i]->absolute_path;
+      value::matrix4d local, world;
+      bool rxs{false};
+      TEST_CHECK(cache.get_local_matrix(path, &local, &rxs));
+      TEST_CHECK(cache.get_world_matrix(path, &world));
+      TEST_CHECK(rxs == nodes[i]->has_resetXformStack());
+      TEST_CHECK(is_close(local, nodes[i]->get_local_matrix(), 1e-9));
+      TEST_CHECK(is_close(world, nodes[i]->get_world_matrix(), 1e-9));
+      TEST_MSG("%s at t = %f", path.full_path_name().c_str(), t);
+
+      // Same result regardless of # of threads.
+      TEST_CHECK(is_close(serial_cache.hierarchy().world_matrices[i],
+                          h.world_matrices[i]));
+    }
+  }
+
+  // !resetXformStack!
+  {
+    value::matrix4d local, world;
+    bool rxs{false};
+    TEST_CHECK(cache.get_local_matrix(Path("/root/scope/reset", ""), &local, &rxs));
+    TEST_CHECK(cache.get_world_matrix(Path("/root/scope/reset", ""), &world));
+    TEST_CHECK(rxs);
+    TEST_CHECK(is_close(local, world));
+  }
+}
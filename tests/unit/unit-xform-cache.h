@@ -0,0 +1,4 @@
+#pragma once
+
+void xform_hierarchy_test(void);
+void xform_cache_test(void);
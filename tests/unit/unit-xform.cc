@@ -355,4 +355,239 @@ void xformOp_test(void) {
   }
 
 
+  // timeSampled xformOp
+  {
+    Xformable x;
+    {
+      XformOp op;
+      op.op_type = XformOp::OpType::Translate;
+      op.set_timesample(0.0f, value::double3({0.0, 0.0, 0.0}));
+      op.set_timesample(10.0f, value::double3({10.0, 0.0, 0.0}));
+
+      x.xformOps.push_back(op);
+    }
+
+    {
+      XformOp op;
+      op.op_type = XformOp::OpType::Scale;
+      op.set_value(value::float3({2.0f, 2.0f, 2.0f}));
+
+      x.xformOps.push_back(op);
+    }
+
+    TEST_CHECK(x.has_timesamples());
+
+    value::matrix4d m;
+    bool resetXformStack{false};
+    std::string err;
+
+    bool ret = x.EvaluateXformOps(5.0, value::TimeSampleInterpolationType::Linear, &m, &resetXformStack, &err);
+    TEST_CHECK(ret);
+    TEST_MSG("%s", err.c_str());
+    TEST_CHECK(float_equals(m.m[0][0], 2.0));
+    TEST_CHECK(float_equals(m.m[3][0], 5.0));
+
+    ret = x.EvaluateXformOps(5.0, value::TimeSampleInterpolationType::Held, &m, &resetXformStack, &err);
+    TEST_CHECK(ret);
+    TEST_CHECK(float_equals(m.m[3][0], 0.0));
+
+    // GetLocalMatrix does not return the cached matrix of other time.
+    auto lm = x.GetLocalMatrix(2.0);
+    TEST_CHECK(lm.has_value());
+    TEST_CHECK(float_equals(lm.value().m[3][0], 2.0));
+    lm = x.GetLocalMatrix(8.0);
+    TEST_CHECK(lm.has_value());
+    TEST_CHECK(float_equals(lm.value().m[3][0], 8.0));
+  }
+
+  // Compiled xformOps
+  {
+    Xformable x;
+    {
+      XformOp op;
+      op.op_type = XformOp::OpType::Scale;
+      op.set_value(value::float3({2.0f, 2.0f, 2.0f}));
+      x.xformOps.push_back(op);
+    }
+    {
+      XformOp op;
+      op.op_type = XformOp::OpType::RotateZ;
+      op.set_value(90.0f);
+      x.xformOps.push_back(op);
+    }
+    {
+      XformOp op;
+      op.op_type = XformOp::OpType::Translate;
+      op.set_timesample(0.0f, value::float3({0.0f, 0.0f, 0.0f}));
+      op.set_timesample(10.0f, value::float3({10.0f, 0.0f, 0.0f}));
+      x.xformOps.push_back(op);
+    }
+    {
+      XformOp op;
+      op.op_type = XformOp::OpType::Translate;
+      op.inverted = true;
+      op.suffix = "pivot";
+      op.set_value(value::double3({1.0, 2.0, 3.0}));
+      x.xformOps.push_back(op);
+    }
+
+    XformOpProgram program;
+    std::string err;
+    TEST_CHECK(x.CompileXformOps(&program, &err));
+    TEST_MSG("%s", err.c_str());
+
+    // [scale, rotateZ] are folded.
+    TEST_CHECK(program.instructions().size() == 3);
+    TEST_CHECK(program.num_animated() == 1);
+    TEST_CHECK(program.reset_xform_stack() == false);
+
+    for (double t : {-1.0, 0.0, 2.5, 7.0, 10.0, 20.0}) {
+      for (auto tinterp : {value::TimeSampleInterpolationType::Linear,
+                           value::TimeSampleInterpolationType::Held}) {
+        value::matrix4d m0, m1;
+        bool resetXformStack{false};
+        TEST_CHECK(x.EvaluateXformOps(t, tinterp, &m0, &resetXformStack, &err));
+        TEST_CHECK(program.evaluate(t, tinterp, &m1, &err));
+        TEST_CHECK(is_close(m0, m1));
+      }
+    }
+
+    value::matrix4d m;
+    TEST_CHECK(program.evaluate(5.0, value::TimeSampleInterpolationType::Linear, &m, &err));
+    // p' = S x R x T x inv(T_pivot) x p
+    value::double3 p = transform(m, value::double3({1.0, 0.0, 0.0}));
+    TEST_CHECK(float_equals(p[0], 4.0));
+    TEST_CHECK(float_equals(p[1], 10.0));
+    TEST_CHECK(float_equals(p[2], -6.0));
+  }
+
+  // GetLocalMatrix() caches the compiled program of timeSampled xformOps.
+  {
+    Xformable x;
+    {
+      XformOp op;
+      op.op_type = XformOp::OpType::Translate;
+      op.set_timesample(0.0f, value::float3({0.0f, 0.0f, 0.0f}));
+      op.set_timesample(10.0f, value::float3({10.0f, 0.0f, 0.0f}));
+      x.xformOps.push_back(op);
+    }
+    {
+      XformOp op;
+      op.op_type = XformOp::OpType::Scale;
+      op.set_value(value::double3({2.0, 2.0, 2.0}));
+      x.xformOps.push_back(op);
+    }
+
+    std::string err;
+    for (double t : {0.0, 5.0, 10.0, 5.0}) {
+      value::matrix4d ref;
+      bool resetXformStack{false};
+      TEST_CHECK(x.EvaluateXformOps(t, value::TimeSampleInterpolationType::Linear, &ref, &resetXformStack, &err));
+      auto m = x.GetLocalMatrix(t);
+      TEST_CHECK(m.has_value());
+      if (m) {
+        TEST_CHECK(is_close(m.value(), ref));
+      }
+    }
+
+    // The program of the copy refers to its own xformOps.
+    Xformable y = x;
+    x = Xformable();
+
+    value::matrix4d ref;
+    bool resetXformStack{false};
+    TEST_CHECK(y.EvaluateXformOps(5.0, value::TimeSampleInterpolationType::Linear, &ref, &resetXformStack, &err));
+    auto m = y.GetLocalMatrix(5.0);
+    TEST_CHECK(m.has_value());
+    if (m) {
+      TEST_CHECK(is_close(m.value(), ref));
+      value::double3 p = transform(m.value(), value::double3({1.0, 0.0, 0.0}));
+      TEST_CHECK(float_equals(p[0], 7.0));
+    }
+
+    // Modified xformOps are recompiled after set_dirty().
+    y.xformOps[1].set_value(value::double3({3.0, 3.0, 3.0}));
+    y.set_dirty(true);
+    m = y.GetLocalMatrix(5.0);
+    TEST_CHECK(m.has_value());
+    if (m) {
+      value::double3 p = transform(m.value(), value::double3({1.0, 0.0, 0.0}));
+      TEST_CHECK(float_equals(p[0], 8.0));
+    }
+  }
+
+  // Type error is reported at compile time.
+  {
+    Xformable x;
+    XformOp op;
+    op.op_type = XformOp::OpType::Scale;
+    op.set_value(value::matrix4d::identity());
+    x.xformOps.push_back(op);
+
+    XformOpProgram program;
+    std::string err;
+    TEST_CHECK(!x.CompileXformOps(&program, &err));
+    TEST_CHECK(err.find("xformOp:scale") != std::string::npos);
+  }
+
+  // Batch transform
+  {
+    value::matrix4d m = trs_angle_xyz({1.0, -2.0, 3.0}, {30.0, 45.0, 60.0},
+                                      {2.0, 0.5, 1.5});
+
+    // Not a multiple of SIMD width to test the remainder loop.
+    constexpr size_t n = 19;
+    std::vector<value::float3> pts(n);
+    std::vector<value::normal3f> nrms(n);
+    for (size_t i = 0; i < n; i++) {
+      pts[i] = {float(i) * 0.5f, 1.0f - float(i), float(i % 3)};
+      nrms[i] = {float(i % 2), 1.0f, float(i % 5)};
+    }
+    nrms[7] = {0.0f, 0.0f, 0.0f};
+
+    std::vector<value::float3> out(n);
+    transform_points(m, pts.data(), out.data(), n);
+    for (size_t i = 0; i < n; i++) {
+      value::float3 ref = transform(m, pts[i]);
+      for (size_t k = 0; k < 3; k++) {
+        TEST_CHECK(float_equals(out[i][k], ref[k], 1e-4f));
+      }
+    }
+
+    transform_dirs(m, pts.data(), out.data(), n);
+    for (size_t i = 0; i < n; i++) {
+      value::float3 ref = transform_dir(m, pts[i]);
+      for (size_t k = 0; k < 3; k++) {
+        TEST_CHECK(float_equals(out[i][k], ref[k], 1e-4f));
+      }
+    }
+
+    // in-place
+    std::vector<value::float3> inplace = pts;
+    transform_points(m, inplace.data(), inplace.data(), n);
+    for (size_t i = 0; i < n; i++) {
+      value::float3 ref = transform(m, pts[i]);
+      for (size_t k = 0; k < 3; k++) {
+        TEST_CHECK(float_equals(inplace[i][k], ref[k], 1e-4f));
+      }
+    }
+
+    std::vector<value::normal3f> nout(n);
+    transform_normals(m, nrms.data(), nout.data(), n);
+    value::matrix4d nm = transpose(inverse(upper_left_3x3_only(m)));
+    for (size_t i = 0; i < n; i++) {
+      if (i == 7) {
+        TEST_CHECK(float_equals(nout[i][0], 0.0f));
+        TEST_CHECK(float_equals(nout[i][1], 0.0f));
+        TEST_CHECK(float_equals(nout[i][2], 0.0f));
+        continue;
+      }
+      value::normal3f ref = transform_dir(nm, nrms[i]);
+      float len = std::sqrt(ref[0] * ref[0] + ref[1] * ref[1] + ref[2] * ref[2]);
+      for (size_t k = 0; k < 3; k++) {
+        TEST_CHECK(float_equals(nout[i][k], ref[k] / len, 1e-5f));
+      }
+    }
+  }
+
 }